@@ -17,6 +17,7 @@
 #define CMSIS_device_header "stm32f10x.h"
 
 #define RTE_DEVICE_STDPERIPH_ADC
+#define RTE_DEVICE_STDPERIPH_DMA
 #define RTE_DEVICE_STDPERIPH_EXTI
 #define RTE_DEVICE_STDPERIPH_FRAMEWORK
 #define RTE_DEVICE_STDPERIPH_GPIO
@@ -1,35 +1,35 @@
 #ifndef  __OLED_TABLE_H
 #define  __OLED_TABLE_H
-	/***************************16*16ĵȡģʽʽ*********/
+	/***************************16*16的点阵字体取模方式：共阴——列行式——逆向输出*********/
 unsigned char const F16x16[] = 	  	 
 {  	  
 
 0x00,0xE0,0xA0,0xA0,0xA0,0xA0,0xF0,0xA0,0xA0,0xA0,0xA0,0xE0,0x00,0x00,0x00,0x00,
-0x00,0x0F,0x04,0x04,0x04,0x04,0x1F,0x14,0x14,0x14,0x14,0x17,0x10,0x0C,0x00,0x00,/*"",7*/
+0x00,0x0F,0x04,0x04,0x04,0x04,0x1F,0x14,0x14,0x14,0x14,0x17,0x10,0x0C,0x00,0x00,/*"电",7*/
 
 0x00,0x10,0x10,0x10,0x10,0x10,0x10,0x90,0xD0,0x70,0x30,0x10,0x00,0x00,0x00,0x00,
-0x01,0x01,0x01,0x01,0x11,0x11,0x11,0x1F,0x01,0x01,0x01,0x01,0x01,0x00,0x00,0x00,/*"",8*/
+0x01,0x01,0x01,0x01,0x11,0x11,0x11,0x1F,0x01,0x01,0x01,0x01,0x01,0x00,0x00,0x00,/*"子",8*/
 
 0x00,0x20,0x20,0x20,0x20,0x20,0xE0,0x20,0x20,0x20,0x20,0x20,0x20,0x00,0x00,0x00,
-0x10,0x10,0x10,0x10,0x10,0x10,0x1F,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x00,0x00,/*"",9*/
+0x10,0x10,0x10,0x10,0x10,0x10,0x1F,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x00,0x00,/*"工",9*/
 
 0x50,0x50,0xF0,0x48,0x48,0x00,0x70,0x50,0x50,0x50,0x50,0x50,0x70,0x00,0x00,0x00,
-0x0C,0x03,0x3F,0x01,0x02,0x15,0x15,0x15,0x15,0x1F,0x15,0x15,0x15,0x11,0x00,0x00,/*"",10*/
+0x0C,0x03,0x3F,0x01,0x02,0x15,0x15,0x15,0x15,0x1F,0x15,0x15,0x15,0x11,0x00,0x00,/*"程",10*/
 
 0x00,0xE0,0x00,0x00,0xF0,0x00,0xD0,0x50,0x50,0xF0,0x50,0x50,0xD0,0x10,0x00,0x00,
-0x00,0x27,0x30,0x18,0x07,0x00,0x0F,0x00,0x00,0x3F,0x08,0x08,0x0F,0x00,0x00,0x00,/*"ʦ",11*/
+0x00,0x27,0x30,0x18,0x07,0x00,0x0F,0x00,0x00,0x3F,0x08,0x08,0x0F,0x00,0x00,0x00,/*"师",11*/
 
 0x40,0x40,0xF0,0x40,0x40,0x40,0xF0,0x40,0x40,0x40,0x40,0xF0,0x40,0x40,0x00,0x00,
-0x00,0x00,0x1F,0x10,0x10,0x10,0x17,0x12,0x12,0x12,0x12,0x17,0x10,0x10,0x00,0x00,/*"",12*/
+0x00,0x00,0x1F,0x10,0x10,0x10,0x17,0x12,0x12,0x12,0x12,0x17,0x10,0x10,0x00,0x00,/*"世",12*/
 
 0x00,0x00,0xF0,0x50,0x50,0x50,0x50,0xF0,0x50,0x50,0x50,0xF0,0x00,0x00,0x00,0x00,
-0x00,0x14,0x15,0x0B,0x07,0x01,0x01,0x01,0x01,0x1F,0x05,0x05,0x04,0x00,0x00,0x00,/*"",13*/
+0x00,0x14,0x15,0x0B,0x07,0x01,0x01,0x01,0x01,0x1F,0x05,0x05,0x04,0x00,0x00,0x00,/*"界",13*/
 
 0x80,0x90,0x90,0x20,0x80,0x80,0x40,0x40,0x20,0x10,0x20,0x40,0x80,0x80,0x00,0x00,
-0x00,0x10,0x1F,0x10,0x08,0x00,0x1F,0x12,0x12,0x12,0x11,0x11,0x0C,0x00,0x00,0x00,/*"",14*/
+0x00,0x10,0x1F,0x10,0x08,0x00,0x1F,0x12,0x12,0x12,0x11,0x11,0x0C,0x00,0x00,0x00,/*"论",14*/
 
 0x40,0x40,0xF8,0x40,0x40,0x90,0x90,0x90,0x90,0x90,0x90,0x90,0x90,0x80,0x00,0x00,
-0x08,0x08,0x0F,0x04,0x14,0x18,0x14,0x12,0x11,0x10,0x12,0x1C,0x18,0x10,0x00,0x00,/*"̳",15*/
+0x08,0x08,0x0F,0x04,0x14,0x18,0x14,0x12,0x11,0x10,0x12,0x1C,0x18,0x10,0x00,0x00,/*"坛",15*/
 
 };
 unsigned char const F32x32[]=
@@ -41,7 +41,7 @@ unsigned char const F32x32[]=
 0x00,0x00,0xFF,0xFF,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0xFF,
 0xFF,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x3F,0x3F,0x00,0x00,0xC0,
 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x07,
-0x0F,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x0E,0x0F,/*"",0*/
+0x0F,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x0E,0x0F,/*"电",0*/
 
 0x00,0x00,0x00,0x00,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
 0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x00,0x00,
@@ -50,7 +50,7 @@ unsigned char const F32x32[]=
 0x00,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,
 0xFF,0xFF,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,
 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x18,0x18,0x18,0x18,0x18,0x18,0x18,
-0x0F,0x0F,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,/*"",1*/
+0x0F,0x0F,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,/*"子",1*/
 
 0x00,0x00,0x00,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
 0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x00,
@@ -59,7 +59,7 @@ unsigned char const F32x32[]=
 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
 0xFF,0xFF,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
 0x00,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,
-0x0F,0x0F,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,/*"",2*/
+0x0F,0x0F,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,/*"工",2*/
 
 0x00,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0xC0,0xC0,0xC0,0xC0,0x80,0x00,0x00,0x80,
 0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x00,
@@ -68,7 +68,7 @@ unsigned char const F32x32[]=
 0x80,0xE0,0x70,0x38,0x1E,0x07,0xFF,0xFF,0x02,0x07,0x0E,0x1C,0x08,0x03,0x63,0x63,
 0x63,0x63,0x63,0x63,0x63,0x63,0xFF,0xFF,0x63,0x63,0x63,0x63,0x63,0x63,0x63,0x63,
 0x00,0x01,0x00,0x00,0x00,0x00,0x1F,0x1F,0x00,0x00,0x00,0x00,0x0C,0x0C,0x0C,0x0C,
-0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0F,0x0F,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,/*"",3*/
+0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0F,0x0F,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,/*"程",3*/
 
 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0x00,0x00,0x00,0x80,0x80,0x80,
 0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
@@ -77,7 +77,7 @@ unsigned char const F32x32[]=
 0x00,0x00,0x7F,0x7F,0x00,0x00,0x00,0xE0,0xFF,0x3F,0x00,0x00,0x00,0x00,0xFF,0xFF,
 0x00,0x00,0x00,0x00,0x00,0xFF,0xFF,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xFF,0x00,
 0x00,0x00,0x00,0x08,0x1C,0x0E,0x07,0x03,0x01,0x00,0x00,0x00,0x00,0x00,0x03,0x03,
-0x00,0x00,0x00,0x00,0x00,0x1F,0x1F,0x00,0x03,0x03,0x03,0x03,0x03,0x03,0x01,0x00,/*"ʦ",4*/
+0x00,0x00,0x00,0x00,0x00,0x1F,0x1F,0x00,0x03,0x03,0x03,0x03,0x03,0x03,0x01,0x00,/*"师",4*/
 
 0x00,0x00,0x00,0x00,0x00,0x80,0x80,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,
 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0x00,0x00,0x00,0x00,
@@ -86,7 +86,7 @@ unsigned char const F32x32[]=
 0x00,0x00,0x00,0x00,0x00,0xFF,0xFF,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x7F,
 0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x7F,0x7F,0x00,0x00,0x00,0x00,
 0x00,0x00,0x00,0x00,0x00,0x0F,0x0F,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,
-0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,/*"",5*/
+0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,0x0C,/*"世",5*/
 
 0x00,0x00,0x00,0x00,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
 0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x00,0x00,
@@ -95,7 +95,7 @@ unsigned char const F32x32[]=
 0x00,0x20,0x60,0x60,0x33,0x33,0x31,0x11,0x19,0x99,0xF9,0xFD,0x05,0x07,0x03,0x03,
 0x01,0x01,0x03,0x03,0x07,0x05,0xFD,0xF9,0x19,0x19,0x11,0x31,0x33,0x33,0x60,0x60,
 0x00,0x00,0x00,0x08,0x18,0x1C,0x0C,0x0E,0x06,0x07,0x03,0x00,0x00,0x00,0x00,0x00,
-0x00,0x00,0x00,0x00,0x00,0x00,0x1F,0x1F,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,/*"",6*/
+0x00,0x00,0x00,0x00,0x00,0x00,0x1F,0x1F,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,/*"界",6*/
 
 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
 0x80,0x80,0x80,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
@@ -104,7 +104,7 @@ unsigned char const F32x32[]=
 0x00,0x00,0x07,0x1F,0x3F,0x7C,0x70,0xE0,0xC0,0x80,0x00,0x00,0x00,0x00,0x00,0x00,
 0x00,0x00,0x80,0xC0,0xE0,0x70,0x7C,0x3F,0x1F,0x07,0x00,0x00,0x00,0x00,0x00,0x00,
 0x00,0x00,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x00,0x00,0x00,0x00,0x00,
-0x00,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x00,0x00,0x00,0x00,0x00,0x00,/*"",0*/
+0x00,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x00,0x00,0x00,0x00,0x00,0x00,/*"Ω",0*/
 };
 unsigned char const BMP[] = 	  	 
 { 
@@ -176,7 +176,7 @@ unsigned char const BMP[] =
 
 };
 
-/************************************6*8ĵ************************************/
+/************************************6*8的点阵************************************/
 const unsigned char  F6x8[][6] =		
 {
 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,// sp
@@ -272,7 +272,7 @@ const unsigned char  F6x8[][6] =
 0x00, 0x44, 0x64, 0x54, 0x4C, 0x44,// z
 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,// horiz lines
 };
-/****************************************8*16ĵ************************************/
+/****************************************8*16的点阵************************************/
 const unsigned char  F8X16[]=	  
 {
   0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,// 0
@@ -1,60 +1,60 @@
 /*********************************************************************************************************
-    ģ : BSPģ(For STM32F1XX)
-    ļ : bsp.c
-    ˵     : ӲײģļҪṩ bsp_Init()á
-               ÿcļڿͷ #include "bsp.h" еģ顣
+    模块名称 : BSP模块(For STM32F1XX)
+    文件名称 : bsp.c
+    说    明 : 这是硬件底层驱动程序模块的主文件。主要提供 bsp_Init()函数供主程序调用。
+               主程序的每个c文件可以在开头添加 #include "bsp.h" 来包含所有的外设驱动模块。
 *********************************************************************************************************/
 #include "bsp.h"
 /*********************************************************************************************************
-      : bsp_Init
-    ˵: ʼӲ豸ֻҪһΡúCPUĴļĴʼһЩȫֱ
-             ȫֱ
-        Σ
-      ֵ: 
+    函 数 名: bsp_Init
+    功能说明: 初始化硬件设备。只需要调用一次。该函数配置CPU寄存器和外设的寄存器并初始化一些全局变量。
+             全局变量。
+    形    参：无
+    返 回 值: 无
 *********************************************************************************************************/
 void bsp_Init ( void )
 {
-//  ST̼ļѾִCPUϵͳʱӵĳʼԲٴظϵͳʱӡ
-//  ļCPUʱƵʡڲFlashٶȺͿѡⲿSRAM FSMCʼ
-//  ϵͳʱȱʡΪ72MHzҪģ޸ system_stm32f10x.c ļ
-	/* ȼΪ4 */
-//	NVIC_PriorityGroupConfig ( NVIC_PriorityGroup_4 ); //ʼжȼ
-	LED_Init(); //ʼLedGPIO
-//    bsp_POWER_Init(); //ʼһػ·IO
+//  由于ST固件库的启动文件已经执行了CPU系统时钟的初始化，所以不必再次重复配置系统时钟。
+//  启动文件配置了CPU主时钟频率、内部Flash访问速度和可选的外部SRAM FSMC初始化。
+//  系统时钟缺省配置为72MHz，如果需要更改，可以修改 system_stm32f10x.c 文件
+	/* 优先级分组设置为4 */
+//	NVIC_PriorityGroupConfig ( NVIC_PriorityGroup_4 ); //初始化中断优先级
+	LED_Init(); //初始化Led的GPIO
+//    bsp_POWER_Init(); //初始化一键开关机电路的IO口
     
-	/*ʼʱ*/
-	SysTickTimer_Init();    //ʼϵͳδʱ (˺Ὺж)
-	bsp_HardTimerInit();    //ʼӲʱ 
-	/*ΪSPIʽOLED*/    
+	/*初始化定时器*/
+	SysTickTimer_Init();    //初始化系统滴答定时器 (此函数会开中断)
+	bsp_HardTimerInit();    //初始化硬件定时器 
+	/*以下为开启SPI驱动方式的OLED*/    
     OLEDIO_Init(); 
-	SPI1_Init();    //ʼSPI
+	SPI1_Init();    //初始化SPI
 	LCD_DLY_ms ( 500 );
-	OLED_Init();  //ʼOLedGPIO
+	OLED_Init();  //初始化OLed的GPIO并配置
 	OLED_CLS();
 	OLED_Fill ( 0x00 );
 	LCD_P8x16Str ( 0, 0, "OLED Test" );
-	/*Ϊ3*/
-	UART_InitALL(); //ʼ
+	/*以下为开启3个串口*/
+	UART_InitALL(); //初始化串口
     
-//	ADC_Configuration(); //ʼADC0
+//	ADC_Configuration(); //初始化ADC0
 
-//	/*ʼSX1278*/
+//	/*初始化SX1278*/
     RFGPIOInit();
-	RFInit();    //Ƶģʼ
-	RFRxMode();  //ģʽ
+	RFInit();    //射频模块初始化
+	RFRxMode();  //进入接收模式
 
-//	/*ʼAD5933*/
+//	/*初始化AD5933*/
     I2C_EE_Init();
     Init_AD5933();
 }
 
 /*
 *********************************************************************************************************
-      : bsp_RunPer10ms
-    ˵: úÿ10msSystickжϵ1Ρ bsp_timer.cĶʱжϷһЩʱҪϸ
-            Էڴ˺磺ɨ衢пƵȡ
-        Σ
-      ֵ: 
+    函 数 名: bsp_RunPer10ms
+    功能说明: 该函数每隔10ms被Systick中断调用1次。详见 bsp_timer.c的定时中断服务程序。一些处理时间要求不严格的
+            任务可以放在此函数。比如：按键扫描、蜂鸣器鸣叫控制等。
+    形    参：无
+    返 回 值: 无
 *********************************************************************************************************
 */
 void bsp_RunPer10ms ( void )
@@ -63,11 +63,11 @@ void bsp_RunPer10ms ( void )
 
 /*
 *********************************************************************************************************
-      : bsp_RunPer1ms
-    ˵: úÿ1msSystickжϵ1Ρ bsp_timer.cĶʱжϷһЩҪԴ
-             Էڴ˺磺ɨ衣
-        : 
-      ֵ: 
+    函 数 名: bsp_RunPer1ms
+    功能说明: 该函数每隔1ms被Systick中断调用1次。详见 bsp_timer.c的定时中断服务程序。一些需要周期性处理的事务
+             可以放在此函数。比如：触摸坐标扫描。
+    形    参: 无
+    返 回 值: 无
 *********************************************************************************************************
 */
 void bsp_RunPer1ms ( void )
@@ -76,15 +76,15 @@ void bsp_RunPer1ms ( void )
 
 /*
 *********************************************************************************************************
-      : bsp_Idle
-    ˵: ʱִеĺһforwhileѭҪ CPU_IDLE() ñ
-           ȱʡΪղûιCPUģʽĹܡ
-        Σ
-      ֵ: 
+    函 数 名: bsp_Idle
+    功能说明: 空闲时执行的函数。一般主程序在for和while循环程序体中需要插入 CPU_IDLE() 宏来调用本函数。
+           本函数缺省为空操作。用户可以添加喂狗、设置CPU进入休眠模式的功能。
+    形    参：无
+    返 回 值: 无
 *********************************************************************************************************
 */
 void bsp_Idle ( void )
 {
-	/*˴ι */
-	TPCProcess ( TaskComps ); //񣬶ʱʱ䵽ģõִ
+	/*此处可以喂狗 */
+	TPCProcess ( TaskComps ); //处理任务，定时时间到达的，即得到执行
 }
@@ -1,9 +1,9 @@
 /**********************************************************************************************************
 *
-*   ģ : BSPģ
-*   ļ : bsp.h
-*   ˵     : ǵײģеhļĻļ Ӧóֻ #include bsp.h ɣ
-*             Ҫ#include ÿģ h ļ
+*   模块名称 : BSP模块
+*   文件名称 : bsp.h
+*   说    明 : 这是底层驱动模块所有的h文件的汇总文件。 应用程序只需 #include bsp.h 即可，
+*             不需要#include 每个模块的 h 文件
 *
 *
 *********************************************************************************************************/
@@ -12,20 +12,20 @@
 #define _BSP_H
 
 #define STM32_V4
-/* Ƿ˿ͺ */
+/* 检查是否定义了开发板型号 */
 #if !defined (STM32_V4) && !defined (STM32_X2)
 #error "Please define the board model : STM32_X2 or STM32_V4"
 #endif
 
-/*  BSP 汾 */
+/* 定义 BSP 版本号 */
 #define __STM32F1_BSP_VERSION       "1.1"
 
-/* CPUʱִеĺ */
+/* CPU空闲时执行的函数 */
 //#define CPU_IDLE()        bsp_Idle()
 
-/* ȫжϵĺ */
-#define ENABLE_INT()    __set_PRIMASK(0)    /* ʹȫж */
-#define DISABLE_INT()   __set_PRIMASK(1)    /* ֹȫж */
+/* 开关全局中断的宏 */
+#define ENABLE_INT()    __set_PRIMASK(0)    /* 使能全局中断 */
+#define DISABLE_INT()   __set_PRIMASK(1)    /* 禁止全局中断 */
 
 #define BSP_Printf printf
 
@@ -37,7 +37,8 @@
 #include <stdint.h>
 #include <stdarg.h>
 
-/* ͨȡעͻע͵ķʽǷײģ */
+/* 通过取消注释或者添加注释的方式控制是否包含底层驱动模块 */
+#include "bsp_ring.h"
 #include "bsp_uartfifo.h"
 #include "bsp_led.h"
 #include "bsp_systimer.h"
@@ -50,17 +51,29 @@
 #include "bsp_uartpro.h"
 #include "bsp_timer.h"
 #include "bsp_sx1276-LoRa.h"
+#include "bsp_sx1276-Fsk.h"
+#include "bsp_pktpool.h"
+#include "bsp_airtime.h"
 #include "bsp_rf.h"
 #include "bsp_power.h"
 #include "bsp_adc.h"
 #include "bsp_i2c_ee.h"
 #include "bsp_ad5933.h"
-
-//λ,ʵ51ƵGPIOƹ,IOڲ궨
+#include "bsp_tlmcodec.h"
+#include "bsp_frag.h"
+#include "bsp_bleframe.h"
+#include "bsp_join.h"
+#include "bsp_relay.h"
+#include "bsp_txq.h"
+#include "bsp_txpwr.h"
+#include "bsp_rxduty.h"
+#include "bsp_bulk.h"
+
+//位带操作,实现51类似的GPIO控制功能,IO口操作宏定义
 #define BITBAND(addr, bitnum)   ((addr & 0xF0000000)+0x2000000+((addr &0xFFFFF)<<5)+(bitnum<<2))
 #define MEM_ADDR(addr)          *((volatile unsigned long  *)(addr))
 #define BIT_ADDR(addr, bitnum)  MEM_ADDR(BITBAND(addr, bitnum))
-//IOڵַӳ
+//IO口地址映射
 #define GPIOA_ODR_Addr    (GPIOA_BASE+12) //0x4001080C 
 #define GPIOB_ODR_Addr    (GPIOB_BASE+12) //0x40010C0C 
 #define GPIOC_ODR_Addr    (GPIOC_BASE+12) //0x4001100C 
@@ -77,28 +90,28 @@
 #define GPIOF_IDR_Addr    (GPIOF_BASE+8) //0x40011A08 
 #define GPIOG_IDR_Addr    (GPIOG_BASE+8) //0x40011E08 
 
-//IOڲ,ֻԵһIO!
-//ȷnֵС16!
-#define PAout(n)   BIT_ADDR(GPIOA_ODR_Addr,n)  // 
-#define PAin(n)    BIT_ADDR(GPIOA_IDR_Addr,n)  // 
+//IO口操作,只对单一的IO口!
+//确保n的值小于16!
+#define PAout(n)   BIT_ADDR(GPIOA_ODR_Addr,n)  //输出 
+#define PAin(n)    BIT_ADDR(GPIOA_IDR_Addr,n)  //输入 
 
-#define PBout(n)   BIT_ADDR(GPIOB_ODR_Addr,n)  // 
-#define PBin(n)    BIT_ADDR(GPIOB_IDR_Addr,n)  // 
+#define PBout(n)   BIT_ADDR(GPIOB_ODR_Addr,n)  //输出 
+#define PBin(n)    BIT_ADDR(GPIOB_IDR_Addr,n)  //输入 
 
-#define PCout(n)   BIT_ADDR(GPIOC_ODR_Addr,n)  // 
-#define PCin(n)    BIT_ADDR(GPIOC_IDR_Addr,n)  // 
+#define PCout(n)   BIT_ADDR(GPIOC_ODR_Addr,n)  //输出 
+#define PCin(n)    BIT_ADDR(GPIOC_IDR_Addr,n)  //输入 
 
-#define PDout(n)   BIT_ADDR(GPIOD_ODR_Addr,n)  // 
-#define PDin(n)    BIT_ADDR(GPIOD_IDR_Addr,n)  // 
+#define PDout(n)   BIT_ADDR(GPIOD_ODR_Addr,n)  //输出 
+#define PDin(n)    BIT_ADDR(GPIOD_IDR_Addr,n)  //输入 
 
-#define PEout(n)   BIT_ADDR(GPIOE_ODR_Addr,n)  // 
-#define PEin(n)    BIT_ADDR(GPIOE_IDR_Addr,n)  //
+#define PEout(n)   BIT_ADDR(GPIOE_ODR_Addr,n)  //输出 
+#define PEin(n)    BIT_ADDR(GPIOE_IDR_Addr,n)  //输入
 
-#define PFout(n)   BIT_ADDR(GPIOF_ODR_Addr,n)  // 
-#define PFin(n)    BIT_ADDR(GPIOF_IDR_Addr,n)  //
+#define PFout(n)   BIT_ADDR(GPIOF_ODR_Addr,n)  //输出 
+#define PFin(n)    BIT_ADDR(GPIOF_IDR_Addr,n)  //输入
 
-#define PGout(n)   BIT_ADDR(GPIOG_ODR_Addr,n)  // 
-#define PGin(n)    BIT_ADDR(GPIOG_IDR_Addr,n)  //
+#define PGout(n)   BIT_ADDR(GPIOG_ODR_Addr,n)  //输出 
+#define PGin(n)    BIT_ADDR(GPIOG_IDR_Addr,n)  //输入
 
 #ifndef SUCCESS
 #define SUCCESS 1
@@ -116,11 +129,11 @@
 #define FALSE 0
 #endif
 
-/* ṩCļõĺ */
+/* 提供给其他C文件调用的函数 */
 void bsp_Init(void);
 void bsp_Idle(void);
 void bsp_RunPer1ms(void);
 void bsp_RunPer10ms(void);
 #endif
 
-/*****************************  www.armfly.com (END OF FILE) *********************************/
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
@@ -8,8 +8,8 @@ void Init_AD5933(void)
     int i, j, k;
     //---this paramter is very important, it decides the collect rate. format: Freq / 1024
     AD5933_Set_Freq_Start(20000);//100Khz, 100K/1024 = 100Hz, data update rate is 100Hz!!!!!!
-    AD5933_Set_Freq_Add(100);//ƵΪ1
-    AD5933_Set_Freq_Num(500);//ҲɨеƵʵ
+    AD5933_Set_Freq_Add(100);//设置频率增量为1
+    AD5933_Set_Freq_Num(500);//设置增量数，也就是扫描中的频率点数
 
     AD5933_Set_Mode( AD5933_Standby, AD5933_OUTPUT_2V, AD5933_Gain_1, AD5933_IN_MCLK, AD5933_NReset );
     AD5933_Set_Mode_Rst();
@@ -30,10 +30,10 @@ void Fre_To_Hex(float fre, u8 *buf)
     buf[2] = dat;
 }
 /*********************************************************************************************************
-*: AD5933_Set_Freq_Start
-*˵:828384ʼƵ
-*β:
-*ֵ: 
+*函数名: AD5933_Set_Freq_Start
+*功能说明:82、83、84设置起始频率
+*形参:
+*返回值: 
 **********************************************************************************************************/
 void AD5933_Set_Freq_Start( unsigned int freq )//
 {
@@ -44,12 +44,12 @@ void AD5933_Set_Freq_Start( unsigned int freq )//
     I2C_EE_ByteWrite( 0x84, buf[2]);
 }
 /*********************************************************************************************************
-*: AD5933_Set_Freq_Add
-*˵:Ƶ
-*β:
-*ֵ: 
+*函数名: AD5933_Set_Freq_Add
+*功能说明:设置频率增量
+*形参:
+*返回值: 
 **********************************************************************************************************/
-void AD5933_Set_Freq_Add( unsigned int afreq )//85,86,87Ƶ
+void AD5933_Set_Freq_Add( unsigned int afreq )//85,86,87设置频率增量
 {
     unsigned char buf[3];
 
@@ -59,12 +59,12 @@ void AD5933_Set_Freq_Add( unsigned int afreq )//85,86,87
     I2C_EE_ByteWrite( 0x87, buf[2]);
 }
 /*********************************************************************************************************
-*: AD5933_Set_Freq_Num
-*˵:
-*β:
-*ֵ: 
+*函数名: AD5933_Set_Freq_Num
+*功能说明:设置增量数
+*形参:
+*返回值: 
 **********************************************************************************************************/
-void AD5933_Set_Freq_Num( unsigned int num )//88,89
+void AD5933_Set_Freq_Num( unsigned int num )//88,89设置增量数
 {
     unsigned char buf[2];
     buf[0] = num >> 8 ;
@@ -73,28 +73,28 @@ void AD5933_Set_Freq_Num( unsigned int num )//88,89
     I2C_EE_ByteWrite( 0x89, buf[1]);
 }
 /*********************************************************************************************************
-*: AD5933_Set_Mode
-*˵:ùģʽѹPGA棬ʱѡ񼰸λ
-*β:
-*ֵ: 
+*函数名: AD5933_Set_Mode
+*功能说明:设置工作模式，输出激励电压，PGA增益，时钟选择及复位等
+*形参:
+*返回值: 
 **********************************************************************************************************/
-void AD5933_Set_Mode( unsigned int ctrl, unsigned int out, unsigned int gain, unsigned int clk, unsigned int rst )//80,81ƼĴ
+void AD5933_Set_Mode( unsigned int ctrl, unsigned int out, unsigned int gain, unsigned int clk, unsigned int rst )//80,81控制寄存器
 {
     iMode = ctrl | out | gain | clk | rst;
     I2C_EE_ByteWrite( 0x80, iMode >> 8 );
     I2C_EE_ByteWrite( 0x81, iMode      );
 }
 
-void AD5933_Set_Mode_Rst(void)//λD4λǸλλ
+void AD5933_Set_Mode_Rst(void)//复位操作，D4位是复位控制位
 {
     iMode  = ( iMode & 0xffef) | AD5933_Reset;
     I2C_EE_ByteWrite( 0x81, iMode      );
 }
 /*********************************************************************************************************
-*: AD5933_Set_Mode_Standby
-*˵:ùģʽʼ//Ƶ/ظƵ//ʡ/
-*β:
-*ֵ: 
+*函数名: AD5933_Set_Mode_Standby
+*功能说明:设置工作模式，初始化/启动/递增频率/重复频率/测温/省电/待机
+*形参:
+*返回值: 
 **********************************************************************************************************/
 void AD5933_Set_Mode_Standby(void)
 {
@@ -132,10 +132,10 @@ void AD5933_Set_Mode_Freq_Temp(void)
     I2C_EE_ByteWrite( 0x80, iMode >> 8  );
 }
 /*********************************************************************************************************
-*: AD5933_Get_DFT_ST
-*˵:ȡ״̬¶ȲЧ/ʵֵֵЧ/Ƶɨ
-*β:
-*ֵ: 
+*函数名: AD5933_Get_DFT_ST
+*功能说明:读取状态，温度测量有效/实值和虚值有效/频率扫描完成
+*形参:
+*返回值: 
 **********************************************************************************************************/
 unsigned char  AD5933_Get_DFT_ST(void)
 {
@@ -144,10 +144,10 @@ unsigned char  AD5933_Get_DFT_ST(void)
     return temp;
 }
 /*********************************************************************************************************
-*: AD5933_Get_Real
-*˵:ȡʵ
-*β:
-*ֵ: 
+*函数名: AD5933_Get_Real
+*功能说明:读取实部
+*形参:
+*返回值: 
 **********************************************************************************************************/
 unsigned int AD5933_Get_Real(void)
 {
@@ -160,10 +160,10 @@ unsigned int AD5933_Get_Real(void)
     return real;
 }
 /*********************************************************************************************************
-*: AD5933_Get_Img
-*˵:ȡ鲿
-*β:
-*ֵ: 
+*函数名: AD5933_Get_Img
+*功能说明:读取虚部
+*形参:
+*返回值: 
 **********************************************************************************************************/
 unsigned int AD5933_Get_Img(void)
 {
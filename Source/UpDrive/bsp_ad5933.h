@@ -13,11 +13,11 @@
 #define AD5933_OUTPUT_400mV			    (2)<<9
 #define AD5933_OUTPUT_200mV			    (1)<<9
 
-#define AD5933_Gain_1					(1)<<8//
+#define AD5933_Gain_1					(1)<<8//增益
 #define AD5933_Gain_5				  	(0)<<8
 
-#define AD5933_IN_MCLK					(0)<<3//ڲʱ
-#define AD5933_OUT_MCLK					(1)<<3//ⲿʱ
+#define AD5933_IN_MCLK					(0)<<3//内部时钟
+#define AD5933_OUT_MCLK					(1)<<3//外部时钟
 
 #define AD5933_Reset			  		(1)<<4
 #define AD5933_NReset				    (0)<<4
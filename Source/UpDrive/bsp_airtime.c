@@ -0,0 +1,159 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 空中时间记录与占空比预算
+*   文件名称 : bsp_airtime.c
+*   版    本 : V1.0
+*   说    明 : 每次发射后按实测的TxDone时间记账，按子频段统计最近 AIR_WINDOW_MIN 分钟的累计发射时间。
+*             窗口分为每分钟一个桶，桶过期时从合计中扣除，查询和记账都是常数时间。
+*             发送前调用 AIR_CanSend 询问能否发送，不能时推迟到下一超帧，用满法规允许的占空比，
+*             不需要按最坏情况限制发送速率。
+*             系统运行时间回绕时不清除记录，只会使预算偏保守。
+*
+*********************************************************************************************************
+*/
+#include "bsp.h"
+
+static const AIR_BAND_T s_tBand[] =
+{
+    { 433050, 434790, 100 },        /* 433.05~434.79MHz，10% */
+    { 0, 0xFFFFFFFF, 10 },          /* 其他频率按1%处理 */
+};
+#define AIR_BAND_NUM    (sizeof(s_tBand) / sizeof(s_tBand[0]))
+
+typedef struct
+{
+    uint32_t bucket[AIR_WINDOW_MIN];    /* 每分钟的发射时间，单位us */
+    uint32_t total;                     /* 窗口内合计 */
+} AIR_LEDGER_T;
+
+static AIR_LEDGER_T s_tLedger[AIR_BAND_NUM];
+static uint8_t s_ucBand;                /* 当前频率所在子频段 */
+static uint32_t s_uiCurMin;             /* 当前桶对应的运行分钟数 */
+
+uint16_t g_usAirDefer = 0;              /* 因占空比预算不足而推迟的发送次数，由调用者累加 */
+
+/*
+*********************************************************************************************************
+*   函 数 名: AIR_Advance
+*   功能说明: 按当前运行时间让过期的桶出窗口
+*   形    参: 无
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+static void AIR_Advance(void)
+{
+    uint32_t now = (uint32_t)bsp_GetRunTime() / AIR_BUCKET_MS;
+    uint8_t i;
+    AIR_LEDGER_T *p;
+
+    if (now < s_uiCurMin)       /* 运行时间回绕 */
+    {
+        s_uiCurMin = now;
+        return;
+    }
+    for (i = 0; (s_uiCurMin < now) && (i < AIR_WINDOW_MIN); i++)
+    {
+        s_uiCurMin++;
+        for (p = s_tLedger; p < &s_tLedger[AIR_BAND_NUM]; p++)
+        {
+            p->total -= p->bucket[s_uiCurMin % AIR_WINDOW_MIN];
+            p->bucket[s_uiCurMin % AIR_WINDOW_MIN] = 0;
+        }
+    }
+    s_uiCurMin = now;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: AIR_Init
+*   功能说明: 清除记录，并按工作频率选择子频段
+*   形    参: _freq_khz : 工作频率，单位KHz
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void AIR_Init(uint32_t _freq_khz)
+{
+    uint8_t i;
+
+    mem_set((char *)s_tLedger, 0, sizeof(s_tLedger));
+    for (i = 0; i < AIR_BAND_NUM - 1; i++)
+    {
+        if ((_freq_khz >= s_tBand[i].lo_khz) && (_freq_khz <= s_tBand[i].hi_khz))
+        {
+            break;
+        }
+    }
+    s_ucBand = i;
+    s_uiCurMin = (uint32_t)bsp_GetRunTime() / AIR_BUCKET_MS;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: AIR_Record
+*   功能说明: 记入一次发射的实际时间
+*   形    参: _us : 发射时间，单位us
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void AIR_Record(uint32_t _us)
+{
+    AIR_LEDGER_T *p = &s_tLedger[s_ucBand];
+
+    AIR_Advance();
+    p->bucket[s_uiCurMin % AIR_WINDOW_MIN] += _us;
+    p->total += _us;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: AIR_BudgetUs
+*   功能说明: 当前子频段在一个窗口内允许的发射时间
+*   形    参: 无
+*   返 回 值: 单位us
+*********************************************************************************************************
+*/
+uint32_t AIR_BudgetUs(void)
+{
+    return (uint32_t)AIR_WINDOW_MIN * AIR_BUCKET_MS * s_tBand[s_ucBand].duty_permille;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: AIR_UsedUs
+*   功能说明: 当前子频段最近一个窗口内已用的发射时间
+*   形    参: 无
+*   返 回 值: 单位us
+*********************************************************************************************************
+*/
+uint32_t AIR_UsedUs(void)
+{
+    AIR_Advance();
+    return s_tLedger[s_ucBand].total;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: AIR_CanSend
+*   功能说明: 询问现在发送 _len 字节是否仍在占空比预算之内
+*   形    参: _len : 负载字节数
+*   返 回 值: 1 可以发送，0 应推迟
+*********************************************************************************************************
+*/
+uint8_t AIR_CanSend(uint8_t _len)
+{
+    return AIR_CanSendUs(RFM96_LoRaAirtimeUs(_len));
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: AIR_CanSendUs
+*   功能说明: 询问现在发射 _us 是否仍在占空比预算之内，用于空中时间不按LoRa计算的FSK数据包
+*   形    参: _us : 发射时间，单位us
+*   返 回 值: 1 可以发送，0 应推迟
+*********************************************************************************************************
+*/
+uint8_t AIR_CanSendUs(uint32_t _us)
+{
+    return (AIR_UsedUs() + _us <= AIR_BudgetUs()) ? 1 : 0;
+}
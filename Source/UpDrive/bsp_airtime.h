@@ -0,0 +1,36 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 空中时间记录与占空比预算
+*   文件名称 : bsp_airtime.h
+*   版    本 : V1.0
+*   说    明 : 头文件
+*
+*********************************************************************************************************
+*/
+#ifndef __BSP_AIRTIME_H
+#define __BSP_AIRTIME_H
+
+#include "stdint.h"
+
+#define AIR_WINDOW_MIN      60          /* 滑动窗口长度，单位分钟(ETSI EN 300 220 按1小时统计占空比) */
+#define AIR_BUCKET_MS       60000       /* 每个统计桶的时长 */
+
+/* 子频段：频率范围和占空比上限(千分比)，按顺序匹配，最后一项匹配其余所有频率 */
+typedef struct
+{
+    uint32_t lo_khz;
+    uint32_t hi_khz;
+    uint16_t duty_permille;
+} AIR_BAND_T;
+
+void AIR_Init(uint32_t _freq_khz);
+void AIR_Record(uint32_t _us);
+uint8_t AIR_CanSend(uint8_t _len);
+uint8_t AIR_CanSendUs(uint32_t _us);
+uint32_t AIR_UsedUs(void);
+uint32_t AIR_BudgetUs(void);
+
+extern uint16_t g_usAirDefer;
+
+#endif
@@ -0,0 +1,100 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : BLE帧解析模块
+*   文件名称 : bsp_bleframe.c
+*   版    本 : V1.0
+*   说    明 : 心率帧的逐字节解析状态机，帧格式见 bsp_bleframe.h。
+*             不依赖任何外设，可以直接在PC上编译。
+*
+*********************************************************************************************************
+*/
+#include "bsp_bleframe.h"
+
+#define BLE_TYPE_OK(_c)     (((_c) == 'P') || ((_c) == 'H'))
+
+/* 已缓存字节构成的帧头不对：丢弃第一个字节，从下一个 '$' 开始重新检查 */
+static void ble_Resync(BLE_PARSER_T *_pParser)
+{
+    uint8_t i, n;
+
+    while (_pParser->len > 0)
+    {
+        for (n = 1; (n < _pParser->len) && (_pParser->buf[n] != BLE_FRAME_HEAD); n++)
+        {
+        }
+        _pParser->ulDrop += n;
+        _pParser->len -= n;
+        for (i = 0; i < _pParser->len; i++)
+        {
+            _pParser->buf[i] = _pParser->buf[n + i];
+        }
+        if ((_pParser->len < 2) || BLE_TYPE_OK(_pParser->buf[1]))
+        {
+            return;     /* 剩余字节最多4个，只需检查类型 */
+        }
+    }
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: BLE_ParserInit
+*   功能说明: 初始化解析器，丢弃未完成的帧，统计清零
+*   形    参: _pParser : 解析器
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void BLE_ParserInit(BLE_PARSER_T *_pParser)
+{
+    _pParser->len = 0;
+    _pParser->ulFrames = 0;
+    _pParser->ulDrop = 0;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: BLE_ParseByte
+*   功能说明: 输入1个字节。帧尾到达且帧头、类型正确时输出一帧
+*   形    参: _pParser : 解析器
+*             _ucByte : 收到的字节
+*             _pFrame : 输出的帧，返回1时有效
+*   返 回 值: 1 收到完整的一帧，0 没有
+*********************************************************************************************************
+*/
+uint8_t BLE_ParseByte(BLE_PARSER_T *_pParser, uint8_t _ucByte, BLE_FRAME_T *_pFrame)
+{
+    if (_pParser->len == 0)
+    {
+        if (_ucByte != BLE_FRAME_HEAD)
+        {
+            _pParser->ulDrop++;
+            return 0;
+        }
+        _pParser->buf[0] = _ucByte;
+        _pParser->len = 1;
+        return 0;
+    }
+
+    _pParser->buf[_pParser->len++] = _ucByte;
+    if (_pParser->len == 2)
+    {
+        if (!BLE_TYPE_OK(_ucByte))
+        {
+            ble_Resync(_pParser);
+        }
+    }
+    else if (_pParser->len == BLE_FRAME_LEN)
+    {
+        if (_ucByte == BLE_FRAME_TAIL)
+        {
+            _pFrame->type = _pParser->buf[1];
+            _pFrame->heart = _pParser->buf[2];
+            _pFrame->battery = _pParser->buf[3];
+            _pParser->len = 0;
+            _pParser->ulFrames++;
+            return 1;
+        }
+        ble_Resync(_pParser);
+    }
+    return 0;
+}
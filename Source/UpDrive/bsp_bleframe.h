@@ -0,0 +1,44 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : BLE帧解析模块
+*   文件名称 : bsp_bleframe.h
+*   版    本 : V1.0
+*   说    明 : 头文件。CC2541 通过串口1发来的心率帧：
+*     '$' 类型 心率 心率带电量 '#'
+*   类型为 'P' 或 'H'，心率和电量是二进制字节，可能等于 '$' 或 '#'。
+*
+*   解析器逐字节输入，不依赖字节之间的空闲间隔：收到 '#' 时立即输出一帧，连续到达的多帧逐个输出。
+*   帧头或帧尾不对时丢弃第一个字节，从已缓存字节中的下一个 '$' 重新开始，因此垃圾数据中间
+*   或半帧之后紧跟的完整帧不会丢失。
+*
+*********************************************************************************************************
+*/
+#ifndef __BSP_BLEFRAME_H
+#define __BSP_BLEFRAME_H
+
+#include "stdint.h"
+
+#define BLE_FRAME_LEN       5       /* '$' 类型 心率 电量 '#' */
+#define BLE_FRAME_HEAD      '$'
+#define BLE_FRAME_TAIL      '#'
+
+typedef struct
+{
+    uint8_t type;                   /* 'P' 或 'H' */
+    uint8_t heart;                  /* 心率 */
+    uint8_t battery;                /* 心率带电池电量 */
+} BLE_FRAME_T;
+
+typedef struct
+{
+    uint8_t buf[BLE_FRAME_LEN];     /* 当前帧已收到的字节，buf[0] 总是 '$' */
+    uint8_t len;
+    uint32_t ulFrames;              /* 输出的帧数 */
+    uint32_t ulDrop;                /* 丢弃的字节数 */
+} BLE_PARSER_T;
+
+void BLE_ParserInit(BLE_PARSER_T *_pParser);
+uint8_t BLE_ParseByte(BLE_PARSER_T *_pParser, uint8_t _ucByte, BLE_FRAME_T *_pFrame);
+
+#endif
@@ -0,0 +1,180 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : FSK批量传输
+*   文件名称 : bsp_bulk.c
+*   版    本 : V1.0
+*   说    明 : 积压数据缓冲区，以及主机分配的窗口内的FSK连续发送。请求和数据包格式见 bsp_bulk.h。
+*             写入和发送都在任务中进行，不需要关中断。
+*
+*********************************************************************************************************
+*/
+#include "bsp.h"
+
+static uint8_t s_ucBuf[BULK_BUF_SIZE];
+static uint16_t s_usHead;           /* 最早一个字节的位置 */
+static uint16_t s_usCount;
+static uint8_t s_ucSeq;             /* FSK数据包序号 */
+
+uint16_t g_usBulkDrop = 0;          /* 缓冲区满而丢弃的字节数 */
+
+/*
+*********************************************************************************************************
+*   函 数 名: BULK_Init
+*   功能说明: 清空积压数据缓冲区
+*   形    参: 无
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void BULK_Init(void)
+{
+    s_usHead = 0;
+    s_usCount = 0;
+    s_ucSeq = 0;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: BULK_Write
+*   功能说明: 把数据追加到积压数据缓冲区，放不下的部分丢弃
+*   形    参: _pBuf : 数据
+*             _len : 数据长度
+*   返 回 值: 实际写入的字节数
+*********************************************************************************************************
+*/
+uint16_t BULK_Write(const uint8_t *_pBuf, uint16_t _len)
+{
+    uint16_t i;
+
+    if (_len > BULK_BUF_SIZE - s_usCount)
+    {
+        g_usBulkDrop += _len - (BULK_BUF_SIZE - s_usCount);
+        _len = BULK_BUF_SIZE - s_usCount;
+    }
+    for (i = 0; i < _len; i++)
+    {
+        s_ucBuf[(s_usHead + s_usCount + i) % BULK_BUF_SIZE] = _pBuf[i];
+    }
+    s_usCount += _len;
+    return _len;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: BULK_Pending
+*   功能说明: 积压数据的字节数
+*   形    参: 无
+*   返 回 值: 字节数
+*********************************************************************************************************
+*/
+uint16_t BULK_Pending(void)
+{
+    return s_usCount;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: BULK_Read
+*   功能说明: 从积压数据缓冲区取出最早的数据，用于按分片报文在LoRa时隙中发送
+*   形    参: _pOut : 输出缓冲区
+*             _max : 最多取出的字节数
+*   返 回 值: 取出的字节数
+*********************************************************************************************************
+*/
+uint16_t BULK_Read(uint8_t *_pOut, uint16_t _max)
+{
+    uint16_t i;
+
+    if (_max > s_usCount)
+    {
+        _max = s_usCount;
+    }
+    for (i = 0; i < _max; i++)
+    {
+        _pOut[i] = s_ucBuf[(s_usHead + i) % BULK_BUF_SIZE];
+    }
+    s_usHead = (s_usHead + _max) % BULK_BUF_SIZE;
+    s_usCount -= _max;
+    return _max;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: BULK_BuildRequest
+*   功能说明: 生成批量传输请求 'b' devID len_lo len_hi '%'，devID 在打包时填入
+*   形    参: _pOut : 输出缓冲区，至少 BULK_REQ_LEN 字节
+*   返 回 值: 请求长度，没有积压数据时返回0
+*********************************************************************************************************
+*/
+uint8_t BULK_BuildRequest(uint8_t *_pOut)
+{
+    if (s_usCount == 0)
+    {
+        return 0;
+    }
+    _pOut[0] = 'b';
+    _pOut[1] = 0;
+    _pOut[2] = (uint8_t)s_usCount;
+    _pOut[3] = (uint8_t)(s_usCount >> 8);
+    _pOut[4] = '%';
+    return BULK_REQ_LEN;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: BULK_Run
+*   功能说明: 在批量传输窗口内切换到FSK模式，连续发送积压数据直到发完、窗口不够再发一包或占空比预算用完，
+*             然后回到LoRa模式。在任务中阻塞执行，窗口期间不处理其他任务，等待发射完成时CPU休眠。
+*             发射失败时停止，未发出的数据留到下一个窗口
+*   形    参: _dur : 窗口长度，单位ms
+*             _rate : FSK速率档位 RF_FSK_xxx
+*             _devid : 本节点devID
+*   返 回 值: 发出的数据字节数(不含包头)
+*********************************************************************************************************
+*/
+uint16_t BULK_Run(uint16_t _dur, uint8_t _rate, uint8_t _devid)
+{
+    uint8_t pkt[BULK_PKT_MAX];
+    int32_t start = bsp_GetRunTime();
+    uint16_t sent = 0, i;
+    uint32_t air;
+    uint8_t n;
+
+    if (_dur <= BULK_GUARD_MS)
+    {
+        return 0;
+    }
+    _dur -= BULK_GUARD_MS;
+    RFFskBegin(_rate);
+    while (s_usCount > 0)
+    {
+        n = (s_usCount < BULK_PKT_MAX - BULK_HDR_LEN) ? s_usCount : BULK_PKT_MAX - BULK_HDR_LEN;
+        air = RFM96_FskAirtimeUs(BULK_HDR_LEN + n);
+        if (bsp_CheckRunTime(start) + air / 1000 + 1 > _dur)
+        {
+            break;
+        }
+        if (AIR_CanSendUs(air) == 0)    /* 占空比预算用完，结束窗口 */
+        {
+            g_usAirDefer++;
+            break;
+        }
+        pkt[0] = 'B';
+        pkt[1] = _devid;
+        pkt[2] = s_ucSeq;
+        for (i = 0; i < n; i++)
+        {
+            pkt[BULK_HDR_LEN + i] = s_ucBuf[(s_usHead + i) % BULK_BUF_SIZE];
+        }
+        if (RFFskSend(pkt, BULK_HDR_LEN + n) == 0)
+        {
+            break;
+        }
+        s_ucSeq++;
+        s_usHead = (s_usHead + n) % BULK_BUF_SIZE;
+        s_usCount -= n;
+        sent += n;
+    }
+    RFFskEnd();
+    return sent;
+}
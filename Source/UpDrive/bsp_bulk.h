@@ -0,0 +1,39 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : FSK批量传输
+*   文件名称 : bsp_bulk.h
+*   版    本 : V1.0
+*   说    明 : 头文件
+*
+*   大量数据(如阻抗扫描结果)不适合用LoRa时隙逐帧上传。节点有积压数据时随遥测帧上报请求：
+*     'b' devID len_lo len_hi '%'      len 为积压的字节数
+*   主机在广播包中为该节点分配批量传输窗口(格式见 bsp_join.h)，节点在窗口内切换到FSK模式连续发送：
+*     'B' devID seq 数据 ...           seq 每包加1，主机据此发现丢包
+*   窗口结束回到LoRa模式。发送成功即从缓冲区删除，不等主机应答。
+*   积压数据先按分片报文(bsp_frag.c)在本节点的LoRa时隙中发送，一个分片报文还没发完又有新的积压数据时
+*   才申请FSK窗口。两条路径各自携带一段数据，主机不保证两者之间的先后顺序。
+*
+*********************************************************************************************************
+*/
+#ifndef __BSP_BULK_H
+#define __BSP_BULK_H
+
+#include "stdint.h"
+
+#define BULK_BUF_SIZE       1024    /* 积压数据缓冲区大小 */
+#define BULK_PKT_MAX        200     /* 每个FSK数据包最大长度，含3字节包头 */
+#define BULK_HDR_LEN        3       /* 'B' devID seq */
+#define BULK_REQ_LEN        5       /* 批量传输请求长度 */
+#define BULK_GUARD_MS       6       /* 窗口末尾留给回到LoRa模式(复位并配置芯片)的时间 */
+
+void BULK_Init(void);
+uint16_t BULK_Write(const uint8_t *_pBuf, uint16_t _len);
+uint16_t BULK_Pending(void);
+uint16_t BULK_Read(uint8_t *_pOut, uint16_t _max);
+uint8_t BULK_BuildRequest(uint8_t *_pOut);
+uint16_t BULK_Run(uint16_t _dur, uint8_t _rate, uint8_t _devid);
+
+extern uint16_t g_usBulkDrop;
+
+#endif
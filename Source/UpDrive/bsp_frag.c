@@ -0,0 +1,297 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 分片与重组模块
+*   文件名称 : bsp_frag.c
+*   版    本 : V1.0
+*   说    明 : 超过一个无线帧的报文按分片发送，主机按位图确认，从机只重发缺少的分片。帧格式见 bsp_frag.h。
+*             不依赖任何外设，时间由调用者传入，可以直接在PC上编译。
+*
+*********************************************************************************************************
+*/
+#include "bsp_frag.h"
+
+#define BIT_GET(_map, _i)   (((_map)[(_i) >> 3] >> ((_i) & 7)) & 1u)
+#define BIT_SET(_map, _i)   ((_map)[(_i) >> 3] |= (uint8_t)(1u << ((_i) & 7)))
+
+uint16_t g_usFragAbort = 0;         /* 重发 FRAG_ROUND_MAX 轮仍未确认而放弃的报文数 */
+
+/* 前 _n 个分片是否都已置位 */
+static uint8_t frag_AllSet(const uint8_t *_pMap, uint8_t _n)
+{
+    uint8_t i;
+
+    for (i = 0; i < _n; i++)
+    {
+        if (BIT_GET(_pMap, i) == 0)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: FRAG_TxInit
+*   功能说明: 初始化发送端，没有待发送的报文
+*   形    参: _pTx : 发送端状态
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void FRAG_TxInit(FRAG_TX_T *_pTx)
+{
+    _pTx->len = 0;
+    _pTx->msg_id = 0;
+    _pTx->total = 0;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: FRAG_TxLoad
+*   功能说明: 装入一个待发送的报文，报文序号加1。上一个报文还没发完时不装入。
+*             只保存缓冲区指针，FRAG_TxBusy 返回0之前调用者不能修改报文
+*   形    参: _pTx : 发送端状态
+*             _pBuf : 报文
+*             _len : 报文长度，超过 FRAG_MSG_MAX 的部分不发送
+*   返 回 值: 装入的字节数，0 表示发送端忙
+*********************************************************************************************************
+*/
+uint16_t FRAG_TxLoad(FRAG_TX_T *_pTx, const uint8_t *_pBuf, uint16_t _len)
+{
+    uint8_t i;
+
+    if ((_pTx->len != 0) || (_len == 0))
+    {
+        return 0;
+    }
+    if (_len > FRAG_MSG_MAX)
+    {
+        _len = FRAG_MSG_MAX;
+    }
+    for (i = 0; i < FRAG_BITMAP_LEN; i++)
+    {
+        _pTx->acked[i] = 0;
+        _pTx->sent[i] = 0;
+    }
+    _pTx->buf = _pBuf;
+    _pTx->len = _len;
+    _pTx->msg_id++;
+    _pTx->total = (uint8_t)((_len + FRAG_DATA_MAX - 1) / FRAG_DATA_MAX);
+    _pTx->round = 0;
+    return _len;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: FRAG_TxBusy
+*   功能说明: 是否有报文正在发送
+*   形    参: _pTx : 发送端状态
+*   返 回 值: 1 有，0 空闲
+*********************************************************************************************************
+*/
+uint8_t FRAG_TxBusy(const FRAG_TX_T *_pTx)
+{
+    return (_pTx->len != 0) ? 1 : 0;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: FRAG_TxBuild
+*   功能说明: 生成下一个分片帧：本轮未发送且未确认的序号最小的分片。一轮发完后从头重发未确认的分片，
+*             超过 FRAG_ROUND_MAX 轮放弃该报文
+*   形    参: _pTx : 发送端状态
+*             _pOut : 输出缓冲区，至少 FRAG_FRAME_MAX 字节
+*             _devid : 本节点devID
+*   返 回 值: 分片帧长度，没有需要发送的分片时返回0
+*********************************************************************************************************
+*/
+uint8_t FRAG_TxBuild(FRAG_TX_T *_pTx, uint8_t *_pOut, uint8_t _devid)
+{
+    uint8_t idx, n, i;
+    uint16_t pos;
+
+    if (_pTx->len == 0)
+    {
+        return 0;
+    }
+    if (frag_AllSet(_pTx->sent, _pTx->total))
+    {
+        if (++_pTx->round >= FRAG_ROUND_MAX)
+        {
+            _pTx->len = 0;
+            g_usFragAbort++;
+            return 0;
+        }
+        for (i = 0; i < FRAG_BITMAP_LEN; i++)
+        {
+            _pTx->sent[i] = _pTx->acked[i];
+        }
+    }
+    for (idx = 0; idx < _pTx->total; idx++)
+    {
+        if (BIT_GET(_pTx->sent, idx) == 0)
+        {
+            break;
+        }
+    }
+    pos = (uint16_t)idx * FRAG_DATA_MAX;
+    n = (_pTx->len - pos > FRAG_DATA_MAX) ? FRAG_DATA_MAX : (uint8_t)(_pTx->len - pos);
+    _pOut[0] = 'F';
+    _pOut[1] = _devid;
+    _pOut[2] = _pTx->msg_id;
+    _pOut[3] = idx;
+    _pOut[4] = _pTx->total;
+    for (i = 0; i < n; i++)
+    {
+        _pOut[FRAG_HDR_LEN + i] = _pTx->buf[pos + i];
+    }
+    _pOut[FRAG_HDR_LEN + n] = '%';
+    BIT_SET(_pTx->sent, idx);
+    return FRAG_HDR_LEN + n + 1;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: FRAG_TxAck
+*   功能说明: 处理主机广播包中的确认位图。全部确认时报文发送完成；否则从缺少的分片开始新的一轮
+*   形    参: _pTx : 发送端状态
+*             _msg_id : 位图对应的报文序号，与当前报文不同时忽略
+*             _pBitmap : 已收到分片的位图，FRAG_BITMAP_LEN 字节，bit i 对应分片 i
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void FRAG_TxAck(FRAG_TX_T *_pTx, uint8_t _msg_id, const uint8_t *_pBitmap)
+{
+    uint8_t i;
+
+    if ((_pTx->len == 0) || (_msg_id != _pTx->msg_id))
+    {
+        return;
+    }
+    for (i = 0; i < FRAG_BITMAP_LEN; i++)
+    {
+        _pTx->acked[i] |= _pBitmap[i];
+        _pTx->sent[i] = _pTx->acked[i];
+    }
+    _pTx->round = 0;
+    if (frag_AllSet(_pTx->acked, _pTx->total))
+    {
+        _pTx->len = 0;
+    }
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: FRAG_RxInit
+*   功能说明: 初始化重组端
+*   形    参: _pRx : 重组端状态
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void FRAG_RxInit(FRAG_RX_T *_pRx)
+{
+    uint8_t i;
+
+    _pRx->len = 0;
+    _pRx->total = 0;
+    _pRx->done = 0;
+    for (i = 0; i < FRAG_BITMAP_LEN; i++)
+    {
+        _pRx->got[i] = 0;
+    }
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: FRAG_RxPut
+*   功能说明: 放入收到的分片帧。devID或报文序号变化时丢弃未完成的报文，开始重组新报文
+*   形    参: _pRx : 重组端状态
+*             _pFrame : 分片帧
+*             _len : 分片帧长度
+*             _now : 当前时刻，单位ms
+*   返 回 值: 本分片使报文重组完成时返回报文长度(报文在 _pRx->buf 中)，否则返回0
+*********************************************************************************************************
+*/
+uint16_t FRAG_RxPut(FRAG_RX_T *_pRx, const uint8_t *_pFrame, uint8_t _len, uint32_t _now)
+{
+    uint8_t idx, total, n, i;
+    uint16_t pos;
+
+    if ((_len < FRAG_HDR_LEN + 2) || (_pFrame[0] != 'F') || (_pFrame[_len - 1] != '%'))
+    {
+        return 0;
+    }
+    idx = _pFrame[3];
+    total = _pFrame[4];
+    n = _len - FRAG_HDR_LEN - 1;
+    if ((total == 0) || (total > FRAG_NUM_MAX) || (idx >= total) || (n > FRAG_DATA_MAX)
+        || ((idx < total - 1) && (n != FRAG_DATA_MAX)))
+    {
+        return 0;
+    }
+    if ((_pRx->total != total) || (_pRx->devid != _pFrame[1]) || (_pRx->msg_id != _pFrame[2]))
+    {
+        FRAG_RxInit(_pRx);
+        _pRx->devid = _pFrame[1];
+        _pRx->msg_id = _pFrame[2];
+        _pRx->total = total;
+    }
+    _pRx->last_ms = _now;
+    if (_pRx->done || BIT_GET(_pRx->got, idx))
+    {
+        return 0; //重复分片：主机的确认没有送达，位图不变
+    }
+    pos = (uint16_t)idx * FRAG_DATA_MAX;
+    for (i = 0; i < n; i++)
+    {
+        _pRx->buf[pos + i] = _pFrame[FRAG_HDR_LEN + i];
+    }
+    BIT_SET(_pRx->got, idx);
+    if (idx == total - 1)
+    {
+        _pRx->len = pos + n;
+    }
+    if (frag_AllSet(_pRx->got, total))
+    {
+        _pRx->done = 1;
+        return _pRx->len;
+    }
+    return 0;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: FRAG_RxBitmap
+*   功能说明: 取已收到分片的位图，由主机放入下一个广播包
+*   形    参: _pRx : 重组端状态
+*             _pBitmap : 输出位图，FRAG_BITMAP_LEN 字节
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void FRAG_RxBitmap(const FRAG_RX_T *_pRx, uint8_t *_pBitmap)
+{
+    uint8_t i;
+
+    for (i = 0; i < FRAG_BITMAP_LEN; i++)
+    {
+        _pBitmap[i] = _pRx->got[i];
+    }
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: FRAG_RxExpire
+*   功能说明: 超过 FRAG_RX_TIMEOUT_MS 没有收到新分片时丢弃未完成的报文，释放重组缓冲区
+*   形    参: _pRx : 重组端状态
+*             _now : 当前时刻，单位ms
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void FRAG_RxExpire(FRAG_RX_T *_pRx, uint32_t _now)
+{
+    if ((_pRx->total != 0) && (_pRx->done == 0) && (_now - _pRx->last_ms > FRAG_RX_TIMEOUT_MS))
+    {
+        FRAG_RxInit(_pRx);
+    }
+}
@@ -0,0 +1,70 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 分片与重组模块
+*   文件名称 : bsp_frag.h
+*   版    本 : V1.0
+*   说    明 : 头文件。发送端在从机上运行，重组端供主机和PC端程序使用，两端共用同一份源码。
+*
+*   超过一个无线帧的数据(阻抗扫频结果、积压的历史数据)分成若干分片，每个时隙发送一片：
+*     'F' devID msg_id idx total 数据 ... '%'
+*   除最后一片外每片携带 FRAG_DATA_MAX 字节，重组端收到最后一片时得到报文长度。
+*   主机在广播包中回送本报文已收到分片的位图(格式见 bsp_join.h)，从机只重发位图中缺少的分片；
+*   没有收到位图时，从机发完一轮后从头重发未确认的分片，连续 FRAG_ROUND_MAX 轮仍未发完则放弃该报文。
+*   重组端超过 FRAG_RX_TIMEOUT_MS 没有收到新分片时丢弃未完成的报文。
+*
+*********************************************************************************************************
+*/
+#ifndef __BSP_FRAG_H
+#define __BSP_FRAG_H
+
+#include "stdint.h"
+
+#define FRAG_HDR_LEN        5       /* 'F' devID msg_id idx total */
+#define FRAG_FRAME_MAX      64      /* 分片帧最大长度，与发送缓冲区一致 */
+#define FRAG_DATA_MAX       (FRAG_FRAME_MAX - FRAG_HDR_LEN - 1)     /* 每片数据字节数 */
+#define FRAG_NUM_MAX        48      /* 每个报文最多的分片数 */
+#define FRAG_BITMAP_LEN     ((FRAG_NUM_MAX + 7) / 8)
+#define FRAG_MSG_MAX        (FRAG_NUM_MAX * FRAG_DATA_MAX)          /* 报文最大长度 */
+#define FRAG_ROUND_MAX      8       /* 没有确认时最多重发几轮 */
+#define FRAG_RX_TIMEOUT_MS  30000   /* 重组端等待下一片的最长时间 */
+
+/* 发送端状态 */
+typedef struct
+{
+    const uint8_t *buf;             /* 调用者的报文缓冲区，发送完成前不能修改 */
+    uint16_t len;                   /* 0: 空闲 */
+    uint8_t msg_id;                 /* 报文序号，每装入一个报文加1 */
+    uint8_t total;                  /* 分片数 */
+    uint8_t round;                  /* 已发送的轮数 */
+    uint8_t acked[FRAG_BITMAP_LEN]; /* 主机已确认的分片 */
+    uint8_t sent[FRAG_BITMAP_LEN];  /* 本轮已发送的分片 */
+} FRAG_TX_T;
+
+/* 重组端状态，主机为每个节点保存一份 */
+typedef struct
+{
+    uint8_t buf[FRAG_MSG_MAX];
+    uint16_t len;                   /* 收到最后一片后得到的报文长度，0: 尚未知道 */
+    uint8_t devid;
+    uint8_t msg_id;
+    uint8_t total;                  /* 0: 空闲 */
+    uint8_t done;                   /* 1: 报文已重组完成，重复分片只更新位图 */
+    uint8_t got[FRAG_BITMAP_LEN];   /* 已收到的分片 */
+    uint32_t last_ms;               /* 最近一次收到分片的时刻 */
+} FRAG_RX_T;
+
+void FRAG_TxInit(FRAG_TX_T *_pTx);
+uint16_t FRAG_TxLoad(FRAG_TX_T *_pTx, const uint8_t *_pBuf, uint16_t _len);
+uint8_t FRAG_TxBusy(const FRAG_TX_T *_pTx);
+uint8_t FRAG_TxBuild(FRAG_TX_T *_pTx, uint8_t *_pOut, uint8_t _devid);
+void FRAG_TxAck(FRAG_TX_T *_pTx, uint8_t _msg_id, const uint8_t *_pBitmap);
+
+void FRAG_RxInit(FRAG_RX_T *_pRx);
+uint16_t FRAG_RxPut(FRAG_RX_T *_pRx, const uint8_t *_pFrame, uint8_t _len, uint32_t _now);
+void FRAG_RxBitmap(const FRAG_RX_T *_pRx, uint8_t *_pBitmap);
+void FRAG_RxExpire(FRAG_RX_T *_pRx, uint32_t _now);
+
+extern uint16_t g_usFragAbort;
+
+#endif
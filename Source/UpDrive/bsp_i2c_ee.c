@@ -4,90 +4,90 @@
   * @author  STMicroelectronics
   * @version V1.0
   * @date    2013-xx-xx
-  * @brief   i2c EEPROM(AT24C02)Ӧúbsp
+  * @brief   i2c EEPROM(AT24C02)应用函数bsp
   */
 
 #include "bsp.h"
 
-/* STM32 I2C ģʽ */
+/* STM32 I2C 快速模式 */
 #define I2C_Speed              400000  //*
 
-/* ַֻҪSTM32ҵI2Cַһ */
+/* 这个地址只要与STM32外挂的I2C器件地址不一样即可 */
 #define I2Cx_OWN_ADDRESS7      0X7C   //
 //#define I2Cx_OWN_ADDRESS7      0X0A   //
 
-/* AT24C01/02ÿҳ8ֽ */
+/* AT24C01/02每页有8个字节 */
 #define I2C_PageSize           8
 
-/* AT24C04/08A/16Aÿҳ16ֽ */
+/* AT24C04/08A/16A每页有16个字节 */
 //#define I2C_PageSize           16
 
 uint16_t EEPROM_ADDRESS;
 
 
 /**
-  * @brief  I2C1 I/O
-  * @param  
-  * @retval 
+  * @brief  I2C1 I/O配置
+  * @param  无
+  * @retval 无
   */
 static void I2C_GPIO_Config(void)
 {
     GPIO_InitTypeDef  GPIO_InitStructure;
 
-    /* ʹ I2C1 йصʱ */
+    /* 使能与 I2C1 有关的时钟 */
     macI2C_APBxClock_FUN ( macI2C_CLK, ENABLE );
     macI2C_GPIO_APBxClock_FUN ( macI2C_GPIO_CLK, ENABLE );
 
 
-    /* PB6-I2C1_SCLPB7-I2C1_SDA*/
+    /* PB6-I2C1_SCL、PB7-I2C1_SDA*/
     GPIO_InitStructure.GPIO_Pin = macI2C_SCL_PIN;
     GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_OD;	       // ©
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_OD;	       // 开漏输出
     GPIO_Init(macI2C_SCL_PORT, &GPIO_InitStructure);
 
     GPIO_InitStructure.GPIO_Pin = macI2C_SDA_PIN;
     GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_OD;	       // ©
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_OD;	       // 开漏输出
     GPIO_Init(macI2C_SDA_PORT, &GPIO_InitStructure);
 }
 
 
 /**
-  * @brief  I2C ģʽ
-  * @param  
-  * @retval 
+  * @brief  I2C 工作模式配置
+  * @param  无
+  * @retval 无
   */
 static void I2C_Mode_Configu(void)
 {
     I2C_InitTypeDef  I2C_InitStructure;
 
-    /* I2C  */
+    /* I2C 配置 */
     I2C_InitStructure.I2C_Mode = I2C_Mode_I2C;
 
-    /* ߵƽȶ͵ƽݱ仯 SCL ʱߵռձ */
+    /* 高电平数据稳定，低电平数据变化 SCL 时钟线的占空比 */
     I2C_InitStructure.I2C_DutyCycle = I2C_DutyCycle_2;
 
     I2C_InitStructure.I2C_OwnAddress1 = I2Cx_OWN_ADDRESS7;
     I2C_InitStructure.I2C_Ack = I2C_Ack_Enable ;
 
-    /* I2CѰַģʽ */
+    /* I2C的寻址模式 */
     I2C_InitStructure.I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit;
 
-    /* ͨ */
+    /* 通信速率 */
     I2C_InitStructure.I2C_ClockSpeed = I2C_Speed;
 
-    /* I2C1 ʼ */
+    /* I2C1 初始化 */
     I2C_Init(macI2Cx, &I2C_InitStructure);
 
-    /* ʹ I2C1 */
+    /* 使能 I2C1 */
     I2C_Cmd(macI2Cx, ENABLE);
 }
 
 
 /**
-  * @brief  I2C (EEPROM)ʼ
-  * @param  
-  * @retval 
+  * @brief  I2C 外设(EEPROM)初始化
+  * @param  无
+  * @retval 无
   */
 void I2C_EE_Init(void)
 {
@@ -96,24 +96,24 @@ void I2C_EE_Init(void)
 
     I2C_Mode_Configu();
 
-    /* ͷļi2c_ee.hеĶѡEEPROMҪдĵַ */
+    /* 根据头文件i2c_ee.h中的定义来选择EEPROM要写入的地址 */
 #ifdef macEEPROM_Block0_ADDRESS
-/* ѡ EEPROM Block0 д */
+/* 选择 EEPROM Block0 来写入 */
     EEPROM_ADDRESS = macEEPROM_Block0_ADDRESS;
 #endif
 
 #ifdef macEEPROM_Block1_ADDRESS
-    /* ѡ EEPROM Block1 д */
+    /* 选择 EEPROM Block1 来写入 */
     EEPROM_ADDRESS = macEEPROM_Block1_ADDRESS;
 #endif
 
 #ifdef macEEPROM_Block2_ADDRESS
-    /* ѡ EEPROM Block2 д */
+    /* 选择 EEPROM Block2 来写入 */
     EEPROM_ADDRESS = macEEPROM_Block2_ADDRESS;
 #endif
 
 #ifdef macEEPROM_Block3_ADDRESS
-    /* ѡ EEPROM Block3 д */
+    /* 选择 EEPROM Block3 来写入 */
     EEPROM_ADDRESS = macEEPROM_Block3_ADDRESS;
 #endif
 }
@@ -121,11 +121,11 @@ void I2C_EE_Init(void)
 
 
 /**
-  * @brief   дһֽڵI2C EEPROM
+  * @brief   写一个字节到I2C EEPROM中
   * @param
-  *		@arg pBuffer:ָ
-  *		@arg WriteAddr:дַ
-  * @retval  
+  *		@arg pBuffer:缓冲区指针
+  *		@arg WriteAddr:写地址
+  * @retval  无
   */
 void I2C_EE_ByteWrite( u8 WriteAddr, u8 dat )
 {
@@ -158,12 +158,12 @@ void I2C_EE_ByteWrite( u8 WriteAddr, u8 dat )
 }
 
 /**
-  * @brief   EEPROMȡһ
+  * @brief   从EEPROM里面读取一块数据
   * @param
-  *		@arg pBuffer:ŴEEPROMȡݵĻָ
-  *		@arg WriteAddr:ݵEEPROMĵַ
-  *     @arg NumByteToWrite:ҪEEPROMȡֽ
-  * @retval  
+  *		@arg pBuffer:存放从EEPROM读取的数据的缓冲区指针
+  *		@arg WriteAddr:接收数据的EEPROM的地址
+  *     @arg NumByteToWrite:要从EEPROM读取的字节数
+  * @retval  无
   */
 unsigned char  I2C_EE_ByteRead(u8 ReadAddr )
 {
@@ -188,7 +188,7 @@ unsigned char  I2C_EE_ByteRead(u8 ReadAddr )
     I2C_Cmd(macI2Cx, ENABLE);
 
     /* Send the EEPROM's internal address to write to */
-    I2C_SendData(macI2Cx, 0xB0);  //----AD5933ָ2017-4-11
+    I2C_SendData(macI2Cx, 0xB0);  //----AD5933的指针命令，2017-4-11
     /* Test on EV8 and clear it */
     while(!I2C_CheckEvent(macI2Cx, I2C_EVENT_MASTER_BYTE_TRANSMITTED));
 
@@ -201,7 +201,7 @@ unsigned char  I2C_EE_ByteRead(u8 ReadAddr )
     /* Send STOP condition */
     I2C_GenerateSTOP(macI2Cx, ENABLE);
 
-    //---------------------------------ȡ---------------------------------//
+    //---------------------------------启动读取操作---------------------------------//
     /* Send STRAT condition a second time */
     I2C_GenerateSTART(macI2Cx, ENABLE);
 
@@ -5,7 +5,7 @@
 #include "stm32f10x.h"
 
 
-/**************************I2C壬I2C1I2C2********************************/
+/**************************I2C参数定义，I2C1或I2C2********************************/
 #define             macI2Cx                                I2C1
 #define             macI2C_APBxClock_FUN                   RCC_APB1PeriphClockCmd
 #define             macI2C_CLK                             RCC_APB1Periph_I2C1
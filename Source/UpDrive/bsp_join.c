@@ -0,0 +1,406 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 入网与时隙分配
+*   文件名称 : bsp_join.c
+*   版    本 : V1.0
+*   说    明 : 从机不再在编译时固定机位号码。上电后在广播包的竞争子时隙中发送入网请求，冲突时按
+*             二进制指数退避；主机在广播包中下发紧凑的时隙号，超帧长度随在网节点数变化。
+*             数据帧中的 devID 为时隙号加1。广播包格式见 bsp_join.h。
+*
+*********************************************************************************************************
+*/
+#include "bsp.h"
+
+#define JOIN_UID_ADDR       0x1FFFF7E8  /* STM32F1 96位芯片唯一ID */
+
+enum
+{
+    JOIN_ST_IDLE = 0,       /* 未入网 */
+    JOIN_ST_JOINED,         /* 已分配时隙 */
+    JOIN_ST_LEGACY          /* 旧格式广播包，使用 JOIN_LEGACY_DEVID */
+};
+
+static uint32_t s_uiUid;            /* 本节点标识 */
+static uint8_t s_ucState;
+static uint8_t s_ucSlot;            /* 已分配的时隙号 */
+static uint8_t s_ucEpoch;           /* 分配时隙时的时隙表版本号 */
+static uint8_t s_ucSlotMs;          /* 最近一个广播包中的时隙长度 */
+static uint8_t s_ucSlotCnt;         /* 最近一个广播包中的数据时隙个数 */
+static uint8_t s_ucCapCnt;          /* 最近一个广播包中的竞争子时隙个数 */
+static int8_t s_cFbSnr;             /* 主机反馈的本节点上行SNR */
+static uint8_t s_ucFbValid;         /* 1: 最近一个广播包带有本节点的反馈 */
+static uint8_t s_ucBulkValid;       /* 1: 最近一个广播包给本节点分配了批量传输窗口 */
+static uint16_t s_usBulkStart;      /* 批量传输窗口在收到广播包后多少ms开始 */
+static uint16_t s_usBulkDur;        /* 批量传输窗口长度，单位ms */
+static uint8_t s_ucBulkRate;        /* 批量传输的FSK速率档位 RF_FSK_xxx */
+static uint8_t s_ucFragValid;       /* 1: 最近一个广播包带有本节点分片报文的确认位图 */
+static uint8_t s_ucFragMsgId;       /* 确认位图对应的报文序号 */
+static uint8_t s_ucFragMap[FRAG_BITMAP_LEN];
+static uint8_t s_ucBackoffExp;      /* 当前退避窗口指数 */
+static uint16_t s_usBackoffLeft;    /* 还需跳过的超帧数 */
+
+/*
+*********************************************************************************************************
+*   函 数 名: JOIN_Init
+*   功能说明: 读取芯片唯一ID作为节点标识，并用它作为随机数种子，使各节点的竞争子时隙选择互不相同
+*   形    参: 无
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void JOIN_Init(void)
+{
+    const uint32_t *uid = (const uint32_t *)JOIN_UID_ADDR;
+
+    s_uiUid = uid[0] ^ uid[1] ^ uid[2];
+    rand_seed(s_uiUid);
+    s_ucState = JOIN_ST_IDLE;
+    s_ucBackoffExp = 0;
+    s_usBackoffLeft = 0;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: JOIN_Leave
+*   功能说明: 放弃已分配的时隙，重新开始入网
+*   形    参: 无
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+static void JOIN_Leave(void)
+{
+    s_ucState = JOIN_ST_IDLE;
+    s_ucBackoffExp = 0;
+    s_usBackoffLeft = 0;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: JOIN_SlotDelay
+*   功能说明: 计算从收到广播包到第 _idx 个时隙开始的延时
+*   形    参: _idx : 时隙序号，竞争子时隙接在数据时隙之后
+*             _slot_ms : 时隙长度
+*   返 回 值: 延时，单位ms，不超过 JOIN_NO_TX - 1
+*********************************************************************************************************
+*/
+static uint16_t JOIN_SlotDelay(uint16_t _idx, uint8_t _slot_ms)
+{
+    uint32_t ms = JOIN_SLOT_GUARD_MS + (uint32_t)_idx * _slot_ms;
+
+    return (ms < JOIN_NO_TX) ? (uint16_t)ms : (JOIN_NO_TX - 1);
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: JOIN_ParseExt
+*   功能说明: 解析广播包反馈之后的扩展记录，只保存发给本节点时隙的记录。遇到未知类型时停止，
+*             以便主机以后增加新的记录类型
+*   形    参: _p : 第一条扩展记录
+*             _pEnd : 广播包结尾
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+static void JOIN_ParseExt(const uint8_t *_p, const uint8_t *_pEnd)
+{
+    uint8_t i;
+
+    while (_p + 2 <= _pEnd)
+    {
+        if ((_p[0] == JOIN_EXT_BULK) && (_p + 1 + JOIN_BULK_LEN <= _pEnd))
+        {
+            if (_p[1] == s_ucSlot)
+            {
+                s_usBulkStart = _p[2] | ((uint16_t)_p[3] << 8);
+                s_usBulkDur = _p[4] | ((uint16_t)_p[5] << 8);
+                s_ucBulkRate = _p[6];
+                s_ucBulkValid = (s_usBulkDur > 0) ? 1 : 0;
+            }
+            _p += 1 + JOIN_BULK_LEN;
+        }
+        else if ((_p[0] == JOIN_EXT_FRAG) && (_p + 1 + JOIN_FRAG_LEN <= _pEnd))
+        {
+            if (_p[1] == s_ucSlot)
+            {
+                s_ucFragMsgId = _p[2];
+                for (i = 0; i < FRAG_BITMAP_LEN; i++)
+                {
+                    s_ucFragMap[i] = _p[3 + i];
+                }
+                s_ucFragValid = 1;
+            }
+            _p += 1 + JOIN_FRAG_LEN;
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: JOIN_OnBeacon
+*   功能说明: 处理主机广播包：更新入网状态，并计算本超帧的发送时刻
+*   形    参: _pBuf : 广播包，前4字节已确认为"$#ST"
+*             _len : 广播包长度
+*   返 回 值: 收到广播包后延时多少ms发送(至少1ms)，本超帧不发送时返回 JOIN_NO_TX
+*********************************************************************************************************
+*/
+uint16_t JOIN_OnBeacon(const uint8_t *_pBuf, uint8_t _len)
+{
+    uint8_t epoch, slot_cnt, slot_ms, cap_cnt, grant_cnt;
+    const uint8_t *p;
+    uint8_t i;
+
+    s_ucFbValid = 0;
+    s_ucBulkValid = 0;
+    s_ucFragValid = 0;
+    if (_len < JOIN_BCN_HDR_LEN) //旧格式广播包，机位号码固定
+    {
+        s_ucState = JOIN_ST_LEGACY;
+        return (JOIN_LEGACY_DEVID - 1) * 100 + 5;
+    }
+    epoch = _pBuf[4];
+    slot_cnt = _pBuf[5];
+    slot_ms = _pBuf[6];
+    cap_cnt = _pBuf[7];
+    grant_cnt = _pBuf[8];
+    if ((grant_cnt > JOIN_MAX_GRANT) || (_len < JOIN_BCN_HDR_LEN + grant_cnt * JOIN_GRANT_LEN) || (slot_ms == 0))
+    {
+        return JOIN_NO_TX;
+    }
+    s_ucSlotMs = slot_ms;
+    s_ucSlotCnt = slot_cnt;
+    s_ucCapCnt = cap_cnt;
+
+    if ((s_ucState == JOIN_ST_LEGACY) || ((s_ucState == JOIN_ST_JOINED) && (epoch != s_ucEpoch)))
+    {
+        JOIN_Leave(); //主机重启或重新压紧了时隙表，原时隙号无效
+    }
+    for (i = 0, p = &_pBuf[JOIN_BCN_HDR_LEN]; i < grant_cnt; i++, p += JOIN_GRANT_LEN)
+    {
+        uint32_t uid = p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+
+        if (uid != s_uiUid)
+        {
+            continue;
+        }
+        if (p[4] == JOIN_SLOT_REVOKE)
+        {
+            JOIN_Leave();
+        }
+        else
+        {
+            s_ucState = JOIN_ST_JOINED;
+            s_ucSlot = p[4];
+            s_ucEpoch = epoch;
+            s_ucBackoffExp = 0;
+            s_usBackoffLeft = 0;
+        }
+    }
+    if ((s_ucState == JOIN_ST_JOINED) && (s_ucSlot >= slot_cnt))
+    {
+        JOIN_Leave(); //时隙表缩短后本节点不在表内
+    }
+    if ((s_ucState == JOIN_ST_JOINED) && (p < &_pBuf[_len])) //分配记录之后是可选的上行链路反馈
+    {
+        uint8_t fb_cnt = *p++;
+
+        for (i = 0; (i < fb_cnt) && (p + JOIN_FB_LEN <= &_pBuf[_len]); i++, p += JOIN_FB_LEN)
+        {
+            if (p[0] == s_ucSlot)
+            {
+                s_cFbSnr = (int8_t)p[1];
+                s_ucFbValid = 1;
+            }
+        }
+        if (i == fb_cnt) //反馈之后是可选的扩展记录
+        {
+            JOIN_ParseExt(p, &_pBuf[_len]);
+        }
+    }
+
+    if (s_ucState == JOIN_ST_JOINED)
+    {
+        return JOIN_SlotDelay(s_ucSlot, slot_ms);
+    }
+
+    /* 未入网：退避结束后在竞争子时隙中随机选一个发送入网请求，并扩大下一次的退避窗口 */
+    if (cap_cnt == 0)
+    {
+        return JOIN_NO_TX;
+    }
+    if (s_usBackoffLeft > 0)
+    {
+        s_usBackoffLeft--;
+        return JOIN_NO_TX;
+    }
+    if (s_ucBackoffExp < JOIN_BACKOFF_MAX)
+    {
+        s_ucBackoffExp++;
+    }
+    s_usBackoffLeft = rand_u32() & ((1u << s_ucBackoffExp) - 1);
+    return JOIN_SlotDelay((uint16_t)slot_cnt + rand_u32() % cap_cnt, slot_ms);
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: JOIN_IsJoined
+*   功能说明: 是否已有时隙，可以发送数据帧
+*   形    参: 无
+*   返 回 值: 1 已入网，0 未入网
+*********************************************************************************************************
+*/
+uint8_t JOIN_IsJoined(void)
+{
+    return (s_ucState != JOIN_ST_IDLE) ? 1 : 0;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: JOIN_DevId
+*   功能说明: 数据帧中使用的设备号
+*   形    参: 无
+*   返 回 值: 时隙号加1，旧格式广播包时为 JOIN_LEGACY_DEVID，未入网返回0
+*********************************************************************************************************
+*/
+uint8_t JOIN_DevId(void)
+{
+    if (s_ucState == JOIN_ST_JOINED)
+    {
+        return s_ucSlot + 1;
+    }
+    if (s_ucState == JOIN_ST_LEGACY)
+    {
+        return JOIN_LEGACY_DEVID;
+    }
+    return 0;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: JOIN_SlotMs
+*   功能说明: 最近一个广播包中的时隙长度，竞争发送时用于限定信道检测和退避的截止时间
+*   形    参: 无
+*   返 回 值: 时隙长度，单位ms，旧格式广播包时为0
+*********************************************************************************************************
+*/
+uint8_t JOIN_SlotMs(void)
+{
+    return (s_ucState == JOIN_ST_LEGACY) ? 0 : s_ucSlotMs;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: JOIN_RelayDelay
+*   功能说明: 中继时隙紧接在竞争子时隙之后，计算从收到广播包到中继时隙开始的延时
+*   形    参: 无
+*   返 回 值: 延时，单位ms；未入网或旧格式广播包时返回 JOIN_NO_TX
+*********************************************************************************************************
+*/
+uint16_t JOIN_RelayDelay(void)
+{
+    if (s_ucState != JOIN_ST_JOINED)
+    {
+        return JOIN_NO_TX;
+    }
+    return JOIN_SlotDelay((uint16_t)s_ucSlotCnt + s_ucCapCnt, s_ucSlotMs);
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: JOIN_CapDelay
+*   功能说明: 已入网节点随机选一个竞争子时隙，用于报警等不能等到下一超帧的数据
+*   形    参: 无
+*   返 回 值: 从收到广播包到该子时隙开始的延时，单位ms；未入网、旧格式广播包或没有竞争子时隙时返回 JOIN_NO_TX
+*********************************************************************************************************
+*/
+uint16_t JOIN_CapDelay(void)
+{
+    if ((s_ucState != JOIN_ST_JOINED) || (s_ucCapCnt == 0))
+    {
+        return JOIN_NO_TX;
+    }
+    return JOIN_SlotDelay((uint16_t)s_ucSlotCnt + rand_u32() % s_ucCapCnt, s_ucSlotMs);
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: JOIN_Feedback
+*   功能说明: 取最近一个广播包中主机对本节点上一次上行数据的反馈，用于发射功率控制
+*   形    参: _pSnr : 输出主机测得的SNR，单位dB；JOIN_FB_LOST 表示主机没有收到
+*   返 回 值: 1 有反馈，0 广播包中没有本节点的反馈
+*********************************************************************************************************
+*/
+uint8_t JOIN_Feedback(int8_t *_pSnr)
+{
+    if (s_ucFbValid)
+    {
+        *_pSnr = s_cFbSnr;
+    }
+    return s_ucFbValid;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: JOIN_BulkGrant
+*   功能说明: 取最近一个广播包中主机分配给本节点的批量传输窗口
+*   形    参: _pStart : 输出窗口在收到广播包后多少ms开始
+*             _pDur : 输出窗口长度，单位ms
+*             _pRate : 输出FSK速率档位
+*   返 回 值: 1 有分配，0 本超帧没有批量传输窗口
+*********************************************************************************************************
+*/
+uint8_t JOIN_BulkGrant(uint16_t *_pStart, uint16_t *_pDur, uint8_t *_pRate)
+{
+    if (s_ucBulkValid)
+    {
+        *_pStart = s_usBulkStart;
+        *_pDur = s_usBulkDur;
+        *_pRate = s_ucBulkRate;
+    }
+    return s_ucBulkValid;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: JOIN_FragAck
+*   功能说明: 取最近一个广播包中主机对本节点分片报文的确认位图
+*   形    参: _pMsgId : 输出位图对应的报文序号
+*             _pBitmap : 输出已收到分片的位图，FRAG_BITMAP_LEN 字节
+*   返 回 值: 1 有确认，0 广播包中没有本节点的确认
+*********************************************************************************************************
+*/
+uint8_t JOIN_FragAck(uint8_t *_pMsgId, uint8_t *_pBitmap)
+{
+    uint8_t i;
+
+    if (s_ucFragValid)
+    {
+        *_pMsgId = s_ucFragMsgId;
+        for (i = 0; i < FRAG_BITMAP_LEN; i++)
+        {
+            _pBitmap[i] = s_ucFragMap[i];
+        }
+    }
+    return s_ucFragValid;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: JOIN_BuildRequest
+*   功能说明: 生成入网请求 '?' uid[4] '%'，uid 小端
+*   形    参: _pBuf : 输出缓冲区，至少 JOIN_REQ_LEN 字节
+*   返 回 值: 请求长度
+*********************************************************************************************************
+*/
+uint8_t JOIN_BuildRequest(uint8_t *_pBuf)
+{
+    _pBuf[0] = '?';
+    _pBuf[1] = (uint8_t)s_uiUid;
+    _pBuf[2] = (uint8_t)(s_uiUid >> 8);
+    _pBuf[3] = (uint8_t)(s_uiUid >> 16);
+    _pBuf[4] = (uint8_t)(s_uiUid >> 24);
+    _pBuf[5] = '%';
+    return JOIN_REQ_LEN;
+}
@@ -0,0 +1,69 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 入网与时隙分配
+*   文件名称 : bsp_join.h
+*   版    本 : V1.0
+*   说    明 : 头文件
+*
+*   主机广播包格式(小端)：
+*     [0..3] "$#ST"
+*     [4]    epoch      时隙表版本号。主机重启或重新压紧时隙表时加1，从机发现变化即重新入网
+*     [5]    slot_cnt   数据时隙个数，即当前在网节点数，主机按入网节点紧凑分配 0 ~ slot_cnt-1
+*     [6]    slot_ms    每个时隙的长度，单位ms
+*     [7]    cap_cnt    数据时隙之后的竞争子时隙个数，每个 slot_ms 长，未入网节点在其中随机选一个发送入网请求
+*     [8]    grant_cnt  本帧携带的分配记录条数，最多 JOIN_MAX_GRANT 条
+*     之后 grant_cnt 条 { uid[4], slot_idx }，slot_idx 为 JOIN_SLOT_REVOKE 表示收回该节点的时隙
+*     之后可选 fb_cnt，以及 fb_cnt 条 { slot_idx, snr }：主机在上一超帧该时隙收到数据的SNR(dB，有符号)，
+*     JOIN_FB_LOST 表示没有收到。主机可以每帧只反馈部分节点，从机据此调整发射功率
+*     之后是可选的扩展记录，每条以类型字节开头，从机遇到未知类型时忽略其后的内容；携带扩展记录时
+*     fb_cnt 不能省略(可以为0)：
+*       'W' { slot_idx, start_ms[2], dur_ms[2], rate }  批量传输窗口：slot_idx 的节点在收到广播包后
+*           start_ms 切换到FSK模式(rate 为 RF_FSK_xxx 速率档位)，连续发送 dur_ms 后回到LoRa，见 bsp_bulk.c。
+*           窗口应安排在所有时隙之后
+*       'A' { slot_idx, msg_id, bitmap[FRAG_BITMAP_LEN] }  分片报文确认：主机已收到的分片位图，见 bsp_frag.h
+*   只有"$#ST"四个字节的旧广播包仍然支持，此时使用编译时的 JOIN_LEGACY_DEVID。
+*
+*   入网请求：'?' uid[4] '%'，uid 由芯片唯一ID异或得到。
+*   主机收到入网请求后分配一个空闲的最小时隙号，在随后的广播包中下发，直到在该时隙收到节点数据；
+*   节点离线(连续若干超帧无数据)后主机收回时隙，把最后一个时隙的节点移到空位并通过分配记录通知，
+*   使 slot_cnt 始终等于在网节点数。
+*
+*********************************************************************************************************
+*/
+#ifndef __BSP_JOIN_H
+#define __BSP_JOIN_H
+
+#include "stdint.h"
+
+#define JOIN_LEGACY_DEVID   3       /* 收到旧格式广播包时使用的机位号码，1，2，3，4等 */
+
+#define JOIN_BCN_HDR_LEN    9       /* 新格式广播包的固定部分长度 */
+#define JOIN_GRANT_LEN      5       /* 每条分配记录的长度 */
+#define JOIN_MAX_GRANT      3       /* 一帧最多携带的分配记录，使广播包不超过缓冲池的小块 */
+#define JOIN_SLOT_REVOKE    0xFF    /* 分配记录中表示收回时隙 */
+#define JOIN_FB_LEN         2       /* 每条上行链路反馈的长度 */
+#define JOIN_FB_LOST        (-128)  /* 反馈中的SNR：主机没有收到该时隙的数据 */
+#define JOIN_EXT_BULK       'W'     /* 扩展记录类型：批量传输窗口 */
+#define JOIN_BULK_LEN       6       /* 批量传输窗口记录的长度，不含类型字节 */
+#define JOIN_EXT_FRAG       'A'     /* 扩展记录类型：分片报文确认 */
+#define JOIN_FRAG_LEN       (2 + FRAG_BITMAP_LEN)   /* 分片报文确认记录的长度，不含类型字节 */
+#define JOIN_REQ_LEN        6       /* 入网请求长度 */
+#define JOIN_SLOT_GUARD_MS  5       /* 收到广播包到第一个时隙开始的保护时间 */
+#define JOIN_BACKOFF_MAX    5       /* 入网请求冲突后最多退避 2^5 个超帧 */
+
+#define JOIN_NO_TX          0xFFFF  /* JOIN_OnBeacon 返回值：本超帧不发送 */
+
+void JOIN_Init(void);
+uint16_t JOIN_OnBeacon(const uint8_t *_pBuf, uint8_t _len);
+uint8_t JOIN_IsJoined(void);
+uint8_t JOIN_DevId(void);
+uint8_t JOIN_SlotMs(void);
+uint16_t JOIN_RelayDelay(void);
+uint16_t JOIN_CapDelay(void);
+uint8_t JOIN_Feedback(int8_t *_pSnr);
+uint8_t JOIN_BulkGrant(uint16_t *_pStart, uint16_t *_pDur, uint8_t *_pRate);
+uint8_t JOIN_FragAck(uint8_t *_pMsgId, uint8_t *_pBitmap);
+uint8_t JOIN_BuildRequest(uint8_t *_pBuf);
+
+#endif
@@ -1,45 +1,45 @@
 /*
 *********************************************************************************************************
 *
-*   ģ : LEDģ(For STM32F1XX)
-*   ļ : bsp_led.c
-*   ˵     : ʼLEDҪGPIO˿
+*   模块名称 : LED模块(For STM32F1XX)
+*   文件名称 : bsp_led.c
+*   说    明 : 初始化LED灯所需要的GPIO端口
 *
 *********************************************************************************************************
 */
 #include "bsp.h"
 /*********************************************************************************************************
-*     : LED_Init
-*   ˵: ʼLEDӦţֱΪPA11PA12PB0PB1
-*       Σ
-*     ֵ: 
+*   函 数 名: LED_Init
+*   功能说明: 初始化LED所对应的引脚，分别为PA11、PA12和PB0、PB1
+*   形    参：无
+*   返 回 值: 无
 *********************************************************************************************************/
 void LED_Init(void)
 { 
-    /*һGPIO_InitTypeDef͵Ľṹ*/
+    /*定义一个GPIO_InitTypeDef类型的结构体*/
     GPIO_InitTypeDef GPIO_InitStructure;
-    /*LEDصGPIOʱ*/
+    /*开启LED相关的GPIO外设时钟*/
     RCC_APB2PeriphClockCmd( LED1_GPIO_CLK | LED2_GPIO_CLK | LED3_GPIO_CLK, ENABLE);
-    /*ѡҪƵGPIO*/
+    /*选择要控制的GPIO引脚*/
     GPIO_InitStructure.GPIO_Pin = LED1_GPIO_PIN;
-    /*ģʽΪͨ*/
+    /*设置引脚模式为通用推挽输出*/
     GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_PP;
-    /*Ϊ50MHz */
+    /*设置引脚速率为50MHz */
     GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-    /*ÿ⺯ʼGPIO*/
+    /*调用库函数，初始化GPIO*/
     GPIO_Init(LED1_GPIO_PORT, &GPIO_InitStructure);
-    /*ѡҪƵGPIO*/
+    /*选择要控制的GPIO引脚*/
     GPIO_InitStructure.GPIO_Pin = LED2_GPIO_PIN;
-    /*ÿ⺯ʼGPIO*/
+    /*调用库函数，初始化GPIO*/
     GPIO_Init(LED2_GPIO_PORT, &GPIO_InitStructure);
-    /*ѡҪƵGPIO*/
+    /*选择要控制的GPIO引脚*/
     GPIO_InitStructure.GPIO_Pin = LED3_GPIO_PIN;
-    /*ÿ⺯ʼGPIOF*/
+    /*调用库函数，初始化GPIOF*/
     GPIO_Init(LED3_GPIO_PORT, &GPIO_InitStructure);
-    /* رled	*/
+    /* 关闭所有led灯	*/
     GPIO_SetBits(LED1_GPIO_PORT, LED1_GPIO_PIN);
-    /* رled	*/
+    /* 关闭所有led灯	*/
     GPIO_SetBits(LED2_GPIO_PORT, LED2_GPIO_PIN);
-    /* رled	*/
+    /* 关闭所有led灯	*/
     GPIO_SetBits(LED3_GPIO_PORT, LED3_GPIO_PIN);    
 }
@@ -2,23 +2,23 @@
 #define  __LED_H
 #include "stm32f10x.h" // Device header
 
-/****************************ΪCaptureNode V1.0************************************/
-void        LED_Init(void); //LEDӦIOڳʼ
-/* LEDӵGPIO˿, ûֻҪ޸Ĵ뼴ɸıƵLED */
-// R-ɫ
-#define LED1_GPIO_PORT    	GPIOE			              /* GPIO˿ */
-#define LED1_GPIO_CLK 	    RCC_APB2Periph_GPIOE		/* GPIO˿ʱ */
-#define LED1_GPIO_PIN		GPIO_Pin_14			        /* ӵSCLʱߵGPIO */
+/****************************以下为CaptureNode V1.0************************************/
+void        LED_Init(void); //LED所对应的IO口初始化函数
+/* 定义LED连接的GPIO端口, 用户只需要修改下面的代码即可改变控制的LED引脚 */
+// R-红色
+#define LED1_GPIO_PORT    	GPIOE			              /* GPIO端口 */
+#define LED1_GPIO_CLK 	    RCC_APB2Periph_GPIOE		/* GPIO端口时钟 */
+#define LED1_GPIO_PIN		GPIO_Pin_14			        /* 连接到SCL时钟线的GPIO */
 
-// G-ɫ
-#define LED2_GPIO_PORT    	GPIOE			              /* GPIO˿ */
-#define LED2_GPIO_CLK 	    RCC_APB2Periph_GPIOE		/* GPIO˿ʱ */
-#define LED2_GPIO_PIN		GPIO_Pin_14			        /* ӵSCLʱߵGPIO */
+// G-绿色
+#define LED2_GPIO_PORT    	GPIOE			              /* GPIO端口 */
+#define LED2_GPIO_CLK 	    RCC_APB2Periph_GPIOE		/* GPIO端口时钟 */
+#define LED2_GPIO_PIN		GPIO_Pin_14			        /* 连接到SCL时钟线的GPIO */
 
-// B-ɫ
-#define LED3_GPIO_PORT    	GPIOE			              /* GPIO˿ */
-#define LED3_GPIO_CLK 	    RCC_APB2Periph_GPIOE		/* GPIO˿ʱ */
-#define LED3_GPIO_PIN		GPIO_Pin_14			        /* ӵSCLʱߵGPIO */
+// B-蓝色
+#define LED3_GPIO_PORT    	GPIOE			              /* GPIO端口 */
+#define LED3_GPIO_CLK 	    RCC_APB2Periph_GPIOE		/* GPIO端口时钟 */
+#define LED3_GPIO_PIN		GPIO_Pin_14			        /* 连接到SCL时钟线的GPIO */
 
 /** the macro definition to trigger the led on or off
   * 1 - off
@@ -27,7 +27,7 @@ void        LED_Init(void); //LED
 #define ON  0
 #define OFF 1
 
-/* ʹñ׼Ĺ̼IO*/
+/* 使用标准的固件库控制IO*/
 #define LED1(a)	    if (a)	\
 					GPIO_SetBits(LED1_GPIO_PORT,LED1_GPIO_PIN);\
 					else		\
@@ -44,13 +44,13 @@ void        LED_Init(void); //LED
 					GPIO_ResetBits(LED3_GPIO_PORT,LED3_GPIO_PIN)
 
 
-/* ֱӲĴķIO */
-#define	digitalHi(p,i)		 {p->BSRR=i;}	 //Ϊߵƽ		
-#define digitalLo(p,i)		 {p->BRR=i;}	 //͵ƽ
-#define digitalToggle(p,i)   {p->ODR ^=i;} //ת״̬
+/* 直接操作寄存器的方法控制IO */
+#define	digitalHi(p,i)		 {p->BSRR=i;}	 //输出为高电平		
+#define digitalLo(p,i)		 {p->BRR=i;}	 //输出低电平
+#define digitalToggle(p,i)   {p->ODR ^=i;} //输出反转状态
 
 
-/* IOĺ */
+/* 定义控制IO的宏 */
 #define LED1_TOGGLE()		   digitalToggle(LED1_GPIO_PORT,LED1_GPIO_PIN)
 #define LED1_OFF()		       digitalHi(LED1_GPIO_PORT,LED1_GPIO_PIN)
 #define LED1_ON()			   digitalLo(LED1_GPIO_PORT,LED1_GPIO_PIN)
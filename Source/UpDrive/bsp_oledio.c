@@ -9,21 +9,21 @@ void OLED_WB ( uint8_t data )
 	SPI_I2S_SendData ( SPI1, data );
 	bsp_DelayUS ( 2 );
 }
-/*******************һֽд***********************/
+/*******************一个字节数据写入***********************/
 void OLED_WrDat ( uint8_t data )
 {
 	OLED_DC = 1;
 	OLED_WB ( data );
 }
 
-/********************һָд**********************/
+/********************一条指令写入**********************/
 void OLED_WrCmd ( uint8_t cmd )
 {
 	OLED_DC = 0;
 	OLED_WB ( cmd );
 }
 
-/**********************ʾλ**********************/
+/**********************设置显示位置**********************/
 void OLED_Set_Pos ( uint8_t x, uint8_t y )
 {
 	/* Page addressing mode */
@@ -32,7 +32,7 @@ void OLED_Set_Pos ( uint8_t x, uint8_t y )
 	OLED_WrCmd ( ( ( x & 0xf0 ) >> 4 ) | 0x10 ); /* set higher nibble of the column address */
 }
 
-/**********************д**********************/
+/**********************写满屏数据**********************/
 void OLED_Fill ( unsigned char bmp_dat )
 {
 	unsigned char y, x;
@@ -44,7 +44,7 @@ void OLED_Fill ( unsigned char bmp_dat )
 	OLED_WrCmd ( 0x22 ); //-Set Page Address
 	OLED_WrCmd ( 0x00 );
 	OLED_WrCmd ( 0x07 );
-	LCD_DLY_ms ( 1 ); /* ȴڲȶ   */
+	LCD_DLY_ms ( 1 ); /* 等待内部稳定   */
 	for ( y = 0; y < Page; y++ )
 	{
 		for ( x = 0; x < X_WIDTH; x++ )
@@ -55,7 +55,7 @@ void OLED_Fill ( unsigned char bmp_dat )
 //    LCD_WrCmd(0xaf);//--turn off oled panel
 }
 
-/********************************************/
+/*********************清屏函数***********************/
 void OLED_CLS ( void )
 {
 	unsigned char y, x;
@@ -70,7 +70,7 @@ void OLED_CLS ( void )
 	}
 }
 
-/*********************ʱ***********************/
+/*********************延时函数***********************/
 void LCD_DLY_ms ( unsigned int ms )
 {
 	unsigned int a;
@@ -84,11 +84,11 @@ void LCD_DLY_ms ( unsigned int ms )
 }
 
 /*****************************************************************************
-        : OLEDIO_Init
-      : OLEDIOʼ
-      : void
-      : NONE
-      ֵ  : NONE
+    函 数 名  : OLEDIO_Init
+    功能描述  : OLED的IO初始化
+    输入参数  : void
+    输出参数  : NONE
+    返 回 值  : NONE
 *****************************************************************************/
 void OLEDIO_Init ( void )
 {
@@ -101,7 +101,7 @@ void OLEDIO_Init ( void )
 }
 
 
-/*********************12864ʼ***********************/
+/*********************12864初始化***********************/
 void OLED_Init ( void )
 {
 	GPIO_InitTypeDef GPIO_InitStructure;
@@ -112,15 +112,15 @@ void OLED_Init ( void )
 	OLED_RST = 0;
 	LCD_DLY_ms ( 50 );
 	OLED_RST = 1;
-	//ϵ絽濪ʼʼҪ㹻ʱ䣬ȴRCλ
+	//从上电到下面开始初始化要有足够的时间，即等待RC复位完毕
 	OLED_WrCmd ( 0xae ); //--turn off oled panel
 	OLED_WrCmd ( 0xa8 ); //--set multiplex ratio(1 to 64)
 	OLED_WrCmd ( 0x3f ); //--1/64 duty
 	OLED_WrCmd ( 0xd3 ); //-set display offset	Shift Mapping RAM Counter (0x00~0x3F)
 	OLED_WrCmd ( 0x00 ); //-not offset
 	OLED_WrCmd ( 0x40 ); //--set start line address  Set Mapping RAM Display Start Line (0x00~0x3F)
-	OLED_WrCmd ( 0xa1 ); //--Set SEG/Column Mapping     0xa0ҷ 0xa1
-	OLED_WrCmd ( 0xc8 ); //Set COM/Row Scan Direction   0xc0· 0xc8
+	OLED_WrCmd ( 0xa1 ); //--Set SEG/Column Mapping     0xa0左右反置 0xa1正常
+	OLED_WrCmd ( 0xc8 ); //Set COM/Row Scan Direction   0xc0上下反置 0xc8正常
 	OLED_WrCmd ( 0xda ); //--set com pins hardware configuration
 	OLED_WrCmd ( 0x12 );
 	OLED_WrCmd ( 0x81 ); //--set contrast control register
@@ -136,10 +136,10 @@ void OLED_Init ( void )
 	OLED_WrCmd ( 0xf8 ); //Set Pre-Charge as 15 Clocks & Discharge as 1 Clock
 	OLED_WrCmd ( 0xdb ); //--set vcomh
 	OLED_WrCmd ( 0x40 ); //Set VCOM Deselect Level
-	OLED_Fill ( 0x00 ); //ʼ
+	OLED_Fill ( 0x00 ); //初始清屏
 }
-/***************ʾ6*8һ׼ASCIIַ	ʾ꣨x,yyΪҳΧ07****************/
-//12864ص㣬ʾ21У8
+/***************功能描述：显示6*8一组标准ASCII字符串	显示的坐标（x,y），y为页范围0～7****************/
+//12864像素点，能显示21列，8行
 void LCD_P6x8Str ( unsigned char x, unsigned char y, unsigned char ch[] )
 {
 	unsigned char c = 0, i = 0, j = 0;
@@ -154,8 +154,8 @@ void LCD_P6x8Str ( unsigned char x, unsigned char y, unsigned char ch[] )
 		j++;
 	}
 }
-/*******************ʾ8*16һ׼ASCIIַ	 ʾ꣨x,y****************/
-//12864ص㣬yȡֵΪ0246ʾ
+/*******************功能描述：显示8*16一组标准ASCII字符串	 显示的坐标（x,y）****************/
+//12864像素点，y的取值为0，2，4，6才能正常显示
 void LCD_P8x16Str ( unsigned char x, unsigned char y, unsigned char ch[] )
 {
 	unsigned char c = 0, i = 0, j = 0;
@@ -173,25 +173,25 @@ void LCD_P8x16Str ( unsigned char x, unsigned char y, unsigned char ch[] )
 		j++;
 	}
 }
-/*****************ʾ16*16  ʾ꣨x,yyΪҳΧ07****************************/
+/*****************功能描述：显示16*16点阵  显示的坐标（x,y），y为页范围0～7****************************/
 void LCD_P16x16Ch ( unsigned char x, unsigned char y, unsigned char N )
 {
 	unsigned char wm = 0;
-	unsigned int adder = 32 * N; //ÿģʼַ
+	unsigned int adder = 32 * N; //每个字模的起始地址
 	OLED_Set_Pos ( x , y );
 	for ( wm = 0; wm < 16; wm++ ) //
 	{
 		OLED_WrDat ( F16x16[adder] );
 		adder += 1;
-	}      									 //ϰ
+	}      									 //上半屏
 	OLED_Set_Pos ( x, y + 1 );
 	for ( wm = 0; wm < 16; wm++ ) //
 	{
 		OLED_WrDat ( F16x16[adder] );
 		adder += 1;
-	} 	  									 //°
+	} 	  									 //下半屏
 }
-/*****************ʾ32*32  ʾ꣨x,yyΪҳΧ07****************************/
+/*****************功能描述：显示32*32点阵  显示的坐标（x,y），y为页范围0～7****************************/
 void LCD_P32x32Ch ( unsigned char x, unsigned char y, unsigned char N )
 {
 	unsigned char wm = 0;
@@ -221,7 +221,7 @@ void LCD_P32x32Ch ( unsigned char x, unsigned char y, unsigned char N )
 		adder += 1;
 	}
 }
-/***********ʾʾBMPͼƬ12864ʼ(x,y),xķΧ0127yΪҳķΧ07*****************/
+/***********功能描述：显示显示BMP图片128×64起始点坐标(x,y),x的范围0～127，y为页的范围0～7*****************/
 void Draw_BMP ( unsigned char x0, unsigned char y0, unsigned char x1, unsigned char y1, unsigned char const BMP[] )
 {
 	unsigned int j = 0;
@@ -2,15 +2,15 @@
 #define __OLED_H__
 
 /*----------------------------------------------------------------------------*
- * ͷļ                                                                 *
+ * 包含头文件                                                                 *
  *----------------------------------------------------------------------------*/
 
 #include "stm32f10x.h"
 /***
- *SPI1ӲSSD1306 OLED 
- *ģ4SPIӿ ƬѡѾӲõ
- *D/Cߴ ʹ
- *SDA: SCL:ʱ
+ *SPI1硬件驱动SSD1306 OLED 
+ *模块是4线SPI接口 片选已经硬件置低
+ *D/C拉高代表输入数据 拉低代表输入命令
+ *SDA:数据输入 SCL:时钟输入
  ****/
 #define     RCC_APB2Periph_OLED_PORT        RCC_APB2Periph_GPIOA
 #define     OLED_DC      PBout(1)
@@ -31,31 +31,31 @@
 #define		  Page			8
 
 void OLED_WB(uint8_t data);
-/*********************LCDд************************************/ 
+/*********************LCD写数据************************************/ 
 void OLED_WrDat(uint8_t data);
-/*********************LCDд************************************/
+/*********************LCD写命令************************************/
 void OLED_WrCmd(uint8_t cmd);
-/*********************趨************************************/
+/*********************设定坐标************************************/
 void OLED_Set_Pos(uint8_t x, uint8_t y);
-/*********************LCDȫ************************************/
+/*********************LCD全屏操作************************************/
 void OLED_Fill(unsigned char bmp_dat);
-/*********************LCDλ************************************/
+/*********************LCD复位************************************/
 void OLED_CLS(void);
-/*********************LCDӦIOƿڳʼ************************************/
+/*********************LCD对应IO控制口初始化************************************/
 void OLEDIO_Init(void);
-/*********************LCDʼ************************************/
+/*********************LCD初始化************************************/
 void OLED_Init(void);
-/*********************ʱ***********************/
+/*********************延时函数***********************/
 void LCD_DLY_ms(unsigned int ms);
-/*****************ʾ6*8һ׼ASCIIַ	ʾ꣨x,yyΪҳΧ07****************/
+/*****************功能描述：显示6*8一组标准ASCII字符串	显示的坐标（x,y），y为页范围0～7****************/
 void LCD_P6x8Str(unsigned char x,unsigned char y,unsigned char ch[]);
-/*****************ʾ8*16һ׼ASCIIַ	 ʾ꣨x,yyΪҳΧ07****************/
+/*****************功能描述：显示8*16一组标准ASCII字符串	 显示的坐标（x,y），y为页范围0～7****************/
 void LCD_P8x16Str(unsigned char x,unsigned char y,unsigned char ch[]);
-/*****************ʾ16*16  ʾ꣨x,yyΪҳΧ07****************************/
+/*****************功能描述：显示16*16点阵  显示的坐标（x,y），y为页范围0～7****************************/
 void LCD_P16x16Ch(unsigned char x,unsigned char y,unsigned char N);
-/*****************ʾ32*32  ʾ꣨x,yyΪҳΧ07****************************/
+/*****************功能描述：显示32*32点阵  显示的坐标（x,y），y为页范围0～7****************************/
 void LCD_P32x32Ch(unsigned char x,unsigned char y,unsigned char N);
-/*****************ʾʾBMPͼƬ12864ʼ(x,y),xķΧ0127yΪҳķΧ07*****************/
+/*****************功能描述：显示显示BMP图片128×64起始点坐标(x,y),x的范围0～127，y为页的范围0～7*****************/
 void Draw_BMP(unsigned char x0, unsigned char y0,unsigned char x1,unsigned char y1,unsigned char const BMP[]);
 
 #endif
@@ -0,0 +1,118 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 无线数据包缓冲池
+*   文件名称 : bsp_pktpool.c
+*   版    本 : V1.0
+*   说    明 : 固定数量、固定大小的数据包缓冲区。接收时按包长申请能容纳该包的最小缓冲区，
+*             射频驱动直接把FIFO中的数据读入其中，然后把缓冲区交给处理任务，处理完毕再归还。
+*             不需要清零，也不需要在多个静态数组之间拷贝；包长超过缓冲区时不会越界。
+*
+*********************************************************************************************************
+*/
+#include "bsp.h"
+
+static uint8_t s_ucSmallBuf[PKT_SMALL_NUM][PKT_SMALL_SIZE];
+static uint8_t s_ucLargeBuf[PKT_LARGE_NUM][PKT_LARGE_SIZE];
+static PKT_BUF_T s_tPkt[PKT_BUF_NUM];   /* 前 PKT_SMALL_NUM 个为小块 */
+
+uint16_t g_usPktAllocFail = 0;          /* 没有可用缓冲区而丢弃的数据包数 */
+
+/*
+*********************************************************************************************************
+*   函 数 名: PKT_Init
+*   功能说明: 初始化缓冲池，所有缓冲区置为空闲
+*   形    参: 无
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void PKT_Init(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < PKT_BUF_NUM; i++)
+    {
+        if (i < PKT_SMALL_NUM)
+        {
+            s_tPkt[i].data = s_ucSmallBuf[i];
+            s_tPkt[i].size = PKT_SMALL_SIZE;
+        }
+        else
+        {
+            s_tPkt[i].data = s_ucLargeBuf[i - PKT_SMALL_NUM];
+            s_tPkt[i].size = PKT_LARGE_SIZE;
+        }
+        s_tPkt[i].len = 0;
+        s_tPkt[i].used = 0;
+    }
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: PKT_Alloc
+*   功能说明: 申请一个能容纳 _len 字节的缓冲区，优先使用小块。数据区内容不清零。
+*   形    参: _len : 数据包长度
+*   返 回 值: 缓冲区指针，没有可用缓冲区时返回0
+*********************************************************************************************************
+*/
+PKT_BUF_T *PKT_Alloc(uint8_t _len)
+{
+    PKT_BUF_T *pkt = 0;
+    uint8_t i;
+
+    DISABLE_INT();
+    for (i = (_len > PKT_SMALL_SIZE) ? PKT_SMALL_NUM : 0; i < PKT_BUF_NUM; i++)
+    {
+        if (s_tPkt[i].used == 0)
+        {
+            s_tPkt[i].used = 1;
+            s_tPkt[i].len = 0;
+            pkt = &s_tPkt[i];
+            break;
+        }
+    }
+    if (pkt == 0)
+    {
+        g_usPktAllocFail++;
+    }
+    ENABLE_INT();
+    return pkt;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: PKT_Free
+*   功能说明: 归还缓冲区
+*   形    参: _pPkt : PKT_Alloc 返回的缓冲区，可以为0
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void PKT_Free(PKT_BUF_T *_pPkt)
+{
+    if (_pPkt != 0)
+    {
+        _pPkt->used = 0;
+    }
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: PKT_FreeCount
+*   功能说明: 统计空闲缓冲区个数，用于调试时检查是否有缓冲区未归还
+*   形    参: 无
+*   返 回 值: 空闲缓冲区个数
+*********************************************************************************************************
+*/
+uint8_t PKT_FreeCount(void)
+{
+    uint8_t i, n = 0;
+
+    for (i = 0; i < PKT_BUF_NUM; i++)
+    {
+        if (s_tPkt[i].used == 0)
+        {
+            n++;
+        }
+    }
+    return n;
+}
@@ -0,0 +1,43 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 无线数据包缓冲池
+*   文件名称 : bsp_pktpool.h
+*   版    本 : V1.0
+*   说    明 : 头文件
+*
+*********************************************************************************************************
+*/
+#ifndef __BSP_PKTPOOL_H
+#define __BSP_PKTPOOL_H
+
+#include "stdint.h"
+
+/* 两种规格的缓冲区：短包(广播、节点数据)用小块，长包用大块，大块可容纳SX1278最大负载255字节 */
+#define PKT_SMALL_SIZE      32
+#define PKT_SMALL_NUM       4
+#define PKT_LARGE_SIZE      255
+#define PKT_LARGE_NUM       2
+
+#define PKT_BUF_NUM         (PKT_SMALL_NUM + PKT_LARGE_NUM)
+
+/* 数据包缓冲区。由 PKT_Alloc 取得，使用者处理完毕后调用 PKT_Free 归还 */
+typedef struct
+{
+    uint8_t *data;      /* 数据区 */
+    uint8_t size;       /* 数据区容量 */
+    uint8_t len;        /* 有效数据长度 */
+    int8_t  snr;        /* 接收信噪比，单位dB */
+    int16_t rssi;       /* 接收信号强度，单位dBm */
+    int32_t time;       /* 从FIFO取出的时刻(bsp_GetRunTime)，单位ms */
+    uint8_t used;       /* 1: 已被占用 */
+} PKT_BUF_T;
+
+void PKT_Init(void);
+PKT_BUF_T *PKT_Alloc(uint8_t _len);
+void PKT_Free(PKT_BUF_T *_pPkt);
+uint8_t PKT_FreeCount(void);
+
+extern uint16_t g_usPktAllocFail;
+
+#endif
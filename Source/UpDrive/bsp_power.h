@@ -2,11 +2,11 @@
 #define  __BSPPOWER_H
 #include "stm32f10x.h" // Device header
 
-/****************************ΪHeartbagV2.0************************************/
-//KEYӵPA4
-//BAT_CӵPB6
-//BAT_MӵPB5
-//PWRӵPC13
+/****************************以下为HeartbagV2.0************************************/
+//KEY连接到PA4
+//BAT_C连接到PB6
+//BAT_M连接到PB5
+//PWR连接到PC13
 #define     GPIO_KEY    PAin(4)
 #define     GPIO_BAT_C  PBin(6)
 #define     GPIO_BAT_M  PBin(5)
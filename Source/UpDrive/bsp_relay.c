@@ -0,0 +1,208 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 中继转发
+*   文件名称 : bsp_relay.c
+*   版    本 : V1.0
+*   说    明 : 远端节点的数据帧封装，以及中继节点的去重、排队和打包转发。帧格式见 bsp_relay.h。
+*             收发都在任务中进行，不需要关中断。
+*
+*********************************************************************************************************
+*/
+#include "bsp.h"
+
+typedef struct
+{
+    uint8_t len;
+    uint8_t data[RELAY_ITEM_MAX];
+} RELAY_ITEM_T;
+
+typedef struct
+{
+    uint8_t devid;          /* 0: 空闲 */
+    uint8_t seq;            /* 最近一次转发的序号 */
+} RELAY_SRC_T;
+
+static RELAY_ITEM_T s_tQueue[RELAY_QUEUE_NUM];
+static uint8_t s_ucHead;            /* 下一个出队位置 */
+static uint8_t s_ucCount;
+static RELAY_SRC_T s_tSrc[RELAY_SRC_NUM];
+static uint8_t s_ucSrcNext;         /* 去重表满时替换的位置 */
+static uint8_t s_ucSeq;             /* 本节点发送序号 */
+
+uint16_t g_usRelayDup = 0;          /* 重复收到而丢弃的数据帧数 */
+uint16_t g_usRelayDrop = 0;         /* 中继队列满或帧过长而丢弃的数据帧数 */
+
+/*
+*********************************************************************************************************
+*   函 数 名: RELAY_Init
+*   功能说明: 清空中继队列和去重表
+*   形    参: 无
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void RELAY_Init(void)
+{
+    s_ucHead = 0;
+    s_ucCount = 0;
+    s_ucSrcNext = 0;
+    mem_set((char *)s_tSrc, 0, sizeof(s_tSrc));
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RELAY_Wrap
+*   功能说明: 远端节点把数据帧封装为 '^' seq 数据帧，每调用一次序号加1
+*   形    参: _pOut : 输出缓冲区，至少 _len + 2 字节
+*             _pFrame : 原数据帧，[1]为devID
+*             _len : 原数据帧长度
+*   返 回 值: 封装后的长度
+*********************************************************************************************************
+*/
+uint8_t RELAY_Wrap(uint8_t *_pOut, const uint8_t *_pFrame, uint8_t _len)
+{
+    uint8_t i;
+
+    _pOut[0] = '^';
+    _pOut[1] = s_ucSeq++;
+    for (i = 0; i < _len; i++)
+    {
+        _pOut[2 + i] = _pFrame[i];
+    }
+    return _len + 2;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RELAY_OnPacket
+*   功能说明: 中继节点处理收到的数据包：是'^'封装的数据帧且不是重复帧时放入中继队列
+*   形    参: _pBuf : 数据包
+*             _len : 数据包长度
+*   返 回 值: 1 已放入队列，0 不是需要转发的数据帧、重复或被丢弃
+*********************************************************************************************************
+*/
+uint8_t RELAY_OnPacket(const uint8_t *_pBuf, uint8_t _len)
+{
+    RELAY_SRC_T *src = 0;
+    RELAY_ITEM_T *item;
+    uint8_t devid, i;
+
+    if ((_len < 4) || (_pBuf[0] != '^') || (_pBuf[3] == 0))
+    {
+        return 0;
+    }
+    devid = _pBuf[3];           /* '^' seq head devID ... */
+    for (i = 0; i < RELAY_SRC_NUM; i++)
+    {
+        if (s_tSrc[i].devid == devid)
+        {
+            src = &s_tSrc[i];
+            break;
+        }
+    }
+    if ((src != 0) && (src->seq == _pBuf[1]))
+    {
+        g_usRelayDup++;
+        return 0;
+    }
+    if ((_len > RELAY_ITEM_MAX) || (s_ucCount >= RELAY_QUEUE_NUM))
+    {
+        g_usRelayDrop++;
+        return 0;
+    }
+    if (src == 0)
+    {
+        src = &s_tSrc[s_ucSrcNext];
+        src->devid = devid;
+        s_ucSrcNext = (s_ucSrcNext + 1) % RELAY_SRC_NUM;
+    }
+    src->seq = _pBuf[1];
+
+    item = &s_tQueue[(s_ucHead + s_ucCount) % RELAY_QUEUE_NUM];
+    for (i = 0; i < _len; i++)
+    {
+        item->data[i] = _pBuf[i];
+    }
+    item->len = _len;
+    s_ucCount++;
+    return 1;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RELAY_Pending
+*   功能说明: 中继队列中等待转发的数据帧数
+*   形    参: 无
+*   返 回 值: 数据帧数
+*********************************************************************************************************
+*/
+uint8_t RELAY_Pending(void)
+{
+    return s_ucCount;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RELAY_FrameLen
+*   功能说明: 计算 RELAY_BuildFrame 将要生成的转发帧长度，不出队，用于发送前检查占空比预算
+*   形    参: 无
+*   返 回 值: 转发帧长度，队列为空时返回0
+*********************************************************************************************************
+*/
+uint8_t RELAY_FrameLen(void)
+{
+    uint8_t pos = 3, n;
+
+    for (n = 0; n < s_ucCount; n++)
+    {
+        uint8_t len = s_tQueue[(s_ucHead + n) % RELAY_QUEUE_NUM].len;
+
+        if (pos + 1 + len + 1 > RELAY_FRAME_MAX)
+        {
+            break;
+        }
+        pos += 1 + len;
+    }
+    return (n > 0) ? pos + 1 : 0;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RELAY_BuildFrame
+*   功能说明: 从中继队列取出数据帧打包为 'R' devID n { len 数据帧 } '%'，放不下的留到下一超帧
+*   形    参: _pOut : 输出缓冲区，至少 RELAY_FRAME_MAX 字节
+*             _devid : 中继节点自己的devID
+*   返 回 值: 转发帧长度，队列为空时返回0
+*********************************************************************************************************
+*/
+uint8_t RELAY_BuildFrame(uint8_t *_pOut, uint8_t _devid)
+{
+    RELAY_ITEM_T *item;
+    uint8_t pos = 3, n = 0, i;
+
+    while (s_ucCount > 0)
+    {
+        item = &s_tQueue[s_ucHead];
+        if (pos + 1 + item->len + 1 > RELAY_FRAME_MAX)
+        {
+            break;
+        }
+        _pOut[pos++] = item->len;
+        for (i = 0; i < item->len; i++)
+        {
+            _pOut[pos++] = item->data[i];
+        }
+        s_ucHead = (s_ucHead + 1) % RELAY_QUEUE_NUM;
+        s_ucCount--;
+        n++;
+    }
+    if (n == 0)
+    {
+        return 0;
+    }
+    _pOut[0] = 'R';
+    _pOut[1] = _devid;
+    _pOut[2] = n;
+    _pOut[pos++] = '%';
+    return pos;
+}
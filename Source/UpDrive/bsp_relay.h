@@ -0,0 +1,43 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 中继转发
+*   文件名称 : bsp_relay.h
+*   版    本 : V1.0
+*   说    明 : 头文件
+*
+*   远端节点(RELAY_UPLINK_EN = 1)仍按广播包在自己的时隙发送，但数据帧封装为 '^' seq 原数据帧，
+*   seq 为本节点发送序号；中继节点(RELAY_EN = 1)收到后按(原帧devID, seq)去重，放入中继队列，
+*   在数据时隙和竞争子时隙之后的中继时隙内打包转发：
+*     'R' 中继devID n { len 原数据帧 } x n '%'
+*   主机在广播包的超帧中为中继时隙预留一个 slot_ms，且一个网络只设一个中继节点。
+*   适用于主机发射功率大、远端节点能收到广播包但上行到不了主机的场合，两跳均使用网络的缺省速率，
+*   代替把远端节点改为SF12慢速直连，比较见 Tools/lora_relay_sim.c。
+*
+*********************************************************************************************************
+*/
+#ifndef __BSP_RELAY_H
+#define __BSP_RELAY_H
+
+#include "stdint.h"
+#include "bsp_txq.h"
+
+#define RELAY_EN            0       /* 1: 本节点担任中继 */
+#define RELAY_UPLINK_EN     0       /* 1: 本节点的上行数据经中继转发 */
+
+#define RELAY_QUEUE_NUM     4       /* 中继队列长度，每超帧最多转发的数据帧数 */
+#define RELAY_ITEM_MAX      (TXQ_FRAME_MAX + 2)     /* 可转发的单个数据帧(含'^'和seq)最大长度，远端节点打包后的上行帧都能封装 */
+#define RELAY_SRC_NUM       16      /* 去重表记录的远端节点数 */
+#define RELAY_FRAME_MAX     (RELAY_ITEM_MAX + 5)    /* 转发帧最大长度，至少能放下一个最长的数据帧 */
+
+void RELAY_Init(void);
+uint8_t RELAY_Wrap(uint8_t *_pOut, const uint8_t *_pFrame, uint8_t _len);
+uint8_t RELAY_OnPacket(const uint8_t *_pBuf, uint8_t _len);
+uint8_t RELAY_Pending(void);
+uint8_t RELAY_FrameLen(void);
+uint8_t RELAY_BuildFrame(uint8_t *_pOut, uint8_t _devid);
+
+extern uint16_t g_usRelayDup;
+extern uint16_t g_usRelayDrop;
+
+#endif
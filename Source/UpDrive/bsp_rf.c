@@ -1,19 +1,67 @@
 /*********************************************************************************************************
-    ģ : RFģ(For STM32F1XX)
-    ļ : bsp_rf.c
-    ˵     :
+    模块名称 : RF模块(For STM32F1XX)
+    文件名称 : bsp_rf.c
+    说    明 :
 *********************************************************************************************************/
 #include "bsp.h"
 const char *rfName = "SX1278";
-u16	iSend, iRev;    //߷ͺͽռ
-u8	sendBuf[64];    //ͻ
-u8	revBuf[128];    //ջ
-//ʼSX1278ĸIO
+u16	iSend, iRev;    //无线发送和接收计数
+u16	iRecover;       //射频模块恢复次数
+u16	iLbtBusy;       //信道检测到截止时间仍忙而放弃发射的次数
+u16	iRxDrop;        //只读包头即丢弃的数据包个数(其他节点的上行数据等)
+u16	iRxLost;        //接收队列满而丢弃的数据包个数，缓冲池不足丢弃的见g_usPktAllocFail
+u16	iImageCal;      //温度漂移后重新做镜像校准的次数
+int16_t	gRfTemp;    //最近一次读取的芯片温度，单位℃，未做偏移校准
+u8	sendBuf[64];    //发送缓冲区
+
+#define RF_ST_STDBY   0   //待机(发射结束、单次接收结束后芯片自动进入)
+#define RF_ST_RXCONT  1   //连续接收
+#define RF_ST_RXSINGLE 2  //单次接收窗口
+#define RF_ST_SLEEP   3   //睡眠
+#define RF_ST_TXREADY 4   //发射数据已写入FIFO，芯片在待机等待RFTxFire，期间不能重新配置为接收
+#define RF_ST_TX      5   //正在发射，等待TxDone(DIO0)
+#define RF_ST_CAD     6   //信道活动检测，等待CadDone(DIO0)
+static u8 s_ucRfState = RF_ST_STDBY;
+
+//DIO中断事件：中断中只置位，不访问SPI，由主循环的RFEventPoll按射频状态处理
+#define RF_EVT_DIO0   0x01  //RxDone / TxDone / CadDone
+#define RF_EVT_DIO1   0x02  //RxTimeout / CadDetected
+#define RF_EVT_DIO3   0x04  //ValidHeader
+static volatile u8 s_ucRfEvt;
+static u8 s_ucRxHeader;       //1: 已检测到有效包头，数据包正在接收
+static int32_t s_iRxHeaderTime; //检测到包头的时刻，超过一个最大数据包的空中时间仍没有RxDone则清除
+static u8 s_ucRxTimeout;      //1: 单次接收窗口超时(DIO1)，由RFRxTimedOut读取
+static u8 s_ucTxSent;         //1: 上次RFTxSentTake之后有LoRa数据包发射完成
+static volatile int32_t s_iDio0Time; //最近一次DIO0中断的时刻，用于计算实际发射时间
+
+//发射和先听后发：发射开始后立即返回，由RFEventPoll按DIO0事件或超时结束并回调
+static RF_TX_DONE s_pTxDone;  //发射结束回调
+static u8 s_ucTxLen;          //正在发射的数据包长度
+static int32_t s_iTxStart;    //进入发射的时刻
+static u16 s_usTxWait;        //等待TxDone的上限，ms
+static u8 s_ucLbtBuf[RF_LBT_LEN_MAX]; //先听后发等待发射的数据
+static u8 s_ucLbtLen;         //0: 没有等待先听后发的数据
+static u16 s_usLbtDeadline;   //从开始检测起的截止时间，ms
+static int32_t s_iLbtStart;   //开始检测的时刻
+static int32_t s_iLbtWait;    //开始退避的时刻
+static u16 s_usLbtBackoff;    //退避时间，ms，0表示不在退避中
+static int32_t s_iCadStart;   //进入CAD的时刻
+static u8 s_ucCadEvt;         //CAD期间累计的DIO事件，CadDetected和CadDone可能分两次取到
+static void RFTxEnd ( u8 ok );
+static void RFLbtStep ( void );
+static void RFCadEnd ( u8 busy );
+
+//接收队列：收到RxDone后立即把数据包从FIFO取出放入队列，任务按自己的节奏取走。
+//写入和取出都在主循环中进行，下标用volatile，以后改为在EXTI中断中写入时不需要修改
+static PKT_BUF_T *s_pRxQueue[RF_RXQ_NUM];
+static volatile u8 s_ucRxIn;   //下一个写入位置，只由RFRxPoll修改
+static volatile u8 s_ucRxOut;  //下一个取出位置，只由RFRxGet修改
+//初始化SX1278的四个IO口
 void RFGPIOInit ( void )
 {
 	GPIO_InitTypeDef GPIO_InitStructure;
 	/* Configure PA8 RF_CE as Output push-pull -------------------------------*/
-	//ԭͼNREST
+	//此引脚在原理图中是NREST引脚
 	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_8;
 	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
 	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_PP;
@@ -27,6 +75,33 @@ void RFGPIOInit ( void )
 	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_2;
 	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING; //GPIO_Mode_IPU;
 	GPIO_Init ( GPIOA, &GPIO_InitStructure );
+	/* Configure PC6 RF_DIO1, PC7 RF_DIO3 as input */
+	RCC_APB2PeriphClockCmd ( RCC_APB2Periph_GPIOC | RCC_APB2Periph_AFIO, ENABLE );
+	GPIO_InitStructure.GPIO_Pin = RF_DIO1_PIN | RF_DIO3_PIN;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
+	GPIO_Init ( RF_DIO_PORT, &GPIO_InitStructure );
+	/* DIO0(PA2)、DIO1(PC6)、DIO3(PC7)上升沿中断 */
+	{
+		EXTI_InitTypeDef EXTI_InitStructure;
+		NVIC_InitTypeDef NVIC_InitStructure;
+
+		GPIO_EXTILineConfig ( GPIO_PortSourceGPIOA, GPIO_PinSource2 );
+		GPIO_EXTILineConfig ( GPIO_PortSourceGPIOC, GPIO_PinSource6 );
+		GPIO_EXTILineConfig ( GPIO_PortSourceGPIOC, GPIO_PinSource7 );
+		EXTI_InitStructure.EXTI_Line = EXTI_Line2 | EXTI_Line6 | EXTI_Line7;
+		EXTI_InitStructure.EXTI_Mode = EXTI_Mode_Interrupt;
+		EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Rising;
+		EXTI_InitStructure.EXTI_LineCmd = ENABLE;
+		EXTI_Init ( &EXTI_InitStructure );
+
+		NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 3; /* 高于定时器，低于串口 */
+		NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+		NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+		NVIC_InitStructure.NVIC_IRQChannel = EXTI2_IRQn;
+		NVIC_Init ( &NVIC_InitStructure );
+		NVIC_InitStructure.NVIC_IRQChannel = EXTI9_5_IRQn;
+		NVIC_Init ( &NVIC_InitStructure );
+	}
 	/* Configure PB11 RF_SDN as Output push-pull -------------------------------*/
 //	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_11;
 //	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
@@ -34,48 +109,583 @@ void RFGPIOInit ( void )
 //	GPIO_Init(GPIOB, &GPIO_InitStructure);
 }
 
-//Ƶģʼ
+//DIO0中断：只记录事件
+void EXTI2_IRQHandler ( void )
+{
+	if ( EXTI_GetITStatus ( EXTI_Line2 ) != RESET )
+	{
+		s_ucRfEvt |= RF_EVT_DIO0;
+		s_iDio0Time = bsp_GetRunTime();
+		EXTI_ClearITPendingBit ( EXTI_Line2 );
+	}
+}
+
+//DIO1、DIO3中断：只记录事件
+void EXTI9_5_IRQHandler ( void )
+{
+	if ( EXTI_GetITStatus ( EXTI_Line6 ) != RESET )
+	{
+		s_ucRfEvt |= RF_EVT_DIO1;
+		EXTI_ClearITPendingBit ( EXTI_Line6 );
+	}
+	if ( EXTI_GetITStatus ( EXTI_Line7 ) != RESET )
+	{
+		s_ucRfEvt |= RF_EVT_DIO3;
+		EXTI_ClearITPendingBit ( EXTI_Line7 );
+	}
+}
+
+//取出并清除DIO中断事件
+static u8 RFEventTake ( void )
+{
+	u8 evt;
+	DISABLE_INT();
+	evt = s_ucRfEvt;
+	s_ucRfEvt = 0;
+	ENABLE_INT();
+	return evt;
+}
+
+//接收状态下的DIO事件：ValidHeader记录数据包正在接收，先听后发据此避让；RxDone把数据包取出放入接收队列；
+//单次接收窗口的RxTimeout使芯片回到待机，由间歇接收任务通过RFRxTimedOut得知
+static void RFRxEvent ( u8 evt )
+{
+	if ( evt & RF_EVT_DIO3 )
+	{
+		s_ucRxHeader = 1;
+		s_iRxHeaderTime = bsp_GetRunTime();
+	}
+	if ( evt & RF_EVT_DIO0 )
+	{
+		RFRxPoll();
+		return;
+	}
+	if ( ( evt & RF_EVT_DIO1 ) && ( s_ucRfState == RF_ST_RXSINGLE ) )
+	{
+		s_ucRfState = RF_ST_STDBY;
+		s_ucRxTimeout = 1;
+	}
+	if ( s_ucRxHeader && ( bsp_CheckRunTime ( s_iRxHeaderTime ) > ( int32_t ) ( RFM96_LoRaAirtimeUs ( PKT_LARGE_SIZE ) / 1000 + 1 ) ) )
+	{
+		s_ucRxHeader = 0; //包头之后没有RxDone(接收被打断)
+	}
+}
+
+//主循环调用：按射频状态处理DIO中断事件，不查询射频模块寄存器和DIO引脚电平。
+//发射和CAD由DIO0事件结束，超时作为故障兜底；先听后发的退避时间到后再次检测信道
+void RFEventPoll ( void )
+{
+	u8 evt = RFEventTake();
+	if ( s_ucRfState == RF_ST_TX )
+	{
+		if ( evt & RF_EVT_DIO0 )
+		{
+			RFTxEnd ( 1 );
+		}
+		else if ( bsp_CheckRunTime ( s_iTxStart ) > s_usTxWait )
+		{
+			RFTxEnd ( 0 ); //没有TxDone，调用者安排射频模块恢复
+		}
+		return;
+	}
+	if ( s_ucRfState == RF_ST_CAD )
+	{
+		s_ucCadEvt |= evt;
+		if ( s_ucCadEvt & RF_EVT_DIO0 )
+		{
+			RFCadEnd ( ( s_ucCadEvt & RF_EVT_DIO1 ) ? 1 : 0 );
+		}
+		else if ( bsp_CheckRunTime ( s_iCadStart ) > ( int32_t ) ( RFM96_LoRaSymbolUs() * RF_CAD_SYMBOLS / 1000 + 1 ) )
+		{
+			RFCadEnd ( 0 );
+		}
+		return;
+	}
+	if ( ( s_ucRfState == RF_ST_RXCONT ) || ( s_ucRfState == RF_ST_RXSINGLE ) )
+	{
+		RFRxEvent ( evt );
+	}
+	if ( ( s_usLbtBackoff > 0 ) && ( bsp_CheckRunTime ( s_iLbtWait ) >= s_usLbtBackoff ) )
+	{
+		RFLbtStep();
+	}
+}
+
+//单次接收窗口是否已超时，读取后清除
+u8 RFRxTimedOut ( void )
+{
+	u8 ret = s_ucRxTimeout;
+	s_ucRxTimeout = 0;
+	return ret;
+}
+
+//是否已检测到有效包头、数据包还没收完
+u8 RFRxBusy ( void )
+{
+	return s_ucRxHeader;
+}
+
+//射频模块初始化
 void RFInit ( void )
 {
 	SPI2_Init();
-	RFM96_LoRaEntryRx(); //ģʽ
+	PKT_Init(); //初始化接收数据包缓冲池
+	AIR_Init ( RF_FREQ_KHZ ); //空中时间记录
+	s_ucRxIn = 0;
+	s_ucRxOut = 0;
+	RFM96_Config ( 0 ); //复位芯片后配置，复位时芯片按缺省频率434MHz(与工作频率相同)完成镜像校准
+	RFM96_LoRaEntryRx(); //进入接收模式
+	s_ucRfState = RF_ST_RXCONT;
 }
 
-//Ƶģģʽ
+//射频模块进入接收模式；间歇接收时改为睡眠，由RFRxWindow在下一个广播包前打开接收窗口
+//已处于目标状态时不重复配置：连续接收模式下收完一包芯片仍在接收，不需要复位芯片重新进入
+//已准备发射、正在发射或CAD时不执行，结束后由RFEventPoll回到接收
 void RFRxMode ( void )
 {
-	RFM96_LoRaEntryRx(); //ģʽ
+	if ( ( s_ucRfState == RF_ST_TXREADY ) || ( s_ucRfState == RF_ST_TX ) || ( s_ucRfState == RF_ST_CAD ) )
+	{
+		return;
+	}
+	if ( RXD_Active() )
+	{
+		if ( s_ucRfState != RF_ST_SLEEP )
+		{
+			RFM96_Sleep();
+			s_ucRfState = RF_ST_SLEEP;
+		}
+		return;
+	}
+	if ( s_ucRfState != RF_ST_RXCONT )
+	{
+		RFM96_LoRaEntryRx(); //进入接收模式
+		s_ucRfState = RF_ST_RXCONT;
+	}
+}
+
+//间歇接收：打开一次单次接收窗口，超时未检测到前导码时芯片置RxTimeout并自动回到待机。RFTxBusy时调用者不应调用
+void RFRxWindow ( void )
+{
+	s_ucRxTimeout = 0;
+	s_ucRxHeader = 0;
+	RFM96_LoRaEntryRxSingle ( RXD_WindowSymbols() );
+	s_ucRfState = RF_ST_RXSINGLE;
+}
+
+//RFEventPoll收到DIO0(RxDone)时调用：立即把数据包从FIFO取出放入接收队列，
+//连续接收模式下芯片继续接收下一包，单次接收结束后芯片已回到待机，由任务处理后调用RFRxMode
+void RFRxPoll ( void )
+{
+	PKT_BUF_T *pkt;
+	u8 next;
+	s_ucRxHeader = 0;
+	pkt = RFRevPacket();
+	if ( s_ucRfState == RF_ST_RXSINGLE )
+	{
+		s_ucRfState = RF_ST_STDBY;
+	}
+	if ( pkt == 0 )
+	{
+		return;
+	}
+	next = ( s_ucRxIn + 1 ) % RF_RXQ_NUM;
+	if ( next == s_ucRxOut ) //队列满，丢弃新包，已排队的数据包先到先处理
+	{
+		PKT_Free ( pkt );
+		iRxLost++;
+		return;
+	}
+	s_pRxQueue[s_ucRxIn] = pkt;
+	s_ucRxIn = next;
 }
 
-//Ƶģ
-u8 RFRevData ( u8 *buf )
+//从接收队列取出一个数据包，队列空时返回0。用完后调用PKT_Free归还缓冲区
+PKT_BUF_T *RFRxGet ( void )
+{
+	PKT_BUF_T *pkt;
+	if ( s_ucRxOut == s_ucRxIn )
+	{
+		return 0;
+	}
+	pkt = s_pRxQueue[s_ucRxOut];
+	s_ucRxOut = ( s_ucRxOut + 1 ) % RF_RXQ_NUM;
+	return pkt;
+}
+
+//射频模块接收数据到调用者的缓冲区，数据包比缓冲区长时丢弃
+u8 RFRevData ( u8 *buf, u8 size )
 {
 	u8 length = 0;
-	if ( GPIO_ReadInputDataBit ( GPIOA, RF_IRQ_PIN ) ) //յݸߵƽж
+	if ( GPIO_ReadInputDataBit ( GPIOA, RF_IRQ_PIN ) ) //收到数据高电平中断
 	{
 //		OLEDPrint(0, 0, "RF Received");
-		length = RFM96_LoRaRxPacket ( revBuf );
+		length = RFM96_LoRaRxPacket ( buf, size );
 		RFRxMode();
 	}
 	if ( length > 0 )
 	{
 		iRev++;
-	} //ݸ
+	} //接收数据个数
 	return ( length );
 }
-//Ƶģ鷢
-u8 RFSendData ( u8 *buf, u8 size )
+
+//按包头判断本节点是否需要该数据包：主机广播包，中继节点另收远端节点'^'封装的数据帧
+//网络中其他节点的上行数据最多，在这里丢弃，不读整个数据包
+static u8 RFPacketWanted ( const u8 *hdr, u8 n )
+{
+	if ( ( n >= 4 ) && ( hdr[0] == '$' ) && ( hdr[1] == '#' ) && ( hdr[2] == 'S' ) && ( hdr[3] == 'T' ) )
+	{
+		return 1;
+	}
+#if RELAY_EN == 1
+	if ( ( n >= 1 ) && ( hdr[0] == '^' ) )
+	{
+		return 1;
+	}
+#endif
+	return 0;
+}
+
+//射频模块接收数据到缓冲池：先读包头，不需要的数据包直接丢弃；
+//需要时按包长申请缓冲区，FIFO剩余数据直接读入，缓冲区交给调用者，用完后调用PKT_Free归还
+//没有数据包、数据包被丢弃或没有空闲缓冲区时返回0
+PKT_BUF_T *RFRevPacket ( void )
 {
-	int ret = 0;
-	ret = RFM96_LoRaEntryTx ( size ); //طֽ
-	ret = RFM96_LoRaTxPacket ( buf, size ); //طֽ
-	bsp_DelayMS ( 5 );
-	RFRxMode(); //ģʽ
+	PKT_BUF_T *pkt;
+	u8 hdr[RF_PEEK_LEN];
+	u8 length, n, i;
+	length = RFM96_LoRaRxBegin();
+	if ( length == 0 )
+	{
+		return 0;
+	}
+	n = RFM96_LoRaRxPeek ( hdr, RF_PEEK_LEN );
+	if ( RFPacketWanted ( hdr, n ) == 0 )
+	{
+		RFM96_LoRaClearIrq(); //丢弃该包
+		iRxDrop++;
+		return 0;
+	}
+	pkt = PKT_Alloc ( length );
+	if ( pkt == 0 )
+	{
+		RFM96_LoRaClearIrq(); //丢弃该包
+		return 0;
+	}
+	for ( i = 0; i < n; i++ )
+	{
+		pkt->data[i] = hdr[i];
+	}
+	RFM96_LoRaRxRead ( pkt->data, length ); //只读包头之后的部分
+	pkt->len = length;
+	pkt->snr = gPktSnr;
+	pkt->rssi = gPktRssi;
+	pkt->time = bsp_GetRunTime();
+	iRev++; //接收数据个数
+	return pkt;
+}
+//射频模块发射数据，立即返回，结果由_done回调通知(见RF_TX_DONE)，发射准备校验失败时立即回调
+//实测发射时间记入空中时间记录，调用者发送前应先用AIR_CanSend检查占空比预算
+void RFSendData ( u8 *buf, u8 size, RF_TX_DONE _done )
+{
+	if ( RFTxBusy() )
+	{
+		if ( _done ) { _done ( RF_LBT_BUSY ); }
+		return;
+	}
+	if ( RFTxStage ( buf, size ) == 0 )
+	{
+		if ( _done ) { _done ( 0 ); }
+		return;
+	}
+	RFTxFire ( _done );
+}
+
+//提前准备发射：配置发射寄存器并把数据写入发射FIFO，芯片停在待机，到时隙时调用RFTxFire
+//准备失败时回到接收模式并返回0。准备好到发射之间射频不接收
+u8 RFTxStage ( u8 *buf, u8 size )
+{
+	u8 ret;
+	ret = RFM96_LoRaTxStage ( buf, size ); //返回发送字节数，寄存器回读校验失败返回0
+	s_ucRfState = RF_ST_STDBY; //发射准备切到待机
+	if ( ret == 0 )
+	{
+		RFRxMode();
+	}
+	else
+	{
+		s_ucRfState = RF_ST_TXREADY; //发射前处理收到的数据包时不回到接收，否则发射寄存器和FIFO指针被改写
+	}
+	return ret;
+}
+
+//发射RFTxStage准备好的数据：只写一次RegOpMode即开始发射并返回，发射开始时刻不受数据帧生成和寄存器配置耗时影响。
+//TxDone(DIO0)中断后由RFEventPoll结束发射、回到接收并回调_done；超过空中时间加 RF_TX_MARGIN_MS 仍没有TxDone时回调0
+void RFTxFire ( RF_TX_DONE _done )
+{
+	u8 len;
+	RFEventTake(); //丢弃准备期间的DIO事件
+	len = RFM96_LoRaTxFire(); //返回发送字节数
+	if ( len == 0 )
+	{
+		s_ucRfState = RF_ST_STDBY;
+		RFRxMode();
+		if ( _done ) { _done ( 0 ); }
+		return;
+	}
+	s_pTxDone = _done;
+	s_ucTxLen = len;
+	s_iTxStart = bsp_GetRunTime();
+	s_usTxWait = RFM96_LoRaAirtimeUs ( len ) / 1000 + RF_TX_MARGIN_MS;
+	s_ucRfState = RF_ST_TX;
+}
+
+//发射结束：ok为1表示收到TxDone。超时也已发射，同样记入空中时间
+static void RFTxEnd ( u8 ok )
+{
+	RF_TX_DONE done = s_pTxDone;
+	int32_t ms = ok ? ( s_iDio0Time - s_iTxStart ) : ( int32_t ) s_usTxWait;
+	RFM96_LoRaTxEnd();
+	gTxTimeUs = ( u32 ) ( ms + 1 ) * 1000; //毫秒计时，偏大不超过1ms
+	AIR_Record ( gTxTimeUs );
+	s_pTxDone = 0;
+	s_ucRfState = RF_ST_STDBY;
+	RFRxMode(); //进入接收模式
+	if ( ok )
+	{
+		iSend++; //发送数据个数
+		s_ucTxSent = 1;
+	}
+	if ( done )
+	{
+		done ( ok ? s_ucTxLen : 0 );
+	}
+}
+
+//是否正在发射：发射数据已准备好、正在发射或先听后发尚未结束，此时不能再发射或切换射频模式
+u8 RFTxBusy ( void )
+{
+	return ( s_ucRfState == RF_ST_TXREADY ) || ( s_ucRfState == RF_ST_TX ) || ( s_ucRfState == RF_ST_CAD )
+	       || ( s_ucLbtLen > 0 );
+}
+
+//读取并清除发射标志：返回1表示上次调用之后本节点发射过LoRa数据包，用于判断主机的上行反馈是否针对本节点
+u8 RFTxSentTake ( void )
+{
+	u8 sent = s_ucTxSent;
+	s_ucTxSent = 0;
+	return sent;
+}
+
+//信道检测：已检测到正在接收的数据包包头时直接认为信道忙；连续接收模式下多次采样RSSI，任一次高于门限即认为忙。
+//返回0时还要由CAD检测低于噪底、RSSI看不出来的远端LoRa前导码，见RFLbtStep。返回1表示信道忙
+u8 RFChannelBusy ( void )
+{
+	u8 i;
+	if ( s_ucRxHeader )
+	{
+		return 1;
+	}
+	if ( s_ucRfState == RF_ST_RXCONT )
+	{
+		for ( i = 0; i < RF_LBT_SAMPLES; i++ )
+		{
+			if ( RFM96_LoRaReadRssi() > RF_LBT_RSSI_THRESH )
+			{
+				return 1;
+			}
+			bsp_DelayUS ( 100 );
+		}
+	}
+	return 0;
+}
+
+//先听后发结束：清除等待发射的数据并回调
+static void RFLbtEnd ( int ret )
+{
+	RF_TX_DONE done = s_pTxDone;
+	s_pTxDone = 0;
+	s_ucLbtLen = 0;
+	if ( done )
+	{
+		done ( ret );
+	}
+}
+
+//信道忙：回到接收，随机退避后由RFEventPoll再检测；到截止时间仍忙则放弃
+static void RFLbtBackoff ( void )
+{
+	int32_t left;
+	u16 backoff;
+	RFRxMode(); //CAD后芯片在待机，退避期间恢复接收，下次检测才能看到包头和RSSI
+	left = ( int32_t ) s_usLbtDeadline - bsp_CheckRunTime ( s_iLbtStart );
+	if ( left <= 0 )
+	{
+		iLbtBusy++;
+		RFLbtEnd ( RF_LBT_BUSY );
+		return;
+	}
+	backoff = 1 + rand_u32() % RF_LBT_BACKOFF_MS;
+	s_usLbtBackoff = ( backoff < left ) ? backoff : ( u16 ) left;
+	s_iLbtWait = bsp_GetRunTime();
+}
+
+//先听后发的一次检测：包头和RSSI都空闲时进入CAD模式，CadDone(DIO0)中断后由RFEventPoll继续
+static void RFLbtStep ( void )
+{
+	s_usLbtBackoff = 0;
+	if ( RFChannelBusy() )
+	{
+		RFLbtBackoff();
+		return;
+	}
+	s_ucRxHeader = 0;
+	s_ucCadEvt = 0;
+	RFEventTake();
+	RFM96_LoRaEntryCad();
+	s_iCadStart = bsp_GetRunTime();
+	s_ucRfState = RF_ST_CAD;
+}
+
+//CAD结束：CadDone(DIO0)时有CadDetected(DIO1)则信道忙；超时未完成时按信道空闲处理。CAD结束后芯片处于待机
+static void RFCadEnd ( u8 busy )
+{
+	RF_TX_DONE done = s_pTxDone;
+	u8 len = s_ucLbtLen;
+	s_ucRfState = RF_ST_STDBY;
+	if ( busy )
+	{
+		RFLbtBackoff();
+		return;
+	}
+	s_pTxDone = 0;
+	s_ucLbtLen = 0;
+	RFSendData ( s_ucLbtBuf, len, done );
+}
+
+//先听后发：复制数据后立即返回。信道空闲时发射；信道忙时随机退避后再检测，直到deadline毫秒后放弃。
+//用于入网请求等竞争发送的数据，固定时隙内的数据直接调用RFSendData。
+//结果由_done回调通知：RF_LBT_BUSY表示信道一直忙或射频正忙未发射，其余同RFSendData
+void RFSendDataLBT ( u8 *buf, u8 size, u16 deadline, RF_TX_DONE _done )
+{
+	if ( RFTxBusy() || ( size > RF_LBT_LEN_MAX ) )
+	{
+		if ( _done ) { _done ( RF_LBT_BUSY ); }
+		return;
+	}
+	memcpy ( s_ucLbtBuf, buf, size );
+	s_ucLbtLen = size;
+	s_usLbtDeadline = deadline;
+	s_iLbtStart = bsp_GetRunTime();
+	s_pTxDone = _done;
+	RFLbtStep();
+}
+
+//DIO1(PC6)中断的触发沿：LoRa模式用上升沿(RxTimeout/CadDetected)，FSK发射用下降沿(FIFO降到门限以下)
+static void RFDio1Edge ( EXTITrigger_TypeDef trig )
+{
+	EXTI_InitTypeDef EXTI_InitStructure;
+	EXTI_InitStructure.EXTI_Line = EXTI_Line6;
+	EXTI_InitStructure.EXTI_Mode = EXTI_Mode_Interrupt;
+	EXTI_InitStructure.EXTI_Trigger = trig;
+	EXTI_InitStructure.EXTI_LineCmd = ENABLE;
+	EXTI_Init ( &EXTI_InitStructure );
+}
+
+//切换到FSK模式，用于主机分配的批量传输窗口。窗口内不接收LoRa数据包，结束时调用RFFskEnd
+void RFFskBegin ( u8 rate )
+{
+	RFM96_FskEntry ( rate );
+	RFDio1Edge ( EXTI_Trigger_Falling );
+	s_ucRfState = RF_ST_STDBY;
+}
+
+//FSK模式发射一个数据包。DIO1下降沿事件时再填入一块，DIO0(PacketSent)事件表示发射完成，
+//等待事件期间CPU休眠，由中断唤醒。发射时间同样记入空中时间记录。返回0表示等待PacketSent超时
+u8 RFFskSend ( u8 *buf, u8 size )
+{
+	u8 sent, evt, ret = 0;
+	int32_t start;
+	int32_t wait = ( int32_t ) ( RFM96_FskAirtimeUs ( size ) / 1000 ) + RF_FSK_TIMEOUT_MARGIN_MS;
+	if ( size == 0 )
+	{ return 0; }
+	RFEventTake(); //丢弃上一个数据包留下的事件
+	sent = RFM96_FskTxStart ( buf, size );
+	start = bsp_GetRunTime();
+	while ( bsp_CheckRunTime ( start ) <= wait )
+	{
+		evt = RFEventTake();
+		if ( evt & RF_EVT_DIO0 )
+		{
+			ret = size;
+			break;
+		}
+		if ( ( evt & RF_EVT_DIO1 ) && ( sent < size ) )
+		{
+			sent = RFM96_FskTxFill ( buf, size, sent );
+			continue;
+		}
+		DISABLE_INT(); //关中断后检查事件再休眠，事件在检查之后到达时WFI立即返回
+		if ( s_ucRfEvt == 0 )
+		{ __WFI(); }
+		ENABLE_INT();
+	}
+	RFM96_FskTxEnd();
+	gTxTimeUs = RFM96_FskAirtimeUs ( size );
+	AIR_Record ( gTxTimeUs );
 	if ( ret > 0 )
 	{
 		iSend++;
-	}    //ݸ
-	return ( ret ); //ɹ0ֵ
+	}
+	return ret;
+}
+
+//结束FSK窗口回到LoRa：FSK配置改写了两种模式共用的寄存器，复位芯片后重新配置并进入接收模式
+void RFFskEnd ( void )
+{
+	RFM96_FskExit();
+	RFDio1Edge ( EXTI_Trigger_Rising );
+	RFEventTake(); //丢弃FSK模式下的DIO事件
+	RFM96_Config ( 0 );
+	RFM96_LoRaEntryRx();
+	s_ucRfState = RF_ST_RXCONT;
+	RFRxMode(); //间歇接收时转入睡眠
+}
+
+//射频模块恢复：重新初始化SPI2并复位、配置SX1278后进入接收模式
+void RFRecover ( void )
+{
+	SPI2_Init();
+	RFM96_Config ( 0 );
+	RFM96_LoRaEntryRx();
+	s_ucRfState = RF_ST_RXCONT;
+	s_pTxDone = 0; //放弃未完成的发射和先听后发
+	s_ucLbtLen = 0;
+	s_usLbtBackoff = 0;
+	iRecover++;
+}
+
+//温度监测：读芯片温度，与上次镜像校准时的温度相差 RF_TEMP_CAL_DELTA 以上时按当前频率重新校准，恢复接收灵敏度。
+//读温度约0.3ms、校准约10ms，期间不接收。单次接收窗口中、正在收包或RFTxBusy时不执行，返回0
+//返回1表示已检查温度，结束后按间歇接收状态回到接收或睡眠
+u8 RFTempCheck ( void )
+{
+	int16_t diff;
+	if ( ( s_ucRfState == RF_ST_RXSINGLE ) || s_ucRxHeader || RFTxBusy() )
+	{
+		return 0;
+	}
+	gRfTemp = RFM96_ReadTemp();
+	diff = gRfTemp - RFM96_CalTemp();
+	if ( ( diff >= RF_TEMP_CAL_DELTA ) || ( diff <= -RF_TEMP_CAL_DELTA ) )
+	{
+		RFM96_ImageCal();
+		iImageCal++;
+	}
+	RFEventTake(); //丢弃切换模式时DIO引脚的跳变
+	s_ucRfState = RF_ST_STDBY;
+	RFRxMode();
+	return 1;
 }
 
 
@@ -2,19 +2,59 @@
 #define	__BSP_RF_H__
 #include "bsp.h"
 #define RF_SX1278
+#define RF_FREQ_KHZ         434000  //工作频率，与 RFM96FreqTbl 一致，用于选择占空比子频段
+
+#define RF_LBT_RSSI_THRESH  (-95)   //信道检测门限，单位dBm，高于此值认为信道忙
+#define RF_LBT_SAMPLES      4       //每次信道检测的RSSI采样次数，取最大值
+#define RF_LBT_BACKOFF_MS   8       //信道忙时随机退避 1 ~ RF_LBT_BACKOFF_MS 毫秒后再检测
+#define RF_LBT_BUSY         (-1)    //发射结束回调的结果：截止时间内信道一直忙或射频正忙，未发射
+#define RF_PEEK_LEN         4       //收包时先读出的包头字节数，用于判断是否需要该数据包
+#define RF_CAD_SYMBOLS      4       //CAD约2个符号，等待CadDone的上限按此符号数计算
+#define RF_LBT_LEN_MAX      80      //先听后发的数据包最大长度，检测期间数据保存在驱动中
+#define RF_TX_MARGIN_MS     10      //等待TxDone的上限 = 空中时间 + 此余量
+#define RF_RXQ_NUM          4       //接收队列长度，可排队 RF_RXQ_NUM-1 个数据包，受缓冲池 PKT_BUF_NUM 限制
+#define RF_TEMP_PERIOD_MS   60000   //温度监测周期
+#define RF_TEMP_CAL_DELTA   8       //芯片温度与上次镜像校准时相差不小于此值(℃)时重新校准
 
 extern const char *rfName;
 extern u16	iSend, iRev;
+extern u16	iRecover;
+extern u16	iLbtBusy;
+extern u16	iRxDrop;
+extern u16	iRxLost;
+extern u16	iImageCal;
+extern int16_t	gRfTemp;
 
 extern u8	sendBuf[64];
-extern u8	revBuf[128];
+
+//发射结束回调，在主循环的RFEventPoll中调用。_ret: 发射的字节数；0 发射准备校验失败或等待TxDone超时，
+//调用者应安排射频模块恢复；RF_LBT_BUSY 信道一直忙或射频正忙，未发射
+typedef void ( *RF_TX_DONE ) ( int _ret );
 
 void SPI2_Init(void);
-u8 RFSendData(u8 *buf, u8 size);
-u8 RFRevData(u8 *buf);
+void RFSendData(u8 *buf, u8 size, RF_TX_DONE _done);
+u8 RFTxStage(u8 *buf, u8 size);
+void RFTxFire(RF_TX_DONE _done);
+u8 RFTxBusy(void);
+u8 RFTxSentTake(void);
+u8 RFChannelBusy(void);
+void RFSendDataLBT(u8 *buf, u8 size, u16 deadline, RF_TX_DONE _done);
+u8 RFRevData(u8 *buf, u8 size);
+PKT_BUF_T *RFRevPacket(void);
+void RFEventPoll(void);
+void RFRxPoll(void);
+u8 RFRxTimedOut(void);
+u8 RFRxBusy(void);
+PKT_BUF_T *RFRxGet(void);
 
 void RFGPIOInit(void);
 void RFRxMode(void);
+void RFRxWindow(void);
 void RFInit(void);
+void RFRecover(void);
+void RFFskBegin(u8 rate);
+u8 RFFskSend(u8 *buf, u8 size);
+void RFFskEnd(void);
+u8 RFTempCheck(void);
 //u8 rfContinueSend(void);
 #endif
@@ -0,0 +1,286 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 单生产者单消费者环形缓冲区
+*   文件名称 : bsp_ring.c
+*   版    本 : V1.0
+*   说    明 : 无锁环形缓冲区，读写指针自由递增，下标用掩码得到。规则见 bsp_ring.h。
+*             不依赖任何外设，可以直接在PC上编译。
+*
+*********************************************************************************************************
+*/
+#include <string.h>
+#include "bsp_ring.h"
+
+/* 消费者取得未读字节数。超过容量时数据已被覆盖，丢弃全部未读数据 */
+static uint16_t ring_Used(RING_T *_pRing)
+{
+    uint16_t usWrite = _pRing->usWrite;
+    uint16_t usUsed = (uint16_t)(usWrite - _pRing->usRead);
+
+    if (usUsed > (uint16_t)(_pRing->usMask + 1))
+    {
+        _pRing->usRead = usWrite;
+        return 0;
+    }
+    RING_BARRIER();     /* 先看到写指针，再读数据 */
+    return usUsed;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RING_Init
+*   功能说明: 初始化环形缓冲区为空
+*   形    参: _pRing : 环形缓冲区
+*             _pBuf : 缓冲区
+*             _usSize : 缓冲区大小，必须是2的整数次幂，最大 32768
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void RING_Init(RING_T *_pRing, uint8_t *_pBuf, uint16_t _usSize)
+{
+    _pRing->pBuf = _pBuf;
+    _pRing->usMask = _usSize - 1;
+    _pRing->usWrite = 0;
+    _pRing->usRead = 0;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RING_Count
+*   功能说明: 未读字节数，生产者和消费者都可以调用。已被覆盖时返回容量
+*   形    参: _pRing : 环形缓冲区
+*   返 回 值: 未读字节数
+*********************************************************************************************************
+*/
+uint16_t RING_Count(const RING_T *_pRing)
+{
+    uint16_t usUsed = (uint16_t)(_pRing->usWrite - _pRing->usRead);
+
+    return (usUsed > (uint16_t)(_pRing->usMask + 1)) ? (uint16_t)(_pRing->usMask + 1) : usUsed;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RING_Free
+*   功能说明: 剩余空间字节数
+*   形    参: _pRing : 环形缓冲区
+*   返 回 值: 可以写入的字节数
+*********************************************************************************************************
+*/
+uint16_t RING_Free(const RING_T *_pRing)
+{
+    return (uint16_t)(_pRing->usMask + 1 - RING_Count(_pRing));
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RING_PutByte
+*   功能说明: 写入1个字节，由生产者调用
+*   形    参: _pRing : 环形缓冲区
+*             _ucByte : 数据
+*   返 回 值: 1 写入成功，0 缓冲区已满
+*********************************************************************************************************
+*/
+uint8_t RING_PutByte(RING_T *_pRing, uint8_t _ucByte)
+{
+    uint16_t usWrite = _pRing->usWrite;
+
+    if ((uint16_t)(usWrite - _pRing->usRead) > _pRing->usMask)
+    {
+        return 0;
+    }
+    _pRing->pBuf[usWrite & _pRing->usMask] = _ucByte;
+    RING_BARRIER();     /* 数据写入后才能移动写指针 */
+    _pRing->usWrite = usWrite + 1;
+    return 1;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RING_Write
+*   功能说明: 写入一块数据，由生产者调用。回绕时分两段复制，最后移动一次写指针
+*   形    参: _pRing : 环形缓冲区
+*             _pData : 数据
+*             _usLen : 数据长度
+*   返 回 值: 写入的字节数，空间不足时只写入能放下的部分
+*********************************************************************************************************
+*/
+uint16_t RING_Write(RING_T *_pRing, const uint8_t *_pData, uint16_t _usLen)
+{
+    uint16_t usWrite = _pRing->usWrite;
+    uint16_t usIdx = usWrite & _pRing->usMask;
+    uint16_t usFree = (uint16_t)(_pRing->usMask + 1 - (uint16_t)(usWrite - _pRing->usRead));
+    uint16_t usTail = _pRing->usMask + 1 - usIdx;
+
+    if (_usLen > usFree)
+    {
+        _usLen = usFree;
+    }
+    if (_usLen <= usTail)
+    {
+        memcpy(&_pRing->pBuf[usIdx], _pData, _usLen);
+    }
+    else
+    {
+        memcpy(&_pRing->pBuf[usIdx], _pData, usTail);
+        memcpy(_pRing->pBuf, _pData + usTail, _usLen - usTail);
+    }
+    RING_BARRIER();
+    _pRing->usWrite = usWrite + _usLen;
+    return _usLen;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RING_Produce
+*   功能说明: 数据已由其他途径(DMA)写入缓冲区，移动写指针，由生产者调用
+*   形    参: _pRing : 环形缓冲区
+*             _usLen : 新写入的字节数
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void RING_Produce(RING_T *_pRing, uint16_t _usLen)
+{
+    RING_BARRIER();
+    _pRing->usWrite = _pRing->usWrite + _usLen;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RING_GetByte
+*   功能说明: 读取1个字节，由消费者调用
+*   形    参: _pRing : 环形缓冲区
+*             _pByte : 存放读取数据的指针
+*   返 回 值: 0 表示无数据  1表示读取到数据
+*********************************************************************************************************
+*/
+uint8_t RING_GetByte(RING_T *_pRing, uint8_t *_pByte)
+{
+    uint16_t usRead;
+
+    if (ring_Used(_pRing) == 0)
+    {
+        return 0;
+    }
+    usRead = _pRing->usRead;
+    *_pByte = _pRing->pBuf[usRead & _pRing->usMask];
+    RING_BARRIER();     /* 数据取出后才能释放空间 */
+    _pRing->usRead = usRead + 1;
+    return 1;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RING_Read
+*   功能说明: 读取一块数据，由消费者调用。回绕时分两段复制，最后移动一次读指针
+*   形    参: _pRing : 环形缓冲区
+*             _pBuf : 存放读取数据的缓冲区
+*             _usLen : 最多读取的字节数
+*   返 回 值: 读取的字节数，0 表示无数据
+*********************************************************************************************************
+*/
+uint16_t RING_Read(RING_T *_pRing, uint8_t *_pBuf, uint16_t _usLen)
+{
+    uint16_t usUsed = ring_Used(_pRing);
+    uint16_t usRead = _pRing->usRead;
+    uint16_t usIdx = usRead & _pRing->usMask;
+    uint16_t usTail = _pRing->usMask + 1 - usIdx;
+
+    if (_usLen > usUsed)
+    {
+        _usLen = usUsed;
+    }
+    if (_usLen <= usTail)
+    {
+        memcpy(_pBuf, &_pRing->pBuf[usIdx], _usLen);
+    }
+    else
+    {
+        memcpy(_pBuf, &_pRing->pBuf[usIdx], usTail);
+        memcpy(_pBuf + usTail, _pRing->pBuf, _usLen - usTail);
+    }
+    RING_BARRIER();
+    _pRing->usRead = usRead + _usLen;
+    return _usLen;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RING_ReadSpan
+*   功能说明: 取从读指针开始到缓冲区末尾为止的连续未读数据，不移动读指针，由消费者调用。
+*             用于DMA发送，发完后调用 RING_Consume
+*   形    参: _pRing : 环形缓冲区
+*             _ppData : 返回连续数据的起始地址
+*   返 回 值: 连续数据的字节数，0 表示无数据
+*********************************************************************************************************
+*/
+uint16_t RING_ReadSpan(RING_T *_pRing, uint8_t **_ppData)
+{
+    uint16_t usUsed = ring_Used(_pRing);
+    uint16_t usIdx = _pRing->usRead & _pRing->usMask;
+    uint16_t usTail = _pRing->usMask + 1 - usIdx;
+
+    *_ppData = &_pRing->pBuf[usIdx];
+    return (usUsed < usTail) ? usUsed : usTail;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RING_Consume
+*   功能说明: 释放已经处理完的数据，移动读指针，由消费者调用
+*   形    参: _pRing : 环形缓冲区
+*             _usLen : 字节数，不能超过未读字节数
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void RING_Consume(RING_T *_pRing, uint16_t _usLen)
+{
+    RING_BARRIER();
+    _pRing->usRead = _pRing->usRead + _usLen;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RING_Flush
+*   功能说明: 丢弃全部未读数据，由消费者调用
+*   形    参: _pRing : 环形缓冲区
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void RING_Flush(RING_T *_pRing)
+{
+    _pRing->usRead = _pRing->usWrite;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RING_Peek
+*   功能说明: 取全部未读数据在缓冲区中的位置(最多两段)，不复制也不移动读指针，由消费者调用。
+*             调用者直接在缓冲区中解析，处理完的字节数用 RING_Consume 释放。
+*             RING_Consume 之前生产者不会改写这些数据；DMA循环接收时未读数据不能超过缓冲区大小
+*   形    参: _pRing : 环形缓冲区
+*             _pSpan : 返回两段数据的地址和长度
+*   返 回 值: 未读字节数(两段之和)
+*********************************************************************************************************
+*/
+uint16_t RING_Peek(RING_T *_pRing, RING_SPAN_T *_pSpan)
+{
+    uint16_t usUsed = ring_Used(_pRing);
+    uint16_t usIdx = _pRing->usRead & _pRing->usMask;
+    uint16_t usTail = _pRing->usMask + 1 - usIdx;
+
+    _pSpan->pData[0] = &_pRing->pBuf[usIdx];
+    _pSpan->pData[1] = _pRing->pBuf;
+    if (usUsed <= usTail)
+    {
+        _pSpan->usLen[0] = usUsed;
+        _pSpan->usLen[1] = 0;
+    }
+    else
+    {
+        _pSpan->usLen[0] = usTail;
+        _pSpan->usLen[1] = usUsed - usTail;
+    }
+    return usUsed;
+}
@@ -0,0 +1,66 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 单生产者单消费者环形缓冲区
+*   文件名称 : bsp_ring.h
+*   版    本 : V1.0
+*   说    明 : 头文件。串口收发FIFO使用的无锁环形缓冲区。
+*
+*   一个缓冲区只有一个生产者和一个消费者(例如主程序写、中断读)，写指针只由生产者修改，读指针只由
+*   消费者修改，双方都不需要关中断。读写指针是自由递增的16位计数，不在缓冲区末尾回零：
+*     未读字节数 = usWrite - usRead (16位无符号回绕)，下标 = 指针 & usMask
+*   因此容量必须是2的整数次幂，且不超过 32768 字节。
+*   生产者先写数据再移动写指针，消费者先取数据再移动读指针，中间用 RING_BARRIER() 阻止编译器重排。
+*   Cortex-M3 单核访问普通内存不会乱序，不需要 DMB 指令。
+*
+*   DMA循环接收时生产者(DMA)不检查剩余空间，未读数据超过容量说明最早的数据已被覆盖，
+*   消费者读取时丢弃全部未读数据。
+*
+*********************************************************************************************************
+*/
+#ifndef __BSP_RING_H
+#define __BSP_RING_H
+
+#include "stdint.h"
+
+#if defined(__CC_ARM)
+    #define RING_BARRIER()      __memory_changed()
+#elif defined(__GNUC__)
+    #define RING_BARRIER()      __asm volatile ("" : : : "memory")
+#else
+    #define RING_BARRIER()
+#endif
+
+typedef struct
+{
+    uint8_t *pBuf;                  /* 缓冲区 */
+    uint16_t usMask;                /* 容量 - 1 */
+    volatile uint16_t usWrite;      /* 写指针，只由生产者修改 */
+    volatile uint16_t usRead;       /* 读指针，只由消费者修改 */
+} RING_T;
+
+/* 未读数据在缓冲区中最多分成两段，第二段从缓冲区开头开始 */
+typedef struct
+{
+    uint8_t *pData[2];
+    uint16_t usLen[2];              /* 没有回绕时 usLen[1] 为0 */
+} RING_SPAN_T;
+
+void RING_Init(RING_T *_pRing, uint8_t *_pBuf, uint16_t _usSize);
+uint16_t RING_Count(const RING_T *_pRing);
+uint16_t RING_Free(const RING_T *_pRing);
+
+/* 生产者调用 */
+uint8_t RING_PutByte(RING_T *_pRing, uint8_t _ucByte);
+uint16_t RING_Write(RING_T *_pRing, const uint8_t *_pData, uint16_t _usLen);
+void RING_Produce(RING_T *_pRing, uint16_t _usLen);
+
+/* 消费者调用 */
+uint8_t RING_GetByte(RING_T *_pRing, uint8_t *_pByte);
+uint16_t RING_Read(RING_T *_pRing, uint8_t *_pBuf, uint16_t _usLen);
+uint16_t RING_ReadSpan(RING_T *_pRing, uint8_t **_ppData);
+uint16_t RING_Peek(RING_T *_pRing, RING_SPAN_T *_pSpan);
+void RING_Consume(RING_T *_pRing, uint16_t _usLen);
+void RING_Flush(RING_T *_pRing);
+
+#endif
@@ -0,0 +1,148 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 广播包对齐的间歇接收
+*   文件名称 : bsp_rxduty.c
+*   版    本 : V1.0
+*   说    明 : 原来射频一直处于连续接收模式，接收电流约11.5mA，是节点待机能耗的主要部分。
+*             连续两次测得相同的广播间隔后锁定周期，此后射频在本节点的收发完成后进入睡眠，
+*             在预计的下一个广播包开始前 RXD_EARLY_MS 进入单次接收，符号超时只覆盖前后各 RXD_EARLY_MS，
+*             没有检测到前导码时芯片自动回到待机。每收到一个广播包重新对时，不累积晶振误差。
+*             连续错过 RXD_MISS_MAX 次或未入网时恢复连续接收。中继节点需要接收远端节点数据，不使用此功能。
+*             能耗对比见 Tools/rx_energy_model.c。
+*
+*********************************************************************************************************
+*/
+#include "bsp.h"
+
+static int32_t s_iBcnStart;         /* 最近一个广播包的开始时刻，单位ms */
+static int32_t s_iPeriod;           /* 广播周期，0 表示未知 */
+static uint8_t s_ucHave;            /* 1: s_iBcnStart 有效 */
+static uint8_t s_ucLock;            /* 1: 周期已锁定 */
+static uint8_t s_ucMiss;            /* 连续错过的广播包数 */
+
+/*
+*********************************************************************************************************
+*   函 数 名: RXD_Init
+*   功能说明: 清除广播周期，恢复连续接收
+*   形    参: 无
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void RXD_Init(void)
+{
+    s_iPeriod = 0;
+    s_ucHave = 0;
+    s_ucLock = 0;
+    s_ucMiss = 0;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RXD_OnBeacon
+*   功能说明: 收到广播包时调用，测量广播周期并对时。允许中间错过若干个广播包
+*   形    参: _len : 广播包长度，用于由接收完成时刻推算广播包开始时刻
+*             _time : 接收完成时刻(bsp_GetRunTime)
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void RXD_OnBeacon(uint8_t _len, int32_t _time)
+{
+    int32_t start = _time - (int32_t)(RFM96_LoRaAirtimeUs(_len) / 1000);
+    int32_t diff, k;
+
+    if (s_ucHave)
+    {
+        diff = start - s_iBcnStart;
+        k = (s_iPeriod > 0) ? (diff + s_iPeriod / 2) / s_iPeriod : 0;
+        if ((k >= 1) && (diff - k * s_iPeriod <= RXD_PERIOD_TOL_MS) && (k * s_iPeriod - diff <= RXD_PERIOD_TOL_MS))
+        {
+            s_ucLock = 1;
+        }
+        else
+        {
+            s_iPeriod = diff;   /* 周期改变或首次测量，下一次一致后再锁定 */
+            s_ucLock = 0;
+        }
+    }
+    s_iBcnStart = start;
+    s_ucHave = 1;
+    s_ucMiss = 0;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RXD_Active
+*   功能说明: 是否处于间歇接收状态，此时 RFRxMode() 让射频睡眠而不是进入连续接收
+*   形    参: 无
+*   返 回 值: 1 间歇接收，0 连续接收
+*********************************************************************************************************
+*/
+uint8_t RXD_Active(void)
+{
+#if (RXD_EN == 1) && (RELAY_EN == 0)
+    return (s_ucLock && JOIN_IsJoined()) ? 1 : 0;
+#else
+    return 0;
+#endif
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RXD_WakeDelay
+*   功能说明: 计算从现在到下一次打开接收的时间
+*   形    参: 无
+*   返 回 值: 单位ms，至少为1；不处于间歇接收状态时返回0
+*********************************************************************************************************
+*/
+uint16_t RXD_WakeDelay(void)
+{
+    int32_t ms;
+
+    if (RXD_Active() == 0)
+    {
+        return 0;
+    }
+    ms = s_iBcnStart + s_iPeriod * (s_ucMiss + 1) - RXD_EARLY_MS - bsp_GetRunTime();
+    if (ms < 1)
+    {
+        ms = 1;
+    }
+    else if (ms > 0xFFFE)
+    {
+        ms = 0xFFFE;
+    }
+    return (uint16_t)ms;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RXD_WindowSymbols
+*   功能说明: 单次接收的符号超时，覆盖预计开始时刻前后各 RXD_EARLY_MS，另加检测前导码所需的符号
+*   形    参: 无
+*   返 回 值: 符号数，1 ~ 1023
+*********************************************************************************************************
+*/
+uint16_t RXD_WindowSymbols(void)
+{
+    uint32_t n = (2 * RXD_EARLY_MS * 1000) / RFM96_LoRaSymbolUs() + 8;
+
+    return (n > 1023) ? 1023 : (uint16_t)n;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: RXD_OnMiss
+*   功能说明: 接收窗口超时没有收到广播包。连续错过 RXD_MISS_MAX 次后解除锁定，恢复连续接收
+*   形    参: 无
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void RXD_OnMiss(void)
+{
+    if (++s_ucMiss >= RXD_MISS_MAX)
+    {
+        s_ucLock = 0;
+        s_ucHave = 0;
+    }
+}
@@ -0,0 +1,28 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 广播包对齐的间歇接收
+*   文件名称 : bsp_rxduty.h
+*   版    本 : V1.0
+*   说    明 : 头文件
+*
+*********************************************************************************************************
+*/
+#ifndef __BSP_RXDUTY_H
+#define __BSP_RXDUTY_H
+
+#include "stdint.h"
+
+#define RXD_EN              1       /* 1: 锁定广播周期后只在广播包前后打开接收，其余时间射频睡眠 */
+#define RXD_EARLY_MS        6       /* 在预计的广播包开始前多少ms进入接收，覆盖任务调度和晶振误差 */
+#define RXD_PERIOD_TOL_MS   4       /* 两次广播间隔之差小于此值认为周期稳定 */
+#define RXD_MISS_MAX        3       /* 连续错过几次广播包后恢复连续接收重新同步 */
+
+void RXD_Init(void);
+void RXD_OnBeacon(uint8_t _len, int32_t _time);
+uint8_t RXD_Active(void);
+uint16_t RXD_WakeDelay(void);
+uint16_t RXD_WindowSymbols(void);
+void RXD_OnMiss(void);
+
+#endif
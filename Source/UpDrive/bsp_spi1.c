@@ -1,10 +1,10 @@
 /********************************************************************************************************
 *
-*   ģ : SPI1ĳʼ
-*   ļ : bsp_spi1.c
-*        : V1.0
-*   ˵     : SPI1ΪӲSPIӿڵOLEDʹ
-*   ޸ļ¼ :
+*   模块名称 : SPI1的初始化
+*   文件名称 : bsp_spi1.c
+*   版    本 : V1.0
+*   说    明 : SPI1为硬件SPI接口的OLED使用
+*   修改记录 :
 
 *********************************************************************************************************/
 #include  "bsp.h"
@@ -1,10 +1,10 @@
 /******************** (C) COPYRIGHT tongxinmao.com ***************************
-* ļ		: SPI2.C
-*    		: 
-*   	: 2016.3.8
-* 			: SPI2ļ
-* 汾			: V1.0
-* ʷ¼  	: 
+* 文件名		: SPI2.C
+* 作者   		: 
+* 创建日期  	: 2016.3.8
+* 描述			: SPI2驱动文件
+* 版本			: V1.0
+* 历史记录  	: 暂无
 ********************************************************************************/
 #include "bsp.h"
 #define RF_SX1278
@@ -21,10 +21,10 @@ void SPI2_Init(void)
     GPIO_InitTypeDef GPIO_InitStructure;
     SPI_I2S_DeInit(SPI2);
     RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB, ENABLE );
-    //SPI2ʹõGPIOB
+    //SPI2口使用的是GPIOB
     RCC_APB1PeriphClockCmd(RCC_APB1Periph_SPI2, ENABLE);
     /* Configure SPI2 pins: SCK, MISO and MOSI */
-    GPIO_InitStructure.GPIO_Pin = GPIO_Pin_13 | GPIO_Pin_14 | GPIO_Pin_15;      //PB13ΪSPI2_CLKPB14ΪSPI2_MISOPB15ΪSPI2_MOSI
+    GPIO_InitStructure.GPIO_Pin = GPIO_Pin_13 | GPIO_Pin_14 | GPIO_Pin_15;      //PB13为SPI2_CLK，PB14为SPI2_MISO，PB15为SPI2_MOSI
     GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;  //??????
     GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
     GPIO_Init(GPIOB, &GPIO_InitStructure);
@@ -36,7 +36,7 @@ void SPI2_Init(void)
     SPI_InitStructure.SPI_CPOL = SPI_CPOL_High;//;        //??????????:?????  SI4463:SPI_CPOL_High	1278SPI_CPOL_Low
 #endif
 #if (defined RF_SI4432) || (defined RF_SX1278)
-    SPI_InitStructure.SPI_CPOL = SPI_CPOL_Low;	////ģʽ SCK Ϊ
+    SPI_InitStructure.SPI_CPOL = SPI_CPOL_Low;	////空闲模式下 SCK 为低
 #endif
     SPI_InitStructure.SPI_CPHA = SPI_CPHA_1Edge;//SPI_CPHA_2Edge;    //???????????
     SPI_InitStructure.SPI_NSS = SPI_NSS_Soft;        //NSS?????(NSS??)????(??SSI?)??:??NSS???SSI???
@@ -0,0 +1,217 @@
+/******************** (C) COPYRIGHT tongxinmao.com ***************************
+    文件名		: sx1276-Fsk.C
+    描述			: SX1276/78 FSK/GFSK模式驱动，用于批量数据的高速传输
+    版本			: V1.0
+    说明			: 可变包长，长度字节 + 负载最多255字节，硬件CRC，数据白化，GFSK BT=1.0。
+                  FSK模式FIFO只有64字节，发射时按FifoLevel边发边填。节点只发不收，FSK接收由主机完成。
+                  DIO0=PacketSent，DIO1=FifoLevel，由 bsp_rf.c 的DIO中断事件驱动填充，不查询引脚或寄存器。
+                  LoRa和FSK的大部分寄存器地址重叠，回到LoRa模式后必须重新执行 RFM96_Config。
+                  温度传感器和镜像校准也只能在FSK模式下操作，RFM96_ReadTemp/RFM96_ImageCal 只改动
+                  FSK专用的RegImageCal和临时关闭的PA，返回LoRa模式后不需要重新配置。
+********************************************************************************/
+
+#include "bsp.h"
+
+static u8 s_ucFskRate = RF_FSK_100K;     //当前FSK速率档位
+
+/**********************************************************
+**FSK速率表：Fxosc = 32MHz，Bitrate = Fxosc/rate，Fdev = 61.035Hz*fdev
+**RxBw = Fxosc/(mant*2^(exp+2))，寄存器 = (mant档位<<3)+exp，mant档位0/1/2对应16/20/24
+**********************************************************/
+const RF_FSK_PROFILE_T RFM96FskTbl[RF_FSK_RATE_NUM] =
+{
+	{ 50000,  { 0x02, 0x80, 0x01, 0x9A }, { 0x12, 0x0A } },   //50kbps,  Fdev 25KHz,  RxBw 83.3KHz, AfcBw 100KHz
+	{ 100000, { 0x01, 0x40, 0x03, 0x33 }, { 0x02, 0x01 } },   //100kbps, Fdev 50KHz,  RxBw 125KHz,  AfcBw 250KHz
+	{ 250000, { 0x00, 0x80, 0x06, 0x66 }, { 0x01, 0x00 } },   //250kbps, Fdev 100KHz, RxBw 250KHz,  AfcBw 500KHz
+};
+
+//0x25~0x2B: RegPreambleMsb/Lsb, RegSyncConfig(AutoRestartRx，同步字4字节), RegSyncValue1~4
+static const u8 s_ucFskSync[7] = { 0x00, RF_FSK_PREAMBLE, 0x53, 0xC1, 0x94, 0xC1, 0x2D };
+//0x30~0x32: RegPacketConfig1(可变包长、白化、CRC), RegPacketConfig2(包模式), RegPayloadLength(接收最大包长)
+static const u8 s_ucFskPacket[3] = { 0xD0, 0x40, 0xFF };
+
+/**********************************************************
+**Name:     RFM96_FskEntry
+**Function: 从LoRa模式切换到FSK模式并配置
+**Input:    rate -- RF_FSK_xxx
+**Output:   None
+**Note:     LongRangeMode位只能在睡眠模式下修改。配置完成后芯片处于FSK待机
+**********************************************************/
+void RFM96_FskEntry ( u8 rate )
+{
+	if ( rate >= RF_FSK_RATE_NUM )
+	{ rate = RF_FSK_100K; }
+	s_ucFskRate = rate;
+	RFM96_Sleep();                                   //LoRa睡眠
+	SPIWrite ( FSK_RegOpMode + 0x08 );               //FSK睡眠，LowFrequencyModeOn
+	BurstWrite ( ( u8 ) ( FSK_RegBitrateMsb >> 8 ), ( u8 * ) RFM96FskTbl[rate].rate, 4 );
+	RFM96_WriteRf ( &RFM96ProfileTbl[gProfile] );    //频率、功率与LoRa相同
+	SPIWrite ( FSK_RegPaRamp + 0x29 );               //GFSK BT=1.0，40us
+	SPIWrite ( FSK_RegRxConfig + 0x1E );             //AFC、AGC自动，检测到前导码开始接收
+	BurstWrite ( ( u8 ) ( FSK_RegRxBw >> 8 ), ( u8 * ) RFM96FskTbl[rate].rxbw, 2 );
+	SPIWrite ( FSK_RegPreambleDetect + 0xAA );       //前导码检测2字节，容差10
+	BurstWrite ( ( u8 ) ( FSK_RegPreambleMsb >> 8 ), ( u8 * ) s_ucFskSync, sizeof ( s_ucFskSync ) );
+	BurstWrite ( ( u8 ) ( FSK_RegPacketConfig1 >> 8 ), ( u8 * ) s_ucFskPacket, sizeof ( s_ucFskPacket ) );
+	SPIWrite ( FSK_RegFifoThresh + 0x80 + RF_FSK_FIFO_THRESH ); //FIFO非空即开始发射
+	SPIWrite ( FSK_RegDioMapping1 + 0x00 );          //DIO0: PacketSent/PayloadReady, DIO1: FifoLevel, DIO3: FifoEmpty
+	SPIWrite ( FSK_RegOpMode + 0x09 );               //FSK待机
+}
+
+/**********************************************************
+**Name:     RFM96_FskExit
+**Function: 回到LoRa模式睡眠
+**Input:    None
+**Output:   None
+**Note:     LoRa调制参数已被覆盖，调用者接着执行 RFM96_LoRaEntryRx 或 RFM96_Config
+**********************************************************/
+void RFM96_FskExit ( void )
+{
+	SPIWrite ( FSK_RegOpMode + 0x08 );               //FSK睡眠，FIFO清空
+	SPIWrite ( FSK_RegOpMode + 0x80 + 0x08 );        //LoRa睡眠
+}
+
+/**********************************************************
+**Name:     RFM96_FskAirtimeUs
+**Function: 当前速率下数据包的空中时间
+**Input:    len -- 负载字节数
+**Output:   空中时间，单位us
+**********************************************************/
+u32 RFM96_FskAirtimeUs ( u8 len )
+{
+	u32 bits = ( u32 ) ( RF_FSK_PREAMBLE + RF_FSK_SYNC_LEN + 1 + len + 2 ) * 8;   //前导码 + 同步字 + 长度 + 负载 + CRC
+	return ( bits * 1000 ) / ( RFM96FskTbl[s_ucFskRate].bps / 1000 );
+}
+
+/**********************************************************
+**Name:     RFM96_FskTxStart
+**Function: 写入长度字节和第一块负载后进入发射
+**Input:    buf -- 数据包
+**          len -- 1~255
+**Output:   已写入FIFO的负载字节数
+**Note:     只写FIFO和RegOpMode即返回。FIFO中不超过 RF_FSK_FIFO_THRESH 字节时FifoLevel(DIO1)变低，
+**          由调用者在DIO1下降沿事件中调用 RFM96_FskTxFill 再填入一块；PacketSent(DIO0)后调用 RFM96_FskTxEnd
+**********************************************************/
+u8 RFM96_FskTxStart ( u8 *buf, u8 len )
+{
+	u8 sent;
+	SPIWrite ( FSK_RegOpMode + 0x09 );               //待机
+	BurstWrite ( 0x00, &len, 1 );
+	sent = ( len < RF_FSK_FIFO_SIZE - 1 ) ? len : RF_FSK_FIFO_SIZE - 1;
+	BurstWrite ( 0x00, buf, sent );
+	SPIWrite ( FSK_RegOpMode + 0x0B );               //发射
+	return sent;
+}
+
+/**********************************************************
+**Name:     RFM96_FskTxFill
+**Function: 发射过程中向FIFO再填入一块负载
+**Input:    buf  -- 数据包
+**          len  -- 数据包长度
+**          sent -- 已写入FIFO的负载字节数
+**Output:   填入后已写入FIFO的负载字节数
+**Note:     FIFO中不超过门限时调用，一次最多填入 FIFO大小 - 门限 - 1 字节，不会溢出
+**********************************************************/
+u8 RFM96_FskTxFill ( u8 *buf, u8 len, u8 sent )
+{
+	u8 n = len - sent;
+	if ( n > RF_FSK_FIFO_SIZE - RF_FSK_FIFO_THRESH - 1 )
+	{ n = RF_FSK_FIFO_SIZE - RF_FSK_FIFO_THRESH - 1; }
+	BurstWrite ( 0x00, buf + sent, n );
+	return sent + n;
+}
+
+/**********************************************************
+**Name:     RFM96_FskTxEnd
+**Function: 发射结束(PacketSent或超时)后回到FSK待机
+**Input:    None
+**Output:   None
+**********************************************************/
+void RFM96_FskTxEnd ( void )
+{
+	SPIWrite ( FSK_RegOpMode + 0x09 );
+}
+
+/**********************************************************
+**Name:     RFM96_TempValue
+**Function: RegTemp/RegFormerTemp 的值换算为温度
+**Input:    raw -- 寄存器值，每LSB -1℃
+**Output:   温度，单位℃，未做偏移校准，只用于比较温度变化
+**********************************************************/
+static int16_t RFM96_TempValue ( u8 raw )
+{
+	return -( int16_t ) ( int8_t ) raw;
+}
+
+/**********************************************************
+**Name:     RFM96_ReadTemp
+**Function: 读取芯片温度
+**Input:    None
+**Output:   温度，单位℃，见 RFM96_TempValue
+**Note:     温度传感器只在FSK模式频率合成器打开时工作：从LoRa睡眠切到FSK，进入FSRx后打开温度监测
+**          RF_TEMP_MEASURE_US，关闭后回到睡眠读RegTemp。返回时芯片处于LoRa待机，FIFO内容丢失
+**********************************************************/
+int16_t RFM96_ReadTemp ( void )
+{
+	u8 cal, raw;
+	RFM96_Sleep();                                   //LongRangeMode位只能在睡眠模式下修改
+	SPIWrite ( FSK_RegOpMode + 0x08 );               //FSK睡眠
+	SPIWrite ( FSK_RegOpMode + 0x09 );               //FSK待机
+	SPIWrite ( FSK_RegOpMode + 0x0C );               //FSRx
+	cal = SPIRead ( ( u8 ) ( FSK_RegImageCal >> 8 ) ) & RF_IMAGECAL_KEEP;
+	SPIWrite ( FSK_RegImageCal + cal );              //打开温度监测
+	bsp_DelayUS ( RF_TEMP_MEASURE_US );
+	SPIWrite ( FSK_RegImageCal + cal + RF_IMAGECAL_TEMPMONITOR_OFF );
+	SPIWrite ( FSK_RegOpMode + 0x08 );               //FSK睡眠
+	raw = SPIRead ( ( u8 ) ( FSK_RegTemp >> 8 ) );
+	SPIWrite ( FSK_RegOpMode + 0x80 + 0x08 );        //LoRa睡眠
+	RFM96_Standby();
+	return RFM96_TempValue ( raw );
+}
+
+/**********************************************************
+**Name:     RFM96_CalTemp
+**Function: 读取上一次镜像校准(上电复位或 RFM96_ImageCal)时的芯片温度
+**Input:    None
+**Output:   温度，单位℃，与 RFM96_ReadTemp 可直接比较
+**********************************************************/
+int16_t RFM96_CalTemp ( void )
+{
+	return RFM96_TempValue ( SPIRead ( ( u8 ) ( REG_LR_FORMERTEMP >> 8 ) ) );
+}
+
+/**********************************************************
+**Name:     RFM96_ImageCal
+**Function: 按当前频率重新做镜像和IQ校准
+**Input:    None
+**Output:   1- 完成, 0- 超时
+**Note:     校准在FSK待机下进行，约10ms，期间关闭PA输出。芯片把本次校准时的温度记入RegFormerTemp。
+**          返回时芯片处于LoRa待机，FIFO内容丢失
+**********************************************************/
+u8 RFM96_ImageCal ( void )
+{
+	u8 cal, pa;
+	u8 count = 0, done = 0;
+	RFM96_Sleep();
+	SPIWrite ( FSK_RegOpMode + 0x08 );               //FSK睡眠
+	SPIWrite ( FSK_RegOpMode + 0x09 );               //FSK待机，频率寄存器两种模式共用
+	pa = SPIRead ( ( u8 ) ( LR_RegPaConfig >> 8 ) );
+	SPIWrite ( LR_RegPaConfig + 0x00 );              //校准期间关闭PA
+	cal = SPIRead ( ( u8 ) ( FSK_RegImageCal >> 8 ) ) & RF_IMAGECAL_KEEP;
+	SPIWrite ( FSK_RegImageCal + cal + RF_IMAGECAL_START );
+	while ( 1 )
+	{
+		bsp_DelayUS ( 100 );
+		if ( ( SPIRead ( ( u8 ) ( FSK_RegImageCal >> 8 ) ) & RF_IMAGECAL_RUNNING ) == 0 )
+		{
+			done = 1;
+			break;
+		}
+		if ( ++count > RF_IMAGECAL_TIMEOUT_MS * 10 )
+		{ break; }
+	}
+	SPIWrite ( LR_RegPaConfig + pa );
+	SPIWrite ( FSK_RegOpMode + 0x08 );               //FSK睡眠
+	SPIWrite ( FSK_RegOpMode + 0x80 + 0x08 );        //LoRa睡眠
+	RFM96_Standby();
+	return done;
+}
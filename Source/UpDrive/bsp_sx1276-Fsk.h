@@ -0,0 +1,74 @@
+/******************** (C) COPYRIGHT tongxinmao.com ***************************
+    文件名		: sx1276-Fsk.h
+    描述			: SX1276/78 FSK/GFSK模式驱动头文件，用于批量数据的高速传输
+    版本			: V1.0
+********************************************************************************/
+#ifndef __SX1276_FSK_H__
+#define __SX1276_FSK_H__
+
+#define RF_FSK_50K          0               //FSK速率档位，见 RFM96FskTbl
+#define RF_FSK_100K         1
+#define RF_FSK_250K         2
+#define RF_FSK_RATE_NUM     3
+
+#define RF_FSK_FIFO_SIZE    64              //FSK模式FIFO只有64字节，更长的数据包边发边填
+#define RF_FSK_FIFO_THRESH  24              //FifoLevel门限：FIFO中字节数不超过此值时再填入一块
+#define RF_FSK_PREAMBLE     5               //前导码长度(字节)
+#define RF_FSK_SYNC_LEN     4               //同步字长度(字节)
+#define RF_FSK_TIMEOUT_MARGIN_MS  5         //等待PacketSent的时间 = 空中时间 + 此余量
+#define RF_TEMP_MEASURE_US  150             //温度监测打开的时间，至少一次温度转换
+#define RF_IMAGECAL_TIMEOUT_MS    20        //等待镜像校准完成的上限，正常约10ms
+
+typedef struct
+{
+	u32 bps;        //比特率
+	u8 rate[4];     //0x02~0x05: RegBitrateMsb/Lsb, RegFdevMsb/Lsb
+	u8 rxbw[2];     //0x12~0x13: RegRxBw, RegAfcBw
+} RF_FSK_PROFILE_T;
+
+// FSK模式寄存器，与LoRa模式地址重叠、含义不同
+#define FSK_RegOpMode                               0x0100
+#define FSK_RegBitrateMsb                           0x0200
+#define FSK_RegPaRamp                               0x0A00
+#define FSK_RegRxConfig                             0x0D00
+#define FSK_RegRxBw                                 0x1200
+#define FSK_RegPreambleDetect                       0x1F00
+#define FSK_RegPreambleMsb                          0x2500
+#define FSK_RegPacketConfig1                        0x3000
+#define FSK_RegFifoThresh                           0x3500
+#define FSK_RegImageCal                             0x3B00
+#define FSK_RegTemp                                 0x3C00
+#define FSK_RegIrqFlags2                            0x3F00
+#define FSK_RegDioMapping1                          0x4000
+
+// RegIrqFlags2 bits
+#define RF_IRQFLAGS2_FIFOFULL                       0x80
+#define RF_IRQFLAGS2_FIFOEMPTY                      0x40
+#define RF_IRQFLAGS2_FIFOLEVEL                      0x20
+#define RF_IRQFLAGS2_FIFOOVERRUN                    0x10
+#define RF_IRQFLAGS2_PACKETSENT                     0x08
+#define RF_IRQFLAGS2_PAYLOADREADY                   0x04
+#define RF_IRQFLAGS2_CRCOK                          0x02
+
+// RegImageCal bits
+#define RF_IMAGECAL_AUTO_ON                         0x80
+#define RF_IMAGECAL_START                           0x40
+#define RF_IMAGECAL_RUNNING                         0x20
+#define RF_IMAGECAL_TEMPCHANGE                      0x08
+#define RF_IMAGECAL_TEMPTHRESH_MASK                 0x06
+#define RF_IMAGECAL_TEMPMONITOR_OFF                 0x01
+#define RF_IMAGECAL_KEEP    ( RF_IMAGECAL_AUTO_ON | RF_IMAGECAL_TEMPTHRESH_MASK )  //读改写时保留的位
+
+extern const RF_FSK_PROFILE_T RFM96FskTbl[];
+
+void RFM96_FskEntry(u8 rate);
+void RFM96_FskExit(void);
+u32 RFM96_FskAirtimeUs(u8 len);
+u8 RFM96_FskTxStart(u8 *buf, u8 len);
+u8 RFM96_FskTxFill(u8 *buf, u8 len, u8 sent);
+void RFM96_FskTxEnd(void);
+int16_t RFM96_ReadTemp(void);
+int16_t RFM96_CalTemp(void);
+u8 RFM96_ImageCal(void);
+
+#endif //__SX1276_FSK_H__
@@ -1,55 +1,69 @@
 /******************** (C) COPYRIGHT tongxinmao.com ***************************
-    ļ		: sx1276-LoRa.C
-       		: tcm123@126.com
-      	: 2016.3.8
-    			: SX1276/78ļ
-    汾			: V1.0
-    ʷ¼  	: 
+    文件名		: sx1276-LoRa.C
+    作者   		: tcm123@126.com
+    创建日期  	: 2016.3.8
+    描述			: SX1276/78驱动文件
+    版本			: V1.0
+    历史记录  	: 暂无
 ********************************************************************************/
 
 #include "bsp.h"
 
 #include <stdio.h>
 
-#define gb_SF  2 //Ƶӵ±
-#define gb_BW  9 //±
-#define CR     0x04
 #define CRC_EN   0x00  //CRC Enable
+#define RF_FRF_IMAGE             0x6C, 0x80, 0x00  //RegFrMsb~RegFrLsb 434MHz 32M晶振   30M:0x73,0xBB,0xBB
+#define RF_PA_IMAGE              0xFF, 0x09, 0x0B, 0x23 //RegPaConfig(20dBm，按gPwrLevel替换), RegPaRamp(缺省40us), RegOcp(关闭), RegLna(最大增益)
+//RegModemConfig1~RegPreambleLsb：带宽、编码率、显式包头；扩频因子、CRC、SymbTimeout=0x3FF(Max)；前导码长度
+#define RF_MODEM_IMAGE(_sf, _bw, _cr, _pre) \
+	{ ( ( _bw ) << 4 ) + ( ( _cr ) << 1 ) + 0x00, ( ( _sf ) << 4 ) + ( CRC_EN << 2 ) + 0x03, 0xFF, ( u8 ) ( ( _pre ) >> 8 ), ( u8 ) ( _pre ) }
+#define RF_TX_BASE_ADDR          0x80  //发射数据在FIFO中的起始地址(上电缺省值)
+#define RF_TX_ENTRY_RETRY        1     //发射准备回读校验失败后的重试次数
 
 u8 gtmp;
+int8_t  gPktSnr;   //最后一包的信噪比，单位dB
+u32 gTxTimeUs;       //最后一次发射从进入TX到TxDone的实测时间，单位us，LoRa由bsp_rf.c按DIO0中断时刻计算
+int16_t gPktRssi;  //最后一包的RSSI，单位dBm
+static u8 s_ucFifoPtr;       //FifoAddrPtr的影子值，接收模式下只有本驱动会移动该指针
+static u8 s_ucFifoPtrValid;  //1: s_ucFifoPtr与芯片一致
+static u8 s_ucRxAddr;        //RFM96_LoRaRxBegin 读到的RxCurrentAddr
+static u8 s_ucRxPeeked;      //RFM96_LoRaRxPeek 已读出的包头字节数
+static u8 s_ucTxLen;         //已写入发射FIFO的数据包长度，0表示没有
 
 /**********************************************************
 **Parameter table define
 **********************************************************/
-const u16 RFM96FreqTbl[3] = {0x066C, 0x0780, 0x0800}; //434MHz  32M0x066C, 0x0780, 0x0800 	   30M:0x0673, 0x07BB, 0x08BB   {0x85,0x89,0xd9},//26M-TCXO 434M
-
-const u16 RFM96PowerTbl[4] =
+/**********************************************************
+**调制参数表：每档的寄存器值在编译时确定，按连续地址分组，
+**切换时整组连续写入，不再逐个寄存器SPIWrite
+**带宽下标 0~9 对应 7.8,10.4,15.6,20.8,31.2,41.7,62.5,125,250,500KHz；编码率 1~4 对应 4/5~4/8
+**SF6只能用固定包长的隐式包头，不提供该档
+**********************************************************/
+const RF_PROFILE_T RFM96ProfileTbl[RF_PROF_NUM] =
 {
-	0x09FF,                   //20dbm
-	0x09FC,                   //17dbm
-	0x09F9,                   //14dbm
-	0x09F6,                   //11dbm
+	//sf  bw cr 前导码  0x06~0x0C                    0x1D~0x21                      0x26 LowDataRateOptimize
+	{ 7,  9, 4, 12, { RF_FRF_IMAGE, RF_PA_IMAGE }, RF_MODEM_IMAGE ( 7, 9, 4, 12 ), 0x00 },  //RF_PROF_SF7_BW500
+	{ 9,  9, 4, 12, { RF_FRF_IMAGE, RF_PA_IMAGE }, RF_MODEM_IMAGE ( 9, 9, 4, 12 ), 0x00 },  //RF_PROF_SF9_BW500，网络缺省
+	{ 10, 8, 4, 12, { RF_FRF_IMAGE, RF_PA_IMAGE }, RF_MODEM_IMAGE ( 10, 8, 4, 12 ), 0x00 }, //RF_PROF_SF10_BW250
+	{ 12, 7, 4, 12, { RF_FRF_IMAGE, RF_PA_IMAGE }, RF_MODEM_IMAGE ( 12, 7, 4, 12 ), 0x08 }, //RF_PROF_SF12_BW125，符号32ms
 };
+u8 gProfile = RF_PROF_DEFAULT;  //当前调制参数档位
 
-/*
-    const u8 RFM96SpreadFactorTbl[7] =
-    {
-    6,7,8,9,10,11,12
-
-    }; */
-
-const u8 RFM96SpreadFactorTbl[6] =
+const u16 RFM96PowerTbl[RF_PWR_LEVELS] =     //RegPaConfig，PA_BOOST输出
 {
-//	6Ƶӵλֻǹ̶ݰȥ6Ƶӵλ
-	7, 8, 9, 10, 11, 12
+	0x09FF,                   //20dbm
+	0x09FF,                   //17dbm
+	0x09FC,                   //14dbm
+	0x09F9,                   //11dbm
+	0x09F6,                   //8dbm
+	0x09F3,                   //5dbm
+	0x09F0,                   //2dbm
 };
-
-const u8 RFM96LoRaBwTbl[10] =
+const u8 RFM96PaDacTbl[RF_PWR_LEVELS] =      //RegPaDac，只有20dBm使用+3dB高功率模式
 {
-	//  0       1      2       3      4       5         6      7       8      9
-	//7.8KHz,10.4KHz,15.6KHz,20.8KHz,31.2KHz,41.7KHz,62.5KHz,125KHz,250KHz,500KHz
-	0, 1, 2, 3, 4, 5, 6, 7, 8, 9
+	0x87, 0x84, 0x84, 0x84, 0x84, 0x84, 0x84,
 };
+u8 gPwrLevel = 0;          //当前发射功率档位，0为最大
 
 const u8  RFM96Data[] = {"1234567890ABCDEFGHIJK"};
 
@@ -132,7 +146,7 @@ u8 SPIRead ( u8 adr )
 	//Delay_ms(1);
 	SPICmd8bit ( adr & 0x7f ); //Send address first
 	tmp = SPIRead8bit();
-	//  printf("addr:%02x  val:%02x\n",adr,tmp);
+	//  printf("读addr:%02x  val:%02x\n",adr,tmp);
 	//  Delay_ms(1);
 	GPIO_SetBits ( GPIOB, RF_SEL_PIN ); //NSS_High;
 	return ( tmp );
@@ -149,7 +163,7 @@ u8 SPIRead ( u8 adr )
 void SPIWrite ( u16 WrPara )
 {
 	WrPara |= 0x8000; //MSB must be "1" for write
-	//  printf("дaddr:%02x  val:%02x\n",WrPara>>8,(u8)WrPara);
+	//  printf("写addr:%02x  val:%02x\n",WrPara>>8,(u8)WrPara);
 	GPIO_ResetBits ( GPIOB, RF_SEL_PIN ); //NSS_Low;
 	SPICmd8bit ( WrPara >> 8 ); //	15->0
 	SPICmd8bit ( ( u8 ) WrPara );
@@ -168,7 +182,7 @@ void SPIWrite ( u16 WrPara )
 void SPIBurstRead ( u8 adr, u8 *ptr, u8 length )
 {
 	u8 i;
-	if ( length <= 1 ) //length must more than one
+	if ( length == 0 )
 	{ return; }
 	else
 	{
@@ -205,7 +219,7 @@ void BurstWrite ( u8 adr, u8 *ptr, u8 length )
 **********************************************************/
 void RFM96_Standby ( void )
 {
-	SPIWrite ( LR_RegOpMode + 0x01 + 0x08 );                       //Standby
+	SPIWrite ( LR_RegOpMode + 0x80 + 0x01 + 0x08 );                //Standby，从睡眠唤醒时LongRangeMode位可写，须保持LoRa模式
 }
 
 /**********************************************************
@@ -216,7 +230,7 @@ void RFM96_Standby ( void )
 **********************************************************/
 void RFM96_Sleep ( void )
 {
-	SPIWrite ( LR_RegOpMode + 0x00 + 0x08 );                       //Sleep
+	SPIWrite ( LR_RegOpMode + 0x80 + 0x08 );                       //Sleep，已在睡眠时再次写入也保持LoRa模式
 }
 /*********************************************************/
 //LoRa mode
@@ -243,6 +257,54 @@ void RFM96_LoRaClearIrq ( void )
 	SPIWrite ( LR_RegIrqFlags + 0xFF );
 }
 
+/**********************************************************
+**Name:     RFM96_WriteRf
+**Function: 写入频率、功率和LNA寄存器
+**Input:    prof -- RFM96ProfileTbl 中的一项
+**Output:   None
+**Note:     0x06~0x0C 一次连续写，RegPaConfig按当前功率档位替换。LoRa和FSK模式共用这几个寄存器
+**********************************************************/
+void RFM96_WriteRf ( const RF_PROFILE_T *prof )
+{
+	u8 rf[sizeof ( prof->rf )];
+	u8 i;
+	for ( i = 0; i < sizeof ( rf ); i++ )
+	{ rf[i] = prof->rf[i]; }
+	rf[3] = ( u8 ) RFM96PowerTbl[gPwrLevel];             //RegPaConfig
+	BurstWrite ( ( u8 ) ( LR_RegFrMsb >> 8 ), rf, sizeof ( rf ) );
+}
+
+/**********************************************************
+**Name:     RFM96_WriteProfile
+**Function: 写入一档调制参数的寄存器值
+**Input:    prof -- RFM96ProfileTbl 中的一项
+**Output:   None
+**Note:     0x06~0x0C、0x1D~0x21 各一次连续写，再单写0x26；RegPaConfig按当前功率档位替换
+**********************************************************/
+static void RFM96_WriteProfile ( const RF_PROFILE_T *prof )
+{
+	RFM96_WriteRf ( prof );
+	BurstWrite ( ( u8 ) ( LR_RegModemConfig1 >> 8 ), ( u8 * ) prof->modem, sizeof ( prof->modem ) );
+	SPIWrite ( LR_RegModemConfig3 + prof->modem3 );
+}
+
+/**********************************************************
+**Name:     RFM96_LoRaSetProfile
+**Function: 切换调制参数档位
+**Input:    prof -- RF_PROF_xxx
+**Output:   None
+**Note:     切到待机后整档写入，不复位芯片；调用后射频处于待机，由调用者重新进入接收或发射。
+**          收发双方必须使用同一档位
+**********************************************************/
+void RFM96_LoRaSetProfile ( u8 prof )
+{
+	if ( prof >= RF_PROF_NUM )
+	{ prof = RF_PROF_DEFAULT; }
+	gProfile = prof;
+	RFM96_Standby();
+	RFM96_WriteProfile ( &RFM96ProfileTbl[prof] );
+}
+
 /**********************************************************
 **Name:     RFM96_Config
 **Function: RFM96 base config
@@ -266,41 +328,13 @@ void RFM96_Config ( u8 mode )
 	RFM96_EntryLoRa();
 	// SPIWrite(0x5904);   //?? Change digital regulator form 1.6V to 1.47V: see errata note
 	{
-		u8	Sx1276VerNO = SPIRead ( ( u8 ) ( REG_LR_VERSION >> 8 ) ); //ȡSX1276 汾 0X11(V1A汾 ̰棩  0X12V1B ʽ棩
+		u8	Sx1276VerNO = SPIRead ( ( u8 ) ( REG_LR_VERSION >> 8 ) ); //获取SX1276 版本号 是0X11(V1A版本 工程版） 或者是 0X12（V1B 正式版）
 //        printf("sx1278(V12) v:%02X", Sx1276VerNO);
 		//	 SPIWrite(RFM96FreqTbl[0]);
 		//	 Sx1276VerNO=SPIRead((u8)(RFM96FreqTbl[0]>>8));
 		//   printf("RFM96FreqTbl[0](0X06_6C) R:0x%02X",Sx1276VerNO);
 	}
-	for ( i = 0; i < 3; i++ )                              //setting frequency parameter
-	{
-		SPIWrite ( RFM96FreqTbl[i] );
-	}
-	//setting base parameter
-	SPIWrite ( RFM96PowerTbl[0] );          //Setting output power parameter
-	SPIWrite ( LR_RegOcp + 0x0B );                         //RegOcp,Close Ocp
-	SPIWrite ( LR_RegLna + 0x23 );                         //RegLNA,High & LNA Enable
-	if ( RFM96SpreadFactorTbl[gb_SF] == 6 )      //SFactor=6
-	{
-		u8 tmp;
-		SPIWrite ( LR_RegModemConfig1 + ( RFM96LoRaBwTbl[gb_BW] << 4 ) + ( CR << 1 ) + 0x01 ); //ãṹImplicit Enable CRC Enable(0x02) & Error Coding rate 4/5(0x01), 4/6(0x02), 4/7(0x03), 4/8(0x04)
-		SPIWrite ( LR_RegModemConfig2 + ( RFM96SpreadFactorTbl[gb_SF] << 4 ) + ( CRC_EN << 2 ) + 0x03 );
-		tmp = SPIRead ( 0x31 );
-		tmp &= 0xF8;
-		tmp |= 0x05;
-		SPIWrite ( 0x3100 + tmp );
-		SPIWrite ( 0x3700 + 0x0C );
-	}
-	else
-	{
-		SPIWrite ( LR_RegModemConfig1 + ( RFM96LoRaBwTbl[gb_BW] << 4 ) + ( CR << 1 ) + 0x00 ); //Explicit Enable CRC Enable(0x02) & Error Coding rate 4/5(0x01), 4/6(0x02), 4/7(0x03), 4/8(0x04)
-		SPIWrite ( LR_RegModemConfig2 + ( RFM96SpreadFactorTbl[gb_SF] << 4 ) + ( CRC_EN << 2 ) + 0x03 ); //SFactor &  LNA gain set by the internal AGC loop
-	}
-	//	SPIWrite(LR_RegModemConfig1+0x36); //BW=3 20.8KHz , CR=3 4/7, explit
-	//	SPIWrite(LR_RegModemConfig2+0x77); //SF=6, CRC on
-	SPIWrite ( LR_RegSymbTimeoutLsb + 0xFF );              //RegSymbTimeoutLsb Timeout = 0x3FF(Max)
-	SPIWrite ( LR_RegPreambleMsb + 0 );                    //RegPreambleMsb
-	SPIWrite ( LR_RegPreambleLsb + 12 );                   //RegPreambleLsb 8+4=12byte Preamble
+	RFM96_WriteProfile ( &RFM96ProfileTbl[gProfile] );     //频率、功率、调制参数，3次连续写
 	SPIWrite ( REG_LR_DIOMAPPING2 + 0x01 );                //RegDioMapping2 DIO5=00, DIO4=01
 	RFM96_Standby();                                         //Entry standby mode
 }
@@ -310,26 +344,82 @@ void RFM96_Config ( u8 mode )
 **Function: Entry Rx mode
 **Input:    None
 **Output:   None
+**Note:     芯片已由 RFM96_Config 完成基本配置，睡眠和待机时寄存器保持，这里只切到待机写入接收相关寄存器，
+**          不再复位芯片。复位会让芯片重新做一次镜像校准，温度漂移后的校准由 RFTempCheck 按需执行
 **********************************************************/
 void RFM96_LoRaEntryRx ( void )
 {
 	u8 addr;
-	RFM96_Config ( 0 ); //setting base parameter
+	RFM96_Standby();
 	SPIWrite ( 0x4D00 + 0x84 ); //Normal and Rx
 	SPIWrite ( LR_RegHopPeriod + 0xFF ); //RegHopPeriod NO FHSS
-	SPIWrite ( REG_LR_DIOMAPPING1 + 0x01 ); //DIO0=00, DIO1=00, DIO2=00, DIO3=01  DIO0=00--RXDONE
-	SPIWrite ( LR_RegIrqFlagsMask + 0x3F ); //Open RxDone interrupt & Timeout
+	SPIWrite ( REG_LR_DIOMAPPING1 + RF_DIOMAP_RX ); //DIO0=RxDone, DIO1=RxTimeout, DIO3=ValidHeader
+	SPIWrite ( LR_RegIrqFlagsMask + RF_IRQMASK_RX ); //Open RxDone, Timeout & ValidHeader interrupt
 	RFM96_LoRaClearIrq();
 	//TODO
 	SPIWrite ( LR_RegPayloadLength + 21 ); //RegPayloadLength  21byte(this register must difine when the data long of one byte in SF is 6)
 	addr = SPIRead ( ( u8 ) ( LR_RegFifoRxBaseAddr >> 8 ) ); //Read RxBaseAddr
-	SPIWrite ( LR_RegFifoAddrPtr + addr ); //RxBaseAddr -> FiFoAddrPtr
+	SPIWrite ( LR_RegFifoAddrPtr + addr ); //RxBaseAddr -> FiFoAddrPtr　
+	s_ucFifoPtr = addr;
+	s_ucFifoPtrValid = 1;
 	SPIWrite ( LR_RegOpMode + 0x0D ); //Continuous Rx Mode
 }
 
+/**********************************************************
+**Name:     RFM96_LoRaEntryRxSingle
+**Function: 从睡眠或待机进入单次接收模式
+**Input:    symb -- 符号超时 1~1023，在此时间内没有检测到前导码则置RxTimeout并自动回到待机
+**Output:   None
+**Note:     睡眠模式下寄存器保持，与 RFM96_LoRaEntryRx 一样不需要复位芯片重新配置
+**********************************************************/
+void RFM96_LoRaEntryRxSingle ( u16 symb )
+{
+	u8 cfg[2];
+	RFM96_Standby();
+	cfg[0] = ( RFM96ProfileTbl[gProfile].modem[1] & 0xFC ) + ( ( symb >> 8 ) & 0x03 ); //RegModemConfig2，SymbTimeout(9:8)
+	cfg[1] = ( u8 ) symb;                                                                  //RegSymbTimeoutLsb
+	BurstWrite ( ( u8 ) ( LR_RegModemConfig2 >> 8 ), cfg, 2 );
+	SPIWrite ( REG_LR_PADAC + 0x84 ); //Normal and Rx
+	SPIWrite ( REG_LR_DIOMAPPING1 + RF_DIOMAP_RX ); //DIO0=RxDone, DIO1=RxTimeout, DIO3=ValidHeader
+	SPIWrite ( LR_RegIrqFlagsMask + RF_IRQMASK_RX ); //Open RxDone, Timeout & ValidHeader interrupt
+	RFM96_LoRaClearIrq();
+	SPIWrite ( LR_RegFifoAddrPtr + 0x00 ); //RxBaseAddr(上电缺省值0x00) -> FiFoAddrPtr
+	s_ucFifoPtr = 0x00;
+	s_ucFifoPtrValid = 1;
+	SPIWrite ( LR_RegOpMode + 0x80 + 0x06 + 0x08 ); //Single Rx Mode
+}
+
+/**********************************************************
+**Name:     RFM96_LoRaIrqFlags
+**Function: 读取中断标志
+**Input:    None
+**Output:   RegIrqFlags，见 RFLR_IRQFLAGS_*
+**********************************************************/
+u8 RFM96_LoRaIrqFlags ( void )
+{
+	return SPIRead ( ( u8 ) ( LR_RegIrqFlags >> 8 ) );
+}
+
+/**********************************************************
+**Name:     RFM96_LoRaEntryCad
+**Function: 进入信道活动检测(CAD)模式
+**Input:    None
+**Output:   None
+**Note:     检测约2个符号后置CadDone(DIO0)，检测到LoRa前导码时同时置CadDetected(DIO1)，
+**          之后芯片自动回到待机。能检测到低于噪底、RSSI看不出来的LoRa信号
+**********************************************************/
+void RFM96_LoRaEntryCad ( void )
+{
+	RFM96_Standby();
+	SPIWrite ( REG_LR_DIOMAPPING1 + RF_DIOMAP_CAD ); //DIO0=CadDone, DIO1=CadDetected
+	SPIWrite ( LR_RegIrqFlagsMask + RF_IRQMASK_CAD );
+	RFM96_LoRaClearIrq();
+	SPIWrite ( LR_RegOpMode + 0x80 + 0x07 + 0x08 ); //CAD Mode
+}
+
 /**********************************************************
 **Name:     RFM96_LoRaRxWaitStable
-**Function: Determine whether the state of stable Rx ѯRX ״̬
+**Function: Determine whether the state of stable Rx 查询RX 状态
 **Input:    none
 **Output:   none
 **********************************************************/
@@ -340,101 +430,259 @@ u8 RFM96_LoRaRxWaitStable ( void )
 	return tmp;
 }
 
+/**********************************************************
+**Name:     RFM96_LoRaRxBegin
+**Function: 读取接收状态，得到数据包长度
+**Input:    None
+**Output:   packet size, 0- 没有有效数据包(已清中断)
+**Note:     连续读0x10~0x13 (RxCurrentAddr, IrqFlagsMask, IrqFlags, RxNbBytes)，
+**          调用者据此准备缓冲区，然后必须调用 RFM96_LoRaRxRead 或 RFM96_LoRaClearIrq
+**********************************************************/
+u8 RFM96_LoRaRxBegin ( void )
+{
+	u8 stat[4];                                                //0x10~0x13
+	s_ucRxPeeked = 0;
+	SPIBurstRead ( ( u8 ) ( LR_RegFifoRxCurrentaddr >> 8 ), stat, 4 );
+	if ( ( stat[2] & RFLR_IRQFLAGS_RXDONE ) == 0 || ( stat[2] & RFLR_IRQFLAGS_PAYLOADCRCERROR ) != 0 )
+	{
+		RFM96_LoRaClearIrq();
+		return 0;
+	}
+	s_ucRxAddr = stat[0];
+	gtmp = stat[3]; //Number for received bytes，各档位都使用显式包头
+	if ( gtmp == 0 )
+	{ RFM96_LoRaClearIrq(); }
+	return gtmp;
+}
+
+/**********************************************************
+**Name:     RFM96_LoRaRxPeek
+**Function: 只读出数据包开头的 n 个字节，用于在读完整个数据包之前判断是否需要
+**Input:    buf -- 缓冲区，至少 n 字节
+**          n   -- 要读的字节数，超过包长时只读包长
+**Output:   实际读出的字节数
+**Note:     在 RFM96_LoRaRxBegin 之后调用。不需要的数据包调用 RFM96_LoRaClearIrq 丢弃；
+**          需要时把这 n 个字节放在缓冲区开头再调用 RFM96_LoRaRxRead，只读剩余部分
+**********************************************************/
+u8 RFM96_LoRaRxPeek ( u8 *buf, u8 n )
+{
+	if ( n > gtmp )
+	{ n = gtmp; }
+	if ( !s_ucFifoPtrValid || s_ucFifoPtr != s_ucRxAddr )
+	{ SPIWrite ( LR_RegFifoAddrPtr + s_ucRxAddr ); }          //last packet addr -> FiFoAddrPtr
+	SPIBurstRead ( 0x00, buf, n );
+	s_ucFifoPtr = s_ucRxAddr + n;
+	s_ucFifoPtrValid = 1;
+	s_ucRxPeeked = n;
+	return n;
+}
+
+/**********************************************************
+**Name:     RFM96_LoRaRxRead
+**Function: 把 RFM96_LoRaRxBegin 得到的数据包读入缓冲区
+**Input:    buf -- 缓冲区，调用者保证至少 len 字节
+**          len -- RFM96_LoRaRxBegin 的返回值
+**Output:   None
+**Note:     连续读FIFO，再连续读0x19~0x1A (PktSnr, PktRssi)，最后清中断。
+**          FifoAddrPtr影子值与应读位置不同时才多写一次指针。
+**          已调用 RFM96_LoRaRxPeek 时从包头之后读起，buf 开头应已放入包头
+**********************************************************/
+void RFM96_LoRaRxRead ( u8 *buf, u8 len )
+{
+	u8 quality[2];                                             //0x19~0x1A
+	u8 addr = s_ucRxAddr + s_ucRxPeeked;
+	if ( !s_ucFifoPtrValid || s_ucFifoPtr != addr )
+	{ SPIWrite ( LR_RegFifoAddrPtr + addr ); }                //last packet addr -> FiFoAddrPtr
+	SPIBurstRead ( 0x00, buf + s_ucRxPeeked, len - s_ucRxPeeked );
+	s_ucRxPeeked = 0;
+	s_ucFifoPtr = s_ucRxAddr + len;
+	s_ucFifoPtrValid = 1;
+	SPIBurstRead ( ( u8 ) ( LR_RegPktSnrValue >> 8 ), quality, 2 );
+	gPktSnr = ( int8_t ) quality[0] / 4;                      //SNR，单位dB
+	gPktRssi = -164 + quality[1];                              //434MHz(LF端口)，单位dBm
+	if ( gPktSnr < 0 )
+	{ gPktRssi += gPktSnr; }
+	RFM96_LoRaClearIrq();
+}
+
 /**********************************************************
 **Name:     RFM96_LoRaRxPacket
 **Function: Receive data in LoRa mode
-**Input:    None
-**Output:   1- Success
-            0- Fail
+**Input:    buf  -- 接收缓冲区
+**          size -- 缓冲区大小
+**Output:   packet size, 0- Fail
+**Note:     每包4次SPI传输，中间不插延时，缓冲区不清零；
+**          数据包比缓冲区长时丢弃该包，不会越界
 **********************************************************/
-u8 RFM96_LoRaRxPacket ( u8 *buf )
+u8 RFM96_LoRaRxPacket ( u8 *buf, u8 size )
 {
-	u8 i;
-	u8 addr;
 	u8 packet_size;
-	for ( i = 0; i < 32; i++ ) //Buffer
-	{ buf[i] = 0x00; }
-	addr = SPIRead ( ( u8 ) ( LR_RegFifoRxCurrentaddr >> 8 ) ); //last packet addr ݰַ(ݵβַ)
-	SPIWrite ( LR_RegFifoAddrPtr + addr );                 //RxBaseAddr -> FiFoAddrPtr
-	bsp_DelayUS ( 1 );
-	if ( RFM96SpreadFactorTbl[gb_SF] == 6 )      //When SpreadFactor is sixwill used Implicit Header mode(Excluding internal packet length)
-	{ packet_size = 21; }
-	else
-	{ packet_size = SPIRead ( ( u8 ) ( LR_RegRxNbBytes >> 8 ) ); } //Number for received bytes
-	gtmp = packet_size;
-	SPIBurstRead ( 0x00, buf, packet_size );
-	RFM96_LoRaClearIrq();
-	bsp_DelayUS ( 1 );
+	packet_size = RFM96_LoRaRxBegin();
+	if ( packet_size == 0 )
+	{ return 0; }
+	if ( packet_size > size )
+	{
+		RFM96_LoRaClearIrq();
+		return 0;
+	}
+	RFM96_LoRaRxRead ( buf, packet_size );
 	return packet_size;
 }
 
+/**********************************************************
+**Name:     RFM96_LoRaReadRssi
+**Function: 读取当前信道的RSSI，用于发射前的信道检测
+**Input:    None
+**Output:   RSSI，单位dBm
+**Note:     只在接收模式下有效，刚进入接收模式时需等待约1ms数值才稳定
+**********************************************************/
+int16_t RFM96_LoRaReadRssi ( void )
+{
+	return -164 + SPIRead ( ( u8 ) ( LR_RegRssiValue >> 8 ) );   //434MHz(LF端口)
+}
+
+/**********************************************************
+**Name:     RFM96_LoRaSetPower
+**Function: 设置发射功率档位
+**Input:    level -- 0 ~ RF_PWR_LEVELS-1，每档3dB，0为20dBm
+**Output:   None
+**Note:     立即写入RegPaConfig(任何模式下都可写)，RegPaDac在下一次进入发射时写入
+**********************************************************/
+void RFM96_LoRaSetPower ( u8 level )
+{
+	if ( level >= RF_PWR_LEVELS )
+	{ level = RF_PWR_LEVELS - 1; }
+	if ( level != gPwrLevel )
+	{
+		gPwrLevel = level;
+		SPIWrite ( RFM96PowerTbl[level] );
+	}
+}
+
+/**********************************************************
+**Name:     RFM96_LoRaSymbolUs
+**Function: 当前配置下一个符号的时间
+**Input:    None
+**Output:   符号时间，单位us
+**********************************************************/
+u32 RFM96_LoRaSymbolUs ( void )
+{
+	static const u32 s_BwHz[10] = { 7800, 10400, 15600, 20800, 31250, 41700, 62500, 125000, 250000, 500000 };
+	return ( ( u32 ) 1000000 << RFM96ProfileTbl[gProfile].sf ) / s_BwHz[RFM96ProfileTbl[gProfile].bw];
+}
+
+/**********************************************************
+**Name:     RFM96_LoRaAirtimeUs
+**Function: 按数据手册4.1.1.6节公式计算当前配置下数据包的空中时间
+**Input:    len -- 负载字节数
+**Output:   空中时间，单位us
+**********************************************************/
+u32 RFM96_LoRaAirtimeUs ( u8 len )
+{
+	const RF_PROFILE_T *prof = &RFM96ProfileTbl[gProfile];
+	u8  sf = prof->sf;
+	u32 tsym = RFM96_LoRaSymbolUs();                                        //符号时间，单位us
+	u8  de = ( prof->modem3 & 0x08 ) ? 1 : 0;                               //LowDataRateOptimize
+	s32 num = 8 * ( s32 ) len - 4 * sf + 28 + 16 * ( CRC_EN ? 1 : 0 );
+	s32 den = 4 * ( sf - 2 * de );
+	u32 npay = 8;
+	if ( num > 0 )
+	{ npay += ( ( num + den - 1 ) / den ) * ( prof->cr + 4 ); }
+	return ( ( prof->preamble * 4 + 17 ) * tsym ) / 4 + npay * tsym;       //(前导码 + 4.25) + 负载符号
+}
 
 /**********************************************************
 **Name:     RFM96_LoRaEntryTx
 **Function: Entry Tx mode
-**Input:    None
-**Output:   None
+**Input:    packet_length
+**Output:   packet_length, 0- 寄存器回读校验失败(SPI故障或芯片已复位)
+**Note:     芯片已由 RFM96_Config 完成基本配置，这里不再复位和延时，
+**          只切到待机并写入发射相关寄存器，每轮固定7次写、2次读，最多重试 RF_TX_ENTRY_RETRY 次。
+**          回读 RegOpMode 和 RegPayloadLength 与写入的影子值比较，不做轮询。
 **********************************************************/
 u8 RFM96_LoRaEntryTx ( u8 packet_length )
 {
-	u8 addr;
-	u8 SysTime = 0;
-	u8 temp;
-	RFM96_Config ( 0 ); //ģ鷢
-	bsp_DelayUS ( 1000 );
-	SPIWrite ( 0x4D00 + 0x87 ); //书 for 20dBm
-	SPIWrite ( LR_RegHopPeriod ); //RegHopPeriod NO FHSS
-	SPIWrite ( REG_LR_DIOMAPPING1 + 0x41 ); //DIO0=01, DIO1=00, DIO2=00, DIO3=01
-	RFM96_LoRaClearIrq();
-	SPIWrite ( LR_RegIrqFlagsMask + 0xF7 ); //Open TxDone interrupt
-	SPIWrite ( LR_RegPayloadLength + packet_length ); //RegPayloadLength  21byteغfifoֽĹϵʲô
-	addr = SPIRead ( ( u8 ) ( LR_RegFifoTxBaseAddr >> 8 ) ); //RegFiFoTxBaseAddr
-	SPIWrite ( LR_RegFifoAddrPtr + addr ); //RegFifoAddrPtr
-	while ( 1 )
+	u8 retry;
+	u8 irq[2] = { 0xF7, 0xFF };                          //0x11 Open TxDone interrupt, 0x12 Clear irq
+	u8 ptr[2] = { RF_TX_BASE_ADDR, RF_TX_BASE_ADDR };    //0x0D FifoAddrPtr, 0x0E FifoTxBaseAddr
+	s_ucFifoPtrValid = 0;
+	for ( retry = 0; retry <= RF_TX_ENTRY_RETRY; retry++ )
 	{
-		temp = SPIRead ( ( u8 ) ( LR_RegPayloadLength >> 8 ) );
-		if ( temp == packet_length )
+		RFM96_Standby();                                  //FIFO只能在待机模式下写入
+		SPIWrite ( REG_LR_PADAC + RFM96PaDacTbl[gPwrLevel] ); //20dBm档打开高功率模式
+		SPIWrite ( LR_RegHopPeriod ); //RegHopPeriod NO FHSS
+		SPIWrite ( REG_LR_DIOMAPPING1 + RF_DIOMAP_TX ); //DIO0=TxDone
+		BurstWrite ( ( u8 ) ( LR_RegIrqFlagsMask >> 8 ), irq, 2 );
+		SPIWrite ( LR_RegPayloadLength + packet_length ); //RegPayloadLength
+		BurstWrite ( ( u8 ) ( LR_RegFifoAddrPtr >> 8 ), ptr, 2 );
+		if ( ( SPIRead ( ( u8 ) ( LR_RegOpMode >> 8 ) ) & 0x87 ) == 0x81    //LoRa模式、待机
+		        && SPIRead ( ( u8 ) ( LR_RegPayloadLength >> 8 ) ) == packet_length )
 		{
-			break;
+			return packet_length;
 		}
-		if ( SysTime >= 3 ) //дЧ
-		{ return 0; }
 	}
-	return 	packet_length;
+	return 0;
+}
+
+/**********************************************************
+**Name:     RFM96_LoRaTxStage
+**Function: 提前准备发射：完成发射配置并把数据包写入发射FIFO，芯片停在待机
+**Input:    buf -- 数据包
+**          len -- 数据包长度
+**Output:   len, 0- 寄存器回读校验失败
+**Note:     之后调用 RFM96_LoRaTxFire 只需写一次RegOpMode即开始发射。
+**          准备好到发射之间芯片不接收，也不能进入睡眠(FIFO内容会丢失)
+**********************************************************/
+u8 RFM96_LoRaTxStage ( u8 *buf, u8 len )
+{
+	s_ucTxLen = 0;
+	if ( RFM96_LoRaEntryTx ( len ) == 0 )
+	{ return 0; }
+	BurstWrite ( 0x00, ( u8 * ) buf, len );
+	s_ucTxLen = len;
+	return len;
 }
 
 /**********************************************************
 **Name:     RFM96_LoRaTxPacket
 **Function: Send data in LoRa mode
 **Input:    None
-**Output:   1- Send over
+**Output:   数据包长度
+**Note:     在 RFM96_LoRaEntryTx 之后调用，写FIFO后立即开始发射，不等待TxDone，见 RFM96_LoRaTxFire
 **********************************************************/
 u8 RFM96_LoRaTxPacket ( u8 *buf, u8 len )
 {
-	u16 count = 0;
 	BurstWrite ( 0x00, ( u8 * ) buf, len );
-	SPIWrite ( LR_RegOpMode + 0x03 + 0x08 ); //Tx Mode
-	/*
-	    gtmp= SPIRead((u8)(LR_RegIrqFlags>>8));
-	    //	delay_us(10);
-	    gtmp= SPIRead((u8)(LR_RegIrqFlags>>8));
-	    //	delay_us(10);
-	    gtmp= SPIRead((u8)(LR_RegIrqFlags>>8));
-	    //	delay_us(10);
-	*/
-	//while(!RF_IRQ_DIO0) ; //Packet send over IRQ ΪH,ƽʱL
-	while ( !GPIO_ReadInputDataBit ( GPIOA, RF_IRQ_PIN ) )
-	{
-		if ( ++count > 1000 )
-		{ break; }
-		bsp_DelayMS ( 1 );
-	}
-	SPIRead ( ( u8 ) ( LR_RegIrqFlags >> 8 ) );
+	s_ucTxLen = len;
+	return RFM96_LoRaTxFire();
+}
+
+/**********************************************************
+**Name:     RFM96_LoRaTxFire
+**Function: 发射已写入FIFO的数据包
+**Input:    None
+**Output:   数据包长度，0- 没有准备好的数据包
+**Note:     只写一次RegOpMode即返回，不等待。发射结束时芯片置TxDone(DIO0)并自动回到待机，
+**          由DIO0中断通知调用者，之后调用 RFM96_LoRaTxEnd；调用者按空中时间自行判断超时
+**********************************************************/
+u8 RFM96_LoRaTxFire ( void )
+{
+	u8 len = s_ucTxLen;
+	if ( len == 0 )
+	{ return 0; }
+	s_ucTxLen = 0;
+	SPIWrite ( LR_RegOpMode + 0x80 + 0x03 + 0x08 ); //Tx Mode
+	return len;
+}
+
+/**********************************************************
+**Name:     RFM96_LoRaTxEnd
+**Function: 发射结束(TxDone或超时)后清除中断标志并进入待机
+**Input:    None
+**Output:   None
+**********************************************************/
+void RFM96_LoRaTxEnd ( void )
+{
 	RFM96_LoRaClearIrq(); //Clear irq
 	RFM96_Standby(); //Entry Standby mode
-	if ( count > 1000 )
-	{
-		return 0;
-	}
-	return len;
 }
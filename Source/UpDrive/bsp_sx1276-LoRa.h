@@ -21,13 +21,37 @@
 #ifndef __SX1276_LORA_H__
 #define __SX1276_LORA_H__
 
-#define	RF_SEL_PIN	 GPIO_Pin_12        //ΪRF_CSN
-#define RF_IRQ_PIN	 GPIO_Pin_2         //Ϊж
+#define	RF_SEL_PIN	 GPIO_Pin_12        //此引脚为RF_CSN引脚
+#define RF_IRQ_PIN	 GPIO_Pin_2         //此引脚为中断引脚
 #define RF_RST	     GPIO_Pin_8         //XL1278-SD01 RESET
 #define	RF_RST_1     GPIO_Pin_11        //xl1278-smt rest 
+#define RF_DIO_PORT  GPIOC              //DIO1、DIO3飞线接PC6、PC7，与DIO0一样配置为上升沿外部中断
+#define RF_DIO1_PIN  GPIO_Pin_6
+#define RF_DIO3_PIN  GPIO_Pin_7
+#define RF_DIO0_HIGH()  GPIO_ReadInputDataBit ( GPIOA, RF_IRQ_PIN )
+#define RF_DIO1_HIGH()  GPIO_ReadInputDataBit ( RF_DIO_PORT, RF_DIO1_PIN )
+#define RF_DIO3_HIGH()  GPIO_ReadInputDataBit ( RF_DIO_PORT, RF_DIO3_PIN )
+
+//RegDioMapping1：DIO0[7:6] DIO1[5:4] DIO2[3:2] DIO3[1:0]
+#define RF_DIOMAP_RX   0x01             //DIO0=RxDone, DIO1=RxTimeout, DIO3=ValidHeader
+#define RF_DIOMAP_TX   0x41             //DIO0=TxDone
+#define RF_DIOMAP_CAD  0xA0             //DIO0=CadDone, DIO1=CadDetected
+//RegIrqFlagsMask：置1的中断不置标志，也不输出到DIO
+#define RF_IRQMASK_RX  0x2F             //打开RxTimeout、RxDone、ValidHeader
+#define RF_IRQMASK_CAD 0xFA             //打开CadDone、CadDetected
+
+#define RF_PWR_LEVELS  7                //发射功率档位数：20,17,14,11,8,5,2dBm
+#define RF_PWR_DBM(_level)  (20 - 3 * (_level))
+
+#define RF_PROF_SF7_BW500   0           //调制参数档位，见 RFM96ProfileTbl
+#define RF_PROF_SF9_BW500   1
+#define RF_PROF_SF10_BW250  2
+#define RF_PROF_SF12_BW125  3
+#define RF_PROF_NUM         4
+#define RF_PROF_DEFAULT     RF_PROF_SF9_BW500   //网络缺省档位，主机和所有节点一致
 
 //-----------------------------------------------------------------------------
-// ӳ
+// 子程序声明
 //-----------------------------------------------------------------------------
 void RF_GpioInt(void);
 void SpiWriteAddressData(unsigned char address, unsigned char data1);
@@ -41,14 +65,52 @@ void SX1276LoRaInit( void );
 typedef unsigned char u8;
 typedef unsigned char uint8_t;
 typedef unsigned char INT8U;
+
+typedef struct
+{
+	u8 sf;          //扩频因子 7~12
+	u8 bw;          //带宽下标 0~9
+	u8 cr;          //编码率 1~4 (4/5~4/8)
+	u8 preamble;    //前导码长度(符号)
+	u8 rf[7];       //0x06~0x0C: RegFrMsb/Mid/Lsb, RegPaConfig, RegPaRamp, RegOcp, RegLna
+	u8 modem[5];    //0x1D~0x21: RegModemConfig1/2, RegSymbTimeoutLsb, RegPreambleMsb/Lsb
+	u8 modem3;      //0x26: RegModemConfig3
+} RF_PROFILE_T;     //一档调制参数的寄存器映像
+extern const RF_PROFILE_T RFM96ProfileTbl[];
 u8 SPIRead(u8 adr);
+void SPIWrite(u16 WrPara);
+void BurstWrite(u8 adr, u8 *ptr, u8 length);
 void SPIBurstRead(u8 adr, u8 *ptr, u8 length);
 void SX1276ReadBuffer( uint8_t addr, uint8_t *buffer, uint8_t size );
+void RFM96_Config(u8 mode);
 void RFM96_LoRaEntryRx(void);
-u8 RFM96_LoRaRxPacket(u8 *buf);
+void RFM96_LoRaEntryRxSingle(u16 symb);
+u8 RFM96_LoRaIrqFlags(void);
+void RFM96_LoRaEntryCad(void);
+void RFM96_Sleep(void);
+u8 RFM96_LoRaRxBegin(void);
+u8 RFM96_LoRaRxPeek(u8 *buf, u8 n);
+void RFM96_LoRaRxRead(u8 *buf, u8 len);
+u8 RFM96_LoRaRxPacket(u8 *buf, u8 size);
+void RFM96_LoRaClearIrq(void);
 u8 RFM96_LoRaEntryTx(u8 packet_length);
+int16_t RFM96_LoRaReadRssi(void);
+void RFM96_LoRaSetPower(u8 level);
+void RFM96_LoRaSetProfile(u8 prof);
+void RFM96_WriteRf(const RF_PROFILE_T *prof);
+void RFM96_Standby(void);
+u32 RFM96_LoRaSymbolUs(void);
+u32 RFM96_LoRaAirtimeUs(u8 len);
 u8 RFM96_LoRaTxPacket(u8 *buf,u8 len);
+u8 RFM96_LoRaTxStage(u8 *buf, u8 len);
+u8 RFM96_LoRaTxFire(void);
+void RFM96_LoRaTxEnd(void);
 void delayms(unsigned int t);
+extern int8_t  gPktSnr;
+extern int16_t gPktRssi;
+extern u32 gTxTimeUs;
+extern u8 gPwrLevel;
+extern u8 gProfile;
 /*!
  * SX1276 Internal registers Address
  */
@@ -82,7 +144,7 @@ void delayms(unsigned int t);
 #define LR_RegPktRssiValue                          0x1A00//RSSI of last packet
 #define LR_RegRssiValue                             0x1B00//Current RSSI
 #define LR_RegHopChannel                            0x1C00//FHSS start channel
-#define LR_RegModemConfig1                          0x1D00//Modem PHY config ҪļĴSignal bandwidth:Error coding rateExplicit Header mode
+#define LR_RegModemConfig1                          0x1D00//Modem PHY config 最重要的寄存器包括Signal bandwidth:Error coding rate，Explicit Header mode
 #define LR_RegModemConfig2                          0x1E00//SF rate,
 #define LR_RegSymbTimeoutLsb                        0x1F00//Receiver timeout value
 #define LR_RegPreambleMsb                           0x2000//Size of preamble
@@ -93,6 +155,16 @@ void delayms(unsigned int t);
 #define LR_RegFifoRxByteAddr                        0x2500//Address of last bytewritten in FIFO
 #define LR_RegModemConfig3                         0x2600//Modem PHY config 3
 
+// RegIrqFlags bits
+#define RFLR_IRQFLAGS_RXTIMEOUT                     0x80
+#define RFLR_IRQFLAGS_RXDONE                        0x40
+#define RFLR_IRQFLAGS_PAYLOADCRCERROR               0x20
+#define RFLR_IRQFLAGS_VALIDHEADER                   0x10
+#define RFLR_IRQFLAGS_TXDONE                        0x08
+#define RFLR_IRQFLAGS_CADDONE                       0x04
+#define RFLR_IRQFLAGS_FHSSCHANGEDCHANNEL            0x02
+#define RFLR_IRQFLAGS_CADDETECTED                   0x01
+
 // I/O settings
 #define REG_LR_DIOMAPPING1                          0x4000
 #define REG_LR_DIOMAPPING2                          0x4100
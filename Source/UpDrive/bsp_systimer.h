@@ -1,12 +1,12 @@
 /*
 *********************************************************************************************************
 *
-*   ģ : ʱģ
-*   ļ : bsp_timer.h
-*        : V1.3
-*   ˵     : ͷļ
+*   模块名称 : 定时器模块
+*   文件名称 : bsp_timer.h
+*   版    本 : V1.3
+*   说    明 : 头文件
 *
-*   Copyright (C), 2015-2016,  www.armfly.com
+*   Copyright (C), 2015-2016, 安富莱电子 www.armfly.com
 *
 *********************************************************************************************************
 */
@@ -15,28 +15,28 @@
 #define __BSP_SYSTIMER_H
 
 /*
-    ڴ˶ɸʱȫֱ
-    ע⣬__IO  volatileΪжϺͬʱʣпɱŻ
+    在此定义若干个软件定时器全局变量
+    注意，必须增加__IO 即 volatile，因为这个变量在中断和主程序中同时被访问，有可能造成编译器错误优化。
 */
-#define TMR_COUNT   4       /* ʱĸ ʱIDΧ 0 - 3) */
+#define TMR_COUNT   4       /* 软件定时器的个数 （定时器ID范围 0 - 3) */
 
-/* ʱṹ壬Ա volatile, CŻʱ */
+/* 定时器结构体，成员变量必须是 volatile, 否则C编译器优化时可能有问题 */
 typedef enum
 {
-    TMR_ONCE_MODE = 0,      /* һιģʽ */
-    TMR_AUTO_MODE = 1       /* Զʱģʽ */
+    TMR_ONCE_MODE = 0,      /* 一次工作模式 */
+    TMR_AUTO_MODE = 1       /* 自动定时工作模式 */
 } TMR_MODE_E;
 
-/* ʱṹ壬Ա volatile, CŻʱ */
+/* 定时器结构体，成员变量必须是 volatile, 否则C编译器优化时可能有问题 */
 typedef struct
 {
-    volatile uint8_t Mode;      /* ģʽ1 */
-    volatile uint8_t Flag;      /* ʱ־  */
-    volatile uint32_t Count;    /*  */
-    volatile uint32_t PreLoad;  /* Ԥװֵ */
+    volatile uint8_t Mode;      /* 计数器模式，1次性 */
+    volatile uint8_t Flag;      /* 定时到达标志  */
+    volatile uint32_t Count;    /* 计数器 */
+    volatile uint32_t PreLoad;  /* 计数器预装值 */
 } SOFT_TMR;
 
-/* ṩCļõĺ */
+/* 提供给其他C文件调用的函数 */
 void SysTickTimer_Init(void);
 void bsp_DelayMS(uint32_t n);
 void bsp_DelayUS(uint32_t n);
@@ -49,4 +49,4 @@ int32_t bsp_CheckRunTime(int32_t _LastTime);
 
 #endif
 
-/*****************************  www.armfly.com (END OF FILE) *********************************/
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
@@ -1,69 +1,112 @@
 #include "bsp.h"
 
 #define NULL 0
-#define DEVID 3 //λ룬1234
+#define TLM_CODEC_EN 0 //1: 上行数据使用关键帧+差分变长编码(帧头为'@')，主机需同步升级解码；0: 原6字节格式
+                       //多条记录聚合为一个数据块后才放入发送队列，遥测延迟最多 TLM_AGG_REC 条记录的间隔
+#define TLM_CHN_NUM 3 //压缩编码的通道数：心率、心率带电量、电池电量
+#define TLM_AGG_REC TLM_MAX_BLK_REC //每个数据块最多聚合的记录数，数据帧放不进发送队列项时提前发出
+#define RF_RECOVER_DELAY 20 //发射失败后延时多少ms执行射频模块恢复任务
+#define RF_TEMP_GUARD_MS 20 //时隙类任务在此时间内将要执行时推迟温度监测，镜像校准约10ms
+#define RF_TEMP_RETRY_MS 1000 //推迟温度监测时的重试间隔
+#define RF_TX_STAGE_MS 3 //本节点时隙开始前多少ms生成上行数据帧并写入发射FIFO，时隙开始时只写一次RegOpMode
+#define AD5933_PRINT_EN 0 //1: 阻抗扫描结果同时以 $实部虚部# 从printf输出，调试用。printf走串口1(蓝牙模块)，正常运行时必须为0
+#define HR_ALARM_HIGH 180 //心率不低于此值时报警
+#define HR_ALARM_LOW 40 //心率不高于此值时报警，0表示心率带未接触，不报警
+#define FRAG_SRC_MAX ((BULK_BUF_SIZE < FRAG_MSG_MAX) ? BULK_BUF_SIZE : FRAG_MSG_MAX) //分片发送的报文只来自积压数据，不超过积压缓冲区大小
 
-extern uint8_t g_uart1_timeout; //⴮1ݳʱȫֱbsp_slavemsg.cļ
-extern uint8_t g_uart2_timeout; //⴮2ݳʱȫֱ
+extern uint8_t TPCTaskNum; //任务数量，在bsp_task.c中被初始化，bsp_tpc.c中使用
+//以下为标志位定义
+uint8_t MasterBstisRcv = FALSE; //从主机广播包解析正确，设置的标志位
+uint8_t BlEisReady = FALSE; //进入串口，同时接收到了正确的数据，标志位
 
-extern RECVDATA_T g_tUart1; //ʼӴ1BLEݽṹ壬bsp_slavemsg.cļ
-extern RECVDATA_T g_tUart2; //ʼӴ2Loraݽṹ壬bsp_slavemsg.cļ
-
-extern uint8_t TPCTaskNum; //bsp_task.cбʼbsp_tpc.cʹ
-//Ϊ־λ
-extern uint8_t LoraPinisHigh;  //main.cмloraIRQţ״̬仯Ϊյloraݣλ
-uint8_t MasterBstisRcv = FALSE; //㲥ȷõı־λ
-uint8_t BlEisReady = FALSE; //봮ڣͬʱյȷݣ־λ
-
-SLVMSG_T s_tSlaMsg; //STM32ʹӻݵĽṹ,bsp_slavemsg.h
-uint8_t KeyScan(void); //״̬İɨ躯
-/************************ṹ˵*************************************/
+SLVMSG_T s_tSlaMsg; //STM32发送从机数据的结构体,见bsp_slavemsg.h
+#if TLM_CODEC_EN == 1
+static TLM_ENC_T s_tTlmEnc; //上行遥测数据编码器
+static int32_t s_iTlmRec[TLM_AGG_REC * TLM_CHN_NUM]; //等待编码的记录，按 [记录][通道] 顺序存放
+static uint8_t s_ucTlmCnt = 0; //等待编码的记录数
+static void FlushTelemetry(uint8_t _cnt); //把最早的若干条记录编码为一个数据帧放入发送队列
+#endif
+uint8_t KeyScan(void); //基于状态机的按键扫描函数
+static uint8_t StageUplink(uint8_t *_pFrame, uint8_t _len); //把上行数据帧写入发射FIFO，远端节点经中继转发
+static uint8_t s_ucTxLead = 0; //上行数据帧准备好后到本节点时隙开始的时间，ms
+static uint8_t s_ucTxStaged = FALSE; //上行数据帧已写入发射FIFO，等待时隙开始
+static void QueueTelemetry(void); //生成遥测数据帧放入发送队列
+static void CheckHrAlarm(uint8_t _hr); //心率越限时生成报警帧
+static void RxWakeArm(void); //按预计的下一个广播包时刻安排间歇接收任务
+static uint16_t AgeAdjust(uint16_t _delay, uint16_t _age); //扣除数据包在接收队列中的等待时间
+static uint8_t s_ucRxWakePhase = 0; //间歇接收任务的阶段：0 打开接收窗口，1 等待窗口结束，2 等待正在接收的数据包
+static uint16_t s_usBulkDur = 0; //主机分配的批量传输窗口长度，ms
+static uint8_t s_ucBulkRate = 0; //批量传输窗口的FSK速率档位
+static uint8_t s_ucBulkReq = FALSE; //批量传输请求已放入发送队列，等待主机分配窗口
+static BLE_PARSER_T s_tBleParser; //串口1 CC2541心率帧解析器，帧格式见bsp_bleframe.h
+static FRAG_TX_T s_tFragTx; //积压数据的分片发送状态
+static uint8_t s_ucFragMsg[FRAG_SRC_MAX]; //正在分片发送的报文，发送完成前不能修改
+static uint8_t BuildUplink(uint8_t *_pFrame); //生成本节点时隙的上行数据帧
+static void TxDoneCheck(int _ret); //发射结束回调：发射失败时启动射频恢复任务
+static void UplinkTxDone(int _ret); //上行数据帧发射结束回调：发出的数据出队
+/************************任务结构体说明*************************************/
 /**
 typedef struct _TPC_TASK
 {
-	uint8_t   attrb;  //̬0̬1
-	uint8_t   Run;  // бǣ0У1xternt
-	uint16_t  Timer;  // ʱ
-	uint16_t  ItvTime;  // мʱ
-	void      (*Task)(void); // Ҫе
-} TPC_TASK; // 
+	uint8_t   attrb;  //静态任务：0，动态任务：1
+	uint8_t   Run;  // 程序运行标记，0：不运行，1：运行xternt
+	uint16_t  Timer;  // 计时器
+	uint16_t  ItvTime;  // 任务运行间隔时间
+	void      (*Task)(void); // 要运行的任务函数
+} TPC_TASK; // 任务定义
 **/
-/************************ṹ˵*************************************/
-TPC_TASK TaskComps[4] =
+/************************任务结构体说明*************************************/
+TPC_TASK TaskComps[11] =
 {
-    //ʱעⵥиıԵĴ
-    { 0, 0, 10, 1000, Task_LEDDisplay }, // ̬LED˸ʱƬＴִ
-    { 0, 0, 1, 2, Task_RecvfromLora }, // ̬񣬴SPIӿڵSX127 8յʱƬＴִ
-    { 1, 0, 100, 0, Task_SendToMaster }, // ̬յ㲥źţʹӻݵ
-    { 0, 0, 1, 10, Task_KeyScan }, // ɨ
-//    { 0, 0, 1, 10, Task_ReadAD5933 }, // ȡAD5933    
-//    { 0, 0, 1, 1, Task_RecvfromUart }, // ̬,ͨڴCC2541    
-//	{ 0, 0, 2, 8, Task_PowerCtl }, // ɨ
-//	{ 0, 0, 3, 10, Task_ADCProcess} //ɼص
+    //添加新任务时，请注意单个任务中改变任务属性的代码
+    { 0, 0, 10, 1000, Task_LEDDisplay }, // 静态任务，LED闪烁任务，时间片到达即可执行
+    { 0, 0, 1, 2, Task_RecvfromLora }, // 静态任务，处理从SPI接口的SX127 8接收的数据任务，时间片到达即可执行
+    { 1, 0, 100, 0, Task_SendToMaster }, // 动态任务，收到广播信号，发送从机数据到主机
+    { 0, 0, 1, 10, Task_KeyScan }, // 按键扫描任务
+    { 1, 0, 0, 0, Task_RfRecover }, // 动态任务，发射失败后复位并重新配置射频模块
+    { 1, 0, 0, 0, Task_RelayForward }, // 动态任务，中继节点在中继时隙转发远端节点的数据
+    { 1, 0, 0, 0, Task_SendAlarm }, // 动态任务，在竞争子时隙发送本超帧时隙之后产生的报警
+    { 1, 0, 0, 0, Task_RxWake }, // 动态任务，间歇接收时在下一个广播包前打开接收窗口
+    { 1, 0, 0, 0, Task_BulkWindow }, // 动态任务，在主机分配的窗口内用FSK模式发送积压数据
+    { 0, 0, RF_TEMP_PERIOD_MS, RF_TEMP_PERIOD_MS, Task_RfTemp }, // 静态任务，监测射频芯片温度，漂移过大时重新校准
+    { 0, 0, 1, 10, Task_RecvfromUart }, // 静态任务，解析串口1接收FIFO中CC2541发来的心率帧，检查心率报警
+//    { 0, 0, 1, 10, Task_ReadAD5933 }, // 读取AD5933任务    
+//	{ 0, 0, 2, 8, Task_PowerCtl }, // 按键扫描任务
+//	{ 0, 0, 3, 10, Task_ADCProcess} //采集电池电量任务
 };
 
 /*********************************************************************************************************
-*     : TaskInit
-*   ˵: ʼ
-*       : 
-*     ֵ: 
+*   函 数 名: TaskInit
+*   功能说明: 任务初始化
+*   形    参: 无
+*   返 回 值: 无
 *********************************************************************************************************/
 void TaskInit(void)
 {
-    TPCTaskNum = (sizeof(TaskComps) / sizeof(TaskComps[0])); // ȡ
+    TPCTaskNum = (sizeof(TaskComps) / sizeof(TaskComps[0])); // 获取任务数
+    JOIN_Init(); //机位号码由主机在广播包中分配
+    RELAY_Init();
+    TXQ_Init();
+    RXD_Init(); //锁定广播周期前保持连续接收
+    BULK_Init();
+    FRAG_TxInit(&s_tFragTx);
+    BLE_ParserInit(&s_tBleParser);
+#if TLM_CODEC_EN == 1
+    TLM_EncInit(&s_tTlmEnc, TLM_CHN_NUM);
+#endif
 }
 /*********************************************************************************************************
-*     : Task_LEDDisplay
-*   ˵: LED˸
+*   函 数 名: Task_LEDDisplay
+*   功能说明: LED闪烁代码
 *********************************************************************************************************/
 void Task_LEDDisplay(void)
 {
-    LED1_TOGGLE(); //ɫLED D7
+    LED1_TOGGLE(); //白色LED D7
     LCD_P8x16Str ( 0, 2, "LED1_TOGGLE" );
 }
 /*********************************************************************************************************
-*     : Task_ReadAD5933
-*   ˵: ȡAD5933迹
+*   函 数 名: Task_ReadAD5933
+*   功能说明: 读取AD5933电阻抗数据任务
 *********************************************************************************************************/
 static unsigned char temp;
 static unsigned int real, img;
@@ -75,163 +118,564 @@ void Task_ReadAD5933(void)
         while(1)//wait for DFT finish
         {
             temp = AD5933_Get_DFT_ST();
-            if( temp & 0x02)//ʵ鲿Ч
+            if( temp & 0x02)//实部和虚部有效
                 break;
         }
         real = AD5933_Get_Real();
         img  = AD5933_Get_Img();
         AD5933_Set_Mode_Freq_UP();
+#if AD5933_PRINT_EN == 1
         printf("$%04X%04X#", real, img);
+#endif
+        {
+            uint8_t rec[4] = { (uint8_t)real, (uint8_t)(real >> 8), (uint8_t)img, (uint8_t)(img >> 8) };
+            BULK_Write(rec, 4); //扫描结果积压到批量传输窗口上传
+        }
     }
 }
 
 /*********************************************************************************************************
-*     : Task_ADCProcess
-*   ˵: ɼص,10msһ
+*   函 数 名: Task_ADCProcess
+*   功能说明: 采集电池电量任务,10ms调用一次
 *********************************************************************************************************/
 void Task_ADCProcess(void)
 {
-	AdcPro(); //ͨadcɼص
+	AdcPro(); //通过adc采集电池电量
 }
 /*********************************************************************************************************
-*     : Task_KeyScan
-*   ˵: ɨ
+*   函 数 名: Task_KeyScan
+*   功能说明: 按键扫描任务
 *********************************************************************************************************/
-static uint32_t KeyStatus = 0;//洢״̬
+static uint32_t KeyStatus = 0;//存储按键状态变量
 void Task_KeyScan(void)
 {
     KeyStatus = KeyScan();
 }
 /*********************************************************************************************************
-*     : Task_PowerCtl
-*   ˵: PWRƵԴţƵԴرյ
+*   函 数 名: Task_PowerCtl
+*   功能说明: PWR控制电源引脚，控制电源关闭的任务
 *********************************************************************************************************/
 void Task_PowerCtl(void)
 {  
     if(KeyStatus == 2)
     {
-        KEY_PWR =  0;//رյԴ
+        KEY_PWR =  0;//关闭电源
     }
 }
 
 /*********************************************************************************************************
-*     : Task_RecvfromLora
-*   ˵: SPIӿڵLoraյ
+*   函 数 名: Task_RecvfromLora
+*   功能说明: 处理从SPI接口的Lora接收的数据任务
 *********************************************************************************************************/
-
-static uint8_t recvdatbuffer[32];   //ݻ
-//static uint8_t recvprintbuffer[32]; //ݴӡ
-//static uint8_t ucrevcount;
 void Task_RecvfromLora(void)
 {
-//    uint8_t length;    
-    if (LoraPinisHigh  == TRUE)//м⵽жΪߣʾյݺλñ־λ
+    PKT_BUF_T *pkt;
+    uint16_t delay, age;
+    int8_t snr;
+    uint8_t got = 0, sent;
+    uint8_t msg_id, map[FRAG_BITMAP_LEN];
+    while ((pkt = RFRxGet()) != NULL) //主循环检测到RxDone时已把数据包取出放入接收队列
     {
-//		OLEDPrint(0, 2, "RF Received");
-//		sprintf(sendBuf, ":%d", bsp_GetRunTime());
-//		OLEDPrint(0, 2, sendBuf);
-//		printf("\t%d\n", bsp_GetRunTime()); //Գʱʱ
-//		ʱ8ms
-//        length = RFM96_LoRaRxPacket(recvdatbuffer);
-        RFM96_LoRaRxPacket(recvdatbuffer);
-        RFRxMode();
-//		ʱ8ms
-//		printf("\t%d\n", bsp_GetRunTime()); //Գʱʱ
-//		if (length > 0)
-//		{
-//			ucrevcount++;
-//			sprintf(recvprintbuffer, "rcvcnt is :%d", ucrevcount);
-//		}
-//		OLEDPrint(0, 2, recvprintbuffer);
-//		printf("receive data length is %d\n", length);
-//		COMx_SendBuf(COM1, recvdatbuffer, 6);
-        if ((recvdatbuffer[0] == '$') && (recvdatbuffer[1] == '#') && (recvdatbuffer[2] == 'S') && (recvdatbuffer[3] == 'T'))
+        got = 1;
+        age = (uint16_t)bsp_CheckRunTime(pkt->time); //从收到到现在的时间，时隙时刻按收到时刻计算
+        if ((pkt->len >= 4) && (pkt->data[0] == '$') && (pkt->data[1] == '#') && (pkt->data[2] == 'S') && (pkt->data[3] == 'T'))
         {
-            MasterBstisRcv = TRUE;   //ýյ־λ
-            TaskComps[2].attrb = 0; //ڵ㷢Ϊ̬
-            TaskComps[2].Timer = (DEVID-1) * 100 + 5; //ڵ1յ㲥źź1ms,ڵ2Ϊ101ms
-//            OLEDPrint(0,3,"recv master!");
+            delay = AgeAdjust(JOIN_OnBeacon(pkt->data, pkt->len), age); //本节点时隙或竞争子时隙的开始时刻
+            RXD_OnBeacon(pkt->len, pkt->time); //测量广播周期，为下一个广播包对时
+            RxWakeArm();
+            sent = RFTxSentTake(); //上一超帧本节点是否发射过
+            if (JOIN_IsJoined() == 0)
+            {
+                TXP_Reset(); //入网请求使用最大功率
+            }
+            else if (JOIN_Feedback(&snr) && sent)
+            {
+                TXP_OnFeedback(snr); //按主机反馈的上行SNR调整发射功率，本节点没有发射时主机的反馈不算数
+            }
+            if (JOIN_FragAck(&msg_id, map))
+            {
+                FRAG_TxAck(&s_tFragTx, msg_id, map); //下一个时隙只重发主机缺少的分片
+            }
+            if (delay != JOIN_NO_TX)
+            {
+                MasterBstisRcv = TRUE;   //设置接收到的主机包标志位
+                TaskComps[2].attrb = 0; //将节点发送任务设置为静态任务
+                //已入网时提前 RF_TX_STAGE_MS 准备上行数据帧，入网请求需要先听后发，不提前准备
+                s_ucTxLead = (JOIN_IsJoined() && (delay > RF_TX_STAGE_MS)) ? RF_TX_STAGE_MS : 0;
+                TaskComps[2].Timer = delay - s_ucTxLead; //时隙0在收到广播信号后5ms启动发送任务,时隙1即为5ms加一个时隙长度
+            }
+            delay = AgeAdjust(JOIN_CapDelay(), age); //报警不等下一超帧，本节点时隙已过时在竞争子时隙发送
+            if (delay != JOIN_NO_TX)
+            {
+                TaskComps[6].attrb = 0;
+                TaskComps[6].Timer = delay;
+            }
+            if (JOIN_BulkGrant(&delay, &s_usBulkDur, &s_ucBulkRate))
+            {
+                TaskComps[8].attrb = 0;
+                TaskComps[8].Timer = AgeAdjust(delay, age);
+            }
+#if RELAY_EN == 1
+            delay = AgeAdjust(JOIN_RelayDelay(), age); //远端节点在本超帧的数据时隙内发送，中继时隙在其后
+            if (delay != JOIN_NO_TX)
+            {
+                TaskComps[5].attrb = 0;
+                TaskComps[5].Timer = delay;
+            }
+#endif
+//                OLEDPrint(0,3,"recv master!");
         }
-        LoraPinisHigh = FALSE;
-    }  
+#if RELAY_EN == 1
+        else
+        {
+            RELAY_OnPacket(pkt->data, pkt->len); //远端节点'^'封装的数据帧，去重后放入中继队列
+        }
+#endif
+        PKT_Free(pkt); //处理完毕，归还缓冲区
+    }
+    if (got)
+    {
+        RFRxMode(); //处理广播包后再决定连续接收还是睡眠，连续接收时不重新配置；上行数据帧已写入发射FIFO时不执行
+    }
+}
+/*********************************************************************************************************
+*   函 数 名: AgeAdjust
+*   功能说明: 数据包在接收队列中等待了 _age ms，从相对收包时刻的延时中扣除，至少为1
+*********************************************************************************************************/
+static uint16_t AgeAdjust(uint16_t _delay, uint16_t _age)
+{
+    if (_delay == JOIN_NO_TX)
+    {
+        return JOIN_NO_TX;
+    }
+    return (_delay > _age) ? (_delay - _age) : 1;
 }
 
 /*********************************************************************************************************
-*     : Task_SendToMaster
-*   ˵: ݰ
+*   函 数 名: Task_SendToMaster
+*   功能说明: 发送数据包至主机任务
 *********************************************************************************************************/
 void Task_SendToMaster(void)
 {
-    if ((MasterBstisRcv == TRUE) && (BlEisReady == TRUE)) //յ㲥źţҴ2541ͨڽյ
+    uint8_t frame[TXQ_FRAME_MAX];
+    uint8_t len;
+    if (s_ucTxStaged == TRUE) //本节点时隙开始，发射已准备好的上行数据帧，发射结束后由 UplinkTxDone 处理结果
+    {
+        s_ucTxStaged = FALSE;
+        RFTxFire(UplinkTxDone);
+    }
+    else if ((MasterBstisRcv == TRUE) && (JOIN_IsJoined() == 0)) //未入网，在竞争子时隙中发送入网请求
+    {
+        uint16_t air = RFM96_LoRaAirtimeUs(JOIN_REQ_LEN) / 1000 + 1;
+
+        if (AIR_CanSend(JOIN_REQ_LEN) == 0)
+        {
+            g_usAirDefer++; //本子频段占空比预算已用完，放弃本超帧
+        }
+        else
+        {
+            //先听后发，退避的截止时间保证请求仍在本竞争子时隙内发完；信道一直忙则放弃，等下一次退避结束
+            RFSendDataLBT(frame, JOIN_BuildRequest(frame), (JOIN_SlotMs() > air) ? (JOIN_SlotMs() - air) : 0, TxDoneCheck);
+        }
+    }
+    else if (MasterBstisRcv == TRUE) //在本节点时隙发送队列中的数据：报警优先，遥测聚合，批量数据填充剩余空间
+    {
+        if (BlEisReady == TRUE) //从2541通过串口接收到数据
+        {
+            QueueTelemetry();
+            BlEisReady = FALSE;
+        }
+        if ((FRAG_TxBusy(&s_tFragTx) == 0) && (BULK_Pending() > 0)) //积压数据先按分片报文在时隙中发送
+        {
+            FRAG_TxLoad(&s_tFragTx, s_ucFragMsg, BULK_Read(s_ucFragMsg, FRAG_SRC_MAX));
+        }
+        else if ((s_ucBulkReq == FALSE) && (BULK_Pending() > 0)) //一个报文还没发完又有积压，申请批量传输窗口
+        {
+            s_ucBulkReq = TXQ_Put(TXQ_TLM, frame, BULK_BuildRequest(frame));
+        }
+        //竞争子时隙的报警或中继转发还没发完时不打包，队列中的数据留到下一超帧
+        len = RFTxBusy() ? 0 : BuildUplink(frame);
+        if ((len > 0) && (AIR_CanSend(len + RELAY_UPLINK_EN * 2) == 0))
+        {
+            TXQ_Done(0);
+            g_usAirDefer++; //占空比预算不足，数据留在队列中
+        }
+        else if ((len > 0) && (StageUplink(frame, len) == 0))
+        {
+            TXQ_Done(0); //发射准备校验失败，不在时隙内重试，交给恢复任务处理
+            TaskComps[4].attrb = 0; //将射频恢复任务设置为静态任务
+            TaskComps[4].Timer = RF_RECOVER_DELAY;
+        }
+        else if (len > 0)
+        {
+            s_ucTxStaged = TRUE; //数据帧已在发射FIFO中，时隙开始时发射
+            TaskComps[2].Timer = (s_ucTxLead > 0) ? s_ucTxLead : 1;
+            MasterBstisRcv = FALSE;
+            return; //保持静态任务，等时隙开始
+        }
+    }
+    TaskComps[2].attrb = 1; //将发送节点数据任务设置为动态任务，等待再次接收到广播信号
+    MasterBstisRcv = FALSE;
+}
+/*********************************************************************************************************
+*   函 数 名: BuildUplink
+*   功能说明: 生成本节点时隙的上行数据帧。报警优先；有分片报文时发送一个分片，遥测留在队列中聚合，
+*             遥测队列快满时才让出时隙，避免遥测被挤掉；没有分片报文时按优先级打包队列中的数据
+*********************************************************************************************************/
+static uint8_t BuildUplink(uint8_t *_pFrame)
+{
+    uint8_t len;
+
+    if (FRAG_TxBusy(&s_tFragTx) && (TXQ_Count(TXQ_TLM) < TXQ_TLM_DEPTH - 1))
+    {
+        len = TXQ_BuildFrame(_pFrame, TXQ_ALARM, JOIN_DevId());
+        if (len == 0)
+        {
+            len = FRAG_TxBuild(&s_tFragTx, _pFrame, JOIN_DevId()); //发射失败的分片在下一轮重发
+        }
+        if (len > 0)
+        {
+            return len;
+        }
+    }
+    return TXQ_BuildFrame(_pFrame, TXQ_BULK, JOIN_DevId());
+}
+/*********************************************************************************************************
+*   函 数 名: TxDoneCheck
+*   功能说明: 发射结束回调，在 RFEventPoll 中调用。发射准备校验失败或等待TxDone超时时启动射频恢复任务
+*********************************************************************************************************/
+static void TxDoneCheck(int _ret)
+{
+    if (_ret == 0)
+    {
+        TaskComps[4].attrb = 0; //将射频恢复任务设置为静态任务
+        TaskComps[4].Timer = RF_RECOVER_DELAY;
+    }
+}
+/*********************************************************************************************************
+*   函 数 名: UplinkTxDone
+*   功能说明: 上行数据帧发射结束回调。发出的数据出队，信道忙或发射失败的数据留在队列中等下一次发送机会
+*********************************************************************************************************/
+static void UplinkTxDone(int _ret)
+{
+    TXQ_Done(_ret > 0);
+    TxDoneCheck(_ret);
+}
+/*********************************************************************************************************
+*   函 数 名: Task_SendAlarm
+*   功能说明: 在竞争子时隙发送报警，收到广播包后执行一次。报警在本节点时隙之前产生时已随时隙发出，这里没有数据
+*********************************************************************************************************/
+void Task_SendAlarm(void)
+{
+    uint8_t frame[TXQ_FRAME_MAX];
+#if RELAY_UPLINK_EN == 1
+    uint8_t wrap[RELAY_ITEM_MAX];
+#endif
+    uint8_t *send = frame;
+    uint8_t len;
+    uint16_t air;
+
+    TaskComps[6].attrb = 1; //恢复为动态任务，等待下一个广播包
+    if (RFTxBusy()) //本节点时隙的数据帧已在发射FIFO中或正在发射，报警留在队列中随下一个时隙发送
+    {
+        return;
+    }
+    len = TXQ_BuildFrame(frame, TXQ_ALARM, JOIN_DevId());
+    if (len == 0)
+    {
+        return;
+    }
+#if RELAY_UPLINK_EN == 1
+    len = RELAY_Wrap(wrap, frame, len); //竞争子时隙的报警同样经中继转发
+    send = wrap;
+#endif
+    if (AIR_CanSend(len) == 0)
     {
-        //ڵ㸳ֵ
-        s_tSlaMsg.head = '&';
-        s_tSlaMsg.devID = DEVID;
-        s_tSlaMsg.BatPowerdata = GetADC()*100/2606;//ADC0ͨȡݽл
-//        s_tSlaMsg.Heartdata = 64;
-//        s_tSlaMsg.HrtPowerdata = 99;
-        s_tSlaMsg.tail = '%';
-        RFSendData(s_tSlaMsg.msg, 6); //͸ýڵ
-        mem_set(s_tSlaMsg.msg,0,6); //Ϻ󽫽ṹ
-        TaskComps[2].attrb = 1; //ͽڵΪ̬񣬵ȴٴνյ㲥ź
-        MasterBstisRcv = FALSE;
-        BlEisReady = FALSE;
+        TXQ_Done(0);
+        g_usAirDefer++;
+        return;
     }
+    air = RFM96_LoRaAirtimeUs(len) / 1000 + 1;
+    RFSendDataLBT(send, len, (JOIN_SlotMs() > air) ? (JOIN_SlotMs() - air) : 0, UplinkTxDone); //信道忙或发射失败时留给下一个时隙
 }
 /*********************************************************************************************************
-*     : Task_RecvfromUart
-*   ˵: uart1ӿڽյCC2541͹
+*   函 数 名: QueueTelemetry
+*   功能说明: 用串口收到的心率数据和电池电量生成遥测数据帧，放入发送队列。devID在打包时填入。
+*             使用压缩编码时先积累记录，凑满 TLM_AGG_REC 条或数据帧将放不进队列项时编码为一个数据块
+*********************************************************************************************************/
+static void QueueTelemetry(void)
+{
+    s_tSlaMsg.head = '&';
+    s_tSlaMsg.devID = 0;
+    s_tSlaMsg.BatPowerdata = GetADC()*100/2606;//从ADC0通道读取数据进行换算
+//    s_tSlaMsg.Heartdata = 64;
+//    s_tSlaMsg.HrtPowerdata = 99;
+    s_tSlaMsg.tail = '%';
+#if TLM_CODEC_EN == 1
+    {
+        TLM_ENC_T enc = s_tTlmEnc; //试编码用编码器的副本，不改变序号和上一条记录
+        uint8_t frame[TLM_BLK_LEN_MAX(TLM_CHN_NUM, TLM_AGG_REC)];
+        int32_t *val = &s_iTlmRec[s_ucTlmCnt * TLM_CHN_NUM];
+
+        val[0] = s_tSlaMsg.Heartdata;
+        val[1] = s_tSlaMsg.HrtPowerdata;
+        val[2] = s_tSlaMsg.BatPowerdata;
+        s_ucTlmCnt++;
+        //加上本条记录后数据帧('@' devID 数据块 '%')放不进发送队列项时，先发出之前的记录
+        if (TLM_EncBlock(&enc, s_iTlmRec, s_ucTlmCnt, frame) + 3 > TXQ_ITEM_MAX)
+        {
+            FlushTelemetry(s_ucTlmCnt - 1);
+        }
+        else if (s_ucTlmCnt == TLM_AGG_REC)
+        {
+            FlushTelemetry(s_ucTlmCnt);
+        }
+    }
+#else
+    TXQ_Put(TXQ_TLM, s_tSlaMsg.msg, 6);
+#endif
+    mem_set(s_tSlaMsg.msg,0,6); //放入队列后将结构体数据清零
+}
+#if TLM_CODEC_EN == 1
+/*********************************************************************************************************
+*   函 数 名: FlushTelemetry
+*   功能说明: 把最早的 _cnt 条记录编码为一个数据块，组成 '@' devID 数据块 '%' 放入发送队列，其余记录前移。
+*             单条记录编码后最长 TLM_BLK_LEN_MAX(TLM_CHN_NUM, 1) + 3 字节，总能放进一个队列项
+*********************************************************************************************************/
+static void FlushTelemetry(uint8_t _cnt)
+{
+    uint8_t frame[TLM_BLK_LEN_MAX(TLM_CHN_NUM, TLM_AGG_REC) + 3];
+    uint8_t len, i;
+
+    frame[0] = '@';
+    frame[1] = 0;
+    len = 2 + TLM_EncBlock(&s_tTlmEnc, s_iTlmRec, _cnt, &frame[2]);
+    frame[len++] = '%';
+    TXQ_Put(TXQ_TLM, frame, len); //压缩后的节点数据
+    for (i = 0; i < (s_ucTlmCnt - _cnt) * TLM_CHN_NUM; i++)
+    {
+        s_iTlmRec[i] = s_iTlmRec[_cnt * TLM_CHN_NUM + i];
+    }
+    s_ucTlmCnt -= _cnt;
+}
+#endif
+/*********************************************************************************************************
+*   函 数 名: CheckHrAlarm
+*   功能说明: 心率进入越限状态时生成一次报警帧 '!' devID 代码 心率 '%'，持续越限不重复报警
+*********************************************************************************************************/
+static void CheckHrAlarm(uint8_t _hr)
+{
+    static uint8_t s_ucAlarm = 0; //当前报警代码，0为正常
+    uint8_t code = 0;
+    uint8_t frame[5];
+
+    if (_hr >= HR_ALARM_HIGH)
+    {
+        code = ALM_HR_HIGH;
+    }
+    else if ((_hr > 0) && (_hr <= HR_ALARM_LOW))
+    {
+        code = ALM_HR_LOW;
+    }
+    if ((code != 0) && (code != s_ucAlarm))
+    {
+        frame[0] = '!';
+        frame[1] = 0;
+        frame[2] = code;
+        frame[3] = _hr;
+        frame[4] = '%';
+        TXQ_Put(TXQ_ALARM, frame, 5);
+    }
+    s_ucAlarm = code;
+}
+/*********************************************************************************************************
+*   函 数 名: StageUplink
+*   功能说明: 把上行数据帧写入发射FIFO，由 RFTxFire 发射。RELAY_UPLINK_EN 为1时封装为'^'帧，由中继节点转发给主机
+*********************************************************************************************************/
+static uint8_t StageUplink(uint8_t *_pFrame, uint8_t _len)
+{
+#if RELAY_UPLINK_EN == 1
+    uint8_t wrap[RELAY_ITEM_MAX];
+
+    return RFTxStage(wrap, RELAY_Wrap(wrap, _pFrame, _len)); //远端节点直接发给主机收不到，不论长短都经中继
+#else
+    return RFTxStage(_pFrame, _len);
+#endif
+}
+/*********************************************************************************************************
+*   函 数 名: Task_RelayForward
+*   功能说明: 中继转发任务，收到广播包后在中继时隙执行一次，把中继队列中的数据帧打包发给主机
+*********************************************************************************************************/
+void Task_RelayForward(void)
+{
+    uint8_t frame[RELAY_FRAME_MAX];
+    uint8_t len;
+
+    len = RFTxBusy() ? 0 : RELAY_FrameLen(); //射频正忙时数据帧留在中继队列中
+    if ((len > 0) && (AIR_CanSend(len) == 0))
+    {
+        g_usAirDefer++; //占空比预算不足，数据帧留在中继队列中
+    }
+    else if (len > 0)
+    {
+        len = RELAY_BuildFrame(frame, JOIN_DevId());
+        RFSendData(frame, len, TxDoneCheck); //发射失败时交给射频恢复任务处理
+    }
+    TaskComps[5].attrb = 1; //恢复为动态任务，等待下一个广播包
+}
+/*********************************************************************************************************
+*   函 数 名: RxWakeArm
+*   功能说明: 间歇接收时安排 Task_RxWake 在预计的下一个广播包之前执行，否则停止该任务
+*********************************************************************************************************/
+static void RxWakeArm(void)
+{
+    uint16_t delay = RXD_WakeDelay();
+
+    s_ucRxWakePhase = 0;
+    TaskComps[7].Timer = delay;
+    TaskComps[7].attrb = (delay > 0) ? 0 : 1;
+}
+/*********************************************************************************************************
+*   函 数 名: Task_RxWake
+*   功能说明: 间歇接收任务。射频在超帧其余时间睡眠，本任务在预计的广播包之前打开单次接收窗口；
+*             收到广播包时由 Task_RecvfromLora 重新安排，窗口超时或收到的不是广播包则记为错过一次，
+*             连续错过 RXD_MISS_MAX 次后 RFRxMode 恢复连续接收，等待重新测量广播周期。
+*             窗口期间每1ms检查一次DIO中断事件：RxTimeout(DIO1)后立即睡眠，ValidHeader(DIO3)后等待数据包收完
+*********************************************************************************************************/
+void Task_RxWake(void)
+{
+    static int32_t s_iOpen; //打开接收窗口的时刻
+    uint16_t limit;
+
+    if (RXD_Active() == 0) //已恢复连续接收
+    {
+        TaskComps[7].attrb = 1;
+        return;
+    }
+    if ((s_ucRxWakePhase == 0) && RFTxBusy()) //发射还没结束，1ms后再打开接收窗口
+    {
+        TaskComps[7].Timer = 1;
+        return;
+    }
+    if (s_ucRxWakePhase == 0)
+    {
+        RFRxWindow();
+        s_iOpen = bsp_GetRunTime();
+        s_ucRxWakePhase = 1;
+        TaskComps[7].Timer = 1;
+        return;
+    }
+    if (s_ucRxWakePhase == 1)
+    {
+        //没有等到DIO1时按符号超时加一个最大数据包的时间兜底
+        limit = (RXD_WindowSymbols() * RFM96_LoRaSymbolUs() + RFM96_LoRaAirtimeUs(PKT_LARGE_SIZE)) / 1000 + 1;
+        if (RFRxBusy())
+        {
+            s_ucRxWakePhase = 2; //检测到包头，正在接收，最长等一个最大数据包的时间
+            TaskComps[7].Timer = RFM96_LoRaAirtimeUs(PKT_LARGE_SIZE) / 1000 + 1;
+            return;
+        }
+        if ((RFRxTimedOut() == 0) && (bsp_CheckRunTime(s_iOpen) < limit))
+        {
+            TaskComps[7].Timer = 1;
+            return;
+        }
+    }
+    RXD_OnMiss();
+    RFRxMode(); //继续睡眠，或连续错过多次后恢复连续接收
+    RxWakeArm();
+}
+/*********************************************************************************************************
+*   函 数 名: Task_BulkWindow
+*   功能说明: 批量传输任务，广播包分配了本节点的窗口时在窗口开始执行一次，FSK发送期间阻塞其他任务
+*********************************************************************************************************/
+void Task_BulkWindow(void)
+{
+    TaskComps[8].attrb = 1; //恢复为动态任务，等待下一次分配
+    s_ucBulkReq = FALSE; //窗口结束后仍有积压数据时重新申请
+    if (RFTxBusy() || (BULK_Pending() == 0)) //本节点时隙的数据帧在发射FIFO中或正在发射，不切换模式
+    {
+        return;
+    }
+    BULK_Run(s_usBulkDur, s_ucBulkRate, JOIN_DevId());
+}
+/*********************************************************************************************************
+*   函 数 名: Task_RfTemp
+*   功能说明: 射频温度监测任务，每 RF_TEMP_PERIOD_MS 执行一次。发射FIFO中有数据、时隙类任务即将执行
+*             或射频正忙时推迟 RF_TEMP_RETRY_MS 再试
+*********************************************************************************************************/
+void Task_RfTemp(void)
+{
+    static const uint8_t s_ucSlotTask[] = { 2, 5, 6, 7, 8 }; //广播包安排的时隙类任务
+    uint8_t i;
+
+    for (i = 0; i < sizeof(s_ucSlotTask); i++)
+    {
+        if ((TaskComps[s_ucSlotTask[i]].attrb == 0) && (TaskComps[s_ucSlotTask[i]].Timer < RF_TEMP_GUARD_MS))
+        {
+            break;
+        }
+    }
+    if ((i < sizeof(s_ucSlotTask)) || (RFTempCheck() == 0)) //射频正忙时RFTempCheck返回0
+    {
+        TaskComps[9].Timer = RF_TEMP_RETRY_MS;
+    }
+}
+/*********************************************************************************************************
+*   函 数 名: Task_RfRecover
+*   功能说明: 射频模块恢复任务，发射失败时由 Task_SendToMaster 启动，执行一次后恢复为动态任务
+*********************************************************************************************************/
+void Task_RfRecover(void)
+{
+    RFRecover(); //重新初始化SPI2，复位SX1278并进入接收模式
+    TaskComps[4].attrb = 1; //恢复为动态任务，等待下一次发射失败
+}
+/*********************************************************************************************************
+*   函 数 名: Task_RecvfromUart
+*   功能说明: 处理从uart1接口接收到的CC2541发送过来的数据任务。每10ms执行一次，不会阻塞其他任务；
+*             115200bps下1KB接收FIFO可缓存约89ms的数据
 *********************************************************************************************************/
 void Task_RecvfromUart(void)
 {
+    RING_SPAN_T span;
+    BLE_FRAME_T frame;
+    uint16_t len, i;
+    uint8_t k;
 
-//3.5ַʱִUart1_RxTimeOutȫֱ g_uart1_timeout = 1; ֪ͨʼ
-	if (g_uart1_timeout == 0)
-	{
-		return; // ûгʱաҪ g_tUart1.RxCount
-	}
-	if (g_tUart1.RxCount < 5)    // յС3ֽھΪ
-	{
-		return;
-	}
-//    printf("%d",g_tUart1.RxCount); //ԽݸǷȷ
-	g_uart1_timeout = 0; // ʱ־
-//    printf("\t%d\n",bsp_GetRunTime());//Գʱʱ
-	if ((g_tUart1.RxBuf[0] != '$') && (g_tUart1.RxBuf[4] != '#')) //ݰͷǷȷ
-	{
-		printf("error in head!");
-	} 
-    else if (g_tUart1.RxBuf[1] == 'P' || g_tUart1.RxBuf[1] == 'H') //ݰǷȷ
-	{
-//ݰȷ
-		s_tSlaMsg.Heartdata = g_tUart1.RxBuf[2];//ֵ
-		s_tSlaMsg.HrtPowerdata = g_tUart1.RxBuf[3];//ʴص
-        BlEisReady = TRUE;
-	} 
-    else
-	{
-//		s_tSlaMsg.Heartdata = 0;
-//		s_tSlaMsg.HrtPowerdata = 0;
-	}
-	g_tUart1.RxCount = 0; // ´֡ͬ
+    //直接在串口1接收FIFO中逐字节解析，不等待总线空闲，连续到达的多帧逐个处理
+    len = COMx_Peek(COM1, &span);
+    for (k = 0; k < 2; k++)
+    {
+        for (i = 0; i < span.usLen[k]; i++)
+        {
+            if (BLE_ParseByte(&s_tBleParser, span.pData[k][i], &frame))
+            {
+                s_tSlaMsg.Heartdata = frame.heart; //心率数值
+                s_tSlaMsg.HrtPowerdata = frame.battery; //心率带电池电量
+                CheckHrAlarm(s_tSlaMsg.Heartdata);
+                BlEisReady = TRUE;
+            }
+        }
+    }
+    COMx_Consume(COM1, len); //未完成的帧已保存在解析器中
 }
 
 
 /*********************************************************************************************************
-*     : KeyScan
-*   ˵: ɨ룬ӵPA4ţ°3ӵʱ
+*   函 数 名: KeyScan
+*   功能说明: 按键扫描代码，按键接到PA4引脚，当按下按键超过3秒钟的时候
 *********************************************************************************************************/
 uint8_t KeyScan(void)
 {
-	static uint8_t ucKeyStatus = 0; //ʾ״̬0ʾδ£1ʾ£2ʾ3ʾ
-	static uint32_t uiKeyInput = 0; //ȡİֵʱΪߵƽ
-	static uint32_t uiCount = 0; //뿪Ӧ100
-	uint8_t key_return = 0; //ֵ
+	static uint8_t ucKeyStatus = 0; //表示按键状态，0表示未按下，1表示按下，2表示长按，3表示弹起
+	static uint32_t uiKeyInput = 0; //保存读取的按键键值，按键按下时为高电平
+	static uint32_t uiCount = 0; //长按计数器，长按三秒开机，应计数100次
+	uint8_t key_return = 0; //函数返回值
 	uiKeyInput = KEY_KEY;
 
 	switch (ucKeyStatus)
 	{
-	case 0: //ǳʼ̬޶
+	case 0: //如果是初始态，即无动作
 		if (uiKeyInput == 0)
 		{
 			ucKeyStatus = 1;
@@ -240,35 +684,35 @@ uint8_t KeyScan(void)
 			ucKeyStatus = 0;
 		}
 		break;
-	case 1: //ǰǱ
-		if (uiKeyInput == 0) //ڻ
+	case 1: //如果先前是被按着
+		if (uiKeyInput == 0) //如果现在还被按着
 		{
-			ucKeyStatus = 2; //лʱ̬
+			ucKeyStatus = 2; //切换到计时态
 			uiCount = 0;
 		} else
 		{
 			ucKeyStatus = 0;
 		}
 		break;
-	case 2: //Ѿл״̬2
-		if (uiKeyInput == 0) //ڻ
+	case 2: //如果已经切换到状态2
+		if (uiKeyInput == 0) //如果现在还被按着
 		{
 			ucKeyStatus = 2;
 			uiCount++;
-			key_return = 1; //1,һͨ飬˵Ѿ210msжϣѾ
-							//ôʱ⵽ͷţ˵һ̰ͨ
-			if (uiCount > 300) //ʱ3s
+			key_return = 1; //返回1,一次完整的普通按键，程序进入这个语句块，说明已经有2次以上10ms的中断，等于已经消抖
+							//那么此时检测到按键被释放，说明是一次普通短按
+			if (uiCount > 300) //按键时间大于3s
 			{
 				uiCount = 0;
-				key_return = 2; //
+				key_return = 2; //长按情况
 			}
-		} else //Ѿ
+		} else //如果已经弹起
 		{
 			ucKeyStatus = 3;
 		}
 		break;
-	case 3: //Ѿл״̬3
-		if (uiKeyInput == 1)//Ѿ
+	case 3: //如果已经切换到状态3
+		if (uiKeyInput == 1)//如果已经弹起
 		{
 			ucKeyStatus = 0;
 			uiCount = 0;
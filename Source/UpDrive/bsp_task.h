@@ -1,49 +1,55 @@
 #ifndef  __TASK__H__
 #define  __TASK__H__
 #include "bsp_tpc.h"
-#pragma anon_unions //ʹṹ
+#pragma anon_unions //使用匿名结构体
 
 /********************************************************************************************************
-* 궨
+* 宏定义
 ********************************************************************************************************/
-#define KEY_KEY 	PAin(4) //PA4,KEYɨ谴
-#define KEY_PWR		PCout(13) //PC13,PWRư
+#define KEY_KEY 	PAin(4) //PA4,KEY扫描按键
+#define KEY_PWR		PCout(13) //PC13,PWR控制按键
 
 typedef union
 {
 	uint8_t msg[8];
 	struct
 	{
-		uint8_t head; //ͷ
-		uint8_t devID; //豸id
-		uint8_t Heartdata; //ֵ
-		uint8_t HrtPowerdata; //ʴ
-		uint8_t BatPowerdata; //ص
-		uint8_t tail; //β
+		uint8_t head; //包头
+		uint8_t devID; //设备id
+		uint8_t Heartdata; //心率值
+		uint8_t HrtPowerdata; //心率带电量
+		uint8_t BatPowerdata; //电池电量
+		uint8_t tail; //包尾
 	};
-} SLVMSG_T; //ӻϢṹ
+} SLVMSG_T; //从机信息结构体
 
 
 /********************************************************************************************************
-* 
+* 变量定义
 ********************************************************************************************************/
 extern TPC_TASK TaskComps[];
 
 /********************************************************************************************************
-* ڲ
+* 内部函数
 ********************************************************************************************************/
-static void Task_RecvfromUart(void);  // 㲥
-static void Task_LEDDisplay(void);  //LED˸
-static void Task_SendToMaster(void); //PC
-static void Task_RecvfromLora(void); //LoraSX1278ӵĴ2ȡ
-static void Task_KeyScan(void); //ɨһ
-static void Task_PowerCtl(void); //ƹػ
-static void Task_ADCProcess(void); //ADCɼѹõ
-static void Task_ReadAD5933(void); //AD5933ȡ迹
+static void Task_RecvfromUart(void);  // 广播任务
+static void Task_LEDDisplay(void);  //LED闪烁任务
+static void Task_SendToMaster(void); //发送数据至PC机
+static void Task_RecvfromLora(void); //从Lora（SX1278）所连接的串口2读取数据任务
+static void Task_KeyScan(void); //扫描一键开机键的任务
+static void Task_PowerCtl(void); //控制关机任务
+static void Task_ADCProcess(void); //ADC采集串联分压电阻获得电量程序
+static void Task_ReadAD5933(void); //从AD5933读取电阻抗数据任务
+static void Task_RfRecover(void); //发射失败后恢复射频模块任务
+static void Task_RelayForward(void); //中继节点转发远端节点数据任务
+static void Task_SendAlarm(void); //在竞争子时隙发送报警任务
+static void Task_RxWake(void); //间歇接收时在广播包前打开接收窗口任务
+static void Task_BulkWindow(void); //在主机分配的窗口内用FSK模式发送积压数据任务
+static void Task_RfTemp(void); //监测射频芯片温度并按需重新校准任务
 /********************************************************************************************************
-* ȫֺ
+* 全局函数
 ********************************************************************************************************/
-extern void TaskInit(void); // ʼ
+extern void TaskInit(void); // 初始化
 extern void bsp_KeyScan(void);
 /*******************************************************************************************************/
 #endif
@@ -1,19 +1,19 @@
 /********************************************************************************************************
 *
-*   ģ : Ӳʱ
-*   ļ : bsp_timer.c
-*        : V1.0
-*   ˵     :
-*   ޸ļ¼ :
+*   模块名称 : 硬件定时器
+*   文件名称 : bsp_timer.c
+*   版    本 : V1.0
+*   说    明 :
+*   修改记录 :
 
 *********************************************************************************************************/
 
 #include "bsp.h"
 
 /*
-  ӲʱTIM ʹ TIM2 - TIM5
-    TIM3 TIM4 16λ
-    TIM2 TIM5 16λ (10316λ, 40732λ)
+  定义用于硬件定时器的TIM， 可以使 TIM2 - TIM5
+    TIM3 和TIM4 是16位
+    TIM2 和TIM5 是16位 (103是16位, 407是32位)
 */
 #define USE_TIM2
 //#define USE_TIM3
@@ -45,7 +45,7 @@
 #endif
 
 
-/*  TIMʱжϵִеĻصָ */
+/* 保存 TIM定时中断到后执行的回调函数指针 */
 static void (*s_TIM_CallBack1)(void);
 static void (*s_TIM_CallBack2)(void);
 static void (*s_TIM_CallBack3)(void);
@@ -53,11 +53,11 @@ static void (*s_TIM_CallBack4)(void);
 
 /*
 *********************************************************************************************************
-*     : bsp_HardTimerInit
-*   ˵:  TIMxusӲʱTIMxУֹͣ.
-*           TIMxTIM2 - TIM5 ֮TIM, ЩTIM4ͨ,  APB1 ϣʱ=SystemCoreClock / 2
-*       : 
-*     ֵ: 
+*   函 数 名: bsp_HardTimerInit
+*   功能说明: 配置 TIMx，用于us级别硬件定时。TIMx将自由运行，永不停止.
+*           TIMx可以用TIM2 - TIM5 之间的TIM, 这些TIM有4个通道, 挂在 APB1 上，输入时钟=SystemCoreClock / 2
+*   形    参: 无
+*   返 回 值: 无
 *********************************************************************************************************
 */
 #if defined (USE_TIM2) || defined (USE_TIM3)  || defined (USE_TIM4) || defined (USE_TIM5)
@@ -68,30 +68,30 @@ void bsp_HardTimerInit(void)
     uint16_t usPrescaler;
     uint32_t uiTIMxCLK;
 
-    /* ʹTIMʱ */
+    /* 使能TIM时钟 */
     RCC_APB1PeriphClockCmd(TIM_HARD_RCC, ENABLE);
 
     /*-----------------------------------------------------------------------
-        system_stm32f4xx.c ļ void SetSysClock(void) ʱӵ£
+        system_stm32f4xx.c 文件中 void SetSysClock(void) 函数对时钟的配置如下：
 
         HCLK = SYSCLK / 1     (AHB1Periph)
         PCLK2 = HCLK / 2      (APB2Periph)
         PCLK1 = HCLK / 4      (APB1Periph)
 
-        ΪAPB1 prescaler != 1,  APB1ϵTIMxCLK = PCLK1 x 2 = SystemCoreClock / 2;
-        ΪAPB2 prescaler != 1,  APB2ϵTIMxCLK = PCLK2 x 2 = SystemCoreClock;
+        因为APB1 prescaler != 1, 所以 APB1上的TIMxCLK = PCLK1 x 2 = SystemCoreClock / 2;
+        因为APB2 prescaler != 1, 所以 APB2上的TIMxCLK = PCLK2 x 2 = SystemCoreClock;
 
-        APB1 ʱ TIM2, TIM3 ,TIM4, TIM5, TIM6, TIM7, TIM12, TIM13,TIM14
-        APB2 ʱ TIM1, TIM8 ,TIM9, TIM10, TIM11
+        APB1 定时器有 TIM2, TIM3 ,TIM4, TIM5, TIM6, TIM7, TIM12, TIM13,TIM14
+        APB2 定时器有 TIM1, TIM8 ,TIM9, TIM10, TIM11
 
     ----------------------------------------------------------------------- */
     uiTIMxCLK = SystemCoreClock / 2;
 
-    usPrescaler = uiTIMxCLK / 1000000 ; /* Ƶ 1us */
+    usPrescaler = uiTIMxCLK / 1000000 ; /* 分频到周期 1us */
 
 #if defined (USE_TIM2) || defined (USE_TIM5)
-    //usPeriod = 0xFFFFFFFF;    /* 407֧32λʱ */
-    usPeriod = 0xFFFF;  /* 103֧16λ */
+    //usPeriod = 0xFFFFFFFF;    /* 407支持32位定时器 */
+    usPeriod = 0xFFFF;  /* 103支持16位 */
 #else
     usPeriod = 0xFFFF;
 #endif
@@ -108,13 +108,13 @@ void bsp_HardTimerInit(void)
     /* TIMx enable counter */
     TIM_Cmd(TIM_HARD, ENABLE);
 
-    /* TIMʱж (Update) */
+    /* 配置TIM定时中断 (Update) */
     {
-        NVIC_InitTypeDef NVIC_InitStructure;    /* жϽṹ misc.h ж */
+        NVIC_InitTypeDef NVIC_InitStructure;    /* 中断结构体在 misc.h 中定义 */
 
         NVIC_InitStructure.NVIC_IRQChannel = TIM_HARD_IRQn;
 
-        NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 4;   /* ȴȼ */
+        NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 4;   /* 比串口优先级低 */
         NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
         NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
         NVIC_Init(&NVIC_InitStructure);
@@ -123,15 +123,15 @@ void bsp_HardTimerInit(void)
 
 /*
 *********************************************************************************************************
-*     : bsp_StartHardTimer
-*   ˵: ʹTIM2-5ζʱʹ, ʱʱ䵽ִлصͬʱ4ʱš
-*           ʱ10us Ҫķڵñִʱ䣬ڲ˲С
-*           TIM2TIM5 16λʱ
-*           TIM3TIM4 16λʱ
-*       : _CC : ͨ123, 4
-*           _uiTimeOut : ʱʱ, λ 1us.  16λʱ 65.5ms; 32λʱ 4294
-*           _pCallBack : ʱʱ䵽󣬱ִеĺ
-*     ֵ: 
+*   函 数 名: bsp_StartHardTimer
+*   功能说明: 使用TIM2-5做单次定时器使用, 定时时间到后执行回调函数。可以同时启动4个定时器，互不干扰。
+*           定时精度正负10us （主要耗费在调用本函数的执行时间，函数内部进行了补偿减小误差）
+*           TIM2和TIM5 是16位定时器。
+*           TIM3和TIM4 是16位定时器。
+*   形    参: _CC : 捕获通道几，1，2，3, 4
+*           _uiTimeOut : 超时时间, 单位 1us.  对于16位定时器，最大 65.5ms; 对于32位定时器，最大 4294秒
+*           _pCallBack : 定时时间到后，被执行的函数
+*   返 回 值: 无
 *********************************************************************************************************
 */
 void bsp_StartHardTimer(uint8_t _CC, uint32_t _uiTimeOut, void *_pCallBack)
@@ -140,7 +140,7 @@ void bsp_StartHardTimer(uint8_t _CC, uint32_t _uiTimeOut, void *_pCallBack)
     uint32_t cnt_tar;
 
     /*
-        ִ䣬ʱ = 18us (ͨ߼ǲIOת)
+        执行下面这个语句，时长 = 18us (通过逻辑分析仪测量IO翻转)
         bsp_StartTimer2(3, 500, (void *)test1);
     */
     if (_uiTimeOut < 5)
@@ -152,40 +152,40 @@ void bsp_StartHardTimer(uint8_t _CC, uint32_t _uiTimeOut, void *_pCallBack)
         _uiTimeOut -= 5;
     }
 
-    cnt_now = TIM_GetCounter(TIM_HARD);     /* ȡǰļֵ */
-    cnt_tar = cnt_now + _uiTimeOut;         /* 㲶ļֵ */
+    cnt_now = TIM_GetCounter(TIM_HARD);     /* 读取当前的计数器值 */
+    cnt_tar = cnt_now + _uiTimeOut;         /* 计算捕获的计数器值 */
     if (_CC == 1)
     {
         s_TIM_CallBack1 = (void (*)(void))_pCallBack;
 
-        TIM_SetCompare1(TIM_HARD, cnt_tar);       /* òȽϼCC1 */
+        TIM_SetCompare1(TIM_HARD, cnt_tar);       /* 设置捕获比较计数器CC1 */
         TIM_ClearITPendingBit(TIM_HARD, TIM_IT_CC1);
-        TIM_ITConfig(TIM_HARD, TIM_IT_CC1, ENABLE);   /* ʹCC1ж */
+        TIM_ITConfig(TIM_HARD, TIM_IT_CC1, ENABLE);   /* 使能CC1中断 */
 
     }
     else if (_CC == 2)
     {
         s_TIM_CallBack2 = (void (*)(void))_pCallBack;
 
-        TIM_SetCompare2(TIM_HARD, cnt_tar);       /* òȽϼCC2 */
+        TIM_SetCompare2(TIM_HARD, cnt_tar);       /* 设置捕获比较计数器CC2 */
         TIM_ClearITPendingBit(TIM_HARD, TIM_IT_CC2);
-        TIM_ITConfig(TIM_HARD, TIM_IT_CC2, ENABLE);   /* ʹCC2ж */
+        TIM_ITConfig(TIM_HARD, TIM_IT_CC2, ENABLE);   /* 使能CC2中断 */
     }
     else if (_CC == 3)
     {
         s_TIM_CallBack3 = (void (*)(void))_pCallBack;
 
-        TIM_SetCompare3(TIM_HARD, cnt_tar);       /* òȽϼCC3 */
+        TIM_SetCompare3(TIM_HARD, cnt_tar);       /* 设置捕获比较计数器CC3 */
         TIM_ClearITPendingBit(TIM_HARD, TIM_IT_CC3);
-        TIM_ITConfig(TIM_HARD, TIM_IT_CC3, ENABLE);   /* ʹCC3ж */
+        TIM_ITConfig(TIM_HARD, TIM_IT_CC3, ENABLE);   /* 使能CC3中断 */
     }
     else if (_CC == 4)
     {
         s_TIM_CallBack4 = (void (*)(void))_pCallBack;
 
-        TIM_SetCompare4(TIM_HARD, cnt_tar);       /* òȽϼCC4 */
+        TIM_SetCompare4(TIM_HARD, cnt_tar);       /* 设置捕获比较计数器CC4 */
         TIM_ClearITPendingBit(TIM_HARD, TIM_IT_CC4);
-        TIM_ITConfig(TIM_HARD, TIM_IT_CC4, ENABLE);   /* ʹCC4ж */
+        TIM_ITConfig(TIM_HARD, TIM_IT_CC4, ENABLE);   /* 使能CC4中断 */
     }
     else
     {
@@ -197,10 +197,10 @@ void bsp_StartHardTimer(uint8_t _CC, uint32_t _uiTimeOut, void *_pCallBack)
 
 /*
 *********************************************************************************************************
-*     : TIMx_IRQHandler
-*   ˵: TIM жϷ
-*       Σ
-*     ֵ: 
+*   函 数 名: TIMx_IRQHandler
+*   功能说明: TIM 中断服务程序
+*   形    参：无
+*   返 回 值: 无
 *********************************************************************************************************
 */
 
@@ -223,36 +223,36 @@ void TIM5_IRQHandler(void)
     if (TIM_GetITStatus(TIM_HARD, TIM_IT_CC1))
     {
         TIM_ClearITPendingBit(TIM_HARD, TIM_IT_CC1);
-        TIM_ITConfig(TIM_HARD, TIM_IT_CC1, DISABLE);    /* CC1ж */
+        TIM_ITConfig(TIM_HARD, TIM_IT_CC1, DISABLE);    /* 禁能CC1中断 */
 
-        /* ȹرжϣִлصΪصҪʱ */
+        /* 先关闭中断，再执行回调函数。因为回调函数可能需要重启定时器 */
         s_TIM_CallBack1();
     }
 
     if (TIM_GetITStatus(TIM_HARD, TIM_IT_CC2))
     {
         TIM_ClearITPendingBit(TIM_HARD, TIM_IT_CC2);
-        TIM_ITConfig(TIM_HARD, TIM_IT_CC2, DISABLE);    /* CC2ж */
+        TIM_ITConfig(TIM_HARD, TIM_IT_CC2, DISABLE);    /* 禁能CC2中断 */
 
-        /* ȹرжϣִлصΪصҪʱ */
+        /* 先关闭中断，再执行回调函数。因为回调函数可能需要重启定时器 */
         s_TIM_CallBack2();
     }
 
     if (TIM_GetITStatus(TIM_HARD, TIM_IT_CC3))
     {
         TIM_ClearITPendingBit(TIM_HARD, TIM_IT_CC3);
-        TIM_ITConfig(TIM_HARD, TIM_IT_CC3, DISABLE);    /* CC3ж */
+        TIM_ITConfig(TIM_HARD, TIM_IT_CC3, DISABLE);    /* 禁能CC3中断 */
 
-        /* ȹرжϣִлصΪصҪʱ */
+        /* 先关闭中断，再执行回调函数。因为回调函数可能需要重启定时器 */
         s_TIM_CallBack3();
     }
 
     if (TIM_GetITStatus(TIM_HARD, TIM_IT_CC4))
     {
         TIM_ClearITPendingBit(TIM_HARD, TIM_IT_CC4);
-        TIM_ITConfig(TIM_HARD, TIM_IT_CC4, DISABLE);    /* CC4ж */
+        TIM_ITConfig(TIM_HARD, TIM_IT_CC4, DISABLE);    /* 禁能CC4中断 */
 
-        /* ȹرжϣִлصΪصҪʱ */
+        /* 先关闭中断，再执行回调函数。因为回调函数可能需要重启定时器 */
         s_TIM_CallBack4();
     }
 }
@@ -0,0 +1,274 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 遥测数据压缩编解码模块
+*   文件名称 : bsp_tlmcodec.c
+*   版    本 : V1.0
+*   说    明 : 心率、心率带电量、电池电量以及阻抗实部/虚部等数据变化缓慢，逐条发送绝对值浪费空中时间。
+*             本模块周期性发送关键帧(绝对值)，其余记录只发送变化通道的 zig-zag 变长差值。
+*             只用到移位、加减和比较，不依赖任何外设，可以直接在PC上编译。
+*
+*********************************************************************************************************
+*/
+#include "bsp_tlmcodec.h"
+
+/* zig-zag 映射，使绝对值小的负数也能编码为短的变长整数 */
+#define ZIGZAG_ENC(v)   (((uint32_t)(v) << 1) ^ (uint32_t)((int32_t)(v) >> 31))
+#define ZIGZAG_DEC(u)   ((int32_t)(((u) >> 1) ^ (0u - ((u) & 1u))))
+
+/*
+*********************************************************************************************************
+*   函 数 名: TLM_PutVarint
+*   功能说明: 按每字节7位、最高位为续位的格式写入一个无符号整数
+*   形    参: _pOut : 输出缓冲区，至少5字节
+*             _val  : 数值
+*   返 回 值: 写入的字节数
+*********************************************************************************************************
+*/
+uint8_t TLM_PutVarint(uint8_t *_pOut, uint32_t _val)
+{
+    uint8_t n = 0;
+
+    while (_val >= 0x80)
+    {
+        _pOut[n++] = (uint8_t)(_val | 0x80);
+        _val >>= 7;
+    }
+    _pOut[n++] = (uint8_t)_val;
+    return n;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: TLM_GetVarint
+*   功能说明: 读取一个变长整数
+*   形    参: _pIn  : 输入缓冲区
+*             _len  : 缓冲区剩余长度
+*             _pVal : 输出数值
+*   返 回 值: 读取的字节数，0 表示数据不完整或超过5字节
+*********************************************************************************************************
+*/
+uint8_t TLM_GetVarint(const uint8_t *_pIn, uint8_t _len, uint32_t *_pVal)
+{
+    uint32_t val = 0;
+    uint8_t i;
+
+    for (i = 0; i < _len && i < 5; i++)
+    {
+        val |= (uint32_t)(_pIn[i] & 0x7F) << (7 * i);
+        if ((_pIn[i] & 0x80) == 0)
+        {
+            *_pVal = val;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: TLM_EncInit
+*   功能说明: 初始化编码器，第一个数据块一定是关键帧
+*   形    参: _pEnc : 编码器
+*             _chn  : 通道数，1 ~ TLM_MAX_CHN
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void TLM_EncInit(TLM_ENC_T *_pEnc, uint8_t _chn)
+{
+    uint8_t i;
+
+    if (_chn > TLM_MAX_CHN)
+    {
+        _chn = TLM_MAX_CHN;
+    }
+    _pEnc->chn = _chn;
+    _pEnc->seq = 0;
+    _pEnc->since_key = TLM_KEY_INTERVAL;
+    for (i = 0; i < TLM_MAX_CHN; i++)
+    {
+        _pEnc->last[i] = 0;
+    }
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: TLM_EncForceKey
+*   功能说明: 下一个数据块强制发送关键帧。主机报告丢包或重新入网后调用。
+*   形    参: _pEnc : 编码器
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void TLM_EncForceKey(TLM_ENC_T *_pEnc)
+{
+    _pEnc->since_key = TLM_KEY_INTERVAL;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: TLM_EncBlock
+*   功能说明: 将若干条记录编码为一个数据块。每隔 TLM_KEY_INTERVAL 个数据块，第一条记录以绝对值发送。
+*   形    参: _pEnc : 编码器
+*             _pVal : 记录数组，按 [记录][通道] 顺序存放
+*             _cnt  : 记录数，1 ~ TLM_MAX_BLK_REC
+*             _pOut : 输出缓冲区，至少 TLM_BLK_LEN_MAX(chn, _cnt) 字节
+*   返 回 值: 编码后的字节数，参数错误返回0
+*********************************************************************************************************
+*/
+uint8_t TLM_EncBlock(TLM_ENC_T *_pEnc, const int32_t *_pVal, uint8_t _cnt, uint8_t *_pOut)
+{
+    uint8_t masklen = (_pEnc->chn + 7) >> 3;
+    uint8_t n = 2;
+    uint8_t r = 0;
+    uint8_t i;
+
+    if (_cnt == 0 || _cnt > TLM_MAX_BLK_REC || _pEnc->chn == 0
+        || TLM_BLK_LEN_MAX(_pEnc->chn, _cnt) > 255)  /* 保证一个数据块能放进一个LoRa帧 */
+    {
+        return 0;
+    }
+    _pOut[0] = (uint8_t)(((_cnt - 1) << 4) | (_pEnc->chn - 1));
+    _pOut[1] = _pEnc->seq++;
+
+    if (_pEnc->since_key >= TLM_KEY_INTERVAL)
+    {
+        _pOut[0] |= TLM_HDR_KEY;
+        for (i = 0; i < _pEnc->chn; i++)
+        {
+            n += TLM_PutVarint(&_pOut[n], ZIGZAG_ENC(_pVal[i]));
+            _pEnc->last[i] = _pVal[i];
+        }
+        _pEnc->since_key = 0;
+        r = 1;
+    }
+    _pEnc->since_key++;
+
+    for (; r < _cnt; r++)
+    {
+        const int32_t *val = &_pVal[r * _pEnc->chn];
+        uint8_t *mask = &_pOut[n];
+
+        for (i = 0; i < masklen; i++)
+        {
+            mask[i] = 0;
+        }
+        n += masklen;
+        for (i = 0; i < _pEnc->chn; i++)
+        {
+            int32_t delta = (int32_t)((uint32_t)val[i] - (uint32_t)_pEnc->last[i]);
+
+            if (delta != 0)
+            {
+                mask[i >> 3] |= (uint8_t)(1 << (i & 7));
+                n += TLM_PutVarint(&_pOut[n], ZIGZAG_ENC(delta));
+                _pEnc->last[i] = val[i];
+            }
+        }
+    }
+    return n;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: TLM_DecInit
+*   功能说明: 初始化解码器，收到第一个关键帧之前的差分块都会被丢弃
+*   形    参: _pDec : 解码器
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void TLM_DecInit(TLM_DEC_T *_pDec)
+{
+    uint8_t i;
+
+    _pDec->chn = 0;
+    _pDec->seq = 0;
+    _pDec->valid = 0;
+    for (i = 0; i < TLM_MAX_CHN; i++)
+    {
+        _pDec->last[i] = 0;
+    }
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: TLM_DecBlock
+*   功能说明: 解码一个数据块。一个无线帧中可以依次存放多个数据块，调用者按返回值逐块向后解析。
+*             差分块序号不连续(中间丢包)时无法还原，本块及之后的差分块都被跳过，直到下一个关键帧。
+*   形    参: _pDec : 解码器
+*             _pIn  : 数据块起始地址
+*             _len  : 剩余字节数
+*             _pVal : 输出记录数组，至少 TLM_MAX_BLK_REC x 通道数
+*             _pCnt : 输出还原出的记录数，无法还原时为0
+*   返 回 值: 本数据块占用的字节数，0 表示格式错误，应丢弃整帧
+*********************************************************************************************************
+*/
+uint8_t TLM_DecBlock(TLM_DEC_T *_pDec, const uint8_t *_pIn, uint8_t _len, int32_t *_pVal, uint8_t *_pCnt)
+{
+    uint8_t chn, cnt, masklen, n, r, i, k;
+    uint32_t u;
+
+    *_pCnt = 0;
+    if (_len < 2)
+    {
+        return 0;
+    }
+    chn = (_pIn[0] & 0x0F) + 1;
+    cnt = ((_pIn[0] >> 4) & 0x07) + 1;
+    masklen = (chn + 7) >> 3;
+    n = 2;
+    r = 0;
+
+    if (_pIn[0] & TLM_HDR_KEY)
+    {
+        for (i = 0; i < chn; i++)
+        {
+            k = TLM_GetVarint(&_pIn[n], _len - n, &u);
+            if (k == 0)
+            {
+                return 0;
+            }
+            n += k;
+            _pDec->last[i] = ZIGZAG_DEC(u);
+            _pVal[i] = _pDec->last[i];
+        }
+        _pDec->chn = chn;
+        _pDec->valid = 1;
+        r = 1;
+    }
+    else if (chn != _pDec->chn || _pIn[1] != _pDec->seq)
+    {
+        _pDec->valid = 0;
+    }
+
+    for (; r < cnt; r++)
+    {
+        const uint8_t *mask = &_pIn[n];
+
+        if (_len < n + masklen)
+        {
+            return 0;
+        }
+        n += masklen;
+        for (i = 0; i < chn; i++)
+        {
+            if (mask[i >> 3] & (1 << (i & 7)))
+            {
+                k = TLM_GetVarint(&_pIn[n], _len - n, &u);
+                if (k == 0)
+                {
+                    return 0;
+                }
+                n += k;
+                _pDec->last[i] = (int32_t)((uint32_t)_pDec->last[i] + (uint32_t)ZIGZAG_DEC(u));
+            }
+            _pVal[r * chn + i] = _pDec->last[i];
+        }
+    }
+
+    _pDec->seq = _pIn[1] + 1;
+    if (_pDec->valid)
+    {
+        *_pCnt = cnt;
+    }
+    return n;
+}
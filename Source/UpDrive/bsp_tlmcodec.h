@@ -0,0 +1,62 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 遥测数据压缩编解码模块
+*   文件名称 : bsp_tlmcodec.h
+*   版    本 : V1.0
+*   说    明 : 头文件。编码端在从机上运行，解码端供主机和PC端程序使用，两端共用同一份源码。
+*
+*********************************************************************************************************
+*/
+#ifndef __BSP_TLMCODEC_H
+#define __BSP_TLMCODEC_H
+
+#include "stdint.h"
+
+#define TLM_MAX_CHN         16      /* 每条记录最多的通道数 */
+#define TLM_MAX_BLK_REC     8       /* 每个数据块最多的记录数 */
+#define TLM_KEY_INTERVAL    4       /* 每隔多少个数据块发送一次关键帧 */
+
+/* _chn 个通道、_cnt 条记录的数据块编码后的最大长度 */
+#define TLM_BLK_LEN_MAX(_chn, _cnt)     (2 + (_cnt) * (((_chn) + 7) / 8 + (_chn) * 5))
+
+/*
+    数据块格式: [HDR][SEQ][REC0][REC1]...
+        HDR : bit7 = 1 表示关键帧，bit4~6 = 记录数-1，bit0~3 = 通道数-1
+        SEQ : 数据块序号，差分块必须与上一块连续才能还原
+        关键帧的 REC0 : 各通道 zig-zag 变长整数表示的绝对值
+        其余记录      : [MASK...][chX ...] MASK 按位标记相对上一条记录变化的通道，
+                        仅变化的通道携带 zig-zag 变长差值
+    一个无线帧中可以依次存放多个数据块。
+*/
+#define TLM_HDR_KEY         0x80
+
+/* 编码器状态 */
+typedef struct
+{
+    uint8_t chn;                    /* 通道数 */
+    uint8_t seq;                    /* 数据块序号 */
+    uint8_t since_key;              /* 距上一个关键帧的数据块数 */
+    int32_t last[TLM_MAX_CHN];      /* 上一条记录的值 */
+} TLM_ENC_T;
+
+/* 解码器状态 */
+typedef struct
+{
+    uint8_t chn;
+    uint8_t seq;                    /* 期望收到的下一个数据块序号 */
+    uint8_t valid;                  /* 已收到关键帧，差分块可以还原 */
+    int32_t last[TLM_MAX_CHN];
+} TLM_DEC_T;
+
+void TLM_EncInit(TLM_ENC_T *_pEnc, uint8_t _chn);
+void TLM_EncForceKey(TLM_ENC_T *_pEnc);
+uint8_t TLM_EncBlock(TLM_ENC_T *_pEnc, const int32_t *_pVal, uint8_t _cnt, uint8_t *_pOut);
+
+void TLM_DecInit(TLM_DEC_T *_pDec);
+uint8_t TLM_DecBlock(TLM_DEC_T *_pDec, const uint8_t *_pIn, uint8_t _len, int32_t *_pVal, uint8_t *_pCnt);
+
+uint8_t TLM_PutVarint(uint8_t *_pOut, uint32_t _val);
+uint8_t TLM_GetVarint(const uint8_t *_pIn, uint8_t _len, uint32_t *_pVal);
+
+#endif
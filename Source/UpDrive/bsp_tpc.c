@@ -1,23 +1,23 @@
 /*
 *********************************************************************************************************
 *
-*   ģ : OS
-*   ļ : bsp_tpc.c
-*        : V1.0
-*   ˵     : ṩ򵥵ĻʱƬѯĻ
+*   模块名称 : 简易OS代码
+*   文件名称 : bsp_tpc.c
+*   版    本 : V1.0
+*   说    明 : 提供简单的基于时间片轮询的机制
 *
 *********************************************************************************************************
 */
-#include "bsp_tpc.h"  // ͷļ
+#include "bsp_tpc.h"  // 头文件
 
-uint8_t TPCTaskNum = 0;//bsp_task.cбʼ
+uint8_t TPCTaskNum = 0;//任务数量，在bsp_task.c中被初始化
 
 /*
 *********************************************************************************************************
-*     : TPCRemarks
-*   ˵: ־Ϊ̬Ͷ̬д̬ǸҪ޸attrbԵ
-*       : 
-*     ֵ: 
+*   函 数 名: TPCRemarks
+*   功能说明: 任务标志处理，分为静态任务和动态任务来进行处理，动态任务是根据需要修改attrb属性的任务
+*   形    参: 无
+*   返 回 值: 无
 *********************************************************************************************************
 */
 void TPCRemarks(TPC_TASK *pTask)
@@ -26,19 +26,19 @@ void TPCRemarks(TPC_TASK *pTask)
 
     for (i=0; i<TPCTaskNum; i++)
     {
-        if(pTask[i].attrb == 0)//Ǿ̬
+        if(pTask[i].attrb == 0)//如果是静态任务
         {
             if (pTask[i].Timer > 0)
             {
-                pTask[i].Timer--; // ȥһ
+                pTask[i].Timer--; // 减去一个节拍
 
-                if (pTask[i].Timer == 0)  // ʱ
+                if (pTask[i].Timer == 0)  // 时间减完了
                 {
-                    if(pTask[i].attrb == 0)//Ǿ̬ѭִУItvTimeִֵ̬һ
+                    if(pTask[i].attrb == 0)//如果是静态任务，循环执行，ItvTime赋值，动态任务执行一次
                     {
-                        pTask[i].Timer = pTask[i].ItvTime;  // ָʱֵ
+                        pTask[i].Timer = pTask[i].ItvTime;  // 恢复计时器值
                     }
-                    pTask[i].Run   = TPC_RUN_STM; // б־
+                    pTask[i].Run   = TPC_RUN_STM; // 置运行标志
                 }
             }
         }
@@ -47,10 +47,10 @@ void TPCRemarks(TPC_TASK *pTask)
 
 /*
 *********************************************************************************************************
-*     : TPCProcess
-*   ˵: ־
-*       : 
-*     ֵ: 
+*   函 数 名: TPCProcess
+*   功能说明: 任务标志处理
+*   形    参: 无
+*   返 回 值: 无
 *********************************************************************************************************
 */
 void TPCProcess(TPC_TASK *pTask)
@@ -59,10 +59,10 @@ void TPCProcess(TPC_TASK *pTask)
 
     for (i=0; i<TPCTaskNum; i++)
     {
-        if (pTask[i].Run == TPC_RUN_STM)  // б־ж
+        if (pTask[i].Run == TPC_RUN_STM)  // 运行标志判断
         {
-            pTask[i].Task();  // 
-            pTask[i].Run = TPC_RUN_CLM; // ־0ȴʱʱ䵽ٴαΪ̬
+            pTask[i].Task();  // 运行任务
+            pTask[i].Run = TPC_RUN_CLM; // 标志清0，等待延时时间到，再次变为可运行态
         }
     }
 }
@@ -0,0 +1,76 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 发射功率控制
+*   文件名称 : bsp_txpwr.c
+*   版    本 : V1.0
+*   说    明 : 根据主机在广播包中反馈的上行SNR闭环调整发射功率，每个超帧最多调整一次：
+*             余量低于 TXP_MARGIN_DB 时升一档(3dB)；降一档后余量仍不低于目标加 TXP_HYST_DB 时降一档；
+*             主机没收到时一次升 TXP_LOST_STEP 档。未入网或没有反馈时使用最大功率。
+*             发射电流是节点能耗的主要部分，靠近主机的节点降低功率还能减少对相邻网络的干扰。
+*
+*********************************************************************************************************
+*/
+#include "bsp.h"
+
+/*
+*********************************************************************************************************
+*   函 数 名: TXP_Reset
+*   功能说明: 恢复最大发射功率，用于上电、入网请求和失去同步
+*   形    参: 无
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void TXP_Reset(void)
+{
+    RFM96_LoRaSetPower(0);
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: TXP_OnFeedback
+*   功能说明: 处理一次主机反馈，调整发射功率档位。只在上一超帧本节点确实发射过时调用，
+*             否则主机报告没收到会让空闲节点一直升功率
+*   形    参: _snr : 主机测得的上行SNR，单位dB；JOIN_FB_LOST 表示主机没有收到
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void TXP_OnFeedback(int8_t _snr)
+{
+    int16_t margin;
+    uint8_t level = gPwrLevel;
+
+    if (_snr == JOIN_FB_LOST)
+    {
+        level = (level > TXP_LOST_STEP) ? (level - TXP_LOST_STEP) : 0;
+    }
+    else
+    {
+        margin = _snr - TXP_SNR_FLOOR(RFM96ProfileTbl[gProfile].sf); //调制参数档位可在运行中切换
+        if (margin < TXP_MARGIN_DB)
+        {
+            if (level > 0)
+            {
+                level--;
+            }
+        }
+        else if ((margin - 3 >= TXP_MARGIN_DB + TXP_HYST_DB) && (level < RF_PWR_LEVELS - 1))
+        {
+            level++;
+        }
+    }
+    RFM96_LoRaSetPower(level);
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: TXP_PowerDbm
+*   功能说明: 当前发射功率
+*   形    参: 无
+*   返 回 值: 单位dBm
+*********************************************************************************************************
+*/
+int8_t TXP_PowerDbm(void)
+{
+    return RF_PWR_DBM(gPwrLevel);
+}
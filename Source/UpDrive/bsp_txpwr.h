@@ -0,0 +1,26 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 发射功率控制
+*   文件名称 : bsp_txpwr.h
+*   版    本 : V1.0
+*   说    明 : 头文件
+*
+*********************************************************************************************************
+*/
+#ifndef __BSP_TXPWR_H
+#define __BSP_TXPWR_H
+
+#include "stdint.h"
+
+/* 解调门限：SF7为-7.5dB，扩频因子每加1降低2.5dB，取整时向下取，如SF9为-13 */
+#define TXP_SNR_FLOOR(_sf)  (-((5 * (_sf) - 19) / 2))
+#define TXP_MARGIN_DB       8       /* 目标余量：主机测得的SNR高于解调门限的dB数 */
+#define TXP_HYST_DB         2       /* 降一档后余量仍高于目标此值以上才降功率，避免来回跳 */
+#define TXP_LOST_STEP       2       /* 主机没收到上行数据时一次升高的档位数 */
+
+void TXP_Reset(void);
+void TXP_OnFeedback(int8_t _snr);
+int8_t TXP_PowerDbm(void);
+
+#endif
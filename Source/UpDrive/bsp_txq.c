@@ -0,0 +1,204 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 上行发送队列
+*   文件名称 : bsp_txq.c
+*   版    本 : V1.0
+*   说    明 : 按优先级分类、每类深度固定的上行发送队列，代替原来就地覆盖的单个 SLVMSG_T。
+*             打包时先放报警，再放例行遥测，帧内还有空间时放批量数据，报警不会排在例行数据之后。
+*             队列满时丢弃该类最旧的一项(旧的遥测和报警不如新的有用)，但已打包、等待 TXQ_Done 的项
+*             不能丢弃，否则 TXQ_Done(1) 出队的是没有发出的项；全部已打包时丢弃新的一项。
+*             打包后的数据项在 TXQ_Done(1) 时才出队，发射失败时留到下一次发送机会。
+*             队列只在任务中访问，不需要关中断。
+*
+*********************************************************************************************************
+*/
+#include "bsp.h"
+
+typedef struct
+{
+    uint8_t len;
+    uint8_t data[TXQ_ITEM_MAX];
+} TXQ_ITEM_T;
+
+typedef struct
+{
+    TXQ_ITEM_T *item;
+    uint8_t depth;
+    uint8_t head;           /* 最旧一项的位置 */
+    uint8_t count;
+    uint8_t taken;          /* 已打包、等待 TXQ_Done 的项数 */
+} TXQ_CLASS_T;
+
+static TXQ_ITEM_T s_tAlarmItem[TXQ_ALARM_DEPTH];
+static TXQ_ITEM_T s_tTlmItem[TXQ_TLM_DEPTH];
+static TXQ_ITEM_T s_tBulkItem[TXQ_BULK_DEPTH];
+static TXQ_CLASS_T s_tClass[TXQ_CLASS_NUM];
+
+uint16_t g_usTxqDrop[TXQ_CLASS_NUM];    /* 各类因队列满或帧过长而丢弃的数据帧数 */
+
+/*
+*********************************************************************************************************
+*   函 数 名: TXQ_Init
+*   功能说明: 清空所有队列
+*   形    参: 无
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void TXQ_Init(void)
+{
+    mem_set((char *)s_tClass, 0, sizeof(s_tClass));
+    s_tClass[TXQ_ALARM].item = s_tAlarmItem;
+    s_tClass[TXQ_ALARM].depth = TXQ_ALARM_DEPTH;
+    s_tClass[TXQ_TLM].item = s_tTlmItem;
+    s_tClass[TXQ_TLM].depth = TXQ_TLM_DEPTH;
+    s_tClass[TXQ_BULK].item = s_tBulkItem;
+    s_tClass[TXQ_BULK].depth = TXQ_BULK_DEPTH;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: TXQ_Put
+*   功能说明: 把一个数据帧放入指定优先级的队列，队列满时丢弃最旧的未打包项
+*   形    参: _cls : TXQ_ALARM / TXQ_TLM / TXQ_BULK
+*             _pFrame : 数据帧，第2字节为devID，打包时填入
+*             _len : 数据帧长度，2 ~ TXQ_ITEM_MAX
+*   返 回 值: 1 成功，0 参数错误或队列中全是已打包的项
+*********************************************************************************************************
+*/
+uint8_t TXQ_Put(uint8_t _cls, const uint8_t *_pFrame, uint8_t _len)
+{
+    TXQ_CLASS_T *q;
+    TXQ_ITEM_T *item;
+    uint8_t i, j;
+
+    if (_cls >= TXQ_CLASS_NUM)
+    {
+        return 0;
+    }
+    q = &s_tClass[_cls];
+    if ((_len < 2) || (_len > TXQ_ITEM_MAX))
+    {
+        g_usTxqDrop[_cls]++;
+        return 0;
+    }
+    if (q->count >= q->depth)
+    {
+        g_usTxqDrop[_cls]++;
+        if (q->taken >= q->count) //发射准备到 TXQ_Done 之间全部已打包，丢弃新的一项
+        {
+            return 0;
+        }
+        for (j = q->taken; j + 1 < q->count; j++) //丢弃最旧的未打包项，后面的项前移，已打包的项不动
+        {
+            q->item[(q->head + j) % q->depth] = q->item[(q->head + j + 1) % q->depth];
+        }
+        q->count--;
+    }
+    item = &q->item[(q->head + q->count) % q->depth];
+    for (i = 0; i < _len; i++)
+    {
+        item->data[i] = _pFrame[i];
+    }
+    item->len = _len;
+    q->count++;
+    return 1;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: TXQ_Count
+*   功能说明: 指定优先级队列中的数据帧数
+*   形    参: _cls : 优先级
+*   返 回 值: 数据帧数
+*********************************************************************************************************
+*/
+uint8_t TXQ_Count(uint8_t _cls)
+{
+    return (_cls < TXQ_CLASS_NUM) ? s_tClass[_cls].count : 0;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: TXQ_BuildFrame
+*   功能说明: 按优先级取出数据帧打包为一个上行帧，数据项暂不出队，发送后必须调用 TXQ_Done
+*   形    参: _pOut : 输出缓冲区，至少 TXQ_FRAME_MAX 字节
+*             _maxcls : 只取优先级不低于此值的数据，竞争子时隙中只发 TXQ_ALARM
+*             _devid : 本节点devID
+*   返 回 值: 上行帧长度，没有数据时返回0
+*********************************************************************************************************
+*/
+uint8_t TXQ_BuildFrame(uint8_t *_pOut, uint8_t _maxcls, uint8_t _devid)
+{
+    TXQ_CLASS_T *q;
+    TXQ_ITEM_T *item, *first = 0;
+    uint8_t cls, pos = 3, n = 0, i;
+
+    for (q = s_tClass; q < &s_tClass[TXQ_CLASS_NUM]; q++)
+    {
+        q->taken = 0;
+    }
+    for (cls = 0; (cls <= _maxcls) && (cls < TXQ_CLASS_NUM); cls++)
+    {
+        q = &s_tClass[cls];
+        while (q->taken < q->count)
+        {
+            item = &q->item[(q->head + q->taken) % q->depth];
+            if (pos + 1 + item->len + 1 > TXQ_FRAME_MAX)
+            {
+                break;
+            }
+            item->data[1] = _devid;
+            _pOut[pos++] = item->len;
+            for (i = 0; i < item->len; i++)
+            {
+                _pOut[pos++] = item->data[i];
+            }
+            if (n++ == 0)
+            {
+                first = item;
+            }
+            q->taken++;
+        }
+    }
+    if (n == 0)
+    {
+        return 0;
+    }
+    if (n == 1)     /* 只有一项时原样发送 */
+    {
+        for (i = 0; i < first->len; i++)
+        {
+            _pOut[i] = first->data[i];
+        }
+        return first->len;
+    }
+    _pOut[0] = '*';
+    _pOut[1] = _devid;
+    _pOut[2] = n;
+    _pOut[pos++] = '%';
+    return pos;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: TXQ_Done
+*   功能说明: 上一次 TXQ_BuildFrame 打包的数据发送完毕
+*   形    参: _ok : 1 发射成功，打包的数据项出队；0 失败，留在队列中等待下一次发送机会
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void TXQ_Done(uint8_t _ok)
+{
+    TXQ_CLASS_T *q;
+
+    for (q = s_tClass; q < &s_tClass[TXQ_CLASS_NUM]; q++)
+    {
+        if (_ok)
+        {
+            q->head = (q->head + q->taken) % q->depth;
+            q->count -= q->taken;
+        }
+        q->taken = 0;
+    }
+}
@@ -0,0 +1,44 @@
+/*
+*********************************************************************************************************
+*
+*   模块名称 : 上行发送队列
+*   文件名称 : bsp_txq.h
+*   版    本 : V1.0
+*   说    明 : 头文件
+*
+*   每个队列项是一个完整的上行数据帧，第2字节为devID，在打包时填入当前的devID。
+*   打包规则：只有一项时原样发送(主机不需要升级即可接收'&'数据帧)，多项时打包为
+*     '*' devID n { len 数据帧 } x n '%'
+*   报警帧：'!' devID 报警代码 数值 '%'
+*
+*********************************************************************************************************
+*/
+#ifndef __BSP_TXQ_H
+#define __BSP_TXQ_H
+
+#include "stdint.h"
+
+/* 优先级，数值越小越优先 */
+#define TXQ_ALARM           0       /* 报警：最近的发送机会，包括竞争子时隙 */
+#define TXQ_TLM             1       /* 例行遥测：在本节点时隙内聚合发送 */
+#define TXQ_BULK            2       /* 批量/积压数据：帧内有剩余空间时顺带发送 */
+#define TXQ_CLASS_NUM       3
+
+#define TXQ_ALARM_DEPTH     2
+#define TXQ_TLM_DEPTH       4
+#define TXQ_BULK_DEPTH      4
+#define TXQ_ITEM_MAX        24      /* 单个数据帧最大长度 */
+#define TXQ_FRAME_MAX       64      /* 打包后的上行帧最大长度 */
+
+#define ALM_HR_HIGH         1       /* 报警代码：心率过高 */
+#define ALM_HR_LOW          2       /* 报警代码：心率过低 */
+
+void TXQ_Init(void);
+uint8_t TXQ_Put(uint8_t _cls, const uint8_t *_pFrame, uint8_t _len);
+uint8_t TXQ_Count(uint8_t _cls);
+uint8_t TXQ_BuildFrame(uint8_t *_pOut, uint8_t _maxcls, uint8_t _devid);
+void TXQ_Done(uint8_t _ok);
+
+extern uint16_t g_usTxqDrop[TXQ_CLASS_NUM];
+
+#endif
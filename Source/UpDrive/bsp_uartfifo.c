@@ -1,135 +1,159 @@
 /********************************************************************************************************
 *
-*   ģ : ж+FIFOģ
-*   ļ : bsp_uart_fifo.c
-*        : V1.0
-*   ˵     : ôж+FIFOģʽʵֶڵͬʱ
-*   ޸ļ¼ :
-* 汾             ˵
-* V1.0  2013-02-01 armfly  ʽ
-* V1.1  2013-06-09 armfly  FiFoṹTxCountԱжϻ; FiFoĺ
-* V1.2  2014-09-29 armfly  RS485 MODBUSӿڡյֽںֱִлص
+*   模块名称 : 串口中断+FIFO驱动模块
+*   文件名称 : bsp_uart_fifo.c
+*   版    本 : V1.0
+*   说    明 : 采用串口中断+FIFO模式实现多个串口的同时访问
+*   修改记录 :
+* 版本号  日期       作者    说明
+* V1.0  2013-02-01 armfly  正式发布
+* V1.1  2013-06-09 armfly  FiFo结构增加TxCount成员变量，方便判断缓冲区满; 增加清FiFo的函数
+* V1.2  2014-09-29 armfly  增加RS485 MODBUS接口。接收到新字节后，直接执行回调函数。
+* V1.3  串口1、2改为DMA循环接收，IDLE中断划分数据帧，不再逐字节中断，也不再占用TIM2做3.5字符超时。
+* V1.4  串口1、2改为DMA发送，数据整块复制到发送FIFO后启动DMA，不再逐字节关中断和TXE中断。
+* V1.5  收发FIFO改为单生产者单消费者无锁环形缓冲区(bsp_ring.c)，读写指针自由递增、按掩码取下标，
+*       去掉收发双方共同修改的计数变量，读写FIFO不再关中断。缓冲区大小必须是2的整数次幂。
+* V1.6  增加整块读取 COMx_Read 和零拷贝的 COMx_Peek/COMx_Consume；端口号查表得到串口设备。
 *
-*   Copyright (C), 2013-2014,  www.armfly.com
+*   Copyright (C), 2013-2014, 安富莱电子 www.armfly.com
 *
 *********************************************************************************************************/
 
 #include "bsp.h"
-/* ÿڽṹ */
+/* 收发FIFO按掩码取下标，缓冲区大小必须是2的整数次幂 */
+#define UART_SIZE_BAD(_size)    (((_size) & ((_size) - 1)) != 0)
+#if UART1_FIFO_EN == 1 && (UART_SIZE_BAD(UART1_TX_BUF_SIZE) || UART_SIZE_BAD(UART1_RX_BUF_SIZE))
+#error "UART1 FIFO size must be a power of 2"
+#endif
+#if UART2_FIFO_EN == 1 && (UART_SIZE_BAD(UART2_TX_BUF_SIZE) || UART_SIZE_BAD(UART2_RX_BUF_SIZE))
+#error "UART2 FIFO size must be a power of 2"
+#endif
+#if UART3_FIFO_EN == 1 && (UART_SIZE_BAD(UART3_TX_BUF_SIZE) || UART_SIZE_BAD(UART3_RX_BUF_SIZE))
+#error "UART3 FIFO size must be a power of 2"
+#endif
+#if UART4_FIFO_EN == 1 && (UART_SIZE_BAD(UART4_TX_BUF_SIZE) || UART_SIZE_BAD(UART4_RX_BUF_SIZE))
+#error "UART4 FIFO size must be a power of 2"
+#endif
+#if UART5_FIFO_EN == 1 && (UART_SIZE_BAD(UART5_TX_BUF_SIZE) || UART_SIZE_BAD(UART5_RX_BUF_SIZE))
+#error "UART5 FIFO size must be a power of 2"
+#endif
+
+/* 定义每个串口结构体变量 */
 #if UART1_FIFO_EN == 1
 static UART_T g_tUart1;
-static uint8_t g_TxBuf1[UART1_TX_BUF_SIZE];     /* ͻ */
-static uint8_t g_RxBuf1[UART1_RX_BUF_SIZE];     /* ջ */
+static uint8_t g_TxBuf1[UART1_TX_BUF_SIZE];     /* 发送缓冲区 */
+static uint8_t g_RxBuf1[UART1_RX_BUF_SIZE];     /* 接收缓冲区 */
 #endif
 
 #if UART2_FIFO_EN == 1
 static UART_T g_tUart2;
-static uint8_t g_TxBuf2[UART2_TX_BUF_SIZE];     /* ͻ */
-static uint8_t g_RxBuf2[UART2_RX_BUF_SIZE];     /* ջ */
+static uint8_t g_TxBuf2[UART2_TX_BUF_SIZE];     /* 发送缓冲区 */
+static uint8_t g_RxBuf2[UART2_RX_BUF_SIZE];     /* 接收缓冲区 */
 #endif
 
 #if UART3_FIFO_EN == 1
 static UART_T g_tUart3;
-static uint8_t g_TxBuf3[UART3_TX_BUF_SIZE];     /* ͻ */
-static uint8_t g_RxBuf3[UART3_RX_BUF_SIZE];     /* ջ */
+static uint8_t g_TxBuf3[UART3_TX_BUF_SIZE];     /* 发送缓冲区 */
+static uint8_t g_RxBuf3[UART3_RX_BUF_SIZE];     /* 接收缓冲区 */
 #endif
 
 #if UART4_FIFO_EN == 1
 static UART_T g_tUart4;
-static uint8_t g_TxBuf4[UART4_TX_BUF_SIZE];     /* ͻ */
-static uint8_t g_RxBuf4[UART4_RX_BUF_SIZE];     /* ջ */
+static uint8_t g_TxBuf4[UART4_TX_BUF_SIZE];     /* 发送缓冲区 */
+static uint8_t g_RxBuf4[UART4_RX_BUF_SIZE];     /* 接收缓冲区 */
 #endif
 
 #if UART5_FIFO_EN == 1
 static UART_T g_tUart5;
-static uint8_t g_TxBuf5[UART5_TX_BUF_SIZE];     /* ͻ */
-static uint8_t g_RxBuf5[UART5_RX_BUF_SIZE];     /* ջ */
+static uint8_t g_TxBuf5[UART5_TX_BUF_SIZE];     /* 发送缓冲区 */
+static uint8_t g_RxBuf5[UART5_RX_BUF_SIZE];     /* 接收缓冲区 */
+#endif
+
+/* 端口号到串口设备的映射表，未使能的串口为0 */
+static UART_T * const s_tComUart[COM_PORT_NUM] =
+{
+#if UART1_FIFO_EN == 1
+	&g_tUart1,
+#else
+	0,
+#endif
+#if UART2_FIFO_EN == 1
+	&g_tUart2,
+#else
+	0,
+#endif
+#if UART3_FIFO_EN == 1
+	&g_tUart3,
+#else
+	0,
+#endif
+#if UART4_FIFO_EN == 1
+	&g_tUart4,
+#else
+	0,
 #endif
+#if UART5_FIFO_EN == 1
+	&g_tUart5,
+#else
+	0,
+#endif
+};
 
-static void UART_InitSoftVar(void); //ʼصıFIFO
+static void UART_InitSoftVar(void); //初始化串口相关的变量，缓冲区，FIFO
 
-static void UART_InitHardPara(void); //ôڵӲʣλֹͣλʼλУλжʹܣ
+static void UART_InitHardPara(void); //配置串口的硬件参数（波特率，数据位，停止位，起始位，校验位，中断使能）
 static void UartSend(UART_T *_pUart, uint8_t *_ucaBuf, uint16_t _usLen);
+static void UartSendDma(UART_T *_pUart, uint8_t *_ucaBuf, uint16_t _usLen);
 static uint8_t UartGetChar(UART_T *_pUart, uint8_t *_pByte);
 static void UartIRQ(UART_T *_pUart);
 static void UART_ConfigNVIC(void);
+static void UartRxDmaInit(UART_T *_pUart);
+static void UartRxDmaUpdate(UART_T *_pUart);
+static void UartTxDmaInit(UART_T *_pUart);
+static void UartTxDmaKick(UART_T *_pUart);
+static void UartTxDmaDone(UART_T *_pUart);
 
 
 /*
 *********************************************************************************************************
-*     : UART_InitALL
-*   ˵: ʼӲȫֱֵ.
-*       :  
-*     ֵ: 
+*   函 数 名: UART_InitALL
+*   功能说明: 初始化串口硬件，并对全局变量赋初值.
+*   形    参:  无
+*   返 回 值: 无
 *********************************************************************************************************
 */
 void UART_InitALL(void)
 {
-	UART_InitSoftVar(); /* ȳʼȫֱ,Ӳ */
-	UART_InitHardPara(); /* ôڵӲ(ʵ) */
-	UART_ConfigNVIC(); /* ôжϣøڵȼȼжϷ*/
+	UART_InitSoftVar(); /* 必须先初始化全局变量,再配置硬件 */
+	UART_InitHardPara(); /* 配置串口的硬件参数(波特率等) */
+	UART_ConfigNVIC(); /* 配置串口中断，设置各个串口的优先级等级和中断服务函数*/
 }
 
 /*
 *********************************************************************************************************
-*     : ComToUart
-*   ˵: COM˿ںתΪUARTָ
-*       : _ucPort: ˿ں(COM1 - COM6)
-*     ֵ: uartָ
+*   函 数 名: ComToUart
+*   功能说明: 将COM端口号转换为UART指针，查表得到
+*   形    参: _ucPort: 端口号(COM1 - COM6)
+*   返 回 值: uart指针，端口未使能或超出范围时返回0
 *********************************************************************************************************
 */
 UART_T* ComToUart(COM_PORT_E _ucPort)
 {
-	if (_ucPort == COM1)
-	{
-#if UART1_FIFO_EN == 1
-		return &g_tUart1;
-#else
-		return 0;
-#endif
-	} else if (_ucPort == COM2)
-	{
-#if UART2_FIFO_EN == 1
-		return &g_tUart2;
-#else
-		return 0;
-#endif
-	} else if (_ucPort == COM3)
-	{
-#if UART3_FIFO_EN == 1
-		return &g_tUart3;
-#else
-		return 0;
-#endif
-	} else if (_ucPort == COM4)
-	{
-#if UART4_FIFO_EN == 1
-		return &g_tUart4;
-#else
-		return 0;
-#endif
-	} else if (_ucPort == COM5)
-	{
-#if UART5_FIFO_EN == 1
-		return &g_tUart5;
-#else
-		return 0;
-#endif
-	} else
+	if ((uint32_t)_ucPort >= COM_PORT_NUM)
 	{
-		/* κδ */
 		return 0;
 	}
+	return s_tComUart[_ucPort];
 }
 
 /*
 *********************************************************************************************************
-*     : COMx_SendBuf
-*   ˵: 򴮿ڷһݡݷŵͻأжϷں̨ɷ
-*       : _ucPort: ˿ں(COM1 - COM6)
-*             _ucaBuf: ͵ݻ
-*             _usLen : ݳ
-*     ֵ: 
+*   函 数 名: COMx_SendBuf
+*   功能说明: 向串口发送一组数据。数据放到发送缓冲区后立即返回，由中断服务程序或DMA在后台完成发送
+*   形    参: _ucPort: 端口号(COM1 - COM6)
+*             _ucaBuf: 待发送的数据缓冲区
+*             _usLen : 数据长度
+*   返 回 值: 无
 *********************************************************************************************************
 */
 void COMx_SendBuf(COM_PORT_E _ucPort, uint8_t *_ucaBuf, uint16_t _usLen)
@@ -144,7 +168,7 @@ void COMx_SendBuf(COM_PORT_E _ucPort, uint8_t *_ucaBuf, uint16_t _usLen)
 
 	if (pUart->SendBefore != 0)
 	{
-		pUart->SendBefore();        /* ÷ǰ485ͨʱô䷽ */
+		pUart->SendBefore();        /* 可以在这个函数中设置发送前的情况，例如485通信时设置传输方向 */
 	}
 
 	UartSend(pUart, _ucaBuf, _usLen);
@@ -152,11 +176,11 @@ void COMx_SendBuf(COM_PORT_E _ucPort, uint8_t *_ucaBuf, uint16_t _usLen)
 
 /*
 *********************************************************************************************************
-*     : COMx_SendChar
-*   ˵: 򴮿ڷ1ֽڡݷŵͻأжϷں̨ɷ
-*       : _ucPort: ˿ں(COM1 - COM6)
-*             _ucByte: ͵
-*     ֵ: 
+*   函 数 名: COMx_SendChar
+*   功能说明: 向串口发送1个字节。数据放到发送缓冲区后立即返回，由中断服务程序在后台完成发送
+*   形    参: _ucPort: 端口号(COM1 - COM6)
+*             _ucByte: 待发送的数据
+*   返 回 值: 无
 *********************************************************************************************************
 */
 void COMx_SendChar(COM_PORT_E _ucPort, uint8_t _ucByte)
@@ -166,11 +190,11 @@ void COMx_SendChar(COM_PORT_E _ucPort, uint8_t _ucByte)
 
 /*
 *********************************************************************************************************
-*     : COMx_GetChar
-*   ˵: Ӵڻȡ1ֽڣݾ
-*       : _ucPort: ˿ں(COM1 - COM6)
-*             _pByte: յݴַ
-*     ֵ: 0 ʾ, 1 ʾȡЧֽ
+*   函 数 名: COMx_GetChar
+*   功能说明: 从串口缓冲区读取1字节，非阻塞。无论有无数据均立即返回
+*   形    参: _ucPort: 端口号(COM1 - COM6)
+*             _pByte: 接收到的数据存放在这个地址
+*   返 回 值: 0 表示无数据, 1 表示读取到有效字节
 *********************************************************************************************************
 */
 uint8_t COMx_GetChar(COM_PORT_E _ucPort, uint8_t *_pByte)
@@ -188,10 +212,81 @@ uint8_t COMx_GetChar(COM_PORT_E _ucPort, uint8_t *_pByte)
 
 /*
 *********************************************************************************************************
-*     : COMx_ClearTxFifo
-*   ˵: 㴮ڷͻ
-*       : _ucPort: ˿ں(COM1 - COM6)
-*     ֵ: 
+*   函 数 名: COMx_Read
+*   功能说明: 从串口接收缓冲区读取一块数据，非阻塞。数据回绕时分两段复制，只移动一次读指针
+*   形    参: _ucPort: 端口号(COM1 - COM6)
+*             _pBuf : 存放读取数据的缓冲区
+*             _usLen : 最多读取的字节数
+*   返 回 值: 读取到的字节数，0 表示无数据
+*********************************************************************************************************
+*/
+uint16_t COMx_Read(COM_PORT_E _ucPort, uint8_t *_pBuf, uint16_t _usLen)
+{
+	UART_T *pUart;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0)
+	{
+		return 0;
+	}
+
+	return RING_Read(&pUart->tRx, _pBuf, _usLen);
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: COMx_Peek
+*   功能说明: 取接收缓冲区中全部未读数据的位置，最多两段(第二段是回绕到缓冲区开头的部分)，不复制数据。
+*             解析完成后用 COMx_Consume 释放已处理的字节，释放之前数据保持不变。
+*             DMA接收的串口要及时释放，未读数据超过缓冲区大小时会被覆盖
+*   形    参: _ucPort: 端口号(COM1 - COM6)
+*             _pSpan : 返回两段数据的地址和长度
+*   返 回 值: 未读字节数(两段之和)
+*********************************************************************************************************
+*/
+uint16_t COMx_Peek(COM_PORT_E _ucPort, RING_SPAN_T *_pSpan)
+{
+	UART_T *pUart;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0)
+	{
+		_pSpan->usLen[0] = 0;
+		_pSpan->usLen[1] = 0;
+		return 0;
+	}
+
+	return RING_Peek(&pUart->tRx, _pSpan);
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: COMx_Consume
+*   功能说明: 释放 COMx_Peek 取得的数据中已经处理完的部分
+*   形    参: _ucPort: 端口号(COM1 - COM6)
+*             _usLen : 字节数，不能超过 COMx_Peek 的返回值
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+void COMx_Consume(COM_PORT_E _ucPort, uint16_t _usLen)
+{
+	UART_T *pUart;
+
+	pUart = ComToUart(_ucPort);
+	if (pUart == 0)
+	{
+		return;
+	}
+
+	RING_Consume(&pUart->tRx, _usLen);
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: COMx_ClearTxFifo
+*   功能说明: 清零串口发送缓冲区
+*   形    参: _ucPort: 端口号(COM1 - COM6)
+*   返 回 值: 无
 *********************************************************************************************************
 */
 void COMx_ClearTxFifo(COM_PORT_E _ucPort)
@@ -204,17 +299,23 @@ void COMx_ClearTxFifo(COM_PORT_E _ucPort)
 		return;
 	}
 
-	pUart->usTxWrite = 0;
-	pUart->usTxRead = 0;
-	pUart->usTxCount = 0;
+	/* 发送FIFO的读指针属于中断，这里短暂关中断代替中断丢弃未发送的数据 */
+	DISABLE_INT();
+	if (pUart->txDma != 0)
+	{
+		DMA_Cmd(pUart->txDma, DISABLE);     /* 停止正在进行的传输 */
+		pUart->usTxDmaLen = 0;
+	}
+	RING_Flush(&pUart->tTx);
+	ENABLE_INT();
 }
 
 /*
 *********************************************************************************************************
-*     : COMx_ClearRxFifo
-*   ˵: 㴮ڽջ
-*       : _ucPort: ˿ں(COM1 - COM6)
-*     ֵ: 
+*   函 数 名: COMx_ClearRxFifo
+*   功能说明: 清零串口接收缓冲区
+*   形    参: _ucPort: 端口号(COM1 - COM6)
+*   返 回 值: 无
 *********************************************************************************************************
 */
 void COMx_ClearRxFifo(COM_PORT_E _ucPort)
@@ -227,25 +328,23 @@ void COMx_ClearRxFifo(COM_PORT_E _ucPort)
 		return;
 	}
 
-	pUart->usRxWrite = 0;
-	pUart->usRxRead = 0;
-	pUart->usRxCount = 0;
+	RING_Flush(&pUart->tRx);    /* 主程序是接收FIFO的消费者，读指针追上写指针即可 */
 }
 
 /*
 *********************************************************************************************************
-*     : UART1_SetBaud
-*   ˵: ޸UART1
-*       : 
-*     ֵ: 
+*   函 数 名: UART1_SetBaud
+*   功能说明: 修改UART1波特率
+*   形    参: 无
+*   返 回 值: 无
 *********************************************************************************************************
 */
 void UART1_SetBaud(uint32_t _baud)
 {
 	USART_InitTypeDef USART_InitStructure;
 
-	/* 2 ôӲ */
-	USART_InitStructure.USART_BaudRate = _baud; /*  */
+	/* 第2步： 配置串口硬件参数 */
+	USART_InitStructure.USART_BaudRate = _baud; /* 波特率 */
 	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
 	USART_InitStructure.USART_StopBits = USART_StopBits_1;
 	USART_InitStructure.USART_Parity = USART_Parity_No;
@@ -256,18 +355,18 @@ void UART1_SetBaud(uint32_t _baud)
 
 /*
 *********************************************************************************************************
-*     : UART2_SetBaud
-*   ˵: ޸UART2
-*       : 
-*     ֵ: 
+*   函 数 名: UART2_SetBaud
+*   功能说明: 修改UART2波特率
+*   形    参: 无
+*   返 回 值: 无
 *********************************************************************************************************
 */
 void UART2_SetBaud(uint32_t _baud)
 {
 	USART_InitTypeDef USART_InitStructure;
 
-	/* 2 ôӲ */
-	USART_InitStructure.USART_BaudRate = _baud; /*  */
+	/* 第2步： 配置串口硬件参数 */
+	USART_InitStructure.USART_BaudRate = _baud; /* 波特率 */
 	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
 	USART_InitStructure.USART_StopBits = USART_StopBits_1;
 	USART_InitStructure.USART_Parity = USART_Parity_No;
@@ -279,18 +378,18 @@ void UART2_SetBaud(uint32_t _baud)
 
 /*
 *********************************************************************************************************
-*     : UART3_SetBaud
-*   ˵: ޸UART3
-*       : 
-*     ֵ: 
+*   函 数 名: UART3_SetBaud
+*   功能说明: 修改UART3波特率
+*   形    参: 无
+*   返 回 值: 无
 *********************************************************************************************************
 */
 void UART3_SetBaud(uint32_t _baud)
 {
 	USART_InitTypeDef USART_InitStructure;
 
-	/* 2 ôӲ */
-	USART_InitStructure.USART_BaudRate = _baud; /*  */
+	/* 第2步： 配置串口硬件参数 */
+	USART_InitStructure.USART_BaudRate = _baud; /* 波特率 */
 	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
 	USART_InitStructure.USART_StopBits = USART_StopBits_1;
 	USART_InitStructure.USART_Parity = USART_Parity_No;
@@ -301,39 +400,39 @@ void UART3_SetBaud(uint32_t _baud)
 
 /*
 *********************************************************************************************************
-*     : Uart3_SendBefore
-*   ˵: ǰ׼RS485ͨţRS485оƬΪ״̬
-*             ޸ UART_InitSoftVar()еĺָڱ g_tUart2.SendBefore = Uart3_SendBefore
-*       : 
-*     ֵ: 
+*   函 数 名: Uart3_SendBefore
+*   功能说明: 发送数据前的准备工作。对于RS485通信，请设置RS485芯片为发送状态，
+*             并修改 UART_InitSoftVar()中的函数指针等于本函数名，比如 g_tUart2.SendBefore = Uart3_SendBefore
+*   形    参: 无
+*   返 回 值: 无
 *********************************************************************************************************
 */
 void Uart3_SendBefore(void)
 {
-//  RS485_TX_EN();  /* лRS485շоƬΪģʽ */
+//  RS485_TX_EN();  /* 切换RS485收发芯片为发送模式 */
 }
 
 /*
 *********************************************************************************************************
-*     : Uart3_SendOver
-*   ˵: һݽƺRS485ͨţRS485оƬΪ״̬
-*             ޸ UART_InitSoftVar()еĺָڱ g_tUart2.SendOver = Uart3_SendOver
-*       : 
-*     ֵ: 
+*   函 数 名: Uart3_SendOver
+*   功能说明: 发送一串数据结束后的善后处理。对于RS485通信，请设置RS485芯片为接收状态，
+*             并修改 UART_InitSoftVar()中的函数指针等于本函数名，比如 g_tUart2.SendOver = Uart3_SendOver
+*   形    参: 无
+*   返 回 值: 无
 *********************************************************************************************************
 */
 void Uart3_SendOver(void)
 {
-//  RS485_RX_EN();  /* лRS485շоƬΪģʽ */
+//  RS485_RX_EN();  /* 切换RS485收发芯片为接收模式 */
 }
 
 
 /*
 *********************************************************************************************************
-*     : RS485_SendBuf
-*   ˵: ͨRS485оƬһݡע⣬ȴϡ
-*       : 
-*     ֵ: 
+*   函 数 名: RS485_SendBuf
+*   功能说明: 通过RS485芯片发送一串数据。注意，本函数不等待发送完毕。
+*   形    参: 无
+*   返 回 值: 无
 *********************************************************************************************************
 */
 void RS485_SendBuf(uint8_t *_ucaBuf, uint16_t _usLen)
@@ -344,11 +443,11 @@ void RS485_SendBuf(uint8_t *_ucaBuf, uint16_t _usLen)
 
 /*
 *********************************************************************************************************
-*     : RS485_SendStr
-*   ˵: 485߷һַ
-*       : _pBuf ݻ
-*            _ucLen ݳ
-*     ֵ: 
+*   函 数 名: RS485_SendStr
+*   功能说明: 向485总线发送一个字符串
+*   形    参: _pBuf 数据缓冲区
+*            _ucLen 数据长度
+*   返 回 值: 无
 *********************************************************************************************************
 */
 void RS485_SendStr(char *_pBuf)
@@ -358,10 +457,10 @@ void RS485_SendStr(char *_pBuf)
 
 /*
 *********************************************************************************************************
-*     : Uart1_ReciveNew
-*   ˵: Uart1յµ
-*       : _byte յ
-*     ֵ: 
+*   函 数 名: Uart1_ReciveNew
+*   功能说明: Uart1接收到新的数据
+*   形    参: _byte 接收到的新数据
+*   返 回 值: 无
 *********************************************************************************************************
 */
 
@@ -374,10 +473,10 @@ void Uart1_ReciveNew(uint8_t _byte)
 
 /*
 *********************************************************************************************************
-*     : Uart2Callback_ReciveNew
-*   ˵: յµ
-*       : _byte յ
-*     ֵ: 
+*   函 数 名: Uart2Callback_ReciveNew
+*   功能说明: 接收到新的数据
+*   形    参: _byte 接收到的新数据
+*   返 回 值: 无
 *********************************************************************************************************
 */
 
@@ -389,10 +488,10 @@ void Uart2_ReciveNew(uint8_t _byte)
 
 /*
 *********************************************************************************************************
-*     : Uart3_ReciveNew
-*   ˵: յµ
-*       : _byte յ
-*     ֵ: 
+*   函 数 名: Uart3_ReciveNew
+*   功能说明: 接收到新的数据
+*   形    参: _byte 接收到的新数据
+*   返 回 值: 无
 *********************************************************************************************************
 */
 
@@ -403,124 +502,112 @@ void Uart3_ReciveNew(uint8_t _byte)
 
 /*
 *********************************************************************************************************
-*     : UART_InitSoftVar
-*   ˵: ʼصı
-*       : 
-*     ֵ: 
+*   函 数 名: UART_InitSoftVar
+*   功能说明: 初始化串口相关的变量
+*   形    参: 无
+*   返 回 值: 无
 *********************************************************************************************************
 */
 static void UART_InitSoftVar(void)
 {
 #if UART1_FIFO_EN == 1
-	g_tUart1.uart = USART1;                     /* STM32 豸 */
-	g_tUart1.pTxBuf = g_TxBuf1;                 /* ͻָ */
-	g_tUart1.pRxBuf = g_RxBuf1;                 /* ջָ */
-	g_tUart1.usTxBufSize = UART1_TX_BUF_SIZE;   /* ͻС */
-	g_tUart1.usRxBufSize = UART1_RX_BUF_SIZE;   /* ջС */
-	g_tUart1.usTxWrite = 0;                     /* FIFOд */
-	g_tUart1.usTxRead = 0;                      /* FIFO */
-	g_tUart1.usRxWrite = 0;                     /* FIFOд */
-	g_tUart1.usRxRead = 0;                      /* FIFO */
-	g_tUart1.usRxCount = 0;                     /* յݸ */
-	g_tUart1.usTxCount = 0;                     /* ͵ݸ */
-	g_tUart1.SendBefore = 0;                    /* ǰĻص */
-	g_tUart1.SendOver = 0;                      /* ϺĻص */
-	g_tUart1.ReciveNew = Uart1_ReciveNew;       /* յݺĻص */
+	g_tUart1.uart = USART1;                     /* STM32 串口设备 */
+	RING_Init(&g_tUart1.tTx, g_TxBuf1, UART1_TX_BUF_SIZE);   /* 发送FIFO */
+	RING_Init(&g_tUart1.tRx, g_RxBuf1, UART1_RX_BUF_SIZE);   /* 接收FIFO */
+	g_tUart1.SendBefore = 0;                    /* 发送数据前的回调函数 */
+	g_tUart1.SendOver = 0;                      /* 发送完毕后的回调函数 */
+	g_tUart1.ReciveNew = 0;                     /* BLE数据由 Task_RecvfromUart 直接从接收FIFO解析，不再复制 */
+#if UART1_RX_DMA_EN == 1
+	g_tUart1.rxDma = DMA1_Channel5;             /* 接收DMA通道 */
+#else
+	g_tUart1.rxDma = 0;
+#endif
+#if UART1_TX_DMA_EN == 1
+	g_tUart1.txDma = DMA1_Channel4;             /* 发送DMA通道 */
+	g_tUart1.txIRQn = DMA1_Channel4_IRQn;
+#else
+	g_tUart1.txDma = 0;
+#endif
+	g_tUart1.usTxDmaLen = 0;
 #endif
 
 #if UART2_FIFO_EN == 1
-	g_tUart2.uart = USART2;                     /* STM32 豸 */
-	g_tUart2.pTxBuf = g_TxBuf2;                 /* ͻָ */
-	g_tUart2.pRxBuf = g_RxBuf2;                 /* ջָ */
-	g_tUart2.usTxBufSize = UART2_TX_BUF_SIZE;   /* ͻС */
-	g_tUart2.usRxBufSize = UART2_RX_BUF_SIZE;   /* ջС */
-	g_tUart2.usTxWrite = 0;                     /* FIFOд */
-	g_tUart2.usTxRead = 0;                      /* FIFO */
-	g_tUart2.usRxWrite = 0;                     /* FIFOд */
-	g_tUart2.usRxRead = 0;                      /* FIFO */
-	g_tUart2.usRxCount = 0;                     /* յݸ */
-	g_tUart2.usTxCount = 0;                     /* ͵ݸ */
-	g_tUart2.SendBefore = 0;                    /* ǰĻص */
-	g_tUart2.SendOver = 0;                      /* ϺĻص */
-	g_tUart2.ReciveNew = Uart2_ReciveNew;       /* յݺĻص */
+	g_tUart2.uart = USART2;                     /* STM32 串口设备 */
+	RING_Init(&g_tUart2.tTx, g_TxBuf2, UART2_TX_BUF_SIZE);   /* 发送FIFO */
+	RING_Init(&g_tUart2.tRx, g_RxBuf2, UART2_RX_BUF_SIZE);   /* 接收FIFO */
+	g_tUart2.SendBefore = 0;                    /* 发送数据前的回调函数 */
+	g_tUart2.SendOver = 0;                      /* 发送完毕后的回调函数 */
+	g_tUart2.ReciveNew = Uart2_ReciveNew;       /* 接收到新数据后的回调函数 */
+#if UART2_RX_DMA_EN == 1
+	g_tUart2.rxDma = DMA1_Channel6;             /* 接收DMA通道 */
+#else
+	g_tUart2.rxDma = 0;
+#endif
+#if UART2_TX_DMA_EN == 1
+	g_tUart2.txDma = DMA1_Channel7;             /* 发送DMA通道 */
+	g_tUart2.txIRQn = DMA1_Channel7_IRQn;
+#else
+	g_tUart2.txDma = 0;
+#endif
+	g_tUart2.usTxDmaLen = 0;
 #endif
 
 #if UART3_FIFO_EN == 1
-	g_tUart3.uart = USART3;                     /* STM32 豸 */
-	g_tUart3.pTxBuf = g_TxBuf3;                 /* ͻָ */
-	g_tUart3.pRxBuf = g_RxBuf3;                 /* ջָ */
-	g_tUart3.usTxBufSize = UART3_TX_BUF_SIZE;   /* ͻС */
-	g_tUart3.usRxBufSize = UART3_RX_BUF_SIZE;   /* ջС */
-	g_tUart3.usTxWrite = 0;                     /* FIFOд */
-	g_tUart3.usTxRead = 0;                      /* FIFO */
-	g_tUart3.usRxWrite = 0;                     /* FIFOд */
-	g_tUart3.usRxRead = 0;                      /* FIFO */
-	g_tUart3.usRxCount = 0;                     /* յݸ */
-	g_tUart3.usTxCount = 0;                     /* ͵ݸ */
-	g_tUart3.SendBefore = Uart3_SendBefore;     /* ǰĻص */
-	g_tUart3.SendOver = Uart3_SendOver;         /* ϺĻص */
-	g_tUart3.ReciveNew = Uart3_ReciveNew;       /* յݺĻص */
+	g_tUart3.uart = USART3;                     /* STM32 串口设备 */
+	RING_Init(&g_tUart3.tTx, g_TxBuf3, UART3_TX_BUF_SIZE);   /* 发送FIFO */
+	RING_Init(&g_tUart3.tRx, g_RxBuf3, UART3_RX_BUF_SIZE);   /* 接收FIFO */
+	g_tUart3.SendBefore = Uart3_SendBefore;     /* 发送数据前的回调函数 */
+	g_tUart3.SendOver = Uart3_SendOver;         /* 发送完毕后的回调函数 */
+	g_tUart3.ReciveNew = Uart3_ReciveNew;       /* 接收到新数据后的回调函数 */
+	g_tUart3.rxDma = 0;                         /* RXNE中断接收 */
+	g_tUart3.txDma = 0;                        /* TXE中断发送 */
+	g_tUart3.usTxDmaLen = 0;
 #endif
 
 #if UART4_FIFO_EN == 1
-	g_tUart4.uart = UART4;                      /* STM32 豸 */
-	g_tUart4.pTxBuf = g_TxBuf4;                 /* ͻָ */
-	g_tUart4.pRxBuf = g_RxBuf4;                 /* ջָ */
-	g_tUart4.usTxBufSize = UART4_TX_BUF_SIZE;   /* ͻС */
-	g_tUart4.usRxBufSize = UART4_RX_BUF_SIZE;   /* ջС */
-	g_tUart4.usTxWrite = 0;                     /* FIFOд */
-	g_tUart4.usTxRead = 0;                      /* FIFO */
-	g_tUart4.usRxWrite = 0;                     /* FIFOд */
-	g_tUart4.usRxRead = 0;                      /* FIFO */
-	g_tUart4.usRxCount = 0;                     /* յݸ */
-	g_tUart4.usTxCount = 0;                     /* ͵ݸ */
-	g_tUart4.SendBefore = 0;                    /* ǰĻص */
-	g_tUart4.SendOver = 0;                      /* ϺĻص */
-	g_tUart4.ReciveNew = 0;                     /* յݺĻص */
+	g_tUart4.uart = UART4;                      /* STM32 串口设备 */
+	RING_Init(&g_tUart4.tTx, g_TxBuf4, UART4_TX_BUF_SIZE);   /* 发送FIFO */
+	RING_Init(&g_tUart4.tRx, g_RxBuf4, UART4_RX_BUF_SIZE);   /* 接收FIFO */
+	g_tUart4.SendBefore = 0;                    /* 发送数据前的回调函数 */
+	g_tUart4.SendOver = 0;                      /* 发送完毕后的回调函数 */
+	g_tUart4.ReciveNew = 0;                     /* 接收到新数据后的回调函数 */
+	g_tUart4.rxDma = 0;                         /* RXNE中断接收 */
+	g_tUart4.txDma = 0;                        /* TXE中断发送 */
+	g_tUart4.usTxDmaLen = 0;
 #endif
 
 #if UART5_FIFO_EN == 1
-	g_tUart5.uart = UART5;                      /* STM32 豸 */
-	g_tUart5.pTxBuf = g_TxBuf5;                 /* ͻָ */
-	g_tUart5.pRxBuf = g_RxBuf5;                 /* ջָ */
-	g_tUart5.usTxBufSize = UART5_TX_BUF_SIZE;   /* ͻС */
-	g_tUart5.usRxBufSize = UART5_RX_BUF_SIZE;   /* ջС */
-	g_tUart5.usTxWrite = 0;                     /* FIFOд */
-	g_tUart5.usTxRead = 0;                      /* FIFO */
-	g_tUart5.usRxWrite = 0;                     /* FIFOд */
-	g_tUart5.usRxRead = 0;                      /* FIFO */
-	g_tUart5.usRxCount = 0;                     /* յݸ */
-	g_tUart5.usTxCount = 0;                     /* ͵ݸ */
-	g_tUart5.SendBefore = 0;                    /* ǰĻص */
-	g_tUart5.SendOver = 0;                      /* ϺĻص */
-	g_tUart5.ReciveNew = 0;                     /* յݺĻص */
+	g_tUart5.uart = UART5;                      /* STM32 串口设备 */
+	RING_Init(&g_tUart5.tTx, g_TxBuf5, UART5_TX_BUF_SIZE);   /* 发送FIFO */
+	RING_Init(&g_tUart5.tRx, g_RxBuf5, UART5_RX_BUF_SIZE);   /* 接收FIFO */
+	g_tUart5.SendBefore = 0;                    /* 发送数据前的回调函数 */
+	g_tUart5.SendOver = 0;                      /* 发送完毕后的回调函数 */
+	g_tUart5.ReciveNew = 0;                     /* 接收到新数据后的回调函数 */
+	g_tUart5.rxDma = 0;                         /* RXNE中断接收 */
+	g_tUart5.txDma = 0;                        /* TXE中断发送 */
+	g_tUart5.usTxDmaLen = 0;
 #endif
 
 
 #if UART6_FIFO_EN == 1
-	g_tUart6.uart = USART6;                     /* STM32 豸 */
-	g_tUart6.pTxBuf = g_TxBuf6;                 /* ͻָ */
-	g_tUart6.pRxBuf = g_RxBuf6;                 /* ջָ */
-	g_tUart6.usTxBufSize = UART6_TX_BUF_SIZE;   /* ͻС */
-	g_tUart6.usRxBufSize = UART6_RX_BUF_SIZE;   /* ջС */
-	g_tUart6.usTxWrite = 0;                     /* FIFOд */
-	g_tUart6.usTxRead = 0;                      /* FIFO */
-	g_tUart6.usRxWrite = 0;                     /* FIFOд */
-	g_tUart6.usRxRead = 0;                      /* FIFO */
-	g_tUart6.usRxCount = 0;                     /* յݸ */
-	g_tUart6.usTxCount = 0;                     /* ͵ݸ */
-	g_tUart6.SendBefore = 0;                    /* ǰĻص */
-	g_tUart6.SendOver = 0;                      /* ϺĻص */
-	g_tUart6.ReciveNew = 0;                     /* յݺĻص */
+	g_tUart6.uart = USART6;                     /* STM32 串口设备 */
+	RING_Init(&g_tUart6.tTx, g_TxBuf6, UART6_TX_BUF_SIZE);   /* 发送FIFO */
+	RING_Init(&g_tUart6.tRx, g_RxBuf6, UART6_RX_BUF_SIZE);   /* 接收FIFO */
+	g_tUart6.SendBefore = 0;                    /* 发送数据前的回调函数 */
+	g_tUart6.SendOver = 0;                      /* 发送完毕后的回调函数 */
+	g_tUart6.ReciveNew = 0;                     /* 接收到新数据后的回调函数 */
+	g_tUart6.rxDma = 0;                         /* RXNE中断接收 */
+	g_tUart6.txDma = 0;                        /* TXE中断发送 */
+	g_tUart6.usTxDmaLen = 0;
 #endif
 }
 
 /*
 *********************************************************************************************************
-*     : UART_InitHardPara
-*   ˵: ôڶӦGPIOôڵӲʣλֹͣλʼλУλжʹܣ
-*       : 
-*     ֵ: 
+*   函 数 名: UART_InitHardPara
+*   功能说明: 配置串口对应的GPIO，配置串口的硬件参数（波特率，数据位，停止位，起始位，校验位，中断使能）等
+*   形    参: 无
+*   返 回 值: 无
 *********************************************************************************************************
 */
 static void UART_InitHardPara(void)
@@ -528,29 +615,29 @@ static void UART_InitHardPara(void)
 	GPIO_InitTypeDef GPIO_InitStructure;
 	USART_InitTypeDef USART_InitStructure;
 
-	/************* PA9PA10   Uart1***********************************************/
-#if UART1_FIFO_EN == 1      /* 1 TX = PA9   RX = PA10  TX = PB6   RX = PB7*/
+	/************* PA9和PA10   Uart1***********************************************/
+#if UART1_FIFO_EN == 1      /* 串口1 TX = PA9   RX = PA10 或 TX = PB6   RX = PB7*/
 
-	/* 1GPIOUSARTʱ */
+	/* 第1步：打开GPIO和USART部件的时钟 */
 	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA | RCC_APB2Periph_AFIO, ENABLE);
 	RCC_APB2PeriphClockCmd(RCC_APB2Periph_USART1, ENABLE);
 
-	/* 2USART TxGPIOΪ츴ģʽ */
+	/* 第2步：将USART Tx的GPIO配置为推挽复用模式 */
 	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_9;
 	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
 	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
 	GPIO_Init(GPIOA, &GPIO_InitStructure);
 
-	/* 3USART RxGPIOΪģʽ
-		CPUλGPIOȱʡǸģʽ費Ǳ
-		ǣһǽϱĶҷֹط޸ߵò
+	/* 第3步：将USART Rx的GPIO配置为浮空输入模式
+		由于CPU复位后，GPIO缺省都是浮空输入模式，因此下面这个步骤不是必须的
+		但是，我还是建议加上便于阅读，并且防止其它地方修改了这个口线的设置参数
 	*/
 	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_10;
 	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
 	GPIO_Init(GPIOA, &GPIO_InitStructure);
 
-	/* 4 ôӲ */
-	USART_InitStructure.USART_BaudRate = UART1_BAUD;    /*  */
+	/* 第4步： 配置串口硬件参数 */
+	USART_InitStructure.USART_BaudRate = UART1_BAUD;    /* 波特率 */
 	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
 	USART_InitStructure.USART_StopBits = USART_StopBits_1;
 	USART_InitStructure.USART_Parity = USART_Parity_No;
@@ -558,69 +645,83 @@ static void UART_InitHardPara(void)
 	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
 	USART_Init(USART1, &USART_InitStructure);
 
-	USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);  /* ʹܽж */
+#if UART1_RX_DMA_EN == 1
+	UartRxDmaInit(&g_tUart1);   /* DMA循环接收，使能IDLE中断 */
+#else
+	USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);  /* 使能接收中断 */
+#endif
+#if UART1_TX_DMA_EN == 1
+	UartTxDmaInit(&g_tUart1);   /* DMA发送，使能传输完成中断 */
+#endif
 	/*
 		USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
-		ע: Ҫڴ˴򿪷ж
-		жʹSendUart()
+		注意: 不要在此处打开发送中断
+		发送中断使能在SendUart()函数打开
 	*/
-	USART_Cmd(USART1, ENABLE);      /* ʹܴ */
+	USART_Cmd(USART1, ENABLE);      /* 使能串口 */
 
-	/* CPUСȱݣúãֱSend1ֽڷͲȥ
-		1ֽ޷ȷͳȥ */
-	USART_ClearFlag(USART1, USART_FLAG_TC);     /* 巢ɱ־Transmission Complete flag */
+	/* CPU的小缺陷：串口配置好，如果直接Send，则第1个字节发送不出去
+		如下语句解决第1个字节无法正确发送出去的问题 */
+	USART_ClearFlag(USART1, USART_FLAG_TC);     /* 清发送完成标志，Transmission Complete flag */
 #endif
 
-	/************* PA2PA3   Uart2***********************************************/
-#if UART2_FIFO_EN == 1      /* 2 TX = PA2 RX = PA3  */
-	/* 1GPIOUSARTʱ */
+	/************* PA2和PA3   Uart2***********************************************/
+#if UART2_FIFO_EN == 1      /* 串口2 TX = PA2， RX = PA3  */
+	/* 第1步：打开GPIO和USART部件的时钟 */
 	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA | RCC_APB2Periph_AFIO, ENABLE);
 	RCC_APB1PeriphClockCmd(RCC_APB1Periph_USART2, ENABLE);
 
-	/* 2USART TxGPIOΪ츴ģʽ */
+	/* 第2步：将USART Tx的GPIO配置为推挽复用模式 */
 	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_2;
 	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
 	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
 	GPIO_Init(GPIOA, &GPIO_InitStructure);
 
-	/* 3USART RxGPIOΪģʽ
-		CPUλGPIOȱʡǸģʽ費Ǳ
-		ǣһǽϱĶҷֹط޸ߵò
+	/* 第3步：将USART Rx的GPIO配置为浮空输入模式
+		由于CPU复位后，GPIO缺省都是浮空输入模式，因此下面这个步骤不是必须的
+		但是，我还是建议加上便于阅读，并且防止其它地方修改了这个口线的设置参数
 	*/
 	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_3;
 	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
 	GPIO_Init(GPIOA, &GPIO_InitStructure);
-	/*  3ѾˣⲽԲ
+	/*  第3步已经做了，因此这步可以不做
 		GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
 	*/
 	GPIO_Init(GPIOA, &GPIO_InitStructure);
 
-	/* 4 ôӲ */
-	USART_InitStructure.USART_BaudRate = UART2_BAUD;    /*  */
+	/* 第4步： 配置串口硬件参数 */
+	USART_InitStructure.USART_BaudRate = UART2_BAUD;    /* 波特率 */
 	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
 	USART_InitStructure.USART_StopBits = USART_StopBits_1;
 	USART_InitStructure.USART_Parity = USART_Parity_No;
 	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
-	USART_InitStructure.USART_Mode = USART_Mode_Tx | USART_Mode_Rx;     /* ѡģʽ */
+	USART_InitStructure.USART_Mode = USART_Mode_Tx | USART_Mode_Rx;     /* 仅选择接收模式 */
 	USART_Init(USART2, &USART_InitStructure);
 
-	USART_ITConfig(USART2, USART_IT_RXNE, ENABLE);  /* ʹܽж */
+#if UART2_RX_DMA_EN == 1
+	UartRxDmaInit(&g_tUart2);   /* DMA循环接收，使能IDLE中断 */
+#else
+	USART_ITConfig(USART2, USART_IT_RXNE, ENABLE);  /* 使能接收中断 */
+#endif
+#if UART2_TX_DMA_EN == 1
+	UartTxDmaInit(&g_tUart2);   /* DMA发送，使能传输完成中断 */
+#endif
 	/*
 		USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
-		ע: Ҫڴ˴򿪷ж
-		жʹSendUart()
+		注意: 不要在此处打开发送中断
+		发送中断使能在SendUart()函数打开
 	*/
-	USART_Cmd(USART2, ENABLE);      /* ʹܴ */
+	USART_Cmd(USART2, ENABLE);      /* 使能串口 */
 
-	/* CPUСȱݣúãֱSend1ֽڷͲȥ
-		1ֽ޷ȷͳȥ */
-	USART_ClearFlag(USART2, USART_FLAG_TC);     /* 巢ɱ־Transmission Complete flag */
+	/* CPU的小缺陷：串口配置好，如果直接Send，则第1个字节发送不出去
+		如下语句解决第1个字节无法正确发送出去的问题 */
+	USART_ClearFlag(USART2, USART_FLAG_TC);     /* 清发送完成标志，Transmission Complete flag */
 #endif
 
-	/************* PB10PB11   Uart3***********************************************/
-#if UART3_FIFO_EN == 1          /* 3 TX = PB10   RX = PB11 */
+	/************* PB10和PB11   Uart3***********************************************/
+#if UART3_FIFO_EN == 1          /* 串口3 TX = PB10   RX = PB11 */
 
-	/*  PB2Ϊл RS485оƬշ״̬ĿûõRS485ֻǵĴ3ʹãε */
+	/* 配置 PB2为推挽输出，用于切换 RS485芯片的收发状态，本项目没有用到RS485，只是单独的串口3使用，因此屏蔽掉 */
 //  {
 //      RCC_APB2PeriphClockCmd(RCC_RS485_TXEN, ENABLE);
 
@@ -630,30 +731,30 @@ static void UART_InitHardPara(void)
 //      GPIO_Init(PORT_RS485_TXEN, &GPIO_InitStructure);
 //  }
 
-	/* 1 GPIOUARTʱ */
+	/* 第1步： 开启GPIO和UART时钟 */
 	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB | RCC_APB2Periph_AFIO, ENABLE);
 	RCC_APB1PeriphClockCmd(RCC_APB1Periph_USART3, ENABLE);
 
-	/* 2USART TxGPIOΪ츴ģʽ */
+	/* 第2步：将USART Tx的GPIO配置为推挽复用模式 */
 	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_10;
 	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
 	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
 	GPIO_Init(GPIOB, &GPIO_InitStructure);
 
-	/* 3USART RxGPIOΪģʽ
-		CPUλGPIOȱʡǸģʽ費Ǳ
-		ǣһǽϱĶҷֹط޸ߵò
+	/* 第3步：将USART Rx的GPIO配置为浮空输入模式
+		由于CPU复位后，GPIO缺省都是浮空输入模式，因此下面这个步骤不是必须的
+		但是，我还是建议加上便于阅读，并且防止其它地方修改了这个口线的设置参数
 	*/
 	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_11;
 	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
 	GPIO_Init(GPIOB, &GPIO_InitStructure);
-	/*  3ѾˣⲽԲ
+	/*  第3步已经做了，因此这步可以不做
 		GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
 	*/
 	GPIO_Init(GPIOB, &GPIO_InitStructure);
 
-	/* 4 ôӲ */
-	USART_InitStructure.USART_BaudRate = UART3_BAUD;    /*  */
+	/* 第4步： 配置串口硬件参数 */
+	USART_InitStructure.USART_BaudRate = UART3_BAUD;    /* 波特率 */
 	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
 	USART_InitStructure.USART_StopBits = USART_StopBits_1;
 	USART_InitStructure.USART_Parity = USART_Parity_No;
@@ -661,41 +762,41 @@ static void UART_InitHardPara(void)
 	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
 	USART_Init(USART3, &USART_InitStructure);
 
-	USART_ITConfig(USART3, USART_IT_RXNE, ENABLE);  /* ʹܽж */
+	USART_ITConfig(USART3, USART_IT_RXNE, ENABLE);  /* 使能接收中断 */
 	/*
 		USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
-		ע: Ҫڴ˴򿪷ж
-		жʹSendUart()
+		注意: 不要在此处打开发送中断
+		发送中断使能在SendUart()函数打开
 	*/
-	USART_Cmd(USART3, ENABLE);      /* ʹܴ */
+	USART_Cmd(USART3, ENABLE);      /* 使能串口 */
 
-	/* CPUСȱݣúãֱSend1ֽڷͲȥ
-		1ֽ޷ȷͳȥ */
-	USART_ClearFlag(USART3, USART_FLAG_TC);     /* 巢ɱ־Transmission Complete flag */
+	/* CPU的小缺陷：串口配置好，如果直接Send，则第1个字节发送不出去
+		如下语句解决第1个字节无法正确发送出去的问题 */
+	USART_ClearFlag(USART3, USART_FLAG_TC);     /* 清发送完成标志，Transmission Complete flag */
 #endif
 
-	/************* PC10PC11   Uart4***********************************************/
-#if UART4_FIFO_EN == 1          /* 4 TX = PC10   RX = PC11 */
-	/* 1 GPIOUARTʱ */
+	/************* PC10和PC11   Uart4***********************************************/
+#if UART4_FIFO_EN == 1          /* 串口4 TX = PC10   RX = PC11 */
+	/* 第1步： 开启GPIO和UART时钟 */
 	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOC | RCC_APB2Periph_AFIO, ENABLE);
 	RCC_APB1PeriphClockCmd(RCC_APB1Periph_UART4, ENABLE);
 
-	/* 2USART TxGPIOΪ츴ģʽ */
+	/* 第2步：将USART Tx的GPIO配置为推挽复用模式 */
 	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_10;
 	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
 	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
 	GPIO_Init(GPIOC, &GPIO_InitStructure);
 
-	/* 3USART RxGPIOΪģʽ
-	   CPUλGPIOȱʡǸģʽ費Ǳ
-	   ǣһǽϱĶҷֹط޸ߵò
+	/* 第3步：将USART Rx的GPIO配置为浮空输入模式
+	   由于CPU复位后，GPIO缺省都是浮空输入模式，因此下面这个步骤不是必须的
+	   但是，我还是建议加上便于阅读，并且防止其它地方修改了这个口线的设置参数
 	*/
 	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_11;
 	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
 	GPIO_Init(GPIOC, &GPIO_InitStructure);
 
-	/* 4 ôӲ */
-	USART_InitStructure.USART_BaudRate = UART4_BAUD;    /*  */
+	/* 第4步： 配置串口硬件参数 */
+	USART_InitStructure.USART_BaudRate = UART4_BAUD;    /* 波特率 */
 	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
 	USART_InitStructure.USART_StopBits = USART_StopBits_1;
 	USART_InitStructure.USART_Parity = USART_Parity_No;
@@ -703,41 +804,41 @@ static void UART_InitHardPara(void)
 	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
 	USART_Init(UART4, &USART_InitStructure);
 
-	USART_ITConfig(UART4, USART_IT_RXNE, ENABLE);   /* ʹܽж */
+	USART_ITConfig(UART4, USART_IT_RXNE, ENABLE);   /* 使能接收中断 */
 	/*
 		USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
-		ע: Ҫڴ˴򿪷ж
-		жʹSendUart()
+		注意: 不要在此处打开发送中断
+		发送中断使能在SendUart()函数打开
 	*/
-	USART_Cmd(UART4, ENABLE);       /* ʹܴ */
+	USART_Cmd(UART4, ENABLE);       /* 使能串口 */
 
-	/* CPUСȱݣúãֱSend1ֽڷͲȥ
-		1ֽ޷ȷͳȥ */
-	USART_ClearFlag(UART4, USART_FLAG_TC);     /* 巢ɱ־Transmission Complete flag */
+	/* CPU的小缺陷：串口配置好，如果直接Send，则第1个字节发送不出去
+		如下语句解决第1个字节无法正确发送出去的问题 */
+	USART_ClearFlag(UART4, USART_FLAG_TC);     /* 清发送完成标志，Transmission Complete flag */
 #endif
-	/************* PC12PD2   Uart5***********************************************/
-#if UART5_FIFO_EN == 1          /* 5 TX = PC12   RX = PD2 */
-	/* 1 GPIOUARTʱ */
+	/************* PC12和PD2   Uart5***********************************************/
+#if UART5_FIFO_EN == 1          /* 串口5 TX = PC12   RX = PD2 */
+	/* 第1步： 开启GPIO和UART时钟 */
 	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOC | RCC_APB2Periph_GPIOD | RCC_APB2Periph_AFIO, ENABLE);
 	RCC_APB1PeriphClockCmd(RCC_APB1Periph_UART5, ENABLE);
 
-	/* 2USART TxGPIOΪ츴ģʽ */
+	/* 第2步：将USART Tx的GPIO配置为推挽复用模式 */
 	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_12;
 	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
 	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
 	GPIO_Init(GPIOC, &GPIO_InitStructure);
 
-	/* 3USART RxGPIOΪģʽ
-	   CPUλGPIOȱʡǸģʽ費Ǳ
-	   ǣһǽϱĶҷֹط޸ߵò
+	/* 第3步：将USART Rx的GPIO配置为浮空输入模式
+	   由于CPU复位后，GPIO缺省都是浮空输入模式，因此下面这个步骤不是必须的
+	   但是，我还是建议加上便于阅读，并且防止其它地方修改了这个口线的设置参数
 	*/
 	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_2;
 	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
 	GPIO_Init(GPIOD, &GPIO_InitStructure);
 
 
-	/* 4 ôӲ */
-	USART_InitStructure.USART_BaudRate = UART5_BAUD;    /*  */
+	/* 第4步： 配置串口硬件参数 */
+	USART_InitStructure.USART_BaudRate = UART5_BAUD;    /* 波特率 */
 	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
 	USART_InitStructure.USART_StopBits = USART_StopBits_1;
 	USART_InitStructure.USART_Parity = USART_Parity_No;
@@ -745,26 +846,26 @@ static void UART_InitHardPara(void)
 	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
 	USART_Init(UART5, &USART_InitStructure);
 
-	USART_ITConfig(UART5, USART_IT_RXNE, ENABLE);   /* ʹܽж */
+	USART_ITConfig(UART5, USART_IT_RXNE, ENABLE);   /* 使能接收中断 */
 	/*
 		USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
-		ע: Ҫڴ˴򿪷ж
-		жʹSendUart()
+		注意: 不要在此处打开发送中断
+		发送中断使能在SendUart()函数打开
 	*/
-	USART_Cmd(UART5, ENABLE);       /* ʹܴ */
+	USART_Cmd(UART5, ENABLE);       /* 使能串口 */
 
-	/* CPUСȱݣúãֱSend1ֽڷͲȥ
-		1ֽ޷ȷͳȥ */
-	USART_ClearFlag(UART5, USART_FLAG_TC);     /* 巢ɱ־Transmission Complete flag */
+	/* CPU的小缺陷：串口配置好，如果直接Send，则第1个字节发送不出去
+		如下语句解决第1个字节无法正确发送出去的问题 */
+	USART_ClearFlag(UART5, USART_FLAG_TC);     /* 清发送完成标志，Transmission Complete flag */
 #endif
 }
 
 /*
 *********************************************************************************************************
-*     : UART_ConfigNVIC
-*   ˵: ôӲжϣָжϷڵȼ
-*       :  
-*     ֵ: 
+*   函 数 名: UART_ConfigNVIC
+*   功能说明: 配置串口硬件中断，指定中断服务函数及各个串口的优先级
+*   形    参:  无
+*   返 回 值: 无
 *********************************************************************************************************
 */
 static void UART_ConfigNVIC(void)
@@ -772,26 +873,44 @@ static void UART_ConfigNVIC(void)
 	NVIC_InitTypeDef NVIC_InitStructure;
 
 	/* Configure the NVIC Preemption Priority Bits */
-	/*  NVIC_PriorityGroupConfig(NVIC_PriorityGroup_0);  ---  bsp.c  bsp_Init() жȼ */
+	/*  NVIC_PriorityGroupConfig(NVIC_PriorityGroup_0);  --- 在 bsp.c 中 bsp_Init() 中配置中断优先级组 */
 
 #if UART1_FIFO_EN == 1
-	/* ʹܴ1ж */
+	/* 使能串口1中断 */
 	NVIC_InitStructure.NVIC_IRQChannel = USART1_IRQn;
 	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
 	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
 	NVIC_Init(&NVIC_InitStructure);
+#if UART1_RX_DMA_EN == 1
+	/* 接收DMA半满、全满中断，与串口1中断同一优先级，不会互相打断 */
+	NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel5_IRQn;
+	NVIC_Init(&NVIC_InitStructure);
+#endif
+#if UART1_TX_DMA_EN == 1
+	/* 发送DMA传输完成中断 */
+	NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel4_IRQn;
+	NVIC_Init(&NVIC_InitStructure);
+#endif
 #endif
 
 #if UART2_FIFO_EN == 1
-	/* ʹܴ2ж */
+	/* 使能串口2中断 */
 	NVIC_InitStructure.NVIC_IRQChannel = USART2_IRQn;
 	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
 	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
 	NVIC_Init(&NVIC_InitStructure);
+#if UART2_RX_DMA_EN == 1
+	NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel6_IRQn;
+	NVIC_Init(&NVIC_InitStructure);
+#endif
+#if UART2_TX_DMA_EN == 1
+	NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel7_IRQn;
+	NVIC_Init(&NVIC_InitStructure);
+#endif
 #endif
 
 #if UART3_FIFO_EN == 1
-	/* ʹܴ3жt */
+	/* 使能串口3中断t */
 	NVIC_InitStructure.NVIC_IRQChannel = USART3_IRQn;
 	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 2;
 	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
@@ -799,7 +918,7 @@ static void UART_ConfigNVIC(void)
 #endif
 
 #if UART4_FIFO_EN == 1
-	/* ʹܴ4жt */
+	/* 使能串口4中断t */
 	NVIC_InitStructure.NVIC_IRQChannel = UART4_IRQn;
 	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 3;
 	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
@@ -807,7 +926,7 @@ static void UART_ConfigNVIC(void)
 #endif
 
 #if UART5_FIFO_EN == 1
-	/* ʹܴ5жt */
+	/* 使能串口5中断t */
 	NVIC_InitStructure.NVIC_IRQChannel = UART5_IRQn;
 	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 4;
 	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
@@ -815,7 +934,7 @@ static void UART_ConfigNVIC(void)
 #endif
 
 #if UART6_FIFO_EN == 1
-	/* ʹܴ6жt */
+	/* 使能串口6中断t */
 	NVIC_InitStructure.NVIC_IRQChannel = USART6_IRQn;
 	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 5;
 	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
@@ -825,206 +944,311 @@ static void UART_ConfigNVIC(void)
 
 /*
 *********************************************************************************************************
-*     : UartSend
-*   ˵: дݵUARTͻ,жϡжϴϺԶرշж
-*       :  
-*     ֵ: 
+*   函 数 名: UartRxDmaInit
+*   功能说明: 配置串口接收DMA：循环模式，把接收数据直接写入接收FIFO，使能半满/全满中断和串口IDLE中断。
+*             DMA是接收FIFO的生产者，写指针由DMA剩余计数得到，主程序读取方式不变
+*   形    参: _pUart : 串口设备，rxDma 必须已赋值
+*   返 回 值: 无
 *********************************************************************************************************
 */
-static void UartSend(UART_T *_pUart, uint8_t *_ucaBuf, uint16_t _usLen)
+static void UartRxDmaInit(UART_T *_pUart)
 {
-	uint16_t i;
+	DMA_InitTypeDef DMA_InitStructure;
+
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+
+	DMA_DeInit(_pUart->rxDma);
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&_pUart->uart->DR;
+	DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)_pUart->tRx.pBuf;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+	DMA_InitStructure.DMA_BufferSize = _pUart->tRx.usMask + 1;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+	DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+	DMA_Init(_pUart->rxDma, &DMA_InitStructure);
+
+	/* 没有空闲间隔的长数据流在DMA写满半个缓冲区时也取走，避免被覆盖 */
+	DMA_ITConfig(_pUart->rxDma, DMA_IT_HT | DMA_IT_TC, ENABLE);
+	DMA_Cmd(_pUart->rxDma, ENABLE);
+
+	USART_DMACmd(_pUart->uart, USART_DMAReq_Rx, ENABLE);
+	USART_ITConfig(_pUart->uart, USART_IT_IDLE, ENABLE);    /* 使能总线空闲中断 */
+}
 
-	for (i = 0; i < _usLen; i++)
+/*
+*********************************************************************************************************
+*   函 数 名: UartRxDmaUpdate
+*   功能说明: 由DMA剩余计数得到DMA写到的位置，移动接收FIFO写指针。未读数据超过缓冲区大小时最早的数据已被DMA覆盖，由主程序读取时丢弃。
+*             在IDLE中断和DMA中断中调用，两者优先级相同，是接收FIFO唯一的生产者
+*   形    参: _pUart : 串口设备
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+static void UartRxDmaUpdate(UART_T *_pUart)
+{
+	uint16_t usMask = _pUart->tRx.usMask;
+	uint16_t usWrite = _pUart->tRx.usWrite & usMask;
+	uint16_t usPos;
+	uint16_t usNew;
+
+	usPos = (usMask + 1 - DMA_GetCurrDataCounter(_pUart->rxDma)) & usMask;
+	usNew = (usPos - usWrite) & usMask;
+	if (usNew == 0)
 	{
-		/* ͻѾˣȴ */
-#if 0
-		/*ڵGPRSʱĴwhileѭԭ ͵1ֽʱ _pUart->usTxWrite = 1_pUart->usTxRead = 0;while(1) ޷˳*/
-		while (1)
-		{
-			uint16_t usRead;
+		return;
+	}
 
-			DISABLE_INT();
-			usRead = _pUart->usTxRead;
-			ENABLE_INT();
+	RING_Produce(&_pUart->tRx, usNew);
+}
 
-			if (++usRead >= _pUart->usTxBufSize)
-			{
-				usRead = 0;
-			}
+/*
+*********************************************************************************************************
+*   函 数 名: UartTxDmaInit
+*   功能说明: 配置串口发送DMA：普通模式，外设为串口DR，使能传输完成中断。每次传输的地址和长度由
+*             UartTxDmaKick 设置
+*   形    参: _pUart : 串口设备，txDma 必须已赋值
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+static void UartTxDmaInit(UART_T *_pUart)
+{
+	DMA_InitTypeDef DMA_InitStructure;
+
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+
+	DMA_DeInit(_pUart->txDma);
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&_pUart->uart->DR;
+	DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)_pUart->tTx.pBuf;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+	DMA_InitStructure.DMA_BufferSize = 1;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+	DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+	DMA_Init(_pUart->txDma, &DMA_InitStructure);
+
+	DMA_ITConfig(_pUart->txDma, DMA_IT_TC, ENABLE);
+	USART_DMACmd(_pUart->uart, USART_DMAReq_Tx, ENABLE);
+}
 
-			if (usRead != _pUart->usTxWrite)
-			{
-				break;
-			}
-		}
-#else
-		/*  _pUart->usTxBufSize == 1 ʱ, ĺ() */
-		while (1)
-		{
-			__IO uint16_t usCount;
+/*
+*********************************************************************************************************
+*   函 数 名: UartTxDmaKick
+*   功能说明: DMA空闲且发送FIFO中有数据时，启动一次DMA传输：从读指针开始到缓冲区末尾为止的连续数据。
+*             只在发送DMA中断中调用，主程序通过挂起该中断来启动传输，DMA状态只由中断修改
+*   形    参: _pUart : 串口设备
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+static void UartTxDmaKick(UART_T *_pUart)
+{
+	uint8_t *pData;
+	uint16_t usLen;
 
-			DISABLE_INT();
-			usCount = _pUart->usTxCount;
-			ENABLE_INT();
+	if (_pUart->usTxDmaLen != 0)
+	{
+		return;
+	}
+	usLen = RING_ReadSpan(&_pUart->tTx, &pData);
+	if (usLen == 0)
+	{
+		return;
+	}
+	_pUart->usTxDmaLen = usLen;
 
-			if (usCount < _pUart->usTxBufSize)
-			{
-				break;
-			}
-		}
-#endif
+	DMA_Cmd(_pUart->txDma, DISABLE);    /* 通道关闭时才能修改地址和长度 */
+	_pUart->txDma->CMAR = (uint32_t)pData;
+	DMA_SetCurrDataCounter(_pUart->txDma, usLen);
+	DMA_Cmd(_pUart->txDma, ENABLE);
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: UartTxDmaDone
+*   功能说明: 发送DMA传输完成：移动发送FIFO读指针，有剩余数据(回绕部分或新写入的数据)时继续传输。
+*             全部发完且有 SendOver 回调时打开串口发送完毕中断，最后1个字节移出后执行回调
+*   形    参: _pUart : 串口设备
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+static void UartTxDmaDone(UART_T *_pUart)
+{
+	RING_Consume(&_pUart->tTx, _pUart->usTxDmaLen);
+	_pUart->usTxDmaLen = 0;
 
-		/* 뷢ͻ */
-		_pUart->pTxBuf[_pUart->usTxWrite] = _ucaBuf[i];
+	UartTxDmaKick(_pUart);
+	if ((_pUart->usTxDmaLen == 0) && (_pUart->SendOver != 0))
+	{
+		USART_ITConfig(_pUart->uart, USART_IT_TC, ENABLE);
+	}
+}
 
-		DISABLE_INT();
-		if (++_pUart->usTxWrite >= _pUart->usTxBufSize)
+/*
+*********************************************************************************************************
+*   函 数 名: UartSendDma
+*   功能说明: DMA发送：把数据整块复制到发送FIFO(回绕时分两段)，DMA空闲时挂起发送DMA中断，由中断启动传输。
+*             先移动写指针再检查DMA状态：DMA正在传输时，传输完成中断一定能看到新写入的数据。
+*             发送FIFO空间不足时等待DMA发出一部分数据后继续复制
+*   形    参: _pUart : 串口设备
+*             _ucaBuf : 待发送的数据
+*             _usLen : 数据长度
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+static void UartSendDma(UART_T *_pUart, uint8_t *_ucaBuf, uint16_t _usLen)
+{
+	uint16_t usLen;
+
+	while (_usLen > 0)
+	{
+		usLen = RING_Write(&_pUart->tTx, _ucaBuf, _usLen);
+		if (_pUart->usTxDmaLen == 0)
 		{
-			_pUart->usTxWrite = 0;
+			NVIC_SetPendingIRQ(_pUart->txIRQn);
 		}
-		_pUart->usTxCount++;
-		ENABLE_INT();
+		_ucaBuf += usLen;
+		_usLen -= usLen;     /* 发送缓冲区已满时 usLen 为0，等待DMA传输完成中断释放空间 */
 	}
-
-	USART_ITConfig(_pUart->uart, USART_IT_TXE, ENABLE);
 }
 
 /*
 *********************************************************************************************************
-*     : UartGetChar
-*   ˵: Ӵڽջȡ1ֽ ã
-*       : _pUart : 豸
-*             _pByte : Ŷȡݵָ
-*     ֵ: 0 ʾ  1ʾȡ
+*   函 数 名: UartSend
+*   功能说明: 填写数据到UART发送缓冲区,并启动发送中断。中断处理函数发送完毕后，自动关闭发送中断
+*   形    参:  无
+*   返 回 值: 无
 *********************************************************************************************************
 */
-static uint8_t UartGetChar(UART_T *_pUart, uint8_t *_pByte)
+static void UartSend(UART_T *_pUart, uint8_t *_ucaBuf, uint16_t _usLen)
 {
-	uint16_t usCount;
-
-	/* usRxWrite жϺбдȡñʱٽ */
-	DISABLE_INT();
-	usCount = _pUart->usRxCount;
-	ENABLE_INT();
+	uint16_t i;
 
-	/* дͬ򷵻0 */
-	//if (_pUart->usRxRead == usRxWrite)
-	if (usCount == 0)   /* Ѿû */
-	{
-		return 0;
-	} else
+	if (_pUart->txDma != 0)
 	{
-		*_pByte = _pUart->pRxBuf[_pUart->usRxRead];     /* ӴڽFIFOȡ1 */
+		UartSendDma(_pUart, _ucaBuf, _usLen);
+		return;
+	}
 
-		/* дFIFO */
-		DISABLE_INT();
-		if (++_pUart->usRxRead >= _pUart->usRxBufSize)
+	for (i = 0; i < _usLen; i++)
+	{
+		/* 如果发送缓冲区已经满了，则等待中断取走数据 */
+		while (RING_PutByte(&_pUart->tTx, _ucaBuf[i]) == 0)
 		{
-			_pUart->usRxRead = 0;
+			USART_ITConfig(_pUart->uart, USART_IT_TXE, ENABLE);
 		}
-		_pUart->usRxCount--;
-		ENABLE_INT();
-		return 1;
 	}
+
+	USART_ITConfig(_pUart->uart, USART_IT_TXE, ENABLE);
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: UartGetChar
+*   功能说明: 从串口接收缓冲区读取1字节数据 （用于主程序调用）
+*   形    参: _pUart : 串口设备
+*             _pByte : 存放读取数据的指针
+*   返 回 值: 0 表示无数据  1表示读取到数据
+*********************************************************************************************************
+*/
+static uint8_t UartGetChar(UART_T *_pUart, uint8_t *_pByte)
+{
+	/* 主程序是接收FIFO唯一的消费者，只修改读指针，不需要关中断 */
+	return RING_GetByte(&_pUart->tRx, _pByte);
 }
 
 /*
 *********************************************************************************************************
-*     : UartIRQ
-*   ˵: жϷãͨõĴжϴݴĴںŽзֱ
-*       : _pUart : 豸
-*     ֵ: 
+*   函 数 名: UartIRQ
+*   功能说明: 供中断服务程序调用，通用的串口中断处理函数，根据传入的串口号进行分别处理
+*   形    参: _pUart : 串口设备
+*   返 回 值: 无
 *********************************************************************************************************
 */
 static void UartIRQ(UART_T *_pUart)
 {
-	/* ж  */
-	if (USART_GetITStatus(_pUart->uart, USART_IT_RXNE) != RESET)
+	uint8_t ch;
+
+	/* DMA接收时的总线空闲中断：把DMA已写入的数据放入接收FIFO */
+	if ((_pUart->rxDma != 0) && (USART_GetITStatus(_pUart->uart, USART_IT_IDLE) != RESET))
 	{
-		/* ӴڽݼĴȡݴŵFIFO */
-		uint8_t ch;
+		USART_ReceiveData(_pUart->uart);    /* 先读SR再读DR，清除IDLE标志 */
+		UartRxDmaUpdate(_pUart);
+	}
 
+	/* 处理接收中断  */
+	if (USART_GetITStatus(_pUart->uart, USART_IT_RXNE) != RESET)
+	{
+		/* 从串口接收数据寄存器读取数据存放到接收FIFO，FIFO已满时丢弃新数据 */
 		ch = USART_ReceiveData(_pUart->uart);
-		_pUart->pRxBuf[_pUart->usRxWrite] = ch;
-		if (++_pUart->usRxWrite >= _pUart->usRxBufSize)
-		{
-			_pUart->usRxWrite = 0;
-		}
-		if (_pUart->usRxCount < _pUart->usRxBufSize)
-		{
-			_pUart->usRxCount++;
-		}
+		RING_PutByte(&_pUart->tRx, ch);
 
-		/* ص,֪ͨӦóյ,һǷ1Ϣһ */
-		//if (_pUart->usRxWrite == _pUart->usRxRead)
-		//if (_pUart->usRxCount == 1)
+		/* 回调函数,通知应用程序收到新数据,一般是发送1个消息或者设置一个标记 */
+		if (_pUart->ReciveNew)
 		{
-			if (_pUart->ReciveNew)
-			{
-				_pUart->ReciveNew(ch);
-			}
+			_pUart->ReciveNew(ch);
 		}
 	}
 
-	/* ͻж */
+	/* 处理发送缓冲区空中断 */
 	if (USART_GetITStatus(_pUart->uart, USART_IT_TXE) != RESET)
 	{
-		//if (_pUart->usTxRead == _pUart->usTxWrite)
-		if (_pUart->usTxCount == 0)
+		/* 从发送FIFO取1个字节写入串口发送数据寄存器 */
+		if (RING_GetByte(&_pUart->tTx, &ch))
+		{
+			USART_SendData(_pUart->uart, ch);
+		}
+		else
 		{
-			/* ͻȡʱ ֹͻж ע⣺ʱ1ݻδϣ*/
+			/* 发送缓冲区的数据已取完时， 禁止发送缓冲区空中断 （注意：此时最后1个数据还未真正发送完毕）*/
 			USART_ITConfig(_pUart->uart, USART_IT_TXE, DISABLE);
 
-			/* ʹݷж */
+			/* 使能数据发送完毕中断 */
 			USART_ITConfig(_pUart->uart, USART_IT_TC, ENABLE);
-		} else
-		{
-			/* ӷFIFOȡ1ֽд봮ڷݼĴ */
-			USART_SendData(_pUart->uart, _pUart->pTxBuf[_pUart->usTxRead]);
-			if (++_pUart->usTxRead >= _pUart->usTxBufSize)
-			{
-				_pUart->usTxRead = 0;
-			}
-			_pUart->usTxCount--;
 		}
-
 	}
-	/* bitλȫϵж */
+	/* 数据bit位全部发送完毕的中断 */
 	else if (USART_GetITStatus(_pUart->uart, USART_IT_TC) != RESET)
 	{
-		//if (_pUart->usTxRead == _pUart->usTxWrite)
-		if (_pUart->usTxCount == 0)
+		if (RING_Count(&_pUart->tTx) == 0)
 		{
-			/* FIFOȫϣֹݷж */
+			/* 如果发送FIFO的数据全部发送完毕，禁止数据发送完毕中断 */
 			USART_ITConfig(_pUart->uart, USART_IT_TC, DISABLE);
 
-			/* ص, һRS485ͨţRS485оƬΪģʽռ */
+			/* 回调函数, 一般用来处理RS485通信，将RS485芯片设置为接收模式，避免抢占总线 */
 			if (_pUart->SendOver)
 			{
 				_pUart->SendOver();
 			}
+		} else if (_pUart->txDma != 0)
+		{
+			/* 打开中断后又写入了新数据，DMA发完后重新打开 */
+			USART_ITConfig(_pUart->uart, USART_IT_TC, DISABLE);
 		} else
 		{
-			/* £˷֧ */
+			/* 正常情况下，不会进入此分支 */
 
-			/* FIFOݻδϣӷFIFOȡ1д뷢ݼĴ */
-			USART_SendData(_pUart->uart, _pUart->pTxBuf[_pUart->usTxRead]);
-			if (++_pUart->usTxRead >= _pUart->usTxBufSize)
+			/* 如果发送FIFO的数据还未完毕，则从发送FIFO取1个数据写入发送数据寄存器 */
+			if (RING_GetByte(&_pUart->tTx, &ch))
 			{
-				_pUart->usTxRead = 0;
+				USART_SendData(_pUart->uart, ch);
 			}
-			_pUart->usTxCount--;
 		}
 	}
 }
 
 /*
 *********************************************************************************************************
-*     : USART1_IRQHandler  USART2_IRQHandler USART3_IRQHandler UART4_IRQHandler UART5_IRQHandler
-*   ˵: USARTжϷ򣬽жжϷݲ
-*       : 
-*     ֵ: 
+*   函 数 名: USART1_IRQHandler  USART2_IRQHandler USART3_IRQHandler UART4_IRQHandler UART5_IRQHandler
+*   功能说明: USART中断服务程序，将中断向量表的中断服务函数改名并传递参数
+*   形    参: 无
+*   返 回 值: 无
 *********************************************************************************************************
 */
 #if UART1_FIFO_EN == 1
@@ -1041,6 +1265,68 @@ void USART2_IRQHandler(void)
 }
 #endif
 
+/*
+*********************************************************************************************************
+*   函 数 名: DMA1_Channel5_IRQHandler  DMA1_Channel6_IRQHandler
+*   功能说明: 串口1、2接收DMA半满/全满中断，取走已收到的数据
+*   形    参: 无
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+#if UART1_FIFO_EN == 1 && UART1_RX_DMA_EN == 1
+void DMA1_Channel5_IRQHandler(void)
+{
+	DMA_ClearITPendingBit(DMA1_IT_GL5);
+	UartRxDmaUpdate(&g_tUart1);
+}
+#endif
+
+#if UART2_FIFO_EN == 1 && UART2_RX_DMA_EN == 1
+void DMA1_Channel6_IRQHandler(void)
+{
+	DMA_ClearITPendingBit(DMA1_IT_GL6);
+	UartRxDmaUpdate(&g_tUart2);
+}
+#endif
+
+/*
+*********************************************************************************************************
+*   函 数 名: DMA1_Channel4_IRQHandler  DMA1_Channel7_IRQHandler
+*   功能说明: 串口1、2发送DMA中断：传输完成，或 UartSendDma 挂起中断请求启动传输
+*   形    参: 无
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+#if UART1_FIFO_EN == 1 && UART1_TX_DMA_EN == 1
+void DMA1_Channel4_IRQHandler(void)
+{
+	if (DMA_GetITStatus(DMA1_IT_TC4) != RESET)
+	{
+		DMA_ClearITPendingBit(DMA1_IT_GL4);
+		UartTxDmaDone(&g_tUart1);
+	}
+	else
+	{
+		UartTxDmaKick(&g_tUart1);
+	}
+}
+#endif
+
+#if UART2_FIFO_EN == 1 && UART2_TX_DMA_EN == 1
+void DMA1_Channel7_IRQHandler(void)
+{
+	if (DMA_GetITStatus(DMA1_IT_TC7) != RESET)
+	{
+		DMA_ClearITPendingBit(DMA1_IT_GL7);
+		UartTxDmaDone(&g_tUart2);
+	}
+	else
+	{
+		UartTxDmaKick(&g_tUart2);
+	}
+}
+#endif
+
 #if UART3_FIFO_EN == 1
 void USART3_IRQHandler(void)
 {
@@ -1071,23 +1357,23 @@ void USART6_IRQHandler(void)
 
 /*
 *********************************************************************************************************
-*     : fputc
-*   ˵: ضputcʹprintfӴ1ӡ
-*       : 
-*     ֵ: 
+*   函 数 名: fputc
+*   功能说明: 重定义putc函数，这样可以使用printf函数从串口1打印输出
+*   形    参: 无
+*   返 回 值: 无
 *********************************************************************************************************
 */
 int fputc(int ch, FILE *f)
 {
-#if 1   /* ҪprintfַͨжFIFOͳȥprintf */
+#if 1   /* 将需要printf的字符通过串口中断FIFO发送出去，printf函数会立即返回 */
 	COMx_SendChar(COM1, ch);
 
 	return ch;
-#else   /* ʽÿַ,ȴݷ */
-	/* дһֽڵUSART1 */
+#else   /* 采用阻塞方式发送每个字符,等待数据发送完毕 */
+	/* 写一个字节到USART1 */
 	USART_SendData(USART1, (uint8_t) ch);
 
-	/* ȴͽ */
+	/* 等待发送结束 */
 	while (USART_GetFlagStatus(USART1, USART_FLAG_TC) == RESET)
 	{}
 
@@ -1097,28 +1383,28 @@ int fputc(int ch, FILE *f)
 
 /*
 *********************************************************************************************************
-*     : fgetc
-*   ˵: ضgetcʹgetcharӴ1
-*       : 
-*     ֵ: 
+*   函 数 名: fgetc
+*   功能说明: 重定义getc函数，这样可以使用getchar函数从串口1输入数据
+*   形    参: 无
+*   返 回 值: 无
 *********************************************************************************************************
 */
 int fgetc(FILE *f)
 {
 
-#if 1   /* ӴڽFIFOȡ1, ֻȡݲŷ */
+#if 1   /* 从串口接收FIFO中取1个数据, 只有取到数据才返回 */
 	uint8_t ucData;
 
 	while (COMx_GetChar(COM1, &ucData) == 0);
 
 	return ucData;
 #else
-	/* ȴ1 */
+	/* 等待串口1输入数据 */
 	while (USART_GetFlagStatus(USART1, USART_FLAG_RXNE) == RESET);
 
 	return (int)USART_ReceiveData(USART1);
 #endif
 }
 
-/*****************************  www.armfly.com (END OF FILE) *********************************/
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
 
@@ -1,9 +1,9 @@
 /********************************************************************************************************
 *
-*   ģ : ж+FIFOģ
-*   ļ : Uart_fifo.h
-*        : V1.0
-*   ˵     : ͷļ
+*   模块名称 : 串口中断+FIFO驱动模块
+*   文件名称 : Uart_fifo.h
+*   版    本 : V1.0
+*   说    明 : 头文件
 *
 *********************************************************************************************************/
 
@@ -11,27 +11,27 @@
 #define _BSP_USART_FIFO_H_
 #include "bsp.h"
 /*
-    ҪĴڶӦĹܽţ޸ Uart_fifo.cļе static void UART_InitHardPara(void)
+    如果需要更改串口对应的管脚，请自行修改 Uart_fifo.c文件中的 static void UART_InitHardPara(void)函数
 */
 
-/* ʹܵĴ, 0 ʾʹܣӴС 1ʾʹ */
+/* 定义使能的串口, 0 表示不使能（不增加代码大小）， 1表示使能 */
 /*
-    USBPC·崮ڷ䣺
-    1 CH340TоƬ1·Խ׶ΪϢ
+    USBPC电路板串口分配：
+    【串口1】 CH340T芯片第1路。调试阶段作为信息输出。
         PA9/USART1_TX
         PA10/USART1_RX
 
-    2SX1278 ģ
+    【串口2】SX1278 模块
         PA2/USART2_TX
         PA3/USART2_RX
 
-    3 GPS ͨţUSBPC޷ʹã
+    【串口3】 GPS 通信（在USBPC中无法使用）
         PB10/USART3_TX
         PB11/USART3_RX
         PB2/BOOT1/RS485_TX_EN
 
-    4 --- á
-    5 --- á
+    【串口4】 --- 不做串口用。
+    【串口5】 --- 不做串口用。
 */
 #define UART1_FIFO_EN   1
 #define UART2_FIFO_EN   1
@@ -39,7 +39,19 @@
 #define UART4_FIFO_EN   0
 #define UART5_FIFO_EN   0
 
-/* RS485оƬʹGPIO, PB2 */
+/* 接收方式：1 表示DMA循环接收到接收FIFO，USART IDLE中断划分数据帧，没有逐字节中断；0 表示RXNE逐字节中断
+    USART1_RX = DMA1通道5，USART2_RX = DMA1通道6
+*/
+#define UART1_RX_DMA_EN 1
+#define UART2_RX_DMA_EN 1
+
+/* 发送方式：1 表示DMA发送，发送FIFO中的连续数据一次DMA传输发完，回绕时分两次；0 表示TXE逐字节中断
+    USART1_TX = DMA1通道4，USART2_TX = DMA1通道7
+*/
+#define UART1_TX_DMA_EN 1
+#define UART2_TX_DMA_EN 1
+
+/* RS485芯片发送使能GPIO, PB2 */
 #define RCC_RS485_TXEN   RCC_APB2Periph_GPIOB
 #define PORT_RS485_TXEN  GPIOB
 #define PIN_RS485_TXEN   GPIO_Pin_2
@@ -48,7 +60,7 @@
 #define RS485_TX_EN()   PORT_RS485_TXEN->BSRR = PIN_RS485_TXEN
 
 
-/* ˿ں */
+/* 定义端口号 */
 typedef enum
 {
     COM1 = 0,   /* USART1  PA9, PA10 */
@@ -58,7 +70,11 @@ typedef enum
     COM5 = 4,   /* UART5, PC12, PD2 */
 } COM_PORT_E;
 
-/* 崮ڲʺFIFOСΪͻͽջ, ֧ȫ˫ */
+#define COM_PORT_NUM    5
+
+/* 定义串口波特率和FIFO缓冲区大小，分为发送缓冲区和接收缓冲区, 支持全双工。
+    缓冲区大小必须是2的整数次幂(见 bsp_ring.h)
+*/
 #if UART1_FIFO_EN == 1
 #define UART1_BAUD          115200
 #define UART1_TX_BUF_SIZE   1*1024
@@ -89,31 +105,30 @@ typedef enum
 #define UART5_RX_BUF_SIZE   1*1024
 #endif
 
-/* 豸ṹ */
+/* 串口设备结构体 */
 typedef struct
 {
-    USART_TypeDef *uart;        /* STM32ڲ豸ָ */
-    uint8_t *pTxBuf;            /* ͻ */
-    uint8_t *pRxBuf;            /* ջ */
-    uint16_t usTxBufSize;       /* ͻС */
-    uint16_t usRxBufSize;       /* ջС */
-    __IO uint16_t usTxWrite;            /* ͻдָ */
-    __IO uint16_t usTxRead;         /* ͻָ */
-    __IO uint16_t usTxCount;            /* ȴ͵ݸ */
-
-    __IO uint16_t usRxWrite;            /* ջдָ */
-    __IO uint16_t usRxRead;         /* ջָ */
-    __IO uint16_t usRxCount;            /* δȡݸ */
-
-    void (*SendBefore)(void);   /* ʼ֮ǰĻصָ루ҪRS485лģʽ */
-    void (*SendOver)(void);     /* ϵĻصָ루ҪRS485ģʽлΪģʽ */
-    void (*ReciveNew)(uint8_t _byte);   /* յݵĻصָ */
+    USART_TypeDef *uart;        /* STM32内部串口设备指针 */
+    RING_T tTx;                 /* 发送FIFO：主程序写，TXE中断或DMA读 */
+    RING_T tRx;                 /* 接收FIFO：RXNE中断或DMA写，主程序读 */
+
+    void (*SendBefore)(void);   /* 开始发送之前的回调函数指针（主要用于RS485切换到发送模式） */
+    void (*SendOver)(void);     /* 发送完毕的回调函数指针（主要用于RS485将发送模式切换为接收模式） */
+    void (*ReciveNew)(uint8_t _byte);   /* 串口收到数据的回调函数指针 */
+
+    DMA_Channel_TypeDef *rxDma; /* 接收DMA通道，0 表示RXNE中断接收 */
+    DMA_Channel_TypeDef *txDma; /* 发送DMA通道，0 表示TXE中断发送 */
+    IRQn_Type txIRQn;           /* 发送DMA中断号，主程序挂起该中断来启动传输 */
+    __IO uint16_t usTxDmaLen;   /* 正在DMA发送的字节数，0 表示DMA空闲 */
 } UART_T;
 
 void UART_InitALL(void);
-void COMx_SendBuf(COM_PORT_E _ucPort, uint8_t *_ucaBuf, uint16_t _usLen);   //_ucPortںţ_ucaBufڷͻ_usLenݳ
-void COMx_SendChar(COM_PORT_E _ucPort, uint8_t _ucByte);    //_ucPortںţ_ucByteڷֽ
-uint8_t COMx_GetChar(COM_PORT_E _ucPort, uint8_t *_pByte);  //_ucPortںţ_pByteڽջ
+void COMx_SendBuf(COM_PORT_E _ucPort, uint8_t *_ucaBuf, uint16_t _usLen);   //_ucPort串口号，_ucaBuf串口发送缓冲区，_usLen数据长度
+void COMx_SendChar(COM_PORT_E _ucPort, uint8_t _ucByte);    //_ucPort串口号，_ucByte串口发送字节数据
+uint8_t COMx_GetChar(COM_PORT_E _ucPort, uint8_t *_pByte);  //_ucPort串口号，_pByte串口接收缓冲区
+uint16_t COMx_Read(COM_PORT_E _ucPort, uint8_t *_pBuf, uint16_t _usLen);    //返回读取的字节数
+uint16_t COMx_Peek(COM_PORT_E _ucPort, RING_SPAN_T *_pSpan);    //零拷贝：取未读数据的位置，不移动读指针
+void COMx_Consume(COM_PORT_E _ucPort, uint16_t _usLen);     //释放 COMx_Peek 取得的数据
 
 void COMx_ClearTxFifo(COM_PORT_E _ucPort);
 void COMx_ClearRxFifo(COM_PORT_E _ucPort);
@@ -127,4 +142,4 @@ void UART2_SetBaud(uint32_t _baud);
 
 #endif
 
-/*****************************  www.armfly.com (END OF FILE) *********************************/
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
@@ -1,23 +1,23 @@
 /*
 *********************************************************************************************************
 *
-*   ģ : ַ\ֵת
-*   ļ : bsp_user_lib.c
-*        : V1.3a
-*   ˵     : ṩһЩõstingmemԼModbus CRC16
-*   ޸ļ¼ :
-*               V1.0  2013-12-05  װ
-*               V1.1  2014-06-20  ӴСת
-*               V1.2  2015-04-06   BEBufToUint32() LEBufToUint32()
-*               V1.3  2015-10-09   BcdToChar(), HexToAscll() AsciiToUint32()
-*               V1.3a 2015-10-09   HexToAscll() ĩβ0BUG
+*   模块名称 : 字符串操作\数值转换
+*   文件名称 : bsp_user_lib.c
+*   版    本 : V1.3a
+*   说    明 : 提供一些常用的sting、mem操作函数以及Modbus CRC16函数
+*   修改记录 :
+*               V1.0  2013-12-05  首版
+*               V1.1  2014-06-20  增加大小端整数转换函数
+*               V1.2  2015-04-06  增加 BEBufToUint32()和 LEBufToUint32()
+*               V1.3  2015-10-09  增加 BcdToChar(), HexToAscll()和 AsciiToUint32()
+*               V1.3a 2015-10-09  解决 HexToAscll() 函数末尾补0的BUG
 *
 *********************************************************************************************************
 */
 
 #include "bsp.h"
 
-// CRC λֵֽ
+// CRC 高位字节值表
 static const uint8_t s_CRCHi[] =
 {
     0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0, 0x80, 0x41, 0x01, 0xC0,
@@ -47,7 +47,7 @@ static const uint8_t s_CRCHi[] =
     0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0, 0x80, 0x41, 0x01, 0xC0,
     0x80, 0x41, 0x00, 0xC1, 0x81, 0x40
 } ;
-// CRC λֵֽ
+// CRC 低位字节值表
 const uint8_t s_CRCLo[] =
 {
     0x00, 0xC0, 0xC1, 0x01, 0xC3, 0x03, 0x02, 0xC2, 0xC6, 0x06,
@@ -80,10 +80,10 @@ const uint8_t s_CRCLo[] =
 
 /*
 *********************************************************************************************************
-*     : str_len
-*   ˵: ַ.0ǽ
-*       : _str : 
-*     ֵ: 
+*   函 数 名: str_len
+*   功能说明: 计算字符串长度.0是结束符
+*   形    参: _str : 缓冲区
+*   返 回 值: 无
 *********************************************************************************************************
 */
 int str_len(char *_str)
@@ -96,11 +96,11 @@ int str_len(char *_str)
 
 /*
 *********************************************************************************************************
-*     : str_cpy
-*   ˵: ַ
-*       : tar : Ŀ껺
-*            src : Դ
-*     ֵ: 
+*   函 数 名: str_cpy
+*   功能说明: 复制字符串
+*   形    参: tar : 目标缓冲区
+*            src : 源缓冲区
+*   返 回 值: 无
 *********************************************************************************************************
 */
 void str_cpy(char *_tar, char *_src)
@@ -114,11 +114,11 @@ void str_cpy(char *_tar, char *_src)
 
 /*
 *********************************************************************************************************
-*     : str_cpyoflen
-*   ˵: ַ
-*       : tar : Ŀ껺
-*            src : Դ
-*     ֵ: 
+*   函 数 名: str_cpyoflen
+*   功能说明: 复制字符串
+*   形    参: tar : 目标缓冲区
+*            src : 源缓冲区
+*   返 回 值: 无
 *********************************************************************************************************
 */
 void str_cpyoflen(uint8_t *_tar, uint8_t *_src,uint8_t _len)
@@ -131,11 +131,11 @@ void str_cpyoflen(uint8_t *_tar, uint8_t *_src,uint8_t _len)
 
 /*
 *********************************************************************************************************
-*     : str_cmp
-*   ˵: ַȽ
-*       : s1 : ַ1
-*             s2 : ַ2
-*     ֵ: 0 ʾ 0ʾ
+*   函 数 名: str_cmp
+*   功能说明: 字符串比较
+*   形    参: s1 : 字符串1
+*             s2 : 字符串2
+*   返 回 值: 0 表示相等 非0表示不等
 *********************************************************************************************************
 */
 int str_cmp(char * s1, char * s2)
@@ -150,11 +150,11 @@ int str_cmp(char * s1, char * s2)
 
 /*
 *********************************************************************************************************
-*     : mem_set
-*   ˵: ûֵ
-*       : tar : Ŀ껺
-*                _data : ֵ
-*     ֵ: 
+*   函 数 名: mem_set
+*   功能说明: 设置缓冲区值
+*   形    参: tar : 目标缓冲区
+*                _data : 设置值
+*   返 回 值: 无
 *********************************************************************************************************
 */
 void mem_set(char *_tar, char _data, int _len)
@@ -167,12 +167,12 @@ void mem_set(char *_tar, char _data, int _len)
 
 /*
 *********************************************************************************************************
-*     : int_to_ascii
-*   ˵: תΪASCII顣ָ֧
-*       : _Number : 
-*            _pBuf : Ŀ껺, תĽ0ַ
-*            _len : ASCIIַ, ַ
-*     ֵ: 
+*   函 数 名: int_to_ascii
+*   功能说明: 将整数转换为ASCII数组。支持负数。
+*   形    参: _Number : 整数
+*            _pBuf : 目标缓冲区, 存放转换后的结果。以0结束的字符串。
+*            _len : ASCII字符个数, 字符串长度
+*   返 回 值: 无
 *********************************************************************************************************
 */
 void int_to_str(int _iNumber, char *_pBuf, unsigned char _len)
@@ -180,9 +180,9 @@ void int_to_str(int _iNumber, char *_pBuf, unsigned char _len)
     unsigned char i;
     int iTemp;
 
-    if (_iNumber < 0)   /*  */
+    if (_iNumber < 0)   /* 负数 */
     {
-        iTemp = -_iNumber;  /* תΪ */
+        iTemp = -_iNumber;  /* 转为正数 */
     }
     else
     {
@@ -191,7 +191,7 @@ void int_to_str(int _iNumber, char *_pBuf, unsigned char _len)
 
     mem_set(_pBuf, ' ',_len);
 
-    /* תΪASCIIַ */
+    /* 将整数转换为ASCII字符串 */
     for (i = 0; i < _len; i++)
     {
         _pBuf[_len - 1 - i] = (iTemp % 10) + '0';
@@ -203,7 +203,7 @@ void int_to_str(int _iNumber, char *_pBuf, unsigned char _len)
     }
     _pBuf[_len] = 0;
 
-    if (_iNumber < 0)   /*  */
+    if (_iNumber < 0)   /* 负数 */
     {
         for (i = 0; i < _len; i++)
         {
@@ -218,10 +218,10 @@ void int_to_str(int _iNumber, char *_pBuf, unsigned char _len)
 
 /*
 *********************************************************************************************************
-*     : str_to_int
-*   ˵: ASCIIַת СԶԽ
-*       : _pStr :תASCII봮. Զţ#0 2014-06-20 ޸Ϊ0-9ַ
-*     ֵ: ֵ
+*   函 数 名: str_to_int
+*   功能说明: 将ASCII码字符串转换成整数。 遇到小数点自动越过。
+*   形    参: _pStr :待转换的ASCII码串. 可以以逗号，#或0结束。 2014-06-20 修改为非0-9的字符。
+*   返 回 值: 二进制整数值
 *********************************************************************************************************
 */
 int str_to_int(char *_pStr)
@@ -235,7 +235,7 @@ int str_to_int(char *_pStr)
     p = _pStr;
     if (*p == '-')
     {
-        flag = 1;   /*  */
+        flag = 1;   /* 负数 */
         p++;
     }
     else
@@ -247,7 +247,7 @@ int str_to_int(char *_pStr)
     for (i = 0; i < 15; i++)
     {
         ucTemp = *p;
-        if (ucTemp == '.')  /* С㣬Զ1ֽ */
+        if (ucTemp == '.')  /* 遇到小数点，自动跳过1个字节 */
         {
             p++;
             ucTemp = *p;
@@ -272,12 +272,12 @@ int str_to_int(char *_pStr)
 
 /*
 *********************************************************************************************************
-*     : BEBufToUint16
-*   ˵: 2ֽ(Big Endian򣬸ֽǰ)תΪ16λ
-*       : _pBuf : 
-*     ֵ: 16λֵ
+*   函 数 名: BEBufToUint16
+*   功能说明: 将2字节数组(大端Big Endian次序，高字节在前)转换为16位整数
+*   形    参: _pBuf : 数组
+*   返 回 值: 16位整数值
 *
-*   (Big Endian)С(Little Endian)
+*   大端(Big Endian)与小端(Little Endian)
 *********************************************************************************************************
 */
 uint16_t BEBufToUint16(uint8_t *_pBuf)
@@ -287,10 +287,10 @@ uint16_t BEBufToUint16(uint8_t *_pBuf)
 
 /*
 *********************************************************************************************************
-*     : LEBufToUint16
-*   ˵: 2ֽ(СLittle Endianֽǰ)תΪ16λ
-*       : _pBuf : 
-*     ֵ: 16λֵ
+*   函 数 名: LEBufToUint16
+*   功能说明: 将2字节数组(小端Little Endian，低字节在前)转换为16位整数
+*   形    参: _pBuf : 数组
+*   返 回 值: 16位整数值
 *********************************************************************************************************
 */
 uint16_t LEBufToUint16(uint8_t *_pBuf)
@@ -301,12 +301,12 @@ uint16_t LEBufToUint16(uint8_t *_pBuf)
 
 /*
 *********************************************************************************************************
-*     : BEBufToUint32
-*   ˵: 4ֽ(Big Endian򣬸ֽǰ)תΪ16λ
-*       : _pBuf : 
-*     ֵ: 16λֵ
+*   函 数 名: BEBufToUint32
+*   功能说明: 将4字节数组(大端Big Endian次序，高字节在前)转换为16位整数
+*   形    参: _pBuf : 数组
+*   返 回 值: 16位整数值
 *
-*   (Big Endian)С(Little Endian)
+*   大端(Big Endian)与小端(Little Endian)
 *********************************************************************************************************
 */
 uint32_t BEBufToUint32(uint8_t *_pBuf)
@@ -316,10 +316,10 @@ uint32_t BEBufToUint32(uint8_t *_pBuf)
 
 /*
 *********************************************************************************************************
-*     : LEBufToUint32
-*   ˵: 4ֽ(СLittle Endianֽǰ)תΪ16λ
-*       : _pBuf : 
-*     ֵ: 16λֵ
+*   函 数 名: LEBufToUint32
+*   功能说明: 将4字节数组(小端Little Endian，低字节在前)转换为16位整数
+*   形    参: _pBuf : 数组
+*   返 回 值: 16位整数值
 *********************************************************************************************************
 */
 uint32_t LEBufToUint32(uint8_t *_pBuf)
@@ -329,29 +329,29 @@ uint32_t LEBufToUint32(uint8_t *_pBuf)
 
 /*
 *********************************************************************************************************
-*     : CRC16_Modbus
-*   ˵: CRC ModbusЭ顣
-*       : _pBuf : У
-*             _usLen : ݳ
-*     ֵ: 16λֵ Modbus ˽ֽȴֽͣں͡
+*   函 数 名: CRC16_Modbus
+*   功能说明: 计算CRC。 用于Modbus协议。
+*   形    参: _pBuf : 参与校验的数据
+*             _usLen : 数据长度
+*   返 回 值: 16位整数值。 对于Modbus ，此结果高字节先传送，低字节后传送。
 *
-*   пܵCRCֵԤװ鵱У㱨ʱԼ򵥵ɣ
-*   һ16λCRC256ܵĸλֽڣһ麬еλֽڵֵ
-*   CRCķʽṩ˱ȶԱĻÿһַµCRCķ
+*   所有可能的CRC值都被预装在两个数组当中，当计算报文内容时可以简单的索引即可；
+*   一个数组包含有16位CRC域的所有256个可能的高位字节，另一个数组含有低位字节的值；
+*   这种索引访问CRC的方式提供了比对报文缓冲区的每一个新字符都计算新的CRC更快的方法；
 *
-*  ע⣺˳ڲִи/CRCֽڵĽ˺صѾCRCֵҲ˵úķֱֵӷ
-*        ڱڷͣ
+*  注意：此程序内部执行高/低CRC字节的交换。此函数返回的是已经经过交换的CRC值；也就是说，该函数的返回值可以直接放置
+*        于报文用于发送；
 *********************************************************************************************************
 */
 uint16_t CRC16_Modbus(uint8_t *_pBuf, uint16_t _usLen)
 {
-    uint8_t ucCRCHi = 0xFF; /* CRCֽڳʼ */
-    uint8_t ucCRCLo = 0xFF; /* CRC ֽڳʼ */
-    uint16_t usIndex;  /* CRCѭе */
+    uint8_t ucCRCHi = 0xFF; /* 高CRC字节初始化 */
+    uint8_t ucCRCLo = 0xFF; /* 低CRC 字节初始化 */
+    uint16_t usIndex;  /* CRC循环中的索引 */
 
     while (_usLen--)
     {
-        usIndex = ucCRCHi ^ *_pBuf++; /* CRC */
+        usIndex = ucCRCHi ^ *_pBuf++; /* 计算CRC */
         ucCRCHi = ucCRCLo ^ s_CRCHi[usIndex];
         ucCRCLo = s_CRCLo[usIndex];
     }
@@ -361,10 +361,10 @@ uint16_t CRC16_Modbus(uint8_t *_pBuf, uint16_t _usLen)
 
 /*
 *********************************************************************************************************
-*     : CaculTwoPoint
-*   ˵: 2ֱ߷̣Yֵ
-*       :  2x
-*     ֵ: xӦyֵ
+*   函 数 名: CaculTwoPoint
+*   功能说明: 根据2点直线方程，计算Y值
+*   形    参:  2个点的坐标和x输入量
+*   返 回 值: x对应的y值
 *********************************************************************************************************
 */
 int32_t  CaculTwoPoint(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x)
@@ -375,10 +375,10 @@ int32_t  CaculTwoPoint(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x
 
 /*
 *********************************************************************************************************
-*     : BcdToChar
-*   ˵: BCDתΪASCIIַ  0x0A ==> 'A'
-*       : _bcd   ĶС16
-*     ֵ: ת
+*   函 数 名: BcdToChar
+*   功能说明: 将BCD码转为ASCII字符。 比如 0x0A ==> 'A'
+*   形    参: _bcd   ：输入的二进制数。必须小于16
+*   返 回 值: 转换结果
 *********************************************************************************************************
 */
 char BcdToChar(uint8_t _bcd)
@@ -399,12 +399,12 @@ char BcdToChar(uint8_t _bcd)
 
 /*
 *********************************************************************************************************
-*     : HexToAscll
-*   ˵: תΪ16ƸʽASCIIַÿ2ASCIIַ1ո
-*             0x12 0x34 תΪ 0x31 0x32 0x20 0x33 0x34 0x00   "1234"
-*       :   _pHex   ݣ
-*               _pAscii ת, ASCIIַ01ƶӦ2ASCIIַ.
-*     ֵ: תõ
+*   函 数 名: HexToAscll
+*   功能说明: 将二进制数组转换为16进制格式的ASCII字符串。每个2个ASCII字符后保留1个空格。
+*             0x12 0x34 转化为 0x31 0x32 0x20 0x33 0x34 0x00  即 "1234"
+*   形    参:   _pHex   ：输入的数据，二进制数组
+*               _pAscii ：存放转换结果, ASCII字符串，0结束。1个二进制对应2个ASCII字符.
+*   返 回 值: 转换得到的整数
 *********************************************************************************************************
 */
 void HexToAscll(uint8_t * _pHex, char *_pAscii, uint16_t _BinBytes)
@@ -429,10 +429,10 @@ void HexToAscll(uint8_t * _pHex, char *_pAscii, uint16_t _BinBytes)
 
 /*
 *********************************************************************************************************
-*     : AsciiToUint32
-*   ˵: 䳤 ASCII ַתΪ32λ  ASCII ַԿո0  ֧16ƺ10
-*       : *pAscii ҪתASCII
-*     ֵ: תõ
+*   函 数 名: AsciiToUint32
+*   功能说明: 变长的 ASCII 字符转换为32位整数  ASCII 字符以空格或者0结束 。 支持16进制和10进制输入
+*   形    参: *pAscii ：要转换的ASCII码
+*   返 回 值: 转换得到的整数
 *********************************************************************************************************
 */
 uint32_t AsciiToUint32(char *pAscii)
@@ -445,7 +445,7 @@ uint32_t AsciiToUint32(char *pAscii)
     uint32_t lResult;
     uint32_t lBitValue;
 
-    /* жǷ16 */
+    /* 判断是否是16进制数 */
     bIsHex = 0;
     if ((pAscii[0] == '0') && ((pAscii[1] == 'x') || (pAscii[1] == 'X')))
     {
@@ -453,14 +453,14 @@ uint32_t AsciiToUint32(char *pAscii)
     }
 
     lResult=0;
-    // ֵΪ 4294967295, 10λ+2ַ"0x" //
+    // 最大数值为 4294967295, 10位+2字符"0x" //
     if (bIsHex == 0)
     {
-        // ʮ //
-        // 󳤶 //
+        // 十进制 //
+        // 求长度 //
         lBitValue=1;
 
-        /* ǰȥ0 */
+        /* 前导去0 */
         for (i = 0; i < 8; i++)
         {
             bTemp = pAscii[i];
@@ -487,11 +487,11 @@ uint32_t AsciiToUint32(char *pAscii)
     }
     else
     {
-        /* 16 */
-        /* 󳤶 */
+        /* 16进制 */
+        /* 求长度 */
         lBitValue=1;
 
-        /* ǰȥ0 */
+        /* 前导去0 */
         for (i = 0; i < 8; i++)
         {
             bTemp = pAscii[i + 2];
@@ -539,4 +539,37 @@ uint32_t AsciiToUint32(char *pAscii)
     return lResult;
 }
 
-/*****************************  www.armfly.com (END OF FILE) *********************************/
+/*
+*********************************************************************************************************
+*   函 数 名: rand_seed
+*   功能说明: 设置 rand_u32() 的种子。各节点应使用不同的种子(如芯片唯一ID)，否则随机退避会同步。
+*   形    参: _seed : 种子，为0时使用固定的非0值
+*   返 回 值: 无
+*********************************************************************************************************
+*/
+static uint32_t s_uiRandState = 2463534242u;
+void rand_seed(uint32_t _seed)
+{
+    s_uiRandState = (_seed != 0) ? _seed : 2463534242u;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: rand_u32
+*   功能说明: xorshift32 伪随机数，用于随机退避、竞争时隙选择
+*   形    参: 无
+*   返 回 值: 32位伪随机数
+*********************************************************************************************************
+*/
+uint32_t rand_u32(void)
+{
+    uint32_t x = s_uiRandState;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s_uiRandState = x;
+    return x;
+}
+
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
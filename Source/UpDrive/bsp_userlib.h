@@ -1,10 +1,10 @@
 /*
 *********************************************************************************************************
 *
-*   ģ : ַ\ֵת
-*   ļ : bsp_user_lib.h
-*        : V1.2
-*   ˵     : ͷļ
+*   模块名称 : 字符串操作\数值转换
+*   文件名称 : bsp_user_lib.h
+*   版    本 : V1.2
+*   说    明 : 头文件
 *
 *********************************************************************************************************
 */
@@ -17,7 +17,7 @@
 
 int str_len(char *_str);
 void str_cpy(char *_tar, char *_src);
-void str_cpyoflen(uint8_t *_tar, uint8_t *_src,uint8_t _len);//ַ
+void str_cpyoflen(uint8_t *_tar, uint8_t *_src,uint8_t _len);//带长度字符串拷贝
 int str_cmp(char * s1, char * s2);
 void mem_set(char *_tar, char _data, int _len);
 
@@ -37,6 +37,9 @@ char BcdToChar(uint8_t _bcd);
 void HexToAscll(uint8_t * _pHex, char *_pAscii, uint16_t _BinBytes);
 uint32_t AsciiToUint32(char *pAscii);
 
+void rand_seed(uint32_t _seed);
+uint32_t rand_u32(void);
+
 #endif
 
-/*****************************  www.armfly.com (END OF FILE) *********************************/
+/***************************** 安富莱电子 www.armfly.com (END OF FILE) *********************************/
@@ -1,19 +1,14 @@
 #include "bsp.h"  // Device header
 
-uint8_t LoraPinisHigh = FALSE;//յݱ־λ
-
 int main(void)
 {
-	bsp_Init();  //ʼӲ豸   
+	bsp_Init();  //初始化硬件设备   
     bsp_DelayMS(10);
-    TaskInit(); //ʼ,ǻȡbsp_idleеtask_processʵ    
+    TaskInit(); //初始化任务,仅是获取任务数量，任务调度在bsp_idle中调用task_process实现    
 
 	while (1)
 	{
-		if (GPIO_ReadInputDataBit(GPIOA, RF_IRQ_PIN)) //SPISX1278յʱIRQΪ
-		{
-			LoraPinisHigh = TRUE;
-		}
+		RFEventPoll(); //处理SX1278的DIO中断事件，收到数据包时立即取出放入接收队列，由Task_RecvfromLora处理
 		bsp_Idle();       
 	}
 }
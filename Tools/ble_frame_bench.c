@@ -0,0 +1,339 @@
+/*********************************************************************************************************
+*
+*   模块名称 : BLE帧解析模糊测试与基准测试
+*   文件名称 : ble_frame_bench.c
+*   版    本 : V1.0
+*   说    明 : 在PC上测试 bsp_bleframe.c 的逐字节帧解析：
+*               - 随机生成串口1数据流：完整帧(心率和电量随机，可能等于 '$' '#')、垃圾字节(偏向 '$' '#' 'P' 'H')、
+*                 半帧、改错1个字节的帧，事件之间按概率出现总线空闲，否则连续到达
+*               - 数据经 bsp_ring.c 接收FIFO按随机长度的DMA块写入，用 RING_Peek/RING_Consume 取出送入解析器，
+*                 与固件 Task_RecvfromUart 的读取方式相同
+*               - 解析结果与穷举参考实现(从左到右，每个位置检查是否为完整帧)逐帧比较，必须完全一致
+*               - 对比旧的按总线空闲划分帧的方式：只看每段数据的前5个字节，帧头检查用的是 &&
+*               - 统计每字节解析耗时
+*
+*   编    译 : gcc -O2 -I../Source/UpDrive -o ble_frame_bench ble_frame_bench.c ../Source/UpDrive/bsp_bleframe.c ../Source/UpDrive/bsp_ring.c
+*   用    法 : ./ble_frame_bench [-events 200000] [-garbage 0.2] [-gap 0.5] [-loops 20] [-baud 115200]
+*
+*********************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bsp_bleframe.h"
+#include "bsp_ring.h"
+
+#define RING_SIZE   1024
+#define OLD_BUF     150         /* RECVDATA_T.RxBuf */
+
+typedef struct
+{
+    long events;
+    double garbage;             /* 事件为垃圾/半帧/错帧的概率 */
+    double gap;                 /* 事件之后出现总线空闲的概率 */
+    int loops;
+    long baud;
+} CFG_T;
+
+typedef struct
+{
+    uint8_t *data;
+    uint8_t *gap;               /* gap[i]=1: 第i个字节之后总线空闲 */
+    uint8_t *start;             /* start[i]=1: 第i个字节是插入的完整帧的开头 */
+    long len;
+    long frames;                /* 插入的完整帧数 */
+} STREAM_T;
+
+typedef struct
+{
+    long pos;                   /* 帧最后一个字节的位置 */
+    BLE_FRAME_T f;
+} HIT_T;
+
+static uint64_t s_rng = 0x9E3779B97F4A7C15ULL;
+
+static uint32_t rnd(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 7;
+    s_rng ^= s_rng << 17;
+    return (uint32_t)(s_rng >> 11);
+}
+
+static double rnd_Unit(void)
+{
+    return (rnd() & 0xFFFFFF) / 16777216.0;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint8_t rnd_Noise(void)
+{
+    static const uint8_t s_ucSpecial[] = {'$', '#', 'P', 'H'};
+
+    return (rnd() % 10 < 3) ? s_ucSpecial[rnd() % 4] : (uint8_t)rnd();
+}
+
+static int frame_Valid(const uint8_t *_p)
+{
+    return (_p[0] == '$') && ((_p[1] == 'P') || (_p[1] == 'H')) && (_p[4] == '#');
+}
+
+static void stream_Build(const CFG_T *_c, STREAM_T *_s)
+{
+    long cap = _c->events * 24 + 16, e;
+    int k, n;
+
+    _s->data = malloc(cap);
+    _s->gap = calloc(cap, 1);
+    _s->start = calloc(cap, 1);
+    _s->len = 0;
+    _s->frames = 0;
+    for (e = 0; e < _c->events; e++)
+    {
+        uint8_t f[BLE_FRAME_LEN];
+        uint8_t *p = &_s->data[_s->len];
+
+        f[0] = '$';
+        f[1] = (rnd() & 1) ? 'P' : 'H';
+        f[2] = (rnd() % 8 == 0) ? ((rnd() & 1) ? '$' : '#') : (uint8_t)(40 + rnd() % 160);
+        f[3] = (rnd() % 8 == 0) ? ((rnd() & 1) ? '$' : '#') : (uint8_t)(rnd() % 101);
+        f[4] = '#';
+        if (rnd_Unit() >= _c->garbage)
+        {
+            memcpy(p, f, BLE_FRAME_LEN);
+            _s->start[_s->len] = 1;
+            _s->len += BLE_FRAME_LEN;
+            _s->frames++;
+        }
+        else
+        {
+            switch (rnd() % 3)
+            {
+            case 0:                     /* 垃圾字节 */
+                n = 1 + rnd() % 20;
+                for (k = 0; k < n; k++)
+                {
+                    p[k] = rnd_Noise();
+                }
+                break;
+            case 1:                     /* 半帧 */
+                n = 1 + rnd() % (BLE_FRAME_LEN - 1);
+                memcpy(p, f, n);
+                break;
+            default:                    /* 改错1个字节 */
+                n = BLE_FRAME_LEN;
+                memcpy(p, f, n);
+                p[rnd() % n] ^= (uint8_t)(1 + rnd() % 255);
+                break;
+            }
+            _s->len += n;
+        }
+        if (rnd_Unit() < _c->gap)
+        {
+            _s->gap[_s->len - 1] = 1;
+        }
+    }
+}
+
+/* 参考实现：从左到右，当前位置开始的5个字节是完整帧则输出并跳过，否则前进1个字节 */
+static long ref_Parse(const STREAM_T *_s, HIT_T *_pHit)
+{
+    long i = 0, n = 0;
+
+    while (i + BLE_FRAME_LEN <= _s->len)
+    {
+        if (frame_Valid(&_s->data[i]))
+        {
+            _pHit[n].pos = i + BLE_FRAME_LEN - 1;
+            _pHit[n].f.type = _s->data[i + 1];
+            _pHit[n].f.heart = _s->data[i + 2];
+            _pHit[n].f.battery = _s->data[i + 3];
+            n++;
+            i += BLE_FRAME_LEN;
+        }
+        else
+        {
+            i++;
+        }
+    }
+    return n;
+}
+
+/* 固件方式：DMA按随机长度写入接收FIFO，主程序 Peek 后逐字节解析再 Consume */
+static long new_Parse(const STREAM_T *_s, HIT_T *_pHit, BLE_PARSER_T *_pParser)
+{
+    static uint8_t buf[RING_SIZE];
+    RING_T ring;
+    RING_SPAN_T span;
+    BLE_FRAME_T f;
+    long in = 0, pos = 0, n = 0;
+    uint16_t len, i;
+    int k;
+
+    RING_Init(&ring, buf, RING_SIZE);
+    BLE_ParserInit(_pParser);
+    while (pos < _s->len)
+    {
+        long chunk = 1 + rnd() % 200;
+
+        if (chunk > _s->len - in)
+        {
+            chunk = _s->len - in;
+        }
+        in += RING_Write(&ring, &_s->data[in], (uint16_t)chunk);
+        len = RING_Peek(&ring, &span);
+        for (k = 0; k < 2; k++)
+        {
+            for (i = 0; i < span.usLen[k]; i++, pos++)
+            {
+                if (BLE_ParseByte(_pParser, span.pData[k][i], &f))
+                {
+                    _pHit[n].pos = pos;
+                    _pHit[n].f = f;
+                    n++;
+                }
+            }
+        }
+        RING_Consume(&ring, len);
+    }
+    return n;
+}
+
+/* 旧方式：总线空闲后检查一段数据，少于5个字节时继续累加；只看前5个字节，帧头检查用 && */
+static void old_Parse(const STREAM_T *_s, long *_pGood, long *_pWrong)
+{
+    uint8_t buf[OLD_BUF];
+    long i, begin = 0;
+    int cnt = 0;
+
+    *_pGood = 0;
+    *_pWrong = 0;
+    for (i = 0; i < _s->len; i++)
+    {
+        if (cnt == 0)
+        {
+            begin = i;
+        }
+        if (cnt < OLD_BUF)
+        {
+            buf[cnt++] = _s->data[i];
+        }
+        if (!_s->gap[i] || (cnt < BLE_FRAME_LEN))
+        {
+            continue;
+        }
+        /* 旧代码：if ((RxBuf[0] != '$') && (RxBuf[4] != '#')) 报错，else if (RxBuf[1] 为 P/H) 接受 */
+        if (!((buf[0] != '$') && (buf[4] != '#')) && ((buf[1] == 'P') || (buf[1] == 'H')))
+        {
+            if (_s->start[begin])
+            {
+                (*_pGood)++;
+            }
+            else
+            {
+                (*_pWrong)++;
+            }
+        }
+        cnt = 0;
+    }
+}
+
+static void usage(void)
+{
+    printf("usage: ble_frame_bench [options]\n"
+           "  -events N     stream events: frames, garbage, partial and corrupted frames (200000)\n"
+           "  -garbage P    probability an event is not an intact frame (0.2)\n"
+           "  -gap P        probability of line idle after an event, else back to back (0.5)\n"
+           "  -loops N      passes over the stream for the timing (20)\n"
+           "  -baud B       UART1 baud rate for the latency line (115200)\n");
+}
+
+int main(int argc, char **argv)
+{
+    CFG_T c;
+    STREAM_T s;
+    HIT_T *ref, *got;
+    BLE_PARSER_T parser;
+    BLE_FRAME_T f;
+    long nref, ngot, i, hit = 0, spurious = 0, old_good, old_wrong, mism = 0;
+    double t0, ns;
+    int l;
+
+    c.events = 200000;
+    c.garbage = 0.2;
+    c.gap = 0.5;
+    c.loops = 20;
+    c.baud = 115200;
+    for (l = 1; l + 1 < argc; l += 2)
+    {
+        const char *opt = argv[l], *val = argv[l + 1];
+
+        if (strcmp(opt, "-events") == 0)        c.events = atol(val);
+        else if (strcmp(opt, "-garbage") == 0)  c.garbage = atof(val);
+        else if (strcmp(opt, "-gap") == 0)      c.gap = atof(val);
+        else if (strcmp(opt, "-loops") == 0)    c.loops = atoi(val);
+        else if (strcmp(opt, "-baud") == 0)     c.baud = atol(val);
+        else break;
+    }
+    if (l < argc || c.events < 1 || c.garbage < 0 || c.garbage > 1 || c.gap < 0 || c.gap > 1 || c.loops < 1
+        || c.baud < 1200)
+    {
+        usage();
+        return 1;
+    }
+
+    stream_Build(&c, &s);
+    ref = malloc(sizeof(HIT_T) * (s.len / BLE_FRAME_LEN + 1));
+    got = malloc(sizeof(HIT_T) * (s.len / BLE_FRAME_LEN + 1));
+    nref = ref_Parse(&s, ref);
+    ngot = new_Parse(&s, got, &parser);
+    for (i = 0; i < nref || i < ngot; i++)
+    {
+        if ((i >= nref) || (i >= ngot) || (ref[i].pos != got[i].pos) || memcmp(&ref[i].f, &got[i].f, sizeof(f)) != 0)
+        {
+            mism++;
+        }
+    }
+    for (i = 0; i < ngot; i++)
+    {
+        if (s.start[got[i].pos - BLE_FRAME_LEN + 1])
+        {
+            hit++;
+        }
+        else
+        {
+            spurious++;     /* 垃圾字节恰好组成了合法帧，参考实现也会输出 */
+        }
+    }
+    old_Parse(&s, &old_good, &old_wrong);
+
+    printf("%ld bytes, %ld events, %ld intact frames, %.0f%% non-frame events, %.0f%% idle gaps\n\n",
+           s.len, c.events, s.frames, c.garbage * 100, c.gap * 100);
+    printf("%-34s %10s %10s %10s\n", "", "delivered", "missed", "spurious");
+    printf("%-34s %10ld %10ld %10ld\n", "streaming parser (bsp_bleframe.c)", hit, s.frames - hit, spurious);
+    printf("%-34s %10ld %10ld %10ld\n", "old idle-line framing", old_good, s.frames - old_good, old_wrong);
+    printf("parser vs reference: %ld frames vs %ld, %ld mismatches; %lu bytes dropped while resyncing\n\n",
+           ngot, nref, mism, (unsigned long)parser.ulDrop);
+
+    t0 = now_ns();
+    for (l = 0; l < c.loops; l++)
+    {
+        BLE_ParserInit(&parser);
+        for (i = 0; i < s.len; i++)
+        {
+            BLE_ParseByte(&parser, s.data[i], &f);
+        }
+    }
+    ns = (now_ns() - t0) / ((double)s.len * c.loops);
+    printf("parse time %.2f ns/B (%.1f MB/s), %lu frames per pass\n", ns, 1e3 / ns, (unsigned long)parser.ulFrames);
+    printf("frame ready after last byte at %ld baud: parser 0 us, USART IDLE %.0f us, 3.5-char timer %.0f us\n",
+           c.baud, 10e6 / c.baud, 35e6 / c.baud);
+    return (mism != 0) ? 1 : 0;
+}
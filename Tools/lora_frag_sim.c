@@ -0,0 +1,275 @@
+/*********************************************************************************************************
+*
+*   模块名称 : 分片传输仿真
+*   文件名称 : lora_frag_sim.c
+*   版    本 : V1.0
+*   说    明 : 用固件的 bsp_frag.c 在PC上仿真超过一帧的报文经有损信道上传，并校验重组结果与原报文一致。
+*             每个超帧节点收到广播包后在 slots 个时隙中各发一个分片；广播包按概率丢失，丢失时节点本超帧
+*             不发送也收不到确认。主机把已收到分片的位图放在下一个广播包中。
+*             对比不带位图的整报文重发：一轮中任何一片丢失，整个报文下一轮重发。
+*             输出每个报文平均占用的超帧数、发送的分片帧数和有效吞吐(报文字节 / 分片帧空中时间)。
+*
+*   编    译 : gcc -O2 -I../Source/UpDrive -o lora_frag_sim lora_frag_sim.c ../Source/UpDrive/bsp_frag.c -lm
+*   用    法 : ./lora_frag_sim [-size 500,1000,2000,2640] [-per 0.1] [-bcn 0.02] [-slots 1] [-msgs 2000]
+*
+*********************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lora_phy.h"
+#include "bsp_frag.h"
+
+#define MAX_SIZE        16
+#define SF_LIMIT        10000       /* 单个报文最多仿真的超帧数 */
+
+typedef struct
+{
+    int    size[MAX_SIZE];
+    int    nsize;
+    double per;                     /* 分片帧丢失率 */
+    double bcn_loss;                /* 广播包丢失率 */
+    int    slots;                   /* 每超帧发送的分片数 */
+    int    msgs;
+    LORA_PHY_T phy;
+} CFG_T;
+
+typedef struct
+{
+    double superframes;             /* 每个报文平均占用的超帧数 */
+    double frames;                  /* 每个报文平均发送的分片帧数 */
+    double air_ms;                  /* 每个报文的分片帧空中时间 */
+    int    fail;                    /* 超过 SF_LIMIT 或放弃的报文数 */
+    int    bad;                     /* 重组结果与原报文不一致的报文数 */
+} RESULT_T;
+
+static int chance(uint64_t *_rng, double _p)
+{
+    return lora_RandUniform(_rng) < _p;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: sim_Selective
+*   功能说明: 固件方案：bsp_frag.c 发送端 + 重组端，主机按位图确认，从机只重发缺少的分片
+*********************************************************************************************************
+*/
+static void sim_Selective(const CFG_T *_c, int _size, uint64_t *_rng, RESULT_T *_r)
+{
+    static uint8_t msg[FRAG_MSG_MAX];
+    static FRAG_TX_T tx;
+    static FRAG_RX_T rx;
+    uint8_t frame[FRAG_FRAME_MAX], map[FRAG_BITMAP_LEN];
+    long sf_sum = 0, fr_sum = 0;
+    double air_sum = 0;
+    uint32_t now = 0;
+    int m, s, k, have_ack;
+
+    memset(_r, 0, sizeof(*_r));
+    FRAG_TxInit(&tx);
+    FRAG_RxInit(&rx);
+    for (m = 0; m < _c->msgs; m++)
+    {
+        uint16_t done = 0;
+
+        for (k = 0; k < _size; k++)
+        {
+            msg[k] = (uint8_t)lora_Rand(_rng);
+        }
+        FRAG_TxLoad(&tx, msg, (uint16_t)_size);
+        have_ack = 0;
+        for (s = 0; (s < SF_LIMIT) && FRAG_TxBusy(&tx); s++)
+        {
+            now += 1000;
+            if (chance(_rng, _c->bcn_loss))
+            {
+                continue;           /* 没有收到广播包：不发送，也收不到确认 */
+            }
+            if (have_ack)
+            {
+                FRAG_RxBitmap(&rx, map);
+                FRAG_TxAck(&tx, rx.msg_id, map);
+            }
+            for (k = 0; (k < _c->slots) && FRAG_TxBusy(&tx); k++)
+            {
+                uint8_t len = FRAG_TxBuild(&tx, frame, 1);
+
+                if (len == 0)
+                {
+                    break;
+                }
+                fr_sum++;
+                air_sum += lora_AirtimeUs(&_c->phy, len) / 1000.0;
+                if (!chance(_rng, _c->per))
+                {
+                    uint16_t n = FRAG_RxPut(&rx, frame, len, now);
+
+                    if (n > 0)
+                    {
+                        done = n;
+                        if ((n != _size) || memcmp(rx.buf, msg, _size) != 0)
+                        {
+                            _r->bad++;
+                        }
+                    }
+                    have_ack = 1;
+                }
+            }
+        }
+        if (FRAG_TxBusy(&tx) || (done == 0))
+        {
+            _r->fail++;
+            FRAG_TxInit(&tx);
+        }
+        sf_sum += s;
+    }
+    _r->superframes = (double)sf_sum / _c->msgs;
+    _r->frames = (double)fr_sum / _c->msgs;
+    _r->air_ms = air_sum / _c->msgs;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: sim_Whole
+*   功能说明: 对比方案：没有位图，一轮中任何一片丢失则整个报文重发
+*********************************************************************************************************
+*/
+static void sim_Whole(const CFG_T *_c, int _size, uint64_t *_rng, RESULT_T *_r)
+{
+    int total = (_size + FRAG_DATA_MAX - 1) / FRAG_DATA_MAX;
+    int last = _size - (total - 1) * FRAG_DATA_MAX;
+    double air_full = lora_AirtimeUs(&_c->phy, FRAG_FRAME_MAX) / 1000.0;
+    double air_last = lora_AirtimeUs(&_c->phy, FRAG_HDR_LEN + last + 1) / 1000.0;
+    long sf_sum = 0, fr_sum = 0;
+    double air_sum = 0;
+    int m, s, idx, lost;
+
+    memset(_r, 0, sizeof(*_r));
+    for (m = 0; m < _c->msgs; m++)
+    {
+        idx = 0;
+        lost = 0;
+        for (s = 0; s < SF_LIMIT; s++)
+        {
+            int k;
+
+            if (chance(_rng, _c->bcn_loss))
+            {
+                continue;
+            }
+            for (k = 0; (k < _c->slots) && (idx < total); k++, idx++)
+            {
+                fr_sum++;
+                air_sum += (idx == total - 1) ? air_last : air_full;
+                lost |= chance(_rng, _c->per);
+            }
+            if (idx == total)
+            {
+                if (!lost)
+                {
+                    break;
+                }
+                idx = 0;
+                lost = 0;
+            }
+        }
+        if (s == SF_LIMIT)
+        {
+            _r->fail++;
+        }
+        sf_sum += s + 1;
+    }
+    _r->superframes = (double)sf_sum / _c->msgs;
+    _r->frames = (double)fr_sum / _c->msgs;
+    _r->air_ms = air_sum / _c->msgs;
+}
+
+static int parse_List(const char *_s, CFG_T *_c)
+{
+    char buf[256], *tok;
+
+    strncpy(buf, _s, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = 0;
+    _c->nsize = 0;
+    for (tok = strtok(buf, ","); tok && _c->nsize < MAX_SIZE; tok = strtok(NULL, ","))
+    {
+        _c->size[_c->nsize] = atoi(tok);
+        if ((_c->size[_c->nsize] < 1) || (_c->size[_c->nsize] > FRAG_MSG_MAX))
+        {
+            return -1;
+        }
+        _c->nsize++;
+    }
+    return _c->nsize > 0 ? 0 : -1;
+}
+
+static void usage(void)
+{
+    printf("usage: lora_frag_sim [options]\n"
+           "  -size LIST    message sizes in bytes, each 1..%d (500,1000,2000,2640)\n"
+           "  -per P        fragment frame loss rate (0.1)\n"
+           "  -bcn P        beacon loss rate; a missed beacon means no TX and no ack (0.02)\n"
+           "  -slots K      fragments sent per superframe (1)\n"
+           "  -msgs N       messages per size (2000)\n", FRAG_MSG_MAX);
+}
+
+int main(int argc, char **argv)
+{
+    CFG_T c;
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    int i, bad = 0;
+
+    memset(&c, 0, sizeof(c));
+    parse_List("500,1000,2000,2640", &c);
+    c.per = 0.1;
+    c.bcn_loss = 0.02;
+    c.slots = 1;
+    c.msgs = 2000;
+    c.phy = g_tPhyDefault;
+
+    for (i = 1; i + 1 < argc; i += 2)
+    {
+        const char *opt = argv[i], *val = argv[i + 1];
+        int err = 0;
+
+        if (strcmp(opt, "-size") == 0)          err = parse_List(val, &c);
+        else if (strcmp(opt, "-per") == 0)      c.per = atof(val);
+        else if (strcmp(opt, "-bcn") == 0)      c.bcn_loss = atof(val);
+        else if (strcmp(opt, "-slots") == 0)    c.slots = atoi(val);
+        else if (strcmp(opt, "-msgs") == 0)     c.msgs = atoi(val);
+        else err = -1;
+        if (err)
+        {
+            usage();
+            return 1;
+        }
+    }
+    if (i < argc || c.per < 0 || c.per >= 1 || c.bcn_loss < 0 || c.bcn_loss >= 1 || c.slots < 1 || c.msgs < 1)
+    {
+        usage();
+        return 1;
+    }
+
+    printf("SF%d/%.0fKHz: %d B per fragment, %.2f ms per full fragment frame, up to %d fragments\n",
+           c.phy.sf, c.phy.bw_khz, FRAG_DATA_MAX, lora_AirtimeUs(&c.phy, FRAG_FRAME_MAX) / 1000.0, FRAG_NUM_MAX);
+    printf("fragment loss %.0f%%, beacon loss %.0f%%, %d fragment(s) per superframe, %d messages per size\n\n",
+           c.per * 100, c.bcn_loss * 100, c.slots, c.msgs);
+    printf("%6s %5s | %22s %9s | %22s %9s | %7s\n", "", "", "selective (bitmap)", "", "whole message", "", "");
+    printf("%6s %5s | %7s %7s %6s %9s | %7s %7s %6s %9s | %7s\n", "size", "frags", "sframes", "frames", "fail",
+           "B/air-s", "sframes", "frames", "fail", "B/air-s", "gain");
+    for (i = 0; i < c.nsize; i++)
+    {
+        RESULT_T sel, whole;
+        double tp_sel, tp_whole;
+
+        sim_Selective(&c, c.size[i], &rng, &sel);
+        sim_Whole(&c, c.size[i], &rng, &whole);
+        bad += sel.bad;
+        tp_sel = c.size[i] / (sel.air_ms / 1000.0);
+        tp_whole = c.size[i] / (whole.air_ms / 1000.0);
+        printf("%6d %5d | %7.1f %7.1f %6d %9.0f | %7.1f %7.1f %6d %9.0f | %6.2fx\n", c.size[i],
+               (c.size[i] + FRAG_DATA_MAX - 1) / FRAG_DATA_MAX, sel.superframes, sel.frames, sel.fail, tp_sel,
+               whole.superframes, whole.frames, whole.fail, tp_whole, tp_sel / tp_whole);
+    }
+    printf("\nB/air-s: message bytes per second of fragment airtime; reassembly mismatches: %d\n", bad);
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,859 @@
+/*********************************************************************************************************
+*
+*   模块名称 : 多节点LoRa网络仿真
+*   文件名称 : lora_netsim.c
+*   版    本 : V1.0
+*   说    明 : 在PC上以1ms节拍运行N个从机的应用逻辑(与 bsp_task.c 中 Task_RecvfromLora /
+*             Task_SendToMaster 以及 bsp_tpc.c 的时间片调度一致)，所有节点共享一个信道模型：
+*               - 对数距离路径损耗 + 对数正态阴影衰落 + 逐包快衰落
+*               - 同扩频因子碰撞，信干比 >= 6dB 时发生捕获效应
+*               - 不同扩频因子准正交，干扰超出有用信号16dB时才造成丢包
+*               - 按数据手册公式计算空中时间，节点收发时半双工
+*             多个仿真任务(节点数 x 重复次数)分配到多个线程并行运行，输出吞吐量、时延分布和每节点能耗，
+*             用于在购买硬件前评估时隙方案可支持的节点规模。
+*
+*   编    译 : gcc -O2 -pthread -o lora_netsim lora_netsim.c -lm
+*   用    法 : ./lora_netsim -n 4,16,64,256 -frames 100 -runs 8
+*             ./lora_netsim -h 查看全部参数
+*
+*********************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "lora_phy.h"
+
+#define TICK_US             1000        /* 仿真节拍，与SysTick一致为1ms */
+#define LAT_BINS            (1 << 17)   /* 时延直方图，1ms一格，最长131s */
+#define MAX_NODE_LIST       16
+
+/* 固件中的时间常数，来自 bsp_task.c / bsp_rf.c / bsp_join.h。
+   SPI耗时取 sx1278_spi_bench 在SPI2 140.6KHz(36MHz/256)下的结果 */
+#define FW_RECV_ITV_MS      2           /* Task_RecvfromLora 运行间隔 */
+#define FW_RX_PROC_US       900         /* RxDone事件后 RFRxPoll 突发读出4字节广播包，芯片保持连续接收 */
+#define FW_SLOT_GUARD_MS    5           /* JOIN_SLOT_GUARD_MS，时隙从收到广播包的时刻算起，已扣除处理耗时 */
+#define FW_TX_STAGE_MS      3           /* RF_TX_STAGE_MS，时隙开始前生成数据帧并写入发射FIFO */
+#define FW_TX_STAGE_US      1900        /* RFM96_LoRaEntryTx + 写FIFO，之后芯片待机等时隙开始 */
+#define FW_TX_FIRE_US       120         /* RFTxFire 只写一次RegOpMode */
+#define FW_TX_POST_US       1400        /* TxDone事件后 RFM96_LoRaTxEnd + RFRxMode，不复位芯片 */
+
+#define UPLINK_LEN          6           /* SLVMSG_T 发送6字节 */
+#define BEACON_LEN          4           /* "$#ST" */
+
+/* 仿真参数 */
+typedef struct
+{
+    int    nodes[MAX_NODE_LIST];
+    int    node_cnt;
+    int    cells;           /* 相邻小区数，每个小区一个主机 */
+    int    cell_sf_step;    /* 相邻小区扩频因子递增步长，0表示同频同SF */
+    double cell_sep_m;      /* 小区主机之间的距离 */
+    int    frames;          /* 仿真的超帧数 */
+    int    runs;            /* 每种节点数重复次数 */
+    int    threads;
+    int    slot_ms;         /* 时隙长度 */
+    double radius_m;        /* 节点分布半径 */
+    double pl_exp;          /* 路径损耗指数 */
+    double shadow_db;       /* 阴影衰落标准差 */
+    double fade_db;         /* 逐包快衰落标准差 */
+    double tx_dbm;
+    int    ble_ms;          /* 蓝牙心率数据到达周期 */
+    uint64_t seed;
+    LORA_PHY_T phy;
+} SIM_CFG_T;
+
+/* 与 TPC_TASK 对应的任务状态 */
+typedef struct
+{
+    uint8_t  attrb;
+    uint8_t  Run;
+    uint16_t Timer;
+    uint16_t ItvTime;
+} SIM_TASK_T;
+
+/* 单个从机实例 */
+typedef struct
+{
+    int      cell;
+    int      slot;          /* 相当于 DEVID-1 */
+    int      sf;
+
+    /* 固件状态 */
+    uint8_t  MasterBstisRcv;
+    uint8_t  TxStaged;      /* s_ucTxStaged：数据帧已在发射FIFO中 */
+    uint8_t  TxLead;        /* s_ucTxLead */
+    uint8_t  BlEisReady;
+    SIM_TASK_T recv;
+    SIM_TASK_T send;
+
+    int64_t  busy_until;    /* 主循环被阻塞到此时刻 */
+    int64_t  deaf_from;     /* 射频不在接收状态的区间 */
+    int64_t  deaf_until;
+    int      irq_pending;   /* DIO0(RxDone)事件 */
+    int      irq_beacon;
+    int      rx_pending;    /* 接收队列中有数据包，等 Task_RecvfromLora 取走 */
+    int      rx_beacon;
+    int64_t  rx_time;       /* 数据包读入接收队列的时刻(PKT_BUF_T.time) */
+    int64_t  sample_time;   /* 当前心率数据产生的时刻 */
+    int64_t  next_ble;
+
+    /* 统计 */
+    int64_t  tx_us;
+    int64_t  stdby_us;
+    uint32_t tx_cnt;
+    uint32_t delivered;
+    uint32_t beacon_rx;
+    uint32_t other_rx;
+    uint32_t samples;
+    uint32_t superseded;
+} SIM_NODE_T;
+
+/* 空中的一次发射 */
+typedef struct
+{
+    int      src;
+    int      sf;
+    int      beacon;
+    int      done;
+    int64_t  start;
+    int64_t  end;
+    int64_t  sample_time;
+} SIM_TX_T;
+
+/* 单次仿真的结果 */
+typedef struct
+{
+    int      n;
+    int      run;
+    double   duration_s;
+    double   sf_ms;         /* 超帧长度 */
+    uint64_t tx_cnt;
+    uint64_t delivered;
+    uint64_t collided;
+    uint64_t weak;
+    uint64_t beacon_sent;
+    uint64_t beacon_rx;
+    uint64_t other_rx;
+    uint64_t samples;
+    uint64_t superseded;
+    double   avg_ma;        /* 每节点射频平均电流 */
+    uint32_t *lat_hist;
+} SIM_RESULT_T;
+
+/* 单次仿真的运行环境 */
+typedef struct
+{
+    const SIM_CFG_T *cfg;
+    int         n;          /* 每个小区节点数 */
+    int         total;      /* 节点总数 */
+    int         ends;       /* 节点 + 主机 */
+    SIM_NODE_T *node;
+    double     *pl;         /* ends x ends 路径损耗矩阵 */
+    SIM_TX_T   *tx;
+    int         tx_num;
+    int         tx_cap;
+    int64_t    *master_deaf_until;
+    uint64_t    rng;
+    SIM_RESULT_T *res;
+} SIM_RUN_T;
+
+static SIM_CFG_T s_tCfg;
+static SIM_RESULT_T *s_pResult;
+static int s_iJobNum;
+static int s_iJobNext;
+static pthread_mutex_t s_tJobLock = PTHREAD_MUTEX_INITIALIZER;
+
+static int cell_sf(const SIM_CFG_T *_cfg, int _cell)
+{
+    int sf = _cfg->phy.sf + _cell * _cfg->cell_sf_step;
+
+    while (sf > 12)
+    {
+        sf -= 6;
+    }
+    return sf;
+}
+
+static int64_t airtime_us(const SIM_CFG_T *_cfg, int _sf, int _len)
+{
+    LORA_PHY_T phy = _cfg->phy;
+
+    phy.sf = _sf;
+    return (int64_t)lora_AirtimeUs(&phy, _len);
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: sim_AddTx
+*   功能说明: 登记一次发射
+*********************************************************************************************************
+*/
+static void sim_AddTx(SIM_RUN_T *_r, int _src, int _sf, int _beacon, int64_t _start, int64_t _sample)
+{
+    SIM_TX_T *t;
+
+    if (_r->tx_num == _r->tx_cap)
+    {
+        _r->tx_cap = _r->tx_cap ? _r->tx_cap * 2 : 256;
+        _r->tx = realloc(_r->tx, _r->tx_cap * sizeof(SIM_TX_T));
+    }
+    t = &_r->tx[_r->tx_num++];
+    t->src = _src;
+    t->sf = _sf;
+    t->beacon = _beacon;
+    t->done = 0;
+    t->start = _start;
+    t->end = _start + airtime_us(_r->cfg, _sf, _beacon ? BEACON_LEN : UPLINK_LEN);
+    t->sample_time = _sample;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: sim_RxOk
+*   功能说明: 判断接收端 _rx 能否正确解调发射 _t
+*   返 回 值: 0 成功，1 信号低于灵敏度，2 被干扰，3 接收端不在接收状态
+*********************************************************************************************************
+*/
+static int sim_RxOk(SIM_RUN_T *_r, const SIM_TX_T *_t, int _rx, int _rx_sf)
+{
+    const SIM_CFG_T *cfg = _r->cfg;
+    double s, i;
+    int k;
+
+    if (_t->sf != _rx_sf)
+    {
+        return 1;
+    }
+    if (_rx < _r->total)
+    {
+        SIM_NODE_T *nd = &_r->node[_rx];
+
+        if (nd->deaf_from < _t->end && nd->deaf_until > _t->start)
+        {
+            return 3;
+        }
+    }
+    else if (_r->master_deaf_until[_rx - _r->total] > _t->start)
+    {
+        return 3;
+    }
+
+    s = cfg->tx_dbm - _r->pl[_t->src * _r->ends + _rx] + cfg->fade_db * lora_RandNormal(&_r->rng);
+    if (s < lora_SensitivityDbm(_t->sf, cfg->phy.bw_khz))
+    {
+        return 1;
+    }
+    for (k = 0; k < _r->tx_num; k++)
+    {
+        const SIM_TX_T *o = &_r->tx[k];
+
+        if (o == _t || o->start >= _t->end || o->end <= _t->start)
+        {
+            continue;
+        }
+        if (o->src == _rx)
+        {
+            return 3;
+        }
+        i = cfg->tx_dbm - _r->pl[o->src * _r->ends + _rx] + cfg->fade_db * lora_RandNormal(&_r->rng);
+        if (o->sf == _t->sf)
+        {
+            if (s - i < 6.0)    /* 同SF捕获门限 */
+            {
+                return 2;
+            }
+        }
+        else if (i - s > 16.0)  /* 不同SF的抑制比 */
+        {
+            return 2;
+        }
+    }
+    return 0;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: sim_Evaluate
+*   功能说明: 发射结束时计算所有接收端的结果
+*********************************************************************************************************
+*/
+static void sim_Evaluate(SIM_RUN_T *_r, SIM_TX_T *_t)
+{
+    SIM_RESULT_T *res = _r->res;
+    int j, ret;
+
+    for (j = 0; j < _r->total; j++)
+    {
+        SIM_NODE_T *nd = &_r->node[j];
+
+        if (j == _t->src)
+        {
+            continue;
+        }
+        if (sim_RxOk(_r, _t, j, nd->sf) == 0)
+        {
+            /* DIO0 拉高，后到的包覆盖先到的包 */
+            nd->irq_pending = 1;
+            nd->irq_beacon = _t->beacon;
+            if (_t->beacon)
+            {
+                nd->beacon_rx++;
+            }
+            else
+            {
+                nd->other_rx++;
+            }
+        }
+    }
+
+    if (!_t->beacon)
+    {
+        SIM_NODE_T *src = &_r->node[_t->src];
+        int m = _r->total + src->cell;
+
+        ret = sim_RxOk(_r, _t, m, cell_sf(_r->cfg, src->cell));
+        if (ret == 0)
+        {
+            int64_t lat = (_t->end - _t->sample_time) / 1000;
+
+            src->delivered++;
+            if (lat >= LAT_BINS)
+            {
+                lat = LAT_BINS - 1;
+            }
+            res->lat_hist[lat]++;
+        }
+        else if (ret == 2)
+        {
+            res->collided++;
+        }
+        else
+        {
+            res->weak++;
+        }
+    }
+    _t->done = 1;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: sim_NodeTick
+*   功能说明: 单个从机1ms节拍，对应 SysTick_ISR 中的 TPCRemarks 和主循环中的 TPCProcess
+*********************************************************************************************************
+*/
+static void sim_NodeTick(SIM_RUN_T *_r, int _id, int64_t _now)
+{
+    const SIM_CFG_T *cfg = _r->cfg;
+    SIM_NODE_T *nd = &_r->node[_id];
+    SIM_TASK_T *tk[2];
+    int i;
+
+    /* 蓝牙心率数据到达，相当于 Task_RecvfromUart 置位 BlEisReady */
+    if (_now >= nd->next_ble)
+    {
+        if (nd->BlEisReady)
+        {
+            nd->superseded++;
+        }
+        nd->samples++;
+        nd->BlEisReady = 1;
+        nd->sample_time = _now;
+        nd->next_ble += (int64_t)cfg->ble_ms * 1000;
+    }
+
+    /* TPCRemarks */
+    tk[0] = &nd->recv;
+    tk[1] = &nd->send;
+    for (i = 0; i < 2; i++)
+    {
+        if (tk[i]->attrb == 0 && tk[i]->Timer > 0)
+        {
+            if (--tk[i]->Timer == 0)
+            {
+                tk[i]->Timer = tk[i]->ItvTime;
+                tk[i]->Run = 1;
+            }
+        }
+    }
+
+    /* 主循环 */
+    if (_now < nd->busy_until)
+    {
+        return;
+    }
+    if (nd->irq_pending)    /* RFEventPoll：RxDone后立即读出数据包放入接收队列，后到的包覆盖先到的包 */
+    {
+        nd->irq_pending = 0;
+        nd->rx_pending = 1;
+        nd->rx_beacon = nd->irq_beacon;
+        nd->rx_time = _now;
+        nd->busy_until = _now + FW_RX_PROC_US;
+        return;
+    }
+
+    /* Task_RecvfromLora */
+    if (nd->recv.Run)
+    {
+        nd->recv.Run = 0;
+        if (nd->rx_pending)
+        {
+            nd->rx_pending = 0;
+            if (nd->rx_beacon && !nd->TxStaged)
+            {
+                /* 时隙按收到广播包的时刻计算(AgeAdjust)，提前 FW_TX_STAGE_MS 准备数据帧 */
+                int64_t delay = FW_SLOT_GUARD_MS + (int64_t)nd->slot * cfg->slot_ms - (_now - nd->rx_time) / 1000;
+
+                if (delay < 1)
+                {
+                    delay = 1;
+                }
+                nd->TxLead = (delay > FW_TX_STAGE_MS) ? FW_TX_STAGE_MS : 0;
+                nd->MasterBstisRcv = 1;
+                nd->send.attrb = 0;
+                nd->send.Timer = (uint16_t)(delay - nd->TxLead);
+            }
+        }
+    }
+
+    /* Task_SendToMaster：先写入发射FIFO，时隙开始时只写一次RegOpMode，TxDone由DIO0事件处理 */
+    if (nd->send.Run)
+    {
+        nd->send.Run = 0;
+        if (nd->TxStaged)
+        {
+            int64_t start = _now + FW_TX_FIRE_US;
+            int64_t air = airtime_us(cfg, nd->sf, UPLINK_LEN);
+            int64_t end = start + air;
+
+            sim_AddTx(_r, _id, nd->sf, 0, start, nd->sample_time);
+            nd->tx_cnt++;
+            nd->tx_us += air;
+            nd->stdby_us += FW_TX_FIRE_US + FW_TX_POST_US;
+            nd->deaf_until = end + FW_TX_POST_US;
+            nd->TxStaged = 0;
+            nd->send.attrb = 1;
+        }
+        else if (nd->MasterBstisRcv && nd->BlEisReady)
+        {
+            uint16_t wait = nd->TxLead ? nd->TxLead : 1;
+
+            nd->busy_until = _now + FW_TX_STAGE_US;
+            nd->deaf_from = _now;
+            nd->deaf_until = _now + wait * 1000 + FW_TX_FIRE_US;  /* 发射前芯片在待机，不接收 */
+            nd->stdby_us += (int64_t)wait * 1000;
+            nd->TxStaged = 1;
+            nd->send.Timer = wait;
+            nd->MasterBstisRcv = 0;
+            nd->BlEisReady = 0;
+        }
+        else
+        {
+            nd->send.attrb = 1;
+            nd->MasterBstisRcv = 0;
+        }
+    }
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: sim_Run
+*   功能说明: 执行一次完整的仿真
+*********************************************************************************************************
+*/
+static void sim_Run(SIM_RESULT_T *_res)
+{
+    const SIM_CFG_T *cfg = &s_tCfg;
+    SIM_RUN_T r;
+    double *x, *y, *shadow;
+    int64_t now, end_time, sf_us, keep_us;
+    int64_t *next_beacon;
+    int i, j, k, c;
+    double total_ma = 0;
+
+    memset(&r, 0, sizeof(r));
+    r.cfg = cfg;
+    r.res = _res;
+    r.n = _res->n;
+    r.total = r.n * cfg->cells;
+    r.ends = r.total + cfg->cells;
+    r.rng = cfg->seed ^ ((uint64_t)_res->n << 32) ^ ((uint64_t)_res->run * 0x9E3779B97F4A7C15ULL);
+    if (r.rng == 0)
+    {
+        r.rng = 1;
+    }
+    r.node = calloc(r.total, sizeof(SIM_NODE_T));
+    r.pl = malloc(sizeof(double) * r.ends * r.ends);
+    r.master_deaf_until = calloc(cfg->cells, sizeof(int64_t));
+    next_beacon = calloc(cfg->cells, sizeof(int64_t));
+    x = malloc(sizeof(double) * r.ends);
+    y = malloc(sizeof(double) * r.ends);
+    shadow = malloc(sizeof(double) * r.ends);
+    _res->lat_hist = calloc(LAT_BINS, sizeof(uint32_t));
+
+    /* 超帧 = 广播时隙 + N 个上行时隙 */
+    sf_us = (int64_t)(r.n + 1) * cfg->slot_ms * 1000;
+    _res->sf_ms = sf_us / 1000.0;
+
+    /* 节点布局：主机在小区中心，从机在半径内均匀分布 */
+    for (c = 0; c < cfg->cells; c++)
+    {
+        x[r.total + c] = c * cfg->cell_sep_m;
+        y[r.total + c] = 0;
+        next_beacon[c] = (int64_t)(lora_RandUniform(&r.rng) * sf_us / 1000) * 1000;
+    }
+    for (i = 0; i < r.total; i++)
+    {
+        double rad = cfg->radius_m * sqrt(lora_RandUniform(&r.rng));
+        double ang = 6.283185307179586 * lora_RandUniform(&r.rng);
+        SIM_NODE_T *nd = &r.node[i];
+
+        nd->cell = i / r.n;
+        nd->slot = i % r.n;
+        nd->sf = cell_sf(cfg, nd->cell);
+        x[i] = x[r.total + nd->cell] + rad * cos(ang);
+        y[i] = rad * sin(ang);
+        nd->recv.ItvTime = FW_RECV_ITV_MS;
+        nd->recv.Timer = 1 + (uint16_t)(lora_Rand(&r.rng) % FW_RECV_ITV_MS);
+        nd->send.attrb = 1;
+        nd->next_ble = (int64_t)(lora_RandUniform(&r.rng) * cfg->ble_ms) * 1000;
+        nd->deaf_from = nd->deaf_until = -1;
+    }
+    for (i = 0; i < r.ends; i++)
+    {
+        shadow[i] = cfg->shadow_db * lora_RandNormal(&r.rng);
+    }
+    for (i = 0; i < r.ends; i++)
+    {
+        for (j = 0; j < r.ends; j++)
+        {
+            double d = hypot(x[i] - x[j], y[i] - y[j]);
+            /* 阴影衰落由两端各贡献一半，保证链路对称 */
+            r.pl[i * r.ends + j] = lora_PathLossDb(d, cfg->pl_exp) + 0.5 * (shadow[i] + shadow[j]);
+        }
+    }
+
+    /* 发射记录只需保留到不再可能与新的发射重叠为止 */
+    keep_us = 2 * airtime_us(cfg, 12, UPLINK_LEN) + FW_TX_STAGE_MS * 1000;
+    end_time = sf_us * (cfg->frames + 1);
+    for (now = 0; now < end_time; now += TICK_US)
+    {
+        /* 主机发送广播包 */
+        for (c = 0; c < cfg->cells; c++)
+        {
+            if (now >= next_beacon[c])
+            {
+                sim_AddTx(&r, r.total + c, cell_sf(cfg, c), 1, now, now);
+                r.master_deaf_until[c] = r.tx[r.tx_num - 1].end;
+                next_beacon[c] += sf_us;
+                _res->beacon_sent++;
+            }
+        }
+
+        /* 发射结束，计算接收结果 */
+        for (k = 0; k < r.tx_num; k++)
+        {
+            if (!r.tx[k].done && r.tx[k].end <= now)
+            {
+                sim_Evaluate(&r, &r.tx[k]);
+            }
+        }
+
+        /* 删除已结束且不会再与其他发射重叠的记录 */
+        for (k = 0, j = 0; k < r.tx_num; k++)
+        {
+            if (!(r.tx[k].done && r.tx[k].end + keep_us < now))
+            {
+                r.tx[j++] = r.tx[k];
+            }
+        }
+        r.tx_num = j;
+
+        for (i = 0; i < r.total; i++)
+        {
+            sim_NodeTick(&r, i, now);
+        }
+    }
+
+    _res->duration_s = end_time / 1e6;
+    for (i = 0; i < r.total; i++)
+    {
+        SIM_NODE_T *nd = &r.node[i];
+        double rx_us = (double)end_time - nd->tx_us - nd->stdby_us;
+
+        _res->tx_cnt += nd->tx_cnt;
+        _res->delivered += nd->delivered;
+        _res->beacon_rx += nd->beacon_rx;
+        _res->other_rx += nd->other_rx;
+        _res->samples += nd->samples;
+        _res->superseded += nd->superseded;
+        total_ma += (nd->tx_us * lora_TxCurrentMa(cfg->tx_dbm) + nd->stdby_us * LORA_I_STDBY_MA
+                     + rx_us * LORA_I_RX_MA) / end_time;
+    }
+    _res->avg_ma = total_ma / r.total;
+
+    free(r.node);
+    free(r.pl);
+    free(r.tx);
+    free(r.master_deaf_until);
+    free(next_beacon);
+    free(x);
+    free(y);
+    free(shadow);
+}
+
+static void *sim_Worker(void *_arg)
+{
+    (void)_arg;
+    for (;;)
+    {
+        int job;
+
+        pthread_mutex_lock(&s_tJobLock);
+        job = s_iJobNext++;
+        pthread_mutex_unlock(&s_tJobLock);
+        if (job >= s_iJobNum)
+        {
+            break;
+        }
+        sim_Run(&s_pResult[job]);
+    }
+    return NULL;
+}
+
+static double hist_Percentile(const uint64_t *_hist, uint64_t _total, double _p)
+{
+    uint64_t target = (uint64_t)(_total * _p);
+    uint64_t acc = 0;
+    int i;
+
+    if (_total == 0)
+    {
+        return 0;
+    }
+    for (i = 0; i < LAT_BINS; i++)
+    {
+        acc += _hist[i];
+        if (acc > target)
+        {
+            return i;
+        }
+    }
+    return LAT_BINS - 1;
+}
+
+static void sim_Report(void)
+{
+    const SIM_CFG_T *cfg = &s_tCfg;
+    uint64_t *hist = malloc(sizeof(uint64_t) * LAT_BINS);
+    int a, b, i;
+
+    printf("PHY: SF%d BW%.1fkHz CR4/%d preamble %d, uplink %d B = %.2f ms, beacon %d B = %.2f ms\n",
+           cfg->phy.sf, cfg->phy.bw_khz, cfg->phy.cr + 4, cfg->phy.preamble,
+           UPLINK_LEN, lora_AirtimeUs(&cfg->phy, UPLINK_LEN) / 1000.0,
+           BEACON_LEN, lora_AirtimeUs(&cfg->phy, BEACON_LEN) / 1000.0);
+    printf("slot %d ms, %d cell(s), radius %.0f m, Ptx %.0f dBm, BLE period %d ms, %d superframes x %d runs\n",
+           cfg->slot_ms, cfg->cells, cfg->radius_m, cfg->tx_dbm, cfg->ble_ms, cfg->frames, cfg->runs);
+    if (FW_TX_FIRE_US + lora_AirtimeUs(&cfg->phy, UPLINK_LEN) > cfg->slot_ms * 1000.0)
+    {
+        printf("! uplink airtime does not fit into one slot\n");
+    }
+    printf("\n");
+    printf("%6s %10s %8s %8s %8s %9s %9s %8s %8s %8s %8s %9s %9s %10s\n",
+           "nodes", "superframe", "PDR%", "data%", "bcn%", "pkt/s", "B/s", "coll", "weak",
+           "lat50", "lat90", "lat99", "I_avg mA", "mJ/pkt");
+
+    for (a = 0; a < cfg->node_cnt; a++)
+    {
+        uint64_t txc = 0, samples = 0, delivered = 0, coll = 0, weak = 0, bsent = 0, brx = 0, lat_n = 0;
+        double dur = 0, ma = 0, sfms = 0;
+        int n = cfg->nodes[a];
+
+        memset(hist, 0, sizeof(uint64_t) * LAT_BINS);
+        for (b = 0; b < cfg->runs; b++)
+        {
+            SIM_RESULT_T *res = &s_pResult[a * cfg->runs + b];
+
+            txc += res->tx_cnt;
+            samples += res->samples;
+            delivered += res->delivered;
+            coll += res->collided;
+            weak += res->weak;
+            bsent += res->beacon_sent;
+            brx += res->beacon_rx;
+            dur += res->duration_s;
+            ma += res->avg_ma;
+            sfms = res->sf_ms;
+            for (i = 0; i < LAT_BINS; i++)
+            {
+                hist[i] += res->lat_hist[i];
+                lat_n += res->lat_hist[i];
+            }
+        }
+        ma /= cfg->runs;
+        printf("%6d %8.0fms %8.1f %8.1f %8.1f %9.2f %9.1f %8llu %8llu %8.0f %8.0f %9.0f %9.2f %10.2f\n",
+               n, sfms,
+               txc ? 100.0 * delivered / txc : 0.0,
+               samples ? 100.0 * delivered / samples : 0.0,
+               bsent ? 100.0 * brx / ((double)bsent * n) : 0.0,
+               delivered / dur * cfg->cells,
+               delivered * UPLINK_LEN / dur * cfg->cells,
+               (unsigned long long)coll, (unsigned long long)weak,
+               hist_Percentile(hist, lat_n, 0.50), hist_Percentile(hist, lat_n, 0.90),
+               hist_Percentile(hist, lat_n, 0.99),
+               ma,
+               delivered ? ma * LORA_SUPPLY_V * (dur / cfg->runs) * n * cfg->cells / (delivered / (double)cfg->runs) : 0.0);
+        if ((n - 1) * cfg->slot_ms + FW_SLOT_GUARD_MS > 0xFFFF)
+        {
+            printf("       ! slot offset of the last node overflows the 16-bit TPC_TASK.Timer\n");
+        }
+    }
+    printf("\nPDR: delivered/transmitted; data: delivered/BLE samples (the rest were overwritten in SLVMSG_T)\n"
+           "latency in ms from arrival of the delivered sample to end of its uplink;"
+           " I_avg is radio-only current per node\n");
+    free(hist);
+}
+
+static void sim_Usage(void)
+{
+    printf("usage: lora_netsim [options]\n"
+           "  -n LIST       node counts per cell, comma separated (4,16,64,256)\n"
+           "  -frames N     superframes to simulate (100)\n"
+           "  -runs N       independent runs per node count (4)\n"
+           "  -threads N    worker threads, 0 = all cores (0)\n"
+           "  -slot MS      TDMA slot length (100)\n"
+           "  -sf N         spreading factor (9)\n"
+           "  -bw KHZ       bandwidth (500)\n"
+           "  -cr N         coding rate 1..4 = 4/5..4/8 (4)\n"
+           "  -radius M     node placement radius (1000)\n"
+           "  -ple X        path loss exponent (2.9)\n"
+           "  -shadow DB    log-normal shadowing sigma (6)\n"
+           "  -fade DB      per-packet fading sigma (2)\n"
+           "  -power DBM    TX power (20)\n"
+           "  -ble MS       BLE sample period (1000)\n"
+           "  -cells N      co-located cells sharing the channel (1)\n"
+           "  -cellsf N     SF step between neighbouring cells, 0 = same SF (1)\n"
+           "  -cellsep M    distance between cell masters (500)\n"
+           "  -seed N       random seed (1)\n");
+}
+
+int main(int argc, char **argv)
+{
+    SIM_CFG_T *cfg = &s_tCfg;
+    pthread_t *tid;
+    int i, a, b;
+
+    cfg->node_cnt = 0;
+    cfg->cells = 1;
+    cfg->cell_sf_step = 1;
+    cfg->cell_sep_m = 500;
+    cfg->frames = 100;
+    cfg->runs = 4;
+    cfg->threads = 0;
+    cfg->slot_ms = 100;
+    cfg->radius_m = 1000;
+    cfg->pl_exp = 2.9;
+    cfg->shadow_db = 6;
+    cfg->fade_db = 2;
+    cfg->tx_dbm = 20;
+    cfg->ble_ms = 1000;
+    cfg->seed = 1;
+    cfg->phy = g_tPhyDefault;
+
+    for (i = 1; i < argc; i++)
+    {
+        const char *opt = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(opt, "-h") == 0 || val == NULL)
+        {
+            sim_Usage();
+            return strcmp(opt, "-h") == 0 ? 0 : 1;
+        }
+        i++;
+        if (strcmp(opt, "-n") == 0)
+        {
+            char *s = strdup(val), *tok;
+
+            for (tok = strtok(s, ","); tok && cfg->node_cnt < MAX_NODE_LIST; tok = strtok(NULL, ","))
+            {
+                cfg->nodes[cfg->node_cnt++] = atoi(tok);
+            }
+            free(s);
+        }
+        else if (strcmp(opt, "-frames") == 0)  cfg->frames = atoi(val);
+        else if (strcmp(opt, "-runs") == 0)    cfg->runs = atoi(val);
+        else if (strcmp(opt, "-threads") == 0) cfg->threads = atoi(val);
+        else if (strcmp(opt, "-slot") == 0)    cfg->slot_ms = atoi(val);
+        else if (strcmp(opt, "-sf") == 0)      cfg->phy.sf = atoi(val);
+        else if (strcmp(opt, "-bw") == 0)      cfg->phy.bw_khz = atof(val);
+        else if (strcmp(opt, "-cr") == 0)      cfg->phy.cr = atoi(val);
+        else if (strcmp(opt, "-radius") == 0)  cfg->radius_m = atof(val);
+        else if (strcmp(opt, "-ple") == 0)     cfg->pl_exp = atof(val);
+        else if (strcmp(opt, "-shadow") == 0)  cfg->shadow_db = atof(val);
+        else if (strcmp(opt, "-fade") == 0)    cfg->fade_db = atof(val);
+        else if (strcmp(opt, "-power") == 0)   cfg->tx_dbm = atof(val);
+        else if (strcmp(opt, "-ble") == 0)     cfg->ble_ms = atoi(val);
+        else if (strcmp(opt, "-cells") == 0)   cfg->cells = atoi(val);
+        else if (strcmp(opt, "-cellsf") == 0)  cfg->cell_sf_step = atoi(val);
+        else if (strcmp(opt, "-cellsep") == 0) cfg->cell_sep_m = atof(val);
+        else if (strcmp(opt, "-seed") == 0)    cfg->seed = strtoull(val, NULL, 0);
+        else
+        {
+            sim_Usage();
+            return 1;
+        }
+    }
+    if (cfg->node_cnt == 0)
+    {
+        cfg->nodes[0] = 4;
+        cfg->nodes[1] = 16;
+        cfg->nodes[2] = 64;
+        cfg->nodes[3] = 256;
+        cfg->node_cnt = 4;
+    }
+    if (cfg->cells < 1 || cfg->runs < 1 || cfg->frames < 1 || cfg->phy.sf < 7 || cfg->phy.sf > 12)
+    {
+        sim_Usage();
+        return 1;
+    }
+    if (cfg->threads <= 0)
+    {
+        cfg->threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        if (cfg->threads <= 0)
+        {
+            cfg->threads = 1;
+        }
+    }
+
+    s_iJobNum = cfg->node_cnt * cfg->runs;
+    s_pResult = calloc(s_iJobNum, sizeof(SIM_RESULT_T));
+    for (a = 0; a < cfg->node_cnt; a++)
+    {
+        for (b = 0; b < cfg->runs; b++)
+        {
+            s_pResult[a * cfg->runs + b].n = cfg->nodes[a];
+            s_pResult[a * cfg->runs + b].run = b;
+        }
+    }
+
+    tid = malloc(sizeof(pthread_t) * cfg->threads);
+    for (i = 0; i < cfg->threads; i++)
+    {
+        pthread_create(&tid[i], NULL, sim_Worker, NULL);
+    }
+    for (i = 0; i < cfg->threads; i++)
+    {
+        pthread_join(tid[i], NULL);
+    }
+
+    sim_Report();
+
+    for (i = 0; i < s_iJobNum; i++)
+    {
+        free(s_pResult[i].lat_hist);
+    }
+    free(s_pResult);
+    free(tid);
+    return 0;
+}
@@ -0,0 +1,154 @@
+/*********************************************************************************************************
+*
+*   模块名称 : 主机端LoRa物理层模型
+*   文件名称 : lora_phy.h
+*   版    本 : V1.0
+*   说    明 : 供Tools目录下的主机仿真/基准程序共用，提供SX1278空中时间、灵敏度、路径损耗和射频电流模型。
+*             仅在PC上编译使用，不参与固件工程。参数默认值与 bsp_sx1276-LoRa.c 中的配置保持一致：
+*             RF_PROF_DEFAULT 档 SF9, 500KHz, CR 4/8, CRC_EN = 0, 前导码12, 显式包头。
+*
+*********************************************************************************************************/
+#ifndef __LORA_PHY_H__
+#define __LORA_PHY_H__
+
+#include <stdint.h>
+#include <math.h>
+
+/* 物理层参数 */
+typedef struct
+{
+    int    sf;          /* 扩频因子 7~12 */
+    double bw_khz;      /* 带宽，单位KHz */
+    int    cr;          /* 编码率 1~4 对应 4/5~4/8 */
+    int    crc;         /* 1: 打开CRC */
+    int    preamble;    /* 前导码长度(符号) */
+    int    implicit;    /* 1: 隐式包头 */
+} LORA_PHY_T;
+
+/* 与固件 RFM96_Config() 一致的缺省参数 */
+static const LORA_PHY_T g_tPhyDefault = { 9, 500.0, 4, 0, 12, 0 };
+
+/*
+*********************************************************************************************************
+*   函 数 名: lora_SymbolUs
+*   功能说明: 计算一个符号的持续时间
+*   形    参: _phy : 物理层参数
+*   返 回 值: 符号时间，单位us
+*********************************************************************************************************
+*/
+static inline double lora_SymbolUs(const LORA_PHY_T *_phy)
+{
+    return (double)(1 << _phy->sf) * 1000.0 / _phy->bw_khz;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: lora_AirtimeUs
+*   功能说明: 按SX1276/78数据手册4.1.1.6节公式计算数据包空中时间
+*   形    参: _phy : 物理层参数
+*             _len : 负载字节数
+*   返 回 值: 空中时间，单位us
+*********************************************************************************************************
+*/
+static inline double lora_AirtimeUs(const LORA_PHY_T *_phy, int _len)
+{
+    double tsym = lora_SymbolUs(_phy);
+    int de = (tsym > 16000.0) ? 1 : 0;      /* 符号时间大于16ms时必须打开LowDataRateOptimize */
+    double num = 8.0 * _len - 4.0 * _phy->sf + 28 + 16 * _phy->crc - 20 * _phy->implicit;
+    double den = 4.0 * (_phy->sf - 2 * de);
+    double nsym = ceil(num / den) * (_phy->cr + 4);
+
+    if (nsym < 0)
+    {
+        nsym = 0;
+    }
+    return (_phy->preamble + 4.25) * tsym + (8 + nsym) * tsym;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: lora_SensitivityDbm
+*   功能说明: 接收灵敏度，125KHz下取数据手册典型值，其他带宽按10log10(BW/125)折算
+*   形    参: _sf, _bw_khz
+*   返 回 值: 灵敏度，单位dBm
+*********************************************************************************************************
+*/
+static inline double lora_SensitivityDbm(int _sf, double _bw_khz)
+{
+    static const double s_sens125[6] = { -123.0, -126.0, -129.0, -132.0, -134.5, -137.0 };
+
+    if (_sf < 7) _sf = 7;
+    if (_sf > 12) _sf = 12;
+    return s_sens125[_sf - 7] + 10.0 * log10(_bw_khz / 125.0);
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: lora_PathLossDb
+*   功能说明: 对数距离路径损耗模型，434MHz下1m参考损耗约25dB
+*   形    参: _dist_m : 距离，单位m
+*             _exp    : 路径损耗指数
+*   返 回 值: 路径损耗，单位dB(不含阴影衰落)
+*********************************************************************************************************
+*/
+static inline double lora_PathLossDb(double _dist_m, double _exp)
+{
+    if (_dist_m < 1.0)
+    {
+        _dist_m = 1.0;
+    }
+    return 25.2 + 10.0 * _exp * log10(_dist_m);
+}
+
+/* SX1278典型电流(3.3V)，单位mA，取自数据手册2.5节 */
+#define LORA_I_SLEEP_MA     0.0002
+#define LORA_I_STDBY_MA     1.6
+#define LORA_I_RX_MA        11.5
+#define LORA_SUPPLY_V       3.3
+
+/*
+*********************************************************************************************************
+*   函 数 名: lora_TxCurrentMa
+*   功能说明: 发射电流，PA_BOOST输出
+*   形    参: _dbm : 发射功率
+*   返 回 值: 电流，单位mA
+*********************************************************************************************************
+*/
+static inline double lora_TxCurrentMa(double _dbm)
+{
+    if (_dbm >= 20.0) return 120.0;
+    if (_dbm >= 17.0) return 87.0;
+    if (_dbm >= 13.0) return 44.0;
+    if (_dbm >= 7.0)  return 29.0;
+    return 20.0;
+}
+
+/* xorshift64* 伪随机数，保证每次仿真可复现 */
+static inline uint64_t lora_Rand(uint64_t *_s)
+{
+    uint64_t x = *_s;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *_s = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+static inline double lora_RandUniform(uint64_t *_s)
+{
+    return (lora_Rand(_s) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static inline double lora_RandNormal(uint64_t *_s)
+{
+    double u1 = lora_RandUniform(_s);
+    double u2 = lora_RandUniform(_s);
+
+    if (u1 < 1e-12)
+    {
+        u1 = 1e-12;
+    }
+    return sqrt(-2.0 * log(u1)) * cos(6.283185307179586 * u2);
+}
+
+#endif
@@ -0,0 +1,234 @@
+/*********************************************************************************************************
+*
+*   模块名称 : 中继与SF12直连对比仿真
+*   文件名称 : lora_relay_sim.c
+*   版    本 : V1.0
+*   说    明 : 远端节点到主机距离为D，中继节点位于两者连线上 D x frac 处。对每个距离比较两种方案：
+*               - 直连：远端节点改用慢速配置(缺省SF12/125KHz)直接发给主机
+*               - 中继：远端节点以网络缺省速率(SF9/500KHz)发给中继，中继按 bsp_relay.c 的帧格式
+*                 把 agg 个远端节点的数据帧打包，在中继时隙转发给主机
+*             链路模型与 lora_netsim.c 相同：对数距离路径损耗 + 每次布设的对数正态阴影衰落 + 逐包快衰落。
+*             输出每个距离的送达率、每个送达数据包占用的信道时间，以及远端节点和全网的射频能耗。
+*             中继节点本来就常开接收，其接收能耗只计收包的空中时间。
+*
+*   编    译 : gcc -O2 -o lora_relay_sim lora_relay_sim.c -lm
+*   用    法 : ./lora_relay_sim [-d 2000,4000,6000,8000,10000] [-frac 0.5] [-exp 3.0] [-len 6]
+*                               [-direct 12,125] [-hop 9,500] [-agg 1] [-power 20]
+*
+*********************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lora_phy.h"
+
+#define MAX_DIST        32
+#define RELAY_HDR_LEN   4           /* 'R' devID n ... '%' */
+#define RELAY_WRAP_LEN  2           /* '^' seq */
+
+typedef struct
+{
+    double dist[MAX_DIST];
+    int    ndist;
+    double frac;
+    double pl_exp;
+    double shadow_db;
+    double fade_db;
+    double tx_dbm;
+    int    len;
+    int    agg;
+    int    trials;
+    int    packets;
+    LORA_PHY_T direct;
+    LORA_PHY_T hop;
+} CFG_T;
+
+typedef struct
+{
+    double pdr;
+    double air_ms;          /* 每个送达数据包占用的信道时间 */
+    double node_mj;         /* 远端节点每个送达数据包的射频能耗 */
+    double total_mj;        /* 远端节点 + 中继节点 */
+} RESULT_T;
+
+/* 一跳是否收到：发射功率 - 路径损耗 - 阴影 + 快衰落 >= 灵敏度 */
+static int link_Ok(const CFG_T *_c, const LORA_PHY_T *_phy, double _pl, uint64_t *_rng)
+{
+    double s = _c->tx_dbm - _pl + _c->fade_db * lora_RandNormal(_rng);
+
+    return s >= lora_SensitivityDbm(_phy->sf, _phy->bw_khz);
+}
+
+static double energy_Mj(double _us, double _ma)
+{
+    return _us * 1e-6 * _ma * LORA_SUPPLY_V;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: sim_Distance
+*   功能说明: 在距离 _d 上仿真 trials 次布设，每次布设发送 packets 个数据包
+*********************************************************************************************************
+*/
+static void sim_Distance(const CFG_T *_c, double _d, uint64_t *_rng, RESULT_T *_direct, RESULT_T *_relay)
+{
+    double t_direct = lora_AirtimeUs(&_c->direct, _c->len);
+    double t_hop1 = lora_AirtimeUs(&_c->hop, _c->len + RELAY_WRAP_LEN);
+    double t_hop2 = lora_AirtimeUs(&_c->hop, RELAY_HDR_LEN + _c->agg * (1 + _c->len + RELAY_WRAP_LEN)) / _c->agg;
+    double i_tx = lora_TxCurrentMa(_c->tx_dbm);
+    long sent = 0, ok_direct = 0, ok_relay = 0, heard_relay = 0;
+    int t, p;
+
+    for (t = 0; t < _c->trials; t++)
+    {
+        double pl_d = lora_PathLossDb(_d, _c->pl_exp) + _c->shadow_db * lora_RandNormal(_rng);
+        double pl_1 = lora_PathLossDb(_d * _c->frac, _c->pl_exp) + _c->shadow_db * lora_RandNormal(_rng);
+        double pl_2 = lora_PathLossDb(_d * (1.0 - _c->frac), _c->pl_exp) + _c->shadow_db * lora_RandNormal(_rng);
+
+        for (p = 0; p < _c->packets; p++)
+        {
+            sent++;
+            ok_direct += link_Ok(_c, &_c->direct, pl_d, _rng);
+            if (link_Ok(_c, &_c->hop, pl_1, _rng))
+            {
+                heard_relay++;
+                ok_relay += link_Ok(_c, &_c->hop, pl_2, _rng);
+            }
+        }
+    }
+
+    /* 直连：每包发射一次 */
+    _direct->pdr = (double)ok_direct / sent;
+    _direct->node_mj = ok_direct ? energy_Mj(t_direct, i_tx) * sent / ok_direct : 0;
+    _direct->total_mj = _direct->node_mj;
+    _direct->air_ms = ok_direct ? t_direct / 1000.0 * sent / ok_direct : 0;
+
+    /* 中继：远端节点每包发射一次，中继收到的包按 agg 打包后转发 */
+    _relay->pdr = (double)ok_relay / sent;
+    if (ok_relay)
+    {
+        double node = energy_Mj(t_hop1, i_tx) * sent;
+        double relay = energy_Mj(t_hop1, LORA_I_RX_MA) * heard_relay + energy_Mj(t_hop2, i_tx) * heard_relay;
+
+        _relay->node_mj = node / ok_relay;
+        _relay->total_mj = (node + relay) / ok_relay;
+        _relay->air_ms = (t_hop1 * sent + t_hop2 * heard_relay) / 1000.0 / ok_relay;
+    }
+    else
+    {
+        _relay->node_mj = _relay->total_mj = _relay->air_ms = 0;
+    }
+}
+
+static int parse_Phy(const char *_s, LORA_PHY_T *_phy)
+{
+    *_phy = g_tPhyDefault;
+    if (sscanf(_s, "%d,%lf", &_phy->sf, &_phy->bw_khz) != 2 || _phy->sf < 7 || _phy->sf > 12 || _phy->bw_khz <= 0)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+static int parse_List(const char *_s, CFG_T *_c)
+{
+    char buf[256], *tok;
+
+    strncpy(buf, _s, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = 0;
+    _c->ndist = 0;
+    for (tok = strtok(buf, ","); tok && _c->ndist < MAX_DIST; tok = strtok(NULL, ","))
+    {
+        _c->dist[_c->ndist++] = atof(tok);
+    }
+    return _c->ndist > 0 ? 0 : -1;
+}
+
+static void usage(void)
+{
+    printf("usage: lora_relay_sim [options]\n"
+           "  -d LIST       node-to-master distances in m (2000,4000,6000,8000,10000)\n"
+           "  -frac F       relay position as a fraction of the distance (0.5)\n"
+           "  -exp E        path loss exponent (3.0)\n"
+           "  -shadow DB    log-normal shadowing sigma per link (6)\n"
+           "  -fade DB      per-packet fading sigma (2)\n"
+           "  -power DBM    TX power, all nodes (20)\n"
+           "  -len N        uplink frame length (6)\n"
+           "  -direct SF,BW slow direct profile (12,125)\n"
+           "  -hop SF,BW    relay hop profile (9,500 = firmware default)\n"
+           "  -agg K        far-node frames per relay frame (1)\n"
+           "  -trials N     placements per distance (2000)\n"
+           "  -packets N    packets per placement (50)\n");
+}
+
+int main(int argc, char **argv)
+{
+    CFG_T c;
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    int i;
+
+    memset(&c, 0, sizeof(c));
+    parse_List("2000,4000,6000,8000,10000", &c);
+    c.frac = 0.5;
+    c.pl_exp = 3.0;
+    c.shadow_db = 6;
+    c.fade_db = 2;
+    c.tx_dbm = 20;
+    c.len = 6;
+    c.agg = 1;
+    c.trials = 2000;
+    c.packets = 50;
+    parse_Phy("12,125", &c.direct);
+    c.hop = g_tPhyDefault;
+
+    for (i = 1; i + 1 < argc; i += 2)
+    {
+        const char *opt = argv[i], *val = argv[i + 1];
+        int err = 0;
+
+        if (strcmp(opt, "-d") == 0)             err = parse_List(val, &c);
+        else if (strcmp(opt, "-frac") == 0)     c.frac = atof(val);
+        else if (strcmp(opt, "-exp") == 0)      c.pl_exp = atof(val);
+        else if (strcmp(opt, "-shadow") == 0)   c.shadow_db = atof(val);
+        else if (strcmp(opt, "-fade") == 0)     c.fade_db = atof(val);
+        else if (strcmp(opt, "-power") == 0)    c.tx_dbm = atof(val);
+        else if (strcmp(opt, "-len") == 0)      c.len = atoi(val);
+        else if (strcmp(opt, "-direct") == 0)   err = parse_Phy(val, &c.direct);
+        else if (strcmp(opt, "-hop") == 0)      err = parse_Phy(val, &c.hop);
+        else if (strcmp(opt, "-agg") == 0)      c.agg = atoi(val);
+        else if (strcmp(opt, "-trials") == 0)   c.trials = atoi(val);
+        else if (strcmp(opt, "-packets") == 0)  c.packets = atoi(val);
+        else err = -1;
+        if (err)
+        {
+            usage();
+            return 1;
+        }
+    }
+    if (i < argc || c.frac <= 0 || c.frac >= 1 || c.len < 1 || c.agg < 1 || c.trials < 1 || c.packets < 1)
+    {
+        usage();
+        return 1;
+    }
+
+    printf("direct SF%d/%.0fKHz: %.1f ms per %d B frame, sensitivity %.1f dBm\n", c.direct.sf, c.direct.bw_khz,
+           lora_AirtimeUs(&c.direct, c.len) / 1000.0, c.len, lora_SensitivityDbm(c.direct.sf, c.direct.bw_khz));
+    printf("relay  SF%d/%.0fKHz: hop1 %.1f ms, hop2 %.1f ms for %d frame(s), sensitivity %.1f dBm\n",
+           c.hop.sf, c.hop.bw_khz, lora_AirtimeUs(&c.hop, c.len + RELAY_WRAP_LEN) / 1000.0,
+           lora_AirtimeUs(&c.hop, RELAY_HDR_LEN + c.agg * (1 + c.len + RELAY_WRAP_LEN)) / 1000.0, c.agg,
+           lora_SensitivityDbm(c.hop.sf, c.hop.bw_khz));
+    printf("path loss exp %.1f, shadowing %.0f dB, fading %.0f dB, %.0f dBm, relay at %.0f%% of distance\n\n",
+           c.pl_exp, c.shadow_db, c.fade_db, c.tx_dbm, c.frac * 100);
+    printf("%8s | %7s %9s %9s | %7s %9s %9s %9s\n", "", "direct", "", "", "relay", "", "", "");
+    printf("%8s | %7s %9s %9s | %7s %9s %9s %9s\n", "dist m", "PDR", "air ms", "node mJ",
+           "PDR", "air ms", "node mJ", "total mJ");
+    for (i = 0; i < c.ndist; i++)
+    {
+        RESULT_T d, r;
+
+        sim_Distance(&c, c.dist[i], &rng, &d, &r);
+        printf("%8.0f | %6.1f%% %9.2f %9.3f | %6.1f%% %9.2f %9.3f %9.3f\n", c.dist[i],
+               d.pdr * 100, d.air_ms, d.node_mj, r.pdr * 100, r.air_ms, r.node_mj, r.total_mj);
+    }
+    printf("\nair ms / mJ are per delivered packet (0 when nothing was delivered)\n");
+    return 0;
+}
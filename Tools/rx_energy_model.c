@@ -0,0 +1,169 @@
+/*********************************************************************************************************
+*
+*   模块名称 : 间歇接收能耗模型
+*   文件名称 : rx_energy_model.c
+*   版    本 : V1.0
+*   说    明 : 比较射频一直连续接收与 bsp_rxduty.c 的广播包对齐单次接收两种方式下，节点射频部分的平均电流。
+*             每个广播周期节点收一个广播包、在本节点时隙发一个上行数据帧：
+*               - 连续接收：发射以外的时间都是接收电流
+*               - 间歇接收：接收窗口从预计的广播包开始前 early ms 打开，到广播包收完为止；
+*                 发射前的待机时间(EntryTx回读校验)和TxDone后回到接收前的待机时间计待机电流，其余时间睡眠。
+*                 错过的广播包按整个符号超时窗口计接收电流
+*             只计射频模块，不含MCU和蓝牙模块。
+*
+*   编    译 : gcc -O2 -o rx_energy_model rx_energy_model.c -lm
+*   用    法 : ./rx_energy_model [-T 500,1000,2000,5000,10000] [-early 6] [-bcn 12] [-len 6]
+*                                [-power 20] [-miss 0.02] [-mah 1000]
+*
+*********************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lora_phy.h"
+
+#define MAX_PERIOD      32
+#define TX_STDBY_MS     1.0         /* 发射准备(EntryTx回读校验)和TxDone到重新进入接收的待机时间 */
+#define WAKE_STDBY_MS   0.3         /* 睡眠唤醒到进入接收的待机时间(晶振起振 + 配置单次接收) */
+#define WINDOW_EXTRA    8           /* 与 RXD_WindowSymbols 相同：检测前导码另加的符号数 */
+
+typedef struct
+{
+    double period[MAX_PERIOD];      /* 广播周期，单位ms */
+    int    nperiod;
+    double early_ms;
+    int    bcn_len;
+    int    len;
+    double tx_dbm;
+    double miss;                    /* 错过广播包的比例 */
+    double mah;
+    LORA_PHY_T phy;
+} CFG_T;
+
+/*
+*********************************************************************************************************
+*   函 数 名: model_Continuous
+*   功能说明: 连续接收时一个广播周期内的平均电流，单位mA
+*********************************************************************************************************
+*/
+static double model_Continuous(const CFG_T *_c, double _period_ms)
+{
+    double t_tx = lora_AirtimeUs(&_c->phy, _c->len) / 1000.0;
+
+    return (lora_TxCurrentMa(_c->tx_dbm) * t_tx + LORA_I_RX_MA * (_period_ms - t_tx)) / _period_ms;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: model_Windowed
+*   功能说明: 间歇接收时一个广播周期内的平均电流，单位mA
+*********************************************************************************************************
+*/
+static double model_Windowed(const CFG_T *_c, double _period_ms)
+{
+    double t_sym = lora_SymbolUs(&_c->phy) / 1000.0;
+    double t_tx = lora_AirtimeUs(&_c->phy, _c->len) / 1000.0;
+    double t_hit = _c->early_ms + lora_AirtimeUs(&_c->phy, _c->bcn_len) / 1000.0;
+    double t_miss = (int)(2 * _c->early_ms / t_sym + WINDOW_EXTRA) * t_sym;
+    double t_rx = (1.0 - _c->miss) * t_hit + _c->miss * t_miss;
+    double t_stdby = WAKE_STDBY_MS + TX_STDBY_MS;
+    double t_sleep = _period_ms - t_rx - t_stdby - t_tx;
+    double q;
+
+    if (t_sleep < 0)
+    {
+        return -1;
+    }
+    q = LORA_I_RX_MA * t_rx + LORA_I_STDBY_MA * t_stdby + lora_TxCurrentMa(_c->tx_dbm) * t_tx
+        + LORA_I_SLEEP_MA * t_sleep;
+    return q / _period_ms;
+}
+
+static int parse_List(const char *_s, CFG_T *_c)
+{
+    char buf[256], *tok;
+
+    strncpy(buf, _s, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = 0;
+    _c->nperiod = 0;
+    for (tok = strtok(buf, ","); tok && _c->nperiod < MAX_PERIOD; tok = strtok(NULL, ","))
+    {
+        _c->period[_c->nperiod++] = atof(tok);
+    }
+    return _c->nperiod > 0 ? 0 : -1;
+}
+
+static void usage(void)
+{
+    printf("usage: rx_energy_model [options]\n"
+           "  -T LIST       beacon periods in ms (500,1000,2000,5000,10000)\n"
+           "  -early MS     RX window opens this long before the predicted beacon (6 = RXD_EARLY_MS)\n"
+           "  -bcn N        beacon length in bytes (12)\n"
+           "  -len N        uplink frame length per period (6)\n"
+           "  -power DBM    TX power (20)\n"
+           "  -miss P       fraction of beacons missed, each costs a full timeout window (0.02)\n"
+           "  -mah C        battery capacity for the lifetime column (1000)\n");
+}
+
+int main(int argc, char **argv)
+{
+    CFG_T c;
+    int i;
+
+    memset(&c, 0, sizeof(c));
+    parse_List("500,1000,2000,5000,10000", &c);
+    c.early_ms = 6;
+    c.bcn_len = 12;
+    c.len = 6;
+    c.tx_dbm = 20;
+    c.miss = 0.02;
+    c.mah = 1000;
+    c.phy = g_tPhyDefault;
+
+    for (i = 1; i + 1 < argc; i += 2)
+    {
+        const char *opt = argv[i], *val = argv[i + 1];
+        int err = 0;
+
+        if (strcmp(opt, "-T") == 0)             err = parse_List(val, &c);
+        else if (strcmp(opt, "-early") == 0)    c.early_ms = atof(val);
+        else if (strcmp(opt, "-bcn") == 0)      c.bcn_len = atoi(val);
+        else if (strcmp(opt, "-len") == 0)      c.len = atoi(val);
+        else if (strcmp(opt, "-power") == 0)    c.tx_dbm = atof(val);
+        else if (strcmp(opt, "-miss") == 0)     c.miss = atof(val);
+        else if (strcmp(opt, "-mah") == 0)      c.mah = atof(val);
+        else err = -1;
+        if (err)
+        {
+            usage();
+            return 1;
+        }
+    }
+    if (i < argc || c.early_ms < 0 || c.bcn_len < 1 || c.len < 1 || c.miss < 0 || c.miss > 1 || c.mah <= 0)
+    {
+        usage();
+        return 1;
+    }
+
+    printf("SF%d/%.0fKHz: beacon %d B %.2f ms, uplink %d B %.2f ms at %.0f dBm (%.0f mA)\n",
+           c.phy.sf, c.phy.bw_khz, c.bcn_len, lora_AirtimeUs(&c.phy, c.bcn_len) / 1000.0,
+           c.len, lora_AirtimeUs(&c.phy, c.len) / 1000.0, c.tx_dbm, lora_TxCurrentMa(c.tx_dbm));
+    printf("RX window opens %.1f ms early, %.0f%% beacons missed, radio only, %.0f mAh battery\n\n",
+           c.early_ms, c.miss * 100, c.mah);
+    printf("%9s | %10s %9s | %10s %9s | %7s\n", "", "continuous", "", "windowed", "", "");
+    printf("%9s | %10s %9s | %10s %9s | %7s\n", "period ms", "avg mA", "life h", "avg mA", "life h", "saving");
+    for (i = 0; i < c.nperiod; i++)
+    {
+        double cont = model_Continuous(&c, c.period[i]);
+        double win = model_Windowed(&c, c.period[i]);
+
+        if (win < 0)
+        {
+            printf("%9.0f | %10.3f %9.0f | %10s %9s | %7s\n", c.period[i], cont, c.mah / cont,
+                   "too short", "", "");
+            continue;
+        }
+        printf("%9.0f | %10.3f %9.0f | %10.3f %9.0f | %6.1fx\n", c.period[i], cont, c.mah / cont,
+               win, c.mah / win, cont / win);
+    }
+    return 0;
+}
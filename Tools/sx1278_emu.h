@@ -0,0 +1,242 @@
+/*********************************************************************************************************
+*
+*   模块名称 : 主机端SX1278 SPI寄存器仿真
+*   文件名称 : sx1278_emu.h
+*   版    本 : V1.0
+*   说    明 : 在PC上替代 stm32f10x.h / bsp.h 中射频驱动用到的部分，使 bsp_sx1276-LoRa.c 原样编译进
+*             主机程序。SPI2每次NSS拉低记为一次传输，首字节为地址(bit7=1为写)，之后地址自动递增，
+*             地址0x00按FifoAddrPtr读写FIFO。统计传输次数、字节数和 bsp_DelayUS/MS 的累计延时，
+*             用于比较驱动改动前后每包的SPI开销。
+*             用法：先 #include "sx1278_emu.h"，再 #include "bsp_sx1276-LoRa.c"。
+*
+*********************************************************************************************************/
+#ifndef __SX1278_EMU_H__
+#define __SX1278_EMU_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#define _BSP_H_                 /* 跳过固件的 bsp.h */
+
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef int32_t  s32;
+
+typedef struct { int id; } GPIO_TypeDef;
+typedef struct { int id; } SPI_TypeDef;
+
+static GPIO_TypeDef s_tEmuGpioA = { 0 }, s_tEmuGpioB = { 1 }, s_tEmuGpioC = { 3 };
+static SPI_TypeDef  s_tEmuSpi2 = { 2 };
+#define GPIOA   (&s_tEmuGpioA)
+#define GPIOB   (&s_tEmuGpioB)
+#define GPIOC   (&s_tEmuGpioC)          /* DIO1、DIO3，未仿真，读出为0 */
+#define SPI2    (&s_tEmuSpi2)
+
+#define GPIO_Pin_2              0x0004
+#define GPIO_Pin_6              0x0040
+#define GPIO_Pin_7              0x0080
+#define GPIO_Pin_8              0x0100
+#define GPIO_Pin_11             0x0800
+#define GPIO_Pin_12             0x1000
+#define SPI_I2S_FLAG_RXNE       0x0001
+#define SPI_I2S_FLAG_TXE        0x0002
+#define RESET                   0
+
+#include "bsp_sx1276-LoRa.h"
+#include "bsp_sx1276-Fsk.h"
+
+/* 仿真状态与统计 */
+typedef struct
+{
+    uint8_t  reg[0x80];
+    uint8_t  fifo[256];
+    int      nss;           /* 1: 传输进行中 */
+    int      first;         /* 下一个字节是地址 */
+    int      wr;
+    uint8_t  addr;
+    uint8_t  rx;            /* 本次交换MISO上的字节 */
+    int      miso_fault;    /* 1: 模拟MISO断线，读出全为0xFF */
+
+    uint32_t txns;          /* SPI传输次数 */
+    uint32_t bytes;         /* 交换的字节数(含地址字节) */
+    uint32_t reads;         /* 读寄存器传输次数 */
+    uint32_t writes;        /* 写寄存器传输次数 */
+    uint32_t delay_us;      /* bsp_DelayUS/MS 累计 */
+    uint32_t resets;        /* 硬件复位次数 */
+} SX1278_EMU_T;
+
+static SX1278_EMU_T g_tEmu;
+
+/* 上电/复位后的寄存器缺省值(数据手册表41，只列出驱动会读到的) */
+static void emu_Reset(void)
+{
+    memset(g_tEmu.reg, 0, sizeof(g_tEmu.reg));
+    g_tEmu.reg[0x01] = 0x09;
+    g_tEmu.reg[0x0E] = 0x80;
+    g_tEmu.reg[0x0F] = 0x00;
+    g_tEmu.reg[0x11] = 0x00;
+    g_tEmu.reg[0x22] = 0x01;
+    g_tEmu.reg[0x23] = 0xFF;
+    g_tEmu.reg[0x42] = 0x12;
+    g_tEmu.resets++;
+}
+
+static void emu_ClearStats(void)
+{
+    g_tEmu.txns = g_tEmu.bytes = g_tEmu.reads = g_tEmu.writes = 0;
+    g_tEmu.delay_us = g_tEmu.resets = 0;
+}
+
+/* 模拟接收到一包数据：写入FIFO并置位RxDone，SNR/RSSI为寄存器原始值 */
+static void emu_InjectRx(const uint8_t *_buf, uint8_t _len, uint8_t _snr_raw, uint8_t _rssi_raw)
+{
+    uint8_t addr = g_tEmu.reg[0x0F];
+    int i;
+
+    for (i = 0; i < _len; i++)
+    {
+        g_tEmu.fifo[(uint8_t)(addr + i)] = _buf[i];
+    }
+    g_tEmu.reg[0x10] = addr;
+    g_tEmu.reg[0x13] = _len;
+    g_tEmu.reg[0x19] = _snr_raw;
+    g_tEmu.reg[0x1A] = _rssi_raw;
+    g_tEmu.reg[0x12] |= 0x50;       /* ValidHeader | RxDone */
+}
+
+static void emu_WriteReg(uint8_t _addr, uint8_t _val)
+{
+    if (_addr == 0x00)
+    {
+        g_tEmu.fifo[g_tEmu.reg[0x0D]++] = _val;
+        return;
+    }
+    if (_addr == 0x12)
+    {
+        g_tEmu.reg[0x12] &= (uint8_t)~_val;     /* 写1清零 */
+        return;
+    }
+    if (_addr == 0x01 && ((g_tEmu.reg[0x01] & 0x07) != 0x00 || (_val & 0x07) != 0x00))
+    {
+        _val = (uint8_t)((_val & 0x7F) | (g_tEmu.reg[0x01] & 0x80));   /* LongRangeMode只能在睡眠模式下修改 */
+    }
+    g_tEmu.reg[_addr] = _val;
+    if (_addr == 0x01 && (_val & 0x07) == 0x03)
+    {
+        g_tEmu.reg[0x12] |= 0x08;               /* 进入TX立即完成 */
+        g_tEmu.reg[0x01] = (uint8_t)((_val & 0xF8) | 0x01);
+    }
+}
+
+static uint8_t emu_ReadReg(uint8_t _addr)
+{
+    if (_addr == 0x00)
+    {
+        return g_tEmu.fifo[g_tEmu.reg[0x0D]++];
+    }
+    return g_tEmu.reg[_addr];
+}
+
+static void GPIO_ResetBits(GPIO_TypeDef *_port, uint16_t _pin)
+{
+    if (_port == GPIOB && (_pin & GPIO_Pin_12))
+    {
+        g_tEmu.nss = 1;
+        g_tEmu.first = 1;
+        g_tEmu.txns++;
+    }
+    if (_port == GPIOA && (_pin & GPIO_Pin_8))
+    {
+        emu_Reset();
+    }
+}
+
+static void GPIO_SetBits(GPIO_TypeDef *_port, uint16_t _pin)
+{
+    if (_port == GPIOB && (_pin & GPIO_Pin_12))
+    {
+        g_tEmu.nss = 0;
+    }
+}
+
+/* DIO0: RegDioMapping1 bit7~6 = 00 为RxDone，01 为TxDone */
+static uint8_t GPIO_ReadInputDataBit(GPIO_TypeDef *_port, uint16_t _pin)
+{
+    uint8_t map = g_tEmu.reg[0x40] >> 6;
+
+    if (_port != GPIOA || _pin != GPIO_Pin_2)
+    {
+        return 0;
+    }
+    if (map == 0)
+    {
+        return (g_tEmu.reg[0x12] & 0x40) ? 1 : 0;
+    }
+    if (map == 1)
+    {
+        return (g_tEmu.reg[0x12] & 0x08) ? 1 : 0;
+    }
+    return 0;
+}
+
+static int SPI_I2S_GetFlagStatus(SPI_TypeDef *_spi, uint16_t _flag)
+{
+    (void)_spi;
+    (void)_flag;
+    return 1;
+}
+
+static void SPI_I2S_SendData(SPI_TypeDef *_spi, uint16_t _data)
+{
+    uint8_t b = (uint8_t)_data;
+
+    (void)_spi;
+    g_tEmu.bytes++;
+    if (!g_tEmu.nss)
+    {
+        g_tEmu.rx = 0xFF;
+        return;
+    }
+    if (g_tEmu.first)
+    {
+        g_tEmu.first = 0;
+        g_tEmu.wr = (b & 0x80) ? 1 : 0;
+        g_tEmu.addr = b & 0x7F;
+        if (g_tEmu.wr) g_tEmu.writes++;
+        else g_tEmu.reads++;
+        g_tEmu.rx = 0x00;
+        return;
+    }
+    if (g_tEmu.wr)
+    {
+        emu_WriteReg(g_tEmu.addr, b);
+        g_tEmu.rx = 0x00;
+    }
+    else
+    {
+        g_tEmu.rx = emu_ReadReg(g_tEmu.addr);
+    }
+    if (g_tEmu.addr != 0x00)
+    {
+        g_tEmu.addr = (g_tEmu.addr + 1) & 0x7F;
+    }
+}
+
+static uint16_t SPI_I2S_ReceiveData(SPI_TypeDef *_spi)
+{
+    (void)_spi;
+    return g_tEmu.miso_fault ? 0xFF : g_tEmu.rx;
+}
+
+static void bsp_DelayUS(uint32_t _us)
+{
+    g_tEmu.delay_us += _us;
+}
+
+static void bsp_DelayMS(uint32_t _ms)
+{
+    g_tEmu.delay_us += _ms * 1000;
+}
+
+#endif
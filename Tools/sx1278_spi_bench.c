@@ -0,0 +1,369 @@
+/*********************************************************************************************************
+*
+*   模块名称 : SX1278接收路径SPI开销基准测试
+*   文件名称 : sx1278_spi_bench.c
+*   版    本 : V1.0
+*   说    明 : 把 bsp_sx1276-LoRa.c 原样编译进来，由 sx1278_emu.h 仿真SPI寄存器，统计每收一包数据
+*             RFM96_LoRaRxPacket 的SPI传输次数、字节数和延时，并与改动前的逐个寄存器读写方式对比。
+*             总线时间按 SPI2 时钟(缺省 36MHz/256 = 140.625KHz)计算，每次传输另加NSS翻转等固定开销，
+*             另列出分频系数改为4(9MHz)时的耗时，此时每次传输的固定开销占主要部分。
+*             同时校验读出的数据、SNR和RSSI是否正确。另列出先读包头、不需要的数据包只读包头即丢弃的开销。
+*             另外比较发射准备 RFM96_LoRaEntryTx 的开销，并模拟MISO断线检查其能否在有限时间内返回。
+*             最后比较切换调制参数档位时逐个寄存器写入与整组连续写入的开销，并校验写入的寄存器值。
+*             另列出回到接收模式时复位芯片与不复位的开销，以及温度监测读温度和镜像校准的开销。
+*
+*   编    译 : gcc -O2 -I../Source/UpDrive -o sx1278_spi_bench sx1278_spi_bench.c
+*   用    法 : ./sx1278_spi_bench [-spi_khz 140.625] [-nss_us 2]
+*
+*********************************************************************************************************/
+#include "sx1278_emu.h"
+#include "bsp_sx1276-LoRa.c"
+#include "bsp_sx1276-Fsk.c"
+
+#include <stdlib.h>
+
+#define RF_PEEK_LEN_BENCH   4       /* 与 bsp_rf.h 的 RF_PEEK_LEN 相同 */
+
+typedef struct
+{
+    uint32_t txns;
+    uint32_t bytes;
+    uint32_t delay_us;
+} COST_T;
+
+static double s_spi_khz = 36000.0 / 256;
+static double s_nss_us = 2.0;
+
+/*
+*********************************************************************************************************
+*   函 数 名: legacy_LoRaRxPacket
+*   功能说明: 改动前的接收函数：逐个读 RxCurrentAddr、RxNbBytes，中间插 bsp_DelayUS(1)
+*   形    参: buf     : 接收缓冲区
+*             quality : 1 表示再单独读取 PktSnr / PktRssi (旧方式要获得链路质量需要另加两次读)
+*   返 回 值: 数据包长度
+*********************************************************************************************************
+*/
+static u8 legacy_LoRaRxPacket(u8 *buf, int quality)
+{
+    u8 i;
+    u8 addr;
+    u8 packet_size;
+
+    for (i = 0; i < 32; i++)
+    {
+        buf[i] = 0x00;
+    }
+    addr = SPIRead((u8)(LR_RegFifoRxCurrentaddr >> 8));
+    SPIWrite(LR_RegFifoAddrPtr + addr);
+    bsp_DelayUS(1);
+    packet_size = SPIRead((u8)(LR_RegRxNbBytes >> 8));
+    SPIBurstRead(0x00, buf, packet_size);
+    if (quality)
+    {
+        gPktSnr = (int8_t)SPIRead((u8)(LR_RegPktSnrValue >> 8)) / 4;
+        gPktRssi = -164 + SPIRead((u8)(LR_RegPktRssiValue >> 8));
+        if (gPktSnr < 0)
+        {
+            gPktRssi += gPktSnr;
+        }
+    }
+    RFM96_LoRaClearIrq();
+    bsp_DelayUS(1);
+    return packet_size;
+}
+
+/* 改动前的发射准备：每次复位并重新配置芯片，延时1ms，回读RegPayloadLength直到一致(超时计数从不增加) */
+static u8 legacy_LoRaEntryTx(u8 packet_length)
+{
+    u8 addr;
+    u8 SysTime = 0;
+    u8 temp;
+
+    RFM96_Config(0);
+    bsp_DelayUS(1000);
+    SPIWrite(0x4D00 + 0x87);
+    SPIWrite(LR_RegHopPeriod);
+    SPIWrite(REG_LR_DIOMAPPING1 + 0x41);
+    RFM96_LoRaClearIrq();
+    SPIWrite(LR_RegIrqFlagsMask + 0xF7);
+    SPIWrite(LR_RegPayloadLength + packet_length);
+    addr = SPIRead((u8)(LR_RegFifoTxBaseAddr >> 8));
+    SPIWrite(LR_RegFifoAddrPtr + addr);
+    while (1)
+    {
+        temp = SPIRead((u8)(LR_RegPayloadLength >> 8));
+        if (temp == packet_length)
+        {
+            break;
+        }
+        if (SysTime >= 3)
+        {
+            return 0;
+        }
+    }
+    return packet_length;
+}
+
+/* 改动前 RFM96_Config 中逐个写入频率、功率和调制参数寄存器 */
+static void legacy_WriteProfile(const RF_PROFILE_T *_p)
+{
+    int i;
+
+    for (i = 0; i < 3; i++)
+    {
+        SPIWrite((u16)(((0x06 + i) << 8) + _p->rf[i]));
+    }
+    SPIWrite(RFM96PowerTbl[gPwrLevel]);
+    SPIWrite(LR_RegOcp + _p->rf[5]);
+    SPIWrite(LR_RegLna + _p->rf[6]);
+    SPIWrite(LR_RegModemConfig1 + _p->modem[0]);
+    SPIWrite(LR_RegModemConfig2 + _p->modem[1]);
+    SPIWrite(LR_RegSymbTimeoutLsb + _p->modem[2]);
+    SPIWrite(LR_RegPreambleMsb + _p->modem[3]);
+    SPIWrite(LR_RegPreambleLsb + _p->modem[4]);
+    SPIWrite(LR_RegModemConfig3 + _p->modem3);
+}
+
+/* 检查芯片寄存器与调制参数表一致 */
+static int profile_Check(const RF_PROFILE_T *_p)
+{
+    return g_tEmu.reg[0x06] == _p->rf[0] && g_tEmu.reg[0x07] == _p->rf[1] && g_tEmu.reg[0x08] == _p->rf[2]
+           && g_tEmu.reg[0x09] == (uint8_t)RFM96PowerTbl[gPwrLevel] && g_tEmu.reg[0x0C] == _p->rf[6]
+           && memcmp(&g_tEmu.reg[0x1D], _p->modem, 5) == 0 && g_tEmu.reg[0x26] == _p->modem3
+           && (g_tEmu.reg[0x01] & 0x87) == 0x81;
+}
+
+static double cost_Us(const COST_T *_c, double _spi_khz)
+{
+    return _c->bytes * 8000.0 / _spi_khz + _c->txns * s_nss_us + _c->delay_us;
+}
+
+static COST_T cost_Take(void)
+{
+    COST_T c;
+
+    c.txns = g_tEmu.txns;
+    c.bytes = g_tEmu.bytes;
+    c.delay_us = g_tEmu.delay_us;
+    return c;
+}
+
+/*
+    运行一种接收方式，返回数据是否正确：
+    0 旧方式，1 旧方式+SNR/RSSI，2 新方式，
+    3 新方式且数据包不在FifoAddrPtr处(连续接收模式下的后续数据包)，需要多写一次指针
+    4 先读包头再读其余部分(RFRevPacket 的方式)，5 只读包头即丢弃(其他节点的上行数据)
+*/
+static int run_Case(int _mode, const uint8_t *_pkt, uint8_t _len, COST_T *_pCost)
+{
+    uint8_t buf[256];
+    u8 n;
+
+    emu_Reset();                /* 每种方式从同样的芯片状态开始，上一种方式改动的寄存器不影响本次 */
+    RFM96_Config(0);
+    s_ucFifoPtrValid = 0;       /* 驱动的FifoAddrPtr影子值由 RFM96_LoRaEntryRx 重新建立 */
+    RFM96_LoRaEntryRx();
+    if (_mode == 3)
+    {
+        g_tEmu.reg[0x0F] = (uint8_t)(s_ucFifoPtr + 0x40);   /* 数据包不在影子指针处 */
+    }
+    emu_InjectRx(_pkt, _len, (uint8_t)(-22), 60);     /* SNR -5.5dB, RSSI原始值60 */
+    gPktSnr = 0;
+    gPktRssi = 0;
+    emu_ClearStats();
+    if (_mode >= 4)
+    {
+        u8 hdr[RF_PEEK_LEN_BENCH], k;
+
+        n = RFM96_LoRaRxBegin();
+        k = RFM96_LoRaRxPeek(hdr, RF_PEEK_LEN_BENCH);
+        if (_mode == 5)
+        {
+            RFM96_LoRaClearIrq();
+            *_pCost = cost_Take();
+            return memcmp(hdr, _pkt, k) == 0 && (g_tEmu.reg[0x12] & 0x40) == 0;
+        }
+        memcpy(buf, hdr, k);
+        RFM96_LoRaRxRead(buf, n);
+    }
+    else if (_mode >= 2)
+    {
+        n = RFM96_LoRaRxPacket(buf, 255);
+    }
+    else
+    {
+        n = legacy_LoRaRxPacket(buf, _mode);
+    }
+    *_pCost = cost_Take();
+    if (n != _len || memcmp(buf, _pkt, _len) != 0 || (g_tEmu.reg[0x12] & 0x40))
+    {
+        return 0;
+    }
+    if (_mode != 0 && (gPktSnr != -5 || gPktRssi != -164 + 60 - 5))
+    {
+        return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    static const char *s_name[6] = { "legacy", "legacy + SNR/RSSI", "burst (new)", "burst, ptr moved",
+                                     "peek + rest", "peek + drop" };
+    static const uint8_t s_len[3] = { 4, 6, 32 };
+    uint8_t pkt[32];
+    COST_T c, rx;
+    int i, m, ok = 1;
+
+    for (i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "-spi_khz") == 0)     s_spi_khz = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "-nss_us") == 0) s_nss_us = atof(argv[i + 1]);
+    }
+    if (i < argc || s_spi_khz <= 0)
+    {
+        printf("usage: sx1278_spi_bench [-spi_khz 140.625] [-nss_us 2]\n");
+        return 1;
+    }
+    for (i = 0; i < 32; i++)
+    {
+        pkt[i] = (uint8_t)('A' + i);
+    }
+    memcpy(pkt, "$#ST", 4);
+    RFM96_Config(0);
+
+    printf("SPI clock %.3f KHz (%.1f us/byte), %.1f us per transaction overhead\n\n",
+           s_spi_khz, 8000.0 / s_spi_khz, s_nss_us);
+    printf("%-20s %4s %6s %6s %8s %10s %10s\n", "RFM96_LoRaRxPacket", "len", "txns", "bytes", "delay",
+           "us", "us @9MHz");
+    for (i = 0; i < 3; i++)
+    {
+        for (m = 0; m < 6; m++)
+        {
+            int pass = run_Case(m, pkt, s_len[i], &c);
+
+            ok &= pass;
+            printf("%-20s %4u %6u %6u %6uus %10.1f %10.1f%s\n", s_name[m], s_len[i], c.txns, c.bytes,
+                   c.delay_us, cost_Us(&c, s_spi_khz), cost_Us(&c, 9000.0), pass ? "" : "  MISMATCH");
+        }
+        printf("\n");
+    }
+
+    /* 发射准备：旧方式每次复位芯片；新方式只写发射相关寄存器并回读校验 */
+    {
+        static const char *s_txname[2] = { "legacy EntryTx", "EntryTx (new)" };
+        uint8_t tx[6] = { '&', 3, 72, 99, 98, '%' };
+
+        printf("\n%-20s %4s %6s %6s %8s %10s %10s\n", "EntryTx + TxPacket", "len", "txns", "bytes", "delay",
+               "us", "us @9MHz");
+        for (m = 0; m < 2; m++)
+        {
+            u8 n;
+
+            RFM96_LoRaEntryRx();
+            emu_ClearStats();
+            n = (m == 0) ? legacy_LoRaEntryTx(6) : RFM96_LoRaEntryTx(6);
+            n = (n == 6) ? RFM96_LoRaTxPacket(tx, 6) : 0;
+            if (n == 6)
+            {
+                RFM96_LoRaTxEnd();     /* 固件在TxDone(DIO0)事件后调用 */
+            }
+            c = cost_Take();
+            ok &= (n == 6 && memcmp(&g_tEmu.fifo[0x80], tx, 6) == 0);
+            printf("%-20s %4u %6u %6u %6uus %10.1f %10.1f%s\n", s_txname[m], 6, c.txns, c.bytes, c.delay_us,
+                   cost_Us(&c, s_spi_khz), cost_Us(&c, 9000.0), n == 6 ? "" : "  FAIL");
+        }
+
+        /* MISO断线：旧方式在回读循环中永远不退出，新方式在有限次传输后返回0 */
+        RFM96_LoRaEntryRx();
+        emu_ClearStats();
+        g_tEmu.miso_fault = 1;
+        m = RFM96_LoRaEntryTx(6);
+        g_tEmu.miso_fault = 0;
+        c = cost_Take();
+        ok &= (m == 0);
+        printf("EntryTx, MISO stuck: returns %d after %u txns, %.1f us (legacy: never returns)\n\n",
+               m, c.txns, cost_Us(&c, s_spi_khz));
+    }
+
+    /* 切换调制参数档位：逐个寄存器写入与整组连续写入 */
+    printf("%-20s %4s %6s %6s %8s %10s %10s\n", "profile switch", "prof", "txns", "bytes", "delay",
+           "us", "us @9MHz");
+    for (m = 0; m < RF_PROF_NUM; m++)
+    {
+        int pass;
+
+        RFM96_LoRaEntryRx();
+        emu_ClearStats();
+        RFM96_Standby();
+        legacy_WriteProfile(&RFM96ProfileTbl[m]);
+        c = cost_Take();
+        printf("%-20s %4d %6u %6u %6uus %10.1f %10.1f\n", "per register", m, c.txns, c.bytes, c.delay_us,
+               cost_Us(&c, s_spi_khz), cost_Us(&c, 9000.0));
+        RFM96_LoRaEntryRx();
+        emu_ClearStats();
+        RFM96_LoRaSetProfile(m);
+        c = cost_Take();
+        pass = profile_Check(&RFM96ProfileTbl[m]);
+        ok &= pass;
+        printf("%-20s %4d %6u %6u %6uus %10.1f %10.1f%s\n", "burst image (new)", m, c.txns, c.bytes,
+               c.delay_us, cost_Us(&c, s_spi_khz), cost_Us(&c, 9000.0), pass ? "" : "  MISMATCH");
+    }
+    RFM96_LoRaSetProfile(RF_PROF_DEFAULT);
+    printf("\n");
+
+    /* 作为参照：发射结束后调用 RFRxMode() 回到接收模式 */
+    emu_ClearStats();
+    RFM96_LoRaEntryRx();
+    rx = cost_Take();
+    /* 超长数据包：缓冲区只有32字节，收到200字节的包时应丢弃且不越界 */
+    {
+        uint8_t small[32 + 4], longpkt[200];
+
+        memset(longpkt, 0x5A, sizeof(longpkt));
+        memset(small, 0xEE, sizeof(small));
+        RFM96_LoRaEntryRx();
+        emu_InjectRx(longpkt, sizeof(longpkt), 0, 60);
+        if (RFM96_LoRaRxPacket(small, 32) != 0 || small[32] != 0xEE || (g_tEmu.reg[0x12] & 0x40))
+        {
+            ok = 0;
+            printf("long packet: buffer overrun or not dropped\n");
+        }
+        else
+        {
+            printf("long packet (200 B into 32 B buffer): dropped, no overrun\n");
+        }
+    }
+
+    emu_ClearStats();
+    RFM96_Config(0);
+    RFM96_LoRaEntryRx();
+    c = cost_Take();
+    printf("RFRxMode() after TX, legacy reset: %u txns, %u bytes, %uus delay, %.1f us total\n",
+           c.txns, c.bytes, c.delay_us, cost_Us(&c, s_spi_khz));
+    printf("RFRxMode() after TX, no reset:     %u txns, %u bytes, %uus delay, %.1f us total\n",
+           rx.txns, rx.bytes, rx.delay_us, cost_Us(&rx, s_spi_khz));
+
+    /* 温度监测：读温度(芯片温度25℃，上次校准时21℃)，再做一次镜像校准，结束后应回到LoRa待机、PA恢复 */
+    {
+        int16_t t, ref;
+        uint8_t pa = g_tEmu.reg[0x09];
+
+        g_tEmu.reg[0x3C] = (uint8_t)(-25);
+        g_tEmu.reg[0x5B] = (uint8_t)(-21);
+        emu_ClearStats();
+        t = RFM96_ReadTemp();
+        ref = RFM96_CalTemp();
+        c = cost_Take();
+        ok &= (t == 25 && ref == 21 && (g_tEmu.reg[0x01] & 0x87) == 0x81);
+        printf("RFM96_ReadTemp + CalTemp: %d / %d C, %u txns, %uus delay, %.1f us total\n", t, ref, c.txns,
+               c.delay_us, cost_Us(&c, s_spi_khz));
+        emu_ClearStats();
+        m = RFM96_ImageCal();
+        c = cost_Take();
+        ok &= (m == 1 && g_tEmu.reg[0x09] == pa && (g_tEmu.reg[0x01] & 0x87) == 0x81);
+        printf("RFM96_ImageCal: %s, %u txns, %uus delay, %.1f us total (chip calibration time not modelled)\n",
+               m ? "done" : "TIMEOUT", c.txns, c.delay_us, cost_Us(&c, s_spi_khz));
+    }
+    return ok ? 0 : 2;
+}
@@ -0,0 +1,291 @@
+/*********************************************************************************************************
+*
+*   模块名称 : 遥测编解码基准测试
+*   文件名称 : tlm_codec_bench.c
+*   版    本 : V1.0
+*   说    明 : 在PC上测试 bsp_tlmcodec.c 的压缩率、编解码耗时，并校验解码结果与原始数据完全一致。
+*             数据来源可以是记录下来的文本文件(每行一条记录，各通道整数以空格或逗号分隔)，
+*             不指定文件时使用内置的两组模拟数据：
+*               - 心率/心率带电量/电池电量，1Hz，24小时
+*               - AD5933 500点扫频的实部/虚部(16位有符号)
+*             原始长度按固件实际发送的字节数计算：遥测每通道1字节，阻抗每通道2字节。
+*             耗时是PC上的测量值，只用于比较不同数据和参数，不能换算为Cortex-M3上的耗时；
+*             板上的耗时需要用DWT周期计数器测量，本程序不提供。
+*             固件每个数据帧最多聚合 TLM_MAX_BLK_REC 条记录(帧长不超过发送队列项)，对应 -agg 8，见 bsp_task.c QueueTelemetry。
+*
+*   编    译 : gcc -O2 -I../Source/UpDrive -o tlm_codec_bench tlm_codec_bench.c ../Source/UpDrive/bsp_tlmcodec.c
+*   用    法 : ./tlm_codec_bench [-f trace.txt -w 字节/通道] [-agg 每帧记录数] [-loops N]
+*
+*********************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bsp_tlmcodec.h"
+
+#define MAX_REC     200000
+
+typedef struct
+{
+    const char *name;
+    int chn;
+    int width;                  /* 原始格式每通道字节数 */
+    int rec;
+    int32_t *val;               /* rec x chn */
+} TRACE_T;
+
+static uint64_t s_rng = 88172645463325252ULL;
+
+static uint32_t rnd(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 7;
+    s_rng ^= s_rng << 17;
+    return (uint32_t)s_rng;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* 模拟心率带数据：心率随机游走，两路电量缓慢下降 */
+static void trace_Telemetry(TRACE_T *_t)
+{
+    int i, hr = 72, hbat = 100, bat = 100;
+
+    _t->name = "telemetry HR/HrtBat/Bat 1Hz 24h";
+    _t->chn = 3;
+    _t->width = 1;
+    _t->rec = 86400;
+    _t->val = malloc(sizeof(int32_t) * _t->rec * _t->chn);
+    for (i = 0; i < _t->rec; i++)
+    {
+        uint32_t r = rnd() % 100;
+
+        if (r < 15 && hr < 180) hr++;
+        else if (r < 30 && hr > 45) hr--;
+        if (i % 900 == 899 && hbat > 0) hbat--;
+        if (i % 1300 == 1299 && bat > 0) bat--;
+        _t->val[i * 3 + 0] = hr;
+        _t->val[i * 3 + 1] = hbat;
+        _t->val[i * 3 + 2] = bat;
+    }
+}
+
+/* 模拟AD5933扫频：实部/虚部随频率平滑变化并叠加少量噪声，重复多次扫频 */
+static void trace_Impedance(TRACE_T *_t)
+{
+    int i, sweep, p;
+    double re = 12000, im = -3000;
+
+    _t->name = "AD5933 sweep real/imag int16, 500 pts x 40";
+    _t->chn = 2;
+    _t->width = 2;
+    _t->rec = 500 * 40;
+    _t->val = malloc(sizeof(int32_t) * _t->rec * _t->chn);
+    for (sweep = 0, i = 0; sweep < 40; sweep++)
+    {
+        for (p = 0; p < 500; p++, i++)
+        {
+            double re_p = re - p * 9.5 + (int)(rnd() % 7) - 3;
+            double im_p = im + p * 4.2 + (int)(rnd() % 7) - 3;
+
+            _t->val[i * 2 + 0] = (int16_t)re_p;
+            _t->val[i * 2 + 1] = (int16_t)im_p;
+        }
+    }
+}
+
+static int trace_Load(TRACE_T *_t, const char *_file, int _width)
+{
+    FILE *fp = fopen(_file, "r");
+    char line[512];
+
+    if (fp == NULL)
+    {
+        perror(_file);
+        return -1;
+    }
+    _t->name = _file;
+    _t->chn = 0;
+    _t->width = _width;
+    _t->rec = 0;
+    _t->val = malloc(sizeof(int32_t) * MAX_REC * TLM_MAX_CHN);
+    while (fgets(line, sizeof(line), fp) && _t->rec < MAX_REC)
+    {
+        char *tok;
+        int n = 0;
+
+        for (tok = strtok(line, " ,\t\r\n"); tok && n < TLM_MAX_CHN; tok = strtok(NULL, " ,\t\r\n"))
+        {
+            _t->val[_t->rec * TLM_MAX_CHN + n++] = (int32_t)strtol(tok, NULL, 0);
+        }
+        if (n == 0)
+        {
+            continue;
+        }
+        if (_t->chn == 0)
+        {
+            _t->chn = n;
+        }
+        _t->rec++;
+    }
+    fclose(fp);
+    if (_t->rec == 0)
+    {
+        return -1;
+    }
+    /* 压紧为 rec x chn */
+    {
+        int i, j;
+
+        for (i = 0; i < _t->rec; i++)
+        {
+            for (j = 0; j < _t->chn; j++)
+            {
+                _t->val[i * _t->chn + j] = _t->val[i * TLM_MAX_CHN + j];
+            }
+        }
+    }
+    return 0;
+}
+
+/*
+*********************************************************************************************************
+*   函 数 名: bench_Run
+*   功能说明: 对一组数据进行压缩率统计、正确性校验和耗时测试。
+*             每 _agg 条记录拼成一个无线帧(按 TLM_MAX_BLK_REC 切分为若干数据块)，
+*             帧头/帧尾('@'/'&' + DEVID + '%')按3字节计入两种格式。
+*********************************************************************************************************
+*/
+static void bench_Run(const TRACE_T *_t, int _agg, int _loops)
+{
+    TLM_ENC_T enc;
+    TLM_DEC_T dec;
+    uint8_t *out = malloc((size_t)_t->rec * TLM_BLK_LEN_MAX(TLM_MAX_CHN, 1));
+    uint16_t *blen = malloc(sizeof(uint16_t) * _t->rec);
+    int32_t v[TLM_MAX_BLK_REC * TLM_MAX_CHN];
+    uint64_t enc_bytes = 0, raw_bytes, raw_frames_bytes = 0, enc_frames_bytes = 0;
+    int i, j, k, blocks = 0, errors = 0, keys = 0;
+    double t0, t_enc, t_dec;
+    size_t pos;
+    uint8_t cnt;
+
+    /* 压缩率与正确性 */
+    TLM_EncInit(&enc, (uint8_t)_t->chn);
+    TLM_DecInit(&dec);
+    for (i = 0, pos = 0; i < _t->rec; i += _agg)
+    {
+        int frame_rec = (_t->rec - i < _agg) ? _t->rec - i : _agg;
+
+        raw_frames_bytes += 3 + (uint64_t)frame_rec * _t->chn * _t->width;
+        enc_frames_bytes += 3;
+        for (j = 0; j < frame_rec; j += TLM_MAX_BLK_REC)
+        {
+            int n = (frame_rec - j < TLM_MAX_BLK_REC) ? frame_rec - j : TLM_MAX_BLK_REC;
+            const int32_t *src = &_t->val[(i + j) * _t->chn];
+
+            blen[blocks] = TLM_EncBlock(&enc, src, (uint8_t)n, &out[pos]);
+            if (out[pos] & TLM_HDR_KEY)
+            {
+                keys++;
+            }
+            if (TLM_DecBlock(&dec, &out[pos], (uint8_t)blen[blocks], v, &cnt) != blen[blocks] || cnt != n
+                || memcmp(v, src, sizeof(int32_t) * n * _t->chn) != 0)
+            {
+                errors++;
+            }
+            enc_bytes += blen[blocks];
+            enc_frames_bytes += blen[blocks];
+            pos += blen[blocks];
+            blocks++;
+        }
+    }
+    raw_bytes = (uint64_t)_t->rec * _t->chn * _t->width;
+
+    /* 耗时 */
+    t0 = now_ns();
+    for (k = 0; k < _loops; k++)
+    {
+        TLM_EncInit(&enc, (uint8_t)_t->chn);
+        for (i = 0, pos = 0; i < _t->rec; i += TLM_MAX_BLK_REC)
+        {
+            int n = (_t->rec - i < TLM_MAX_BLK_REC) ? _t->rec - i : TLM_MAX_BLK_REC;
+
+            pos += TLM_EncBlock(&enc, &_t->val[i * _t->chn], (uint8_t)n, &out[pos]);
+        }
+    }
+    t_enc = (now_ns() - t0) / ((double)_loops * _t->rec);
+
+    t0 = now_ns();
+    for (k = 0; k < _loops; k++)
+    {
+        TLM_DecInit(&dec);
+        for (i = 0, pos = 0; i < _t->rec; i += TLM_MAX_BLK_REC)
+        {
+            pos += TLM_DecBlock(&dec, &out[pos], 255, v, &cnt);
+        }
+    }
+    t_dec = (now_ns() - t0) / ((double)_loops * _t->rec);
+
+    printf("%s\n", _t->name);
+    printf("  records %d x %d ch, %d blocks, %d key blocks (every %d)\n",
+           _t->rec, _t->chn, blocks, keys, TLM_KEY_INTERVAL);
+    printf("  payload: raw %llu B, encoded %llu B, ratio %.2f : 1, %.2f B/record\n",
+           (unsigned long long)raw_bytes, (unsigned long long)enc_bytes,
+           (double)raw_bytes / enc_bytes, (double)enc_bytes / _t->rec);
+    printf("  %d records/frame: raw frames %llu B, encoded frames %llu B, ratio %.2f : 1\n",
+           _agg, (unsigned long long)raw_frames_bytes, (unsigned long long)enc_frames_bytes,
+           (double)raw_frames_bytes / enc_frames_bytes);
+    printf("  encode %.1f ns/record, decode %.1f ns/record, round-trip errors %d\n\n", t_enc, t_dec, errors);
+
+    free(out);
+    free(blen);
+}
+
+int main(int argc, char **argv)
+{
+    const char *file = NULL;
+    int width = 1, agg = 8, loops = 50, i;
+
+    for (i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "-f") == 0)          file = argv[i + 1];
+        else if (strcmp(argv[i], "-w") == 0)     width = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-agg") == 0)   agg = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-loops") == 0) loops = atoi(argv[i + 1]);
+    }
+    if (i < argc || agg < 1 || loops < 1)
+    {
+        printf("usage: tlm_codec_bench [-f trace.txt -w bytes_per_channel] [-agg records_per_frame] [-loops N]\n");
+        return 1;
+    }
+
+    if (file)
+    {
+        TRACE_T t;
+
+        if (trace_Load(&t, file, width) != 0)
+        {
+            return 1;
+        }
+        bench_Run(&t, agg, loops);
+        free(t.val);
+    }
+    else
+    {
+        TRACE_T t1, t2;
+
+        trace_Telemetry(&t1);
+        trace_Impedance(&t2);
+        bench_Run(&t1, agg, loops);
+        bench_Run(&t2, agg, loops);
+        free(t1.val);
+        free(t2.val);
+    }
+    return 0;
+}
@@ -0,0 +1,573 @@
+/*********************************************************************************************************
+*
+*   模块名称 : 串口FIFO基准测试
+*   文件名称 : uart_ring_bench.c
+*   版    本 : V1.0
+*   说    明 : 在PC上比较串口FIFO两种实现每字节的耗时：
+*               - 旧实现(bsp_uartfifo.c V1.4)：读写指针到末尾回零，收发双方共同修改计数变量，
+*                 主程序每读写1个字节关中断2次；DMA发送时整块复制，也要关中断更新计数
+*               - 新实现(bsp_ring.c)：读写指针自由递增、按掩码取下标，不关中断
+*             旧实现的 DISABLE_INT/ENABLE_INT 在PC上用一次 volatile 写加编译器屏障代替，与 CPSID/CPSIE
+*             一样阻止编译器把FIFO访问移出临界区，但不包括真实的关中断代价；同时统计每字节的临界区次数。
+*             接收方向还比较主程序的几种读取方式：旧的 if 链查端口号 + 逐字节 GetChar、查表 + 逐字节、
+*             COMx_Read 整块复制、COMx_Peek 在接收缓冲区中直接解析后 COMx_Consume。
+*             另外用两个线程分别做生产者和消费者检查新实现无锁读写的数据完整性，并检查DMA接收覆盖后
+*             消费者丢弃未读数据。
+*
+*   编    译 : gcc -O2 -I../Source/UpDrive -o uart_ring_bench uart_ring_bench.c ../Source/UpDrive/bsp_ring.c -lpthread
+*   用    法 : ./uart_ring_bench [-bytes N] [-chunk 64] [-size 1024] [-mt N]
+*
+*********************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include "bsp_ring.h"
+
+#define MAX_SIZE    32768
+
+/* 旧实现的关中断：volatile 写 + 编译器屏障 */
+static volatile uint32_t s_primask;
+static uint32_t s_crit;
+#define DISABLE_INT()   do { s_primask = 1; s_crit++; __asm volatile ("" : : : "memory"); } while (0)
+#define ENABLE_INT()    do { __asm volatile ("" : : : "memory"); s_primask = 0; } while (0)
+
+/* bsp_uartfifo.c V1.4 的FIFO部分 */
+typedef struct
+{
+    uint8_t *pBuf;
+    uint16_t usSize;
+    volatile uint16_t usWrite;
+    volatile uint16_t usRead;
+    volatile uint16_t usCount;
+} OLD_FIFO_T;
+
+/* 主程序写1个字节：UartSend 的循环体 */
+static uint8_t old_PutByte(OLD_FIFO_T *_p, uint8_t _ucByte)
+{
+    uint16_t usCount;
+
+    DISABLE_INT();
+    usCount = _p->usCount;
+    ENABLE_INT();
+    if (usCount >= _p->usSize)
+    {
+        return 0;
+    }
+    _p->pBuf[_p->usWrite] = _ucByte;
+    DISABLE_INT();
+    if (++_p->usWrite >= _p->usSize)
+    {
+        _p->usWrite = 0;
+    }
+    _p->usCount++;
+    ENABLE_INT();
+    return 1;
+}
+
+/* 主程序读1个字节：UartGetChar */
+static uint8_t old_GetByte(OLD_FIFO_T *_p, uint8_t *_pByte)
+{
+    uint16_t usCount;
+
+    DISABLE_INT();
+    usCount = _p->usCount;
+    ENABLE_INT();
+    if (usCount == 0)
+    {
+        return 0;
+    }
+    *_pByte = _p->pBuf[_p->usRead];
+    DISABLE_INT();
+    if (++_p->usRead >= _p->usSize)
+    {
+        _p->usRead = 0;
+    }
+    _p->usCount--;
+    ENABLE_INT();
+    return 1;
+}
+
+/* 中断写1个字节：RXNE 分支 */
+static void old_IsrPut(OLD_FIFO_T *_p, uint8_t _ucByte)
+{
+    _p->pBuf[_p->usWrite] = _ucByte;
+    if (++_p->usWrite >= _p->usSize)
+    {
+        _p->usWrite = 0;
+    }
+    if (_p->usCount < _p->usSize)
+    {
+        _p->usCount++;
+    }
+}
+
+/* 中断读1个字节：TXE 分支 */
+static uint8_t old_IsrGet(OLD_FIFO_T *_p, uint8_t *_pByte)
+{
+    if (_p->usCount == 0)
+    {
+        return 0;
+    }
+    *_pByte = _p->pBuf[_p->usRead];
+    if (++_p->usRead >= _p->usSize)
+    {
+        _p->usRead = 0;
+    }
+    _p->usCount--;
+    return 1;
+}
+
+/* 主程序整块写入：UartSendDma 的一次循环 */
+static uint16_t old_Write(OLD_FIFO_T *_p, const uint8_t *_pData, uint16_t _usLen)
+{
+    uint16_t usFree, usTail;
+
+    DISABLE_INT();
+    usFree = _p->usSize - _p->usCount;
+    ENABLE_INT();
+    if (_usLen > usFree)
+    {
+        _usLen = usFree;
+    }
+    usTail = _p->usSize - _p->usWrite;
+    if (_usLen <= usTail)
+    {
+        memcpy(&_p->pBuf[_p->usWrite], _pData, _usLen);
+    }
+    else
+    {
+        memcpy(&_p->pBuf[_p->usWrite], _pData, usTail);
+        memcpy(_p->pBuf, _pData + usTail, _usLen - usTail);
+    }
+    DISABLE_INT();
+    _p->usWrite += _usLen;
+    if (_p->usWrite >= _p->usSize)
+    {
+        _p->usWrite -= _p->usSize;
+    }
+    _p->usCount += _usLen;
+    ENABLE_INT();
+    return _usLen;
+}
+
+/* DMA发送完成：UartTxDmaDone 移动读指针 */
+static void old_Consume(OLD_FIFO_T *_p, uint16_t _usLen)
+{
+    _p->usRead += _usLen;
+    if (_p->usRead >= _p->usSize)
+    {
+        _p->usRead -= _p->usSize;
+    }
+    _p->usCount -= _usLen;
+}
+
+typedef struct
+{
+    long bytes;
+    int chunk;
+    int size;
+    long mt_bytes;
+} CFG_T;
+
+static uint8_t s_buf[MAX_SIZE];
+static uint8_t s_src[MAX_SIZE];
+static volatile uint32_t s_sink;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* 发送方向逐字节：主程序写 chunk 字节，TXE 中断逐字节取走 */
+static double run_TxByte(const CFG_T *_c, int _new)
+{
+    OLD_FIFO_T f = {s_buf, (uint16_t)_c->size, 0, 0, 0};
+    RING_T r;
+    uint32_t sum = 0;
+    uint8_t ch;
+    long done;
+    double t0;
+    int i;
+
+    RING_Init(&r, s_buf, (uint16_t)_c->size);
+    t0 = now_ns();
+    for (done = 0; done < _c->bytes; done += _c->chunk)
+    {
+        for (i = 0; i < _c->chunk; i++)
+        {
+            if (_new) RING_PutByte(&r, (uint8_t)i); else old_PutByte(&f, (uint8_t)i);
+        }
+        if (_new) { while (RING_GetByte(&r, &ch)) sum += ch; }
+        else      { while (old_IsrGet(&f, &ch)) sum += ch; }
+    }
+    s_sink = sum;
+    return (now_ns() - t0) / done;
+}
+
+/* 接收方向逐字节：RXNE 中断逐字节写入，主程序读取 */
+static double run_RxByte(const CFG_T *_c, int _new)
+{
+    OLD_FIFO_T f = {s_buf, (uint16_t)_c->size, 0, 0, 0};
+    RING_T r;
+    uint32_t sum = 0;
+    uint8_t ch;
+    long done;
+    double t0;
+    int i;
+
+    RING_Init(&r, s_buf, (uint16_t)_c->size);
+    t0 = now_ns();
+    for (done = 0; done < _c->bytes; done += _c->chunk)
+    {
+        for (i = 0; i < _c->chunk; i++)
+        {
+            if (_new) RING_PutByte(&r, (uint8_t)i); else old_IsrPut(&f, (uint8_t)i);
+        }
+        if (_new) { while (RING_GetByte(&r, &ch)) sum += ch; }
+        else      { while (old_GetByte(&f, &ch)) sum += ch; }
+    }
+    s_sink = sum;
+    return (now_ns() - t0) / done;
+}
+
+/* DMA发送整块：主程序复制 chunk 字节，DMA完成中断移动读指针 */
+static double run_TxBlock(const CFG_T *_c, int _new)
+{
+    OLD_FIFO_T f = {s_buf, (uint16_t)_c->size, 0, 0, 0};
+    RING_T r;
+    uint8_t *p;
+    uint16_t n;
+    long done;
+    double t0;
+
+    RING_Init(&r, s_buf, (uint16_t)_c->size);
+    t0 = now_ns();
+    for (done = 0; done < _c->bytes; done += _c->chunk)
+    {
+        if (_new)
+        {
+            RING_Write(&r, s_src, (uint16_t)_c->chunk);
+            while ((n = RING_ReadSpan(&r, &p)) != 0)
+            {
+                s_sink = p[0];
+                RING_Consume(&r, n);
+            }
+        }
+        else
+        {
+            old_Write(&f, s_src, (uint16_t)_c->chunk);
+            while (f.usCount != 0)
+            {
+                n = f.usSize - f.usRead;
+                if (n > f.usCount)
+                {
+                    n = f.usCount;
+                }
+                s_sink = f.pBuf[f.usRead];
+                old_Consume(&f, n);
+            }
+        }
+    }
+    return (now_ns() - t0) / done;
+}
+
+/* 旧的 ComToUart：if 链 */
+static OLD_FIFO_T s_tOldCom[5];
+static RING_T s_tCom[5];
+
+__attribute__((noinline)) static OLD_FIFO_T *old_ComToUart(int _port)
+{
+    if (_port == 0)         return &s_tOldCom[0];
+    else if (_port == 1)    return &s_tOldCom[1];
+    else if (_port == 2)    return &s_tOldCom[2];
+    else if (_port == 3)    return &s_tOldCom[3];
+    else if (_port == 4)    return &s_tOldCom[4];
+    return 0;
+}
+
+/* 新的 ComToUart：查表 */
+__attribute__((noinline)) static RING_T *new_ComToUart(int _port)
+{
+    static RING_T * const tab[5] = {&s_tCom[0], &s_tCom[1], &s_tCom[2], &s_tCom[3], &s_tCom[4]};
+
+    return ((unsigned)_port < 5) ? tab[_port] : 0;
+}
+
+/* DMA接收：数据整块写入，移动写指针 */
+static void old_DmaFill(OLD_FIFO_T *_p, const uint8_t *_pData, uint16_t _usLen)
+{
+    uint16_t usTail = _p->usSize - _p->usWrite;
+
+    if (_usLen <= usTail)
+    {
+        memcpy(&_p->pBuf[_p->usWrite], _pData, _usLen);
+    }
+    else
+    {
+        memcpy(&_p->pBuf[_p->usWrite], _pData, usTail);
+        memcpy(_p->pBuf, _pData + usTail, _usLen - usTail);
+    }
+    _p->usWrite += _usLen;
+    if (_p->usWrite >= _p->usSize)
+    {
+        _p->usWrite -= _p->usSize;
+    }
+    _p->usCount += _usLen;
+}
+
+/* 主程序读取接收数据并做简单解析(累加)，_mode: 0 旧GetChar 1 新GetChar 2 Read 3 Peek */
+static double run_RxApi(const CFG_T *_c, int _mode)
+{
+    const int port = 1;         /* COM2，BLE */
+    OLD_FIFO_T *f = &s_tOldCom[port];
+    RING_T *r = &s_tCom[port];
+    uint8_t tmp[MAX_SIZE];
+    RING_SPAN_T span;
+    uint32_t sum = 0;
+    uint16_t n, k;
+    uint8_t ch;
+    long done;
+    double t0;
+    int j;
+
+    f->pBuf = s_buf;
+    f->usSize = (uint16_t)_c->size;
+    f->usWrite = f->usRead = f->usCount = 0;
+    RING_Init(r, s_buf, (uint16_t)_c->size);
+    t0 = now_ns();
+    for (done = 0; done < _c->bytes; done += _c->chunk)
+    {
+        if (_mode == 0)
+        {
+            old_DmaFill(f, s_src, (uint16_t)_c->chunk);
+            while (old_GetByte(old_ComToUart(port), &ch)) sum += ch;
+            continue;
+        }
+        RING_Write(r, s_src, (uint16_t)_c->chunk);
+        if (_mode == 1)
+        {
+            while (RING_GetByte(new_ComToUart(port), &ch)) sum += ch;
+        }
+        else if (_mode == 2)
+        {
+            n = RING_Read(new_ComToUart(port), tmp, (uint16_t)sizeof(tmp));
+            for (k = 0; k < n; k++) sum += tmp[k];
+        }
+        else
+        {
+            n = RING_Peek(new_ComToUart(port), &span);
+            for (j = 0; j < 2; j++)
+            {
+                const uint8_t *p = span.pData[j];
+                uint16_t len = span.usLen[j];
+
+                for (k = 0; k < len; k++) sum += p[k];
+            }
+            RING_Consume(new_ComToUart(port), n);
+        }
+    }
+    s_sink = sum;
+    return (now_ns() - t0) / done;
+}
+
+/* 两个线程分别做生产者和消费者，检查无锁读写不丢字节、不乱序 */
+typedef struct
+{
+    RING_T ring;
+    long bytes;
+    long bad;
+} MT_T;
+
+static void *mt_Producer(void *_arg)
+{
+    MT_T *m = (MT_T *)_arg;
+    uint8_t blk[97];
+    long i = 0;
+    int k;
+
+    while (i < m->bytes)
+    {
+        if ((i & 1) == 0)
+        {
+            if (RING_PutByte(&m->ring, (uint8_t)(i * 7)))
+            {
+                i++;
+            }
+            else
+            {
+                sched_yield();      /* 满：单核机器上让消费者运行 */
+            }
+            continue;
+        }
+        for (k = 0; k < (int)sizeof(blk); k++)
+        {
+            blk[k] = (uint8_t)((i + k) * 7);
+        }
+        k = (m->bytes - i < (long)sizeof(blk)) ? (int)(m->bytes - i) : (int)sizeof(blk);
+        k = RING_Write(&m->ring, blk, (uint16_t)k);
+        if (k == 0)
+        {
+            sched_yield();
+        }
+        i += k;
+    }
+    return 0;
+}
+
+static void *mt_Consumer(void *_arg)
+{
+    MT_T *m = (MT_T *)_arg;
+    uint8_t *p, ch;
+    uint16_t n, k;
+    long i = 0;
+
+    while (i < m->bytes)
+    {
+        if (i & 1)
+        {
+            if (RING_GetByte(&m->ring, &ch))
+            {
+                m->bad += (ch != (uint8_t)(i * 7));
+                i++;
+            }
+            else
+            {
+                sched_yield();
+            }
+            continue;
+        }
+        n = RING_ReadSpan(&m->ring, &p);
+        if (n == 0)
+        {
+            sched_yield();
+        }
+        for (k = 0; k < n; k++)
+        {
+            m->bad += (p[k] != (uint8_t)((i + k) * 7));
+        }
+        RING_Consume(&m->ring, n);
+        i += n;
+    }
+    return 0;
+}
+
+static long run_Mt(const CFG_T *_c)
+{
+    static uint8_t buf[MAX_SIZE];
+    pthread_t tp, tc;
+    MT_T m;
+
+    RING_Init(&m.ring, buf, (uint16_t)_c->size);
+    m.bytes = _c->mt_bytes;
+    m.bad = 0;
+    pthread_create(&tc, 0, mt_Consumer, &m);
+    pthread_create(&tp, 0, mt_Producer, &m);
+    pthread_join(tp, 0);
+    pthread_join(tc, 0);
+    return m.bad;
+}
+
+/* DMA循环接收超过容量：消费者丢弃全部未读数据，之后恢复正常 */
+static int run_Overrun(const CFG_T *_c)
+{
+    RING_T r;
+    uint8_t ch;
+    int err = 0;
+
+    RING_Init(&r, s_buf, (uint16_t)_c->size);
+    RING_Produce(&r, (uint16_t)(_c->size - 1));
+    err |= (RING_Count(&r) != _c->size - 1);
+    RING_Produce(&r, 2);
+    err |= (RING_Count(&r) != _c->size);
+    err |= (RING_GetByte(&r, &ch) != 0);
+    err |= (RING_Count(&r) != 0);
+    s_buf[r.usWrite & r.usMask] = 0x5A;
+    RING_Produce(&r, 1);
+    err |= (RING_GetByte(&r, &ch) != 1) || (ch != 0x5A);
+    return err;
+}
+
+static void usage(void)
+{
+    printf("usage: uart_ring_bench [options]\n"
+           "  -bytes N      bytes per timed run (50000000)\n"
+           "  -chunk K      bytes written before the other side drains them, <= size (64)\n"
+           "  -size S       FIFO size, power of 2, 2..%d (1024)\n"
+           "  -mt N         bytes pushed through the two-thread check (20000000)\n", MAX_SIZE);
+}
+
+int main(int argc, char **argv)
+{
+    CFG_T c;
+    double t_old, t_new;
+    uint32_t crit;
+    long bad;
+    int i, err;
+
+    c.bytes = 50000000;
+    c.chunk = 64;
+    c.size = 1024;
+    c.mt_bytes = 20000000;
+    for (i = 1; i + 1 < argc; i += 2)
+    {
+        const char *opt = argv[i], *val = argv[i + 1];
+
+        if (strcmp(opt, "-bytes") == 0)         c.bytes = atol(val);
+        else if (strcmp(opt, "-chunk") == 0)    c.chunk = atoi(val);
+        else if (strcmp(opt, "-size") == 0)     c.size = atoi(val);
+        else if (strcmp(opt, "-mt") == 0)       c.mt_bytes = atol(val);
+        else break;
+    }
+    if (i < argc || c.bytes < 1 || c.size < 2 || c.size > MAX_SIZE || (c.size & (c.size - 1)) != 0
+        || c.chunk < 1 || c.chunk > c.size || c.mt_bytes < 1)
+    {
+        usage();
+        return 1;
+    }
+
+    printf("FIFO %d bytes, %d bytes per burst, %ld bytes per run\n\n", c.size, c.chunk, c.bytes);
+    printf("%-28s %12s %12s %8s %14s\n", "path", "old ns/B", "ring ns/B", "speedup", "old crit/B");
+
+    s_crit = 0;
+    t_old = run_TxByte(&c, 0);
+    crit = s_crit;
+    t_new = run_TxByte(&c, 1);
+    printf("%-28s %12.2f %12.2f %7.2fx %14.2f\n", "TX byte (UartSend+TXE)", t_old, t_new, t_old / t_new,
+           (double)crit / c.bytes);
+
+    s_crit = 0;
+    t_old = run_RxByte(&c, 0);
+    crit = s_crit;
+    t_new = run_RxByte(&c, 1);
+    printf("%-28s %12.2f %12.2f %7.2fx %14.2f\n", "RX byte (RXNE+GetChar)", t_old, t_new, t_old / t_new,
+           (double)crit / c.bytes);
+
+    s_crit = 0;
+    t_old = run_TxBlock(&c, 0);
+    crit = s_crit;
+    t_new = run_TxBlock(&c, 1);
+    printf("%-28s %12.2f %12.2f %7.2fx %14.3f\n", "TX block (UartSendDma)", t_old, t_new, t_old / t_new,
+           (double)crit / c.bytes);
+
+    printf("\nRX consumer API (DMA fills %d bytes, main program reads and sums them)\n", c.chunk);
+    t_old = run_RxApi(&c, 0);
+    printf("  %-40s %8.2f ns/B\n", "old: if-chain + GetChar per byte", t_old);
+    t_new = run_RxApi(&c, 1);
+    printf("  %-40s %8.2f ns/B %7.2fx\n", "table + GetChar per byte", t_new, t_old / t_new);
+    t_new = run_RxApi(&c, 2);
+    printf("  %-40s %8.2f ns/B %7.2fx\n", "COMx_Read bulk copy", t_new, t_old / t_new);
+    t_new = run_RxApi(&c, 3);
+    printf("  %-40s %8.2f ns/B %7.2fx\n", "COMx_Peek in place + COMx_Consume", t_new, t_old / t_new);
+
+    bad = run_Mt(&c);
+    err = run_Overrun(&c);
+    printf("\nring has no critical sections; two-thread check: %ld bytes, %ld mismatches; DMA overrun check: %s\n",
+           c.mt_bytes, bad, err ? "FAIL" : "ok");
+    return (bad || err) ? 1 : 0;
+}